@@ -0,0 +1,235 @@
+#pragma once
+#ifndef SAE_ENGINE_CORE_BENCHMARK_H
+#define SAE_ENGINE_CORE_BENCHMARK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+	Minimal benchmark harness modelled on Google Benchmark so the suite has no external dependency. Benchmarks are
+	written the same way :
+
+		static void BM_Something(bench::State& _state)
+		{
+			auto _setup = make_data(_state.range(0));
+			for (auto _ : _state)
+			{
+				bench::do_not_optimize(work(_setup));
+			};
+			_state.set_items_processed(_state.iterations() * _state.range(0));
+		};
+		SAE_BENCHMARK(BM_Something)->range(8, 4096);
+
+	and the JSON written by --out uses the Google Benchmark layout so its compare tooling can diff two runs.
+*/
+
+namespace sae::engine::core::bench
+{
+	/**
+	 * @brief Prevents the compiler from optimizing away the computation of _value
+	*/
+	template <typename T>
+	inline void do_not_optimize(T&& _value)
+	{
+#if defined(_MSC_VER)
+		static volatile const void* sink_ = nullptr;
+		sink_ = &_value;
+#else
+		asm volatile("" : : "r,m"(_value) : "memory");
+#endif
+	};
+
+	/**
+	 * @brief Prevents the compiler from assuming memory written before the call is not read afterwards
+	*/
+	inline void clobber_memory()
+	{
+#if defined(_MSC_VER)
+		std::atomic_signal_fence(std::memory_order_acq_rel);
+#else
+		asm volatile("" : : : "memory");
+#endif
+	};
+
+	/**
+	 * @brief Passed to each benchmark function, iterating it runs the timed loop
+	*/
+	class State
+	{
+	public:
+		using clock_type = std::chrono::steady_clock;
+
+		struct Value {};
+
+		class iterator
+		{
+		public:
+			Value operator*() const noexcept { return Value{}; };
+			iterator& operator++() noexcept
+			{
+				--this->remaining_;
+				return *this;
+			};
+			bool operator!=(const iterator&) noexcept
+			{
+				if (this->remaining_ != 0)
+				{
+					return true;
+				};
+				this->state_->finish_timing();
+				return false;
+			};
+
+			iterator(State* _state, uint64_t _remaining) noexcept :
+				state_{ _state }, remaining_{ _remaining }
+			{};
+
+		private:
+			State* state_;
+			uint64_t remaining_;
+		};
+
+		iterator begin()
+		{
+			this->resume_timing();
+			return iterator{ this, this->iterations_ };
+		};
+		iterator end() noexcept
+		{
+			return iterator{ this, 0 };
+		};
+
+		/**
+		 * @brief Excludes the time until resume_timing() from the result, use for per iteration setup
+		*/
+		void pause_timing();
+		void resume_timing();
+
+		/**
+		 * @brief Returns the n'th argument this run was registered with
+		*/
+		int64_t range(size_t _n = 0) const { return this->args_.at(_n); };
+
+		uint64_t iterations() const noexcept { return this->iterations_; };
+
+		void set_items_processed(int64_t _items) noexcept { this->items_ = _items; };
+		void set_bytes_processed(int64_t _bytes) noexcept { this->bytes_ = _bytes; };
+		void set_label(std::string _label) { this->label_ = std::move(_label); };
+
+		/**
+		 * @brief Extra named values written alongside the timings, e.g. state.counters["gl_calls"] = n
+		*/
+		std::map<std::string, double> counters{};
+
+		/**
+		 * @brief Marks the run as failed, the loop still has to be exited by the benchmark
+		*/
+		void skip_with_error(std::string _message);
+
+		State(std::vector<int64_t> _args, uint64_t _iterations);
+
+	private:
+		friend class Runner;
+		void finish_timing();
+
+		std::vector<int64_t> args_;
+		uint64_t iterations_;
+
+		bool running_ = false;
+		clock_type::time_point real_start_{};
+		std::clock_t cpu_start_ = 0;
+		double real_seconds_ = 0.0;
+		double cpu_seconds_ = 0.0;
+
+		int64_t items_ = 0;
+		int64_t bytes_ = 0;
+		std::string label_{};
+		std::string error_{};
+	};
+
+	using function_type = std::function<void(State&)>;
+
+	/**
+	 * @brief A registered benchmark, configured through the chained setters returned by SAE_BENCHMARK
+	*/
+	class Benchmark
+	{
+	public:
+		/**
+		 * @brief Adds a run with a single argument
+		*/
+		Benchmark* arg(int64_t _arg);
+
+		/**
+		 * @brief Adds a run with several arguments
+		*/
+		Benchmark* args(std::vector<int64_t> _args);
+
+		/**
+		 * @brief Adds runs for _lo, each power of _multiplier in between, and _hi
+		*/
+		Benchmark* range(int64_t _lo, int64_t _hi, int64_t _multiplier = 8);
+
+		/**
+		 * @brief Uses a fixed iteration count instead of running until the minimum time
+		*/
+		Benchmark* iterations(uint64_t _count);
+
+		/**
+		 * @brief Overrides the minimum measured time for this benchmark in seconds
+		*/
+		Benchmark* min_time(double _seconds);
+
+		const std::string& name() const noexcept { return this->name_; };
+
+		Benchmark(std::string _name, function_type _fn);
+
+	private:
+		friend class Runner;
+		friend int run_benchmarks(int _argc, char* _argv[]);
+
+		std::string name_;
+		function_type fn_;
+		std::vector<std::vector<int64_t>> arg_sets_{};
+		uint64_t iterations_ = 0;
+		double min_time_ = 0.0;
+	};
+
+	/**
+	 * @brief Adds a benchmark to the global list, used through SAE_BENCHMARK
+	*/
+	Benchmark* register_benchmark(std::string _name, function_type _fn);
+
+	/**
+	 * @brief Runs every registered benchmark selected by the command line and writes the results.
+	 *
+	 *	--filter=<text>        only run benchmarks whose name contains text
+	 *	--max_arg=<n>          skip runs with an argument above n, keeps quick runs away from the largest inputs
+	 *	--min_time=<seconds>   minimum measured time per run, default 0.5
+	 *	--repetitions=<n>      run each benchmark n times and add mean, median and stddev rows
+	 *	--out=<file>           also write the results to a JSON file
+	 *	--list                 print the benchmark names and exit
+	 *
+	 * @return Process exit code, non zero if any benchmark reported an error
+	*/
+	int run_benchmarks(int _argc, char* _argv[]);
+
+}
+
+#define SAE_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define SAE_BENCHMARK_CONCAT(a, b) SAE_BENCHMARK_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Registers a function taking bench::State& as a benchmark
+*/
+#define SAE_BENCHMARK(fn) \
+	static ::sae::engine::core::bench::Benchmark* SAE_BENCHMARK_CONCAT(sae_benchmark_, __LINE__) = \
+		::sae::engine::core::bench::register_benchmark(#fn, fn)
+
+#endif
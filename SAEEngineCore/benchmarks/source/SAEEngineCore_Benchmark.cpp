@@ -0,0 +1,567 @@
+#include "SAEEngineCore_Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+namespace sae::engine::core::bench
+{
+	void State::pause_timing()
+	{
+		if (this->running_)
+		{
+			this->real_seconds_ += std::chrono::duration<double>(clock_type::now() - this->real_start_).count();
+			this->cpu_seconds_ += (double)(std::clock() - this->cpu_start_) / (double)CLOCKS_PER_SEC;
+			this->running_ = false;
+		};
+	};
+	void State::resume_timing()
+	{
+		if (!this->running_)
+		{
+			this->running_ = true;
+			this->cpu_start_ = std::clock();
+			this->real_start_ = clock_type::now();
+		};
+	};
+
+	void State::finish_timing()
+	{
+		this->pause_timing();
+	};
+
+	void State::skip_with_error(std::string _message)
+	{
+		this->error_ = std::move(_message);
+	};
+
+	State::State(std::vector<int64_t> _args, uint64_t _iterations) :
+		args_{ std::move(_args) }, iterations_{ _iterations }
+	{};
+
+}
+
+namespace sae::engine::core::bench
+{
+	Benchmark* Benchmark::arg(int64_t _arg)
+	{
+		this->arg_sets_.push_back({ _arg });
+		return this;
+	};
+	Benchmark* Benchmark::args(std::vector<int64_t> _args)
+	{
+		this->arg_sets_.push_back(std::move(_args));
+		return this;
+	};
+	Benchmark* Benchmark::range(int64_t _lo, int64_t _hi, int64_t _multiplier)
+	{
+		this->arg(_lo);
+		for (int64_t n = 1; n < _hi; n *= _multiplier)
+		{
+			if (n > _lo)
+			{
+				this->arg(n);
+			};
+		};
+		if (_hi != _lo)
+		{
+			this->arg(_hi);
+		};
+		return this;
+	};
+	Benchmark* Benchmark::iterations(uint64_t _count)
+	{
+		this->iterations_ = _count;
+		return this;
+	};
+	Benchmark* Benchmark::min_time(double _seconds)
+	{
+		this->min_time_ = _seconds;
+		return this;
+	};
+
+	Benchmark::Benchmark(std::string _name, function_type _fn) :
+		name_{ std::move(_name) }, fn_{ std::move(_fn) }
+	{};
+
+	namespace
+	{
+		std::vector<std::unique_ptr<Benchmark>>& benchmarks()
+		{
+			static std::vector<std::unique_ptr<Benchmark>> _benchmarks{};
+			return _benchmarks;
+		};
+	};
+
+	Benchmark* register_benchmark(std::string _name, function_type _fn)
+	{
+		auto& _benchmarks = benchmarks();
+		_benchmarks.push_back(std::make_unique<Benchmark>(std::move(_name), std::move(_fn)));
+		return _benchmarks.back().get();
+	};
+
+}
+
+namespace sae::engine::core::bench
+{
+	namespace
+	{
+		struct Options
+		{
+			std::string filter{};
+			std::optional<int64_t> max_arg{};
+			double min_time = 0.5;
+			size_t repetitions = 1;
+			std::string out{};
+			bool list = false;
+		};
+
+		/**
+		 * @brief One row of output, either a measured run or an aggregate over repetitions
+		*/
+		struct Result
+		{
+			std::string name{};
+			std::string run_name{};
+			std::string aggregate{};
+			size_t repetition = 0;
+			size_t repetitions = 1;
+			uint64_t iterations = 0;
+
+			// Per iteration, in nanoseconds
+			double real_ns = 0.0;
+			double cpu_ns = 0.0;
+
+			double items_per_second = 0.0;
+			double bytes_per_second = 0.0;
+			std::map<std::string, double> counters{};
+			std::string label{};
+			std::string error{};
+		};
+
+		std::string run_name(const Benchmark& _bench, const std::vector<int64_t>& _args)
+		{
+			std::string _out = _bench.name();
+			for (auto& a : _args)
+			{
+				_out += '/' + std::to_string(a);
+			};
+			return _out;
+		};
+
+		std::string json_escape(const std::string& _str)
+		{
+			std::string _out{};
+			for (auto c : _str)
+			{
+				switch (c)
+				{
+				case '"':
+					_out += "\\\"";
+					break;
+				case '\\':
+					_out += "\\\\";
+					break;
+				case '\n':
+					_out += "\\n";
+					break;
+				default:
+					_out += c;
+					break;
+				};
+			};
+			return _out;
+		};
+
+		std::string format_time(double _ns)
+		{
+			std::ostringstream _str{};
+			_str << std::fixed << std::setprecision(_ns < 10.0 ? 2 : (_ns < 100.0 ? 1 : 0)) << _ns << " ns";
+			return _str.str();
+		};
+
+		std::string format_rate(double _perSecond, const char* _unit)
+		{
+			const char* _prefixes[] = { "", "k", "M", "G", "T" };
+			size_t _prefix = 0;
+			while (_perSecond >= 1000.0 && _prefix + 1 < std::size(_prefixes))
+			{
+				_perSecond /= 1000.0;
+				++_prefix;
+			};
+			std::ostringstream _str{};
+			_str << std::fixed << std::setprecision(2) << _perSecond << _prefixes[_prefix] << _unit;
+			return _str.str();
+		};
+
+	};
+
+	class Runner
+	{
+	public:
+
+		/**
+		 * @brief Runs _bench once with the given iteration count and returns the filled in state
+		*/
+		static State run_once(Benchmark& _bench, const std::vector<int64_t>& _args, uint64_t _iterations)
+		{
+			State _state{ _args, _iterations };
+			_bench.fn_(_state);
+			_state.pause_timing();
+			return _state;
+		};
+
+		/**
+		 * @brief Finds an iteration count that takes at least the minimum time, growing it the way Google Benchmark does
+		*/
+		static Result measure(Benchmark& _bench, const std::vector<int64_t>& _args, const Options& _opts)
+		{
+			const double _minTime = (_bench.min_time_ > 0.0) ? _bench.min_time_ : _opts.min_time;
+			uint64_t _iterations = (_bench.iterations_ != 0) ? _bench.iterations_ : 1;
+
+			constexpr uint64_t MAX_ITERATIONS = 1000000000;
+			while (true)
+			{
+				auto _state = run_once(_bench, _args, _iterations);
+				const auto _seconds = _state.real_seconds_;
+
+				const bool _done = _bench.iterations_ != 0 || !_state.error_.empty() || _seconds >= _minTime ||
+					_iterations >= MAX_ITERATIONS;
+				if (_done)
+				{
+					Result _out{};
+					_out.name = run_name(_bench, _args);
+					_out.run_name = _out.name;
+					_out.iterations = _iterations;
+					_out.real_ns = _state.real_seconds_ * 1e9 / (double)_iterations;
+					_out.cpu_ns = _state.cpu_seconds_ * 1e9 / (double)_iterations;
+					if (_state.items_ != 0 && _state.real_seconds_ > 0.0)
+					{
+						_out.items_per_second = (double)_state.items_ / _state.real_seconds_;
+					};
+					if (_state.bytes_ != 0 && _state.real_seconds_ > 0.0)
+					{
+						_out.bytes_per_second = (double)_state.bytes_ / _state.real_seconds_;
+					};
+					_out.counters = std::move(_state.counters);
+					_out.label = std::move(_state.label_);
+					_out.error = std::move(_state.error_);
+					return _out;
+				};
+
+				// Aim 40% past the minimum time to avoid another round, growing at most 10x at once
+				const double _multiplier = (_seconds > 0.0) ? std::min(10.0, _minTime * 1.4 / _seconds) : 10.0;
+				_iterations = std::min<uint64_t>(MAX_ITERATIONS,
+					std::max<uint64_t>(_iterations + 1, (uint64_t)std::ceil((double)_iterations * _multiplier)));
+			};
+		};
+
+		static std::vector<Result> aggregate(const std::vector<Result>& _runs)
+		{
+			std::vector<Result> _out{};
+			if (_runs.size() < 2)
+			{
+				return _out;
+			};
+
+			auto _make = [&_runs](const char* _name, auto&& _reduce)
+			{
+				Result _res{};
+				_res.name = _runs.front().run_name + "_" + _name;
+				_res.run_name = _runs.front().run_name;
+				_res.aggregate = _name;
+				_res.repetitions = _runs.size();
+				_res.iterations = _runs.size();
+				_res.real_ns = _reduce([](const Result& r) { return r.real_ns; });
+				_res.cpu_ns = _reduce([](const Result& r) { return r.cpu_ns; });
+				_res.items_per_second = _reduce([](const Result& r) { return r.items_per_second; });
+				_res.bytes_per_second = _reduce([](const Result& r) { return r.bytes_per_second; });
+				for (auto& c : _runs.front().counters)
+				{
+					const auto _key = c.first;
+					_res.counters[_key] = _reduce([&_key](const Result& r) { return r.counters.at(_key); });
+				};
+				return _res;
+			};
+
+			auto _values = [&_runs](auto&& _get)
+			{
+				std::vector<double> _out{};
+				for (auto& r : _runs)
+				{
+					_out.push_back(_get(r));
+				};
+				return _out;
+			};
+			auto _mean = [&_values](auto&& _get)
+			{
+				const auto _v = _values(_get);
+				double _sum = 0.0;
+				for (auto& v : _v)
+				{
+					_sum += v;
+				};
+				return _sum / (double)_v.size();
+			};
+			auto _median = [&_values](auto&& _get)
+			{
+				auto _v = _values(_get);
+				std::sort(_v.begin(), _v.end());
+				const auto _mid = _v.size() / 2;
+				return (_v.size() % 2 == 0) ? (_v[_mid - 1] + _v[_mid]) / 2.0 : _v[_mid];
+			};
+			auto _stddev = [&_values, &_mean](auto&& _get)
+			{
+				const auto _v = _values(_get);
+				const auto _m = _mean(_get);
+				double _sum = 0.0;
+				for (auto& v : _v)
+				{
+					_sum += (v - _m) * (v - _m);
+				};
+				return std::sqrt(_sum / (double)(_v.size() - 1));
+			};
+
+			_out.push_back(_make("mean", _mean));
+			_out.push_back(_make("median", _median));
+			_out.push_back(_make("stddev", _stddev));
+			return _out;
+		};
+
+		static void print_header()
+		{
+			std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(16) << "Time"
+				<< std::setw(16) << "CPU" << std::setw(14) << "Iterations" << '\n';
+			std::cout << std::string(94, '-') << '\n';
+		};
+
+		static void print(const Result& _res)
+		{
+			std::cout << std::left << std::setw(48) << _res.name << std::right;
+			if (!_res.error.empty())
+			{
+				std::cout << " ERROR : " << _res.error << '\n';
+				return;
+			};
+			std::cout << std::setw(16) << format_time(_res.real_ns) << std::setw(16) << format_time(_res.cpu_ns)
+				<< std::setw(14) << _res.iterations;
+			if (_res.bytes_per_second > 0.0)
+			{
+				std::cout << ' ' << format_rate(_res.bytes_per_second, "B/s");
+			};
+			if (_res.items_per_second > 0.0)
+			{
+				std::cout << ' ' << format_rate(_res.items_per_second, " items/s");
+			};
+			for (auto& c : _res.counters)
+			{
+				std::cout << ' ' << c.first << '=' << c.second;
+			};
+			if (!_res.label.empty())
+			{
+				std::cout << ' ' << _res.label;
+			};
+			std::cout << '\n';
+		};
+
+		static void write_json(std::ostream& _ostr, const std::vector<Result>& _results)
+		{
+			const auto _now = std::time(nullptr);
+			char _date[64]{};
+			std::strftime(_date, sizeof(_date), "%Y-%m-%dT%H:%M:%S", std::localtime(&_now));
+
+			_ostr << "{\n  \"context\": {\n";
+			_ostr << "    \"date\": \"" << _date << "\",\n";
+			_ostr << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#if defined(NDEBUG)
+			_ostr << "    \"library_build_type\": \"release\"\n";
+#else
+			_ostr << "    \"library_build_type\": \"debug\"\n";
+#endif
+			_ostr << "  },\n  \"benchmarks\": [\n";
+
+			_ostr << std::setprecision(10);
+			for (size_t n = 0; n != _results.size(); ++n)
+			{
+				const auto& r = _results[n];
+				_ostr << "    {\n";
+				_ostr << "      \"name\": \"" << json_escape(r.name) << "\",\n";
+				_ostr << "      \"run_name\": \"" << json_escape(r.run_name) << "\",\n";
+				if (r.aggregate.empty())
+				{
+					_ostr << "      \"run_type\": \"iteration\",\n";
+					_ostr << "      \"repetitions\": " << r.repetitions << ",\n";
+					_ostr << "      \"repetition_index\": " << r.repetition << ",\n";
+				}
+				else
+				{
+					_ostr << "      \"run_type\": \"aggregate\",\n";
+					_ostr << "      \"repetitions\": " << r.repetitions << ",\n";
+					_ostr << "      \"aggregate_name\": \"" << r.aggregate << "\",\n";
+				};
+				if (!r.error.empty())
+				{
+					_ostr << "      \"error_occurred\": true,\n";
+					_ostr << "      \"error_message\": \"" << json_escape(r.error) << "\",\n";
+				};
+				_ostr << "      \"iterations\": " << r.iterations << ",\n";
+				_ostr << "      \"real_time\": " << r.real_ns << ",\n";
+				_ostr << "      \"cpu_time\": " << r.cpu_ns << ",\n";
+				_ostr << "      \"time_unit\": \"ns\"";
+				if (r.bytes_per_second > 0.0)
+				{
+					_ostr << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+				};
+				if (r.items_per_second > 0.0)
+				{
+					_ostr << ",\n      \"items_per_second\": " << r.items_per_second;
+				};
+				for (auto& c : r.counters)
+				{
+					_ostr << ",\n      \"" << json_escape(c.first) << "\": " << c.second;
+				};
+				if (!r.label.empty())
+				{
+					_ostr << ",\n      \"label\": \"" << json_escape(r.label) << "\"";
+				};
+				_ostr << "\n    }" << ((n + 1 != _results.size()) ? "," : "") << '\n';
+			};
+			_ostr << "  ]\n}\n";
+		};
+
+		static bool parse(int _argc, char* _argv[], Options& _opts)
+		{
+			for (int n = 1; n < _argc; ++n)
+			{
+				const std::string _arg{ _argv[n] };
+				auto _value = [&_arg](const char* _flag) -> std::optional<std::string>
+				{
+					const auto _len = std::strlen(_flag);
+					if (_arg.compare(0, _len, _flag) == 0)
+					{
+						return _arg.substr(_len);
+					};
+					return std::nullopt;
+				};
+
+				if (auto v = _value("--filter="); v)
+				{
+					_opts.filter = *v;
+				}
+				else if (auto v = _value("--max_arg="); v)
+				{
+					_opts.max_arg = std::stoll(*v);
+				}
+				else if (auto v = _value("--min_time="); v)
+				{
+					_opts.min_time = std::stod(*v);
+				}
+				else if (auto v = _value("--repetitions="); v)
+				{
+					_opts.repetitions = std::max<size_t>(1, std::stoul(*v));
+				}
+				else if (auto v = _value("--out="); v)
+				{
+					_opts.out = *v;
+				}
+				else if (_arg == "--list")
+				{
+					_opts.list = true;
+				}
+				else
+				{
+					std::cerr << "unknown argument " << _arg << '\n';
+					return false;
+				};
+			};
+			return true;
+		};
+
+	};
+
+	int run_benchmarks(int _argc, char* _argv[])
+	{
+		Options _opts{};
+		if (!Runner::parse(_argc, _argv, _opts))
+		{
+			return 2;
+		};
+
+		std::vector<Result> _results{};
+		bool _failed = false;
+		if (!_opts.list)
+		{
+			Runner::print_header();
+		};
+
+		for (auto& b : benchmarks())
+		{
+			auto _argSets = b->arg_sets_;
+			if (_argSets.empty())
+			{
+				_argSets.push_back({});
+			};
+			for (auto& _args : _argSets)
+			{
+				const auto _name = run_name(*b, _args);
+				if (!_opts.filter.empty() && _name.find(_opts.filter) == std::string::npos)
+				{
+					continue;
+				};
+				if (_opts.max_arg && std::any_of(_args.begin(), _args.end(), [&_opts](int64_t a) { return a > *_opts.max_arg; }))
+				{
+					continue;
+				};
+				if (_opts.list)
+				{
+					std::cout << _name << '\n';
+					continue;
+				};
+
+				std::vector<Result> _runs{};
+				for (size_t r = 0; r != _opts.repetitions; ++r)
+				{
+					auto _res = Runner::measure(*b, _args, _opts);
+					_res.repetition = r;
+					_res.repetitions = _opts.repetitions;
+					_failed = _failed || !_res.error.empty();
+					Runner::print(_res);
+					_runs.push_back(std::move(_res));
+				};
+				for (auto& _agg : Runner::aggregate(_runs))
+				{
+					Runner::print(_agg);
+					_runs.push_back(std::move(_agg));
+				};
+				_results.insert(_results.end(), _runs.begin(), _runs.end());
+			};
+		};
+
+		if (!_opts.out.empty())
+		{
+			std::ofstream _file{ _opts.out, std::ios::binary | std::ios::trunc };
+			if (!_file.is_open())
+			{
+				std::cerr << "could not open " << _opts.out << '\n';
+				return 2;
+			};
+			Runner::write_json(_file, _results);
+		};
+
+		return _failed ? 1 : 0;
+	};
+
+}
+
+int main(int argc, char* argv[], char* envp[])
+{
+	return sae::engine::core::bench::run_benchmarks(argc, argv);
+};
@@ -0,0 +1,121 @@
+#include "SAEEngineCore_Benchmark.h"
+
+#include <SAEEngineCore_Event.h>
+#include <SAEEngineCore_Object.h>
+
+using namespace sae::engine::core;
+
+/*
+	Event construction, the queue and coalescer in front of GFXContext, and dispatch through the object tree with and
+	without the spatial index.
+*/
+
+namespace
+{
+	constexpr Rect SCREEN{ { 0_px, 0_px }, { 1600_px, 900_px } };
+
+	void build_grid(GFXContext& _context, int64_t _count)
+	{
+		for (int64_t n = 0; n != _count; ++n)
+		{
+			const auto _x = (int)((n * 37) % 1500);
+			const auto _y = (int)((n * 53) % 800);
+			_context.emplace(new GFXObject{ Rect{ { _x, _y }, { _x + 40, _y + 40 } } });
+		};
+		_context.refresh();
+	};
+
+	Event cursor_event(int64_t _n)
+	{
+		Event::evCursorMove _move{};
+		_move.cursor_x = (int16_t)((_n * 7) % 1600);
+		_move.cursor_y = (int16_t)((_n * 3) % 900);
+		return Event{ _move, true };
+	};
+
+}
+
+static void BM_Event_Construct_CursorMove(bench::State& _state)
+{
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		auto _ev = cursor_event(n++);
+		bench::do_not_optimize(_ev);
+	};
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_Event_Construct_CursorMove);
+
+static void BM_Event_Construct_Blackboard(bench::State& _state)
+{
+	for (auto _ : _state)
+	{
+		Event _ev{ Event::evBlackboardChange{ "player.health.current" } };
+		bench::do_not_optimize(_ev);
+	};
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_Event_Construct_Blackboard);
+
+static void BM_Event_Dispatch(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	build_grid(_context, _state.range(0));
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		auto _ev = cursor_event(n++);
+		_context.handle_event(_ev);
+	};
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_Event_Dispatch)->range(64, 32768);
+
+static void BM_Event_Dispatch_SpatialIndex(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	build_grid(_context, _state.range(0));
+	_context.enable_spatial_index();
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		auto _ev = cursor_event(n++);
+		_context.handle_event(_ev);
+	};
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_Event_Dispatch_SpatialIndex)->range(64, 32768);
+
+static void BM_EventQueue_PushPop(bench::State& _state)
+{
+	EventQueue _queue{ 1024, EventQueue::OVERFLOW_POLICY::DROP_OLDEST };
+	Event _out{};
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		_queue.push(cursor_event(n++));
+		_queue.try_pop(_out);
+	};
+	bench::do_not_optimize(_out);
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_EventQueue_PushPop);
+
+static void BM_GFXContext_ProcessEvents(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	build_grid(_context, 1024);
+	const auto _burst = _state.range(0);
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		for (int64_t b = 0; b != _burst; ++b)
+		{
+			_context.post_event(cursor_event(n++));
+		};
+		_context.process_events();
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _burst);
+};
+SAE_BENCHMARK(BM_GFXContext_ProcessEvents)->range(1, 256);
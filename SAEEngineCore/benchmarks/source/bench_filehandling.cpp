@@ -0,0 +1,164 @@
+#include "SAEEngineCore_Benchmark.h"
+
+#include <SAEEngineCore_FileHandling.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	OpenFile and MappedFile throughput on files of several sizes. The files are written to the temp directory once per run
+	and removed afterwards, so after the first iteration the reads come from the page cache.
+*/
+
+namespace
+{
+	std::filesystem::path make_file(int64_t _bytes)
+	{
+		auto _path = std::filesystem::temp_directory_path() / ("sae_bench_" + std::to_string(_bytes) + ".bin");
+		std::ofstream _file{ _path, std::ios::binary | std::ios::trunc };
+		std::vector<char> _chunk(64 * 1024);
+		for (size_t n = 0; n != _chunk.size(); ++n)
+		{
+			_chunk[n] = (char)('a' + (n % 26));
+		};
+		for (int64_t _left = _bytes; _left > 0; _left -= (int64_t)_chunk.size())
+		{
+			_file.write(_chunk.data(), (std::streamsize)std::min<int64_t>(_left, (int64_t)_chunk.size()));
+		};
+		return _path;
+	};
+
+}
+
+static void BM_OpenFile(bench::State& _state)
+{
+	const auto _bytes = _state.range(0);
+	const auto _path = make_file(_bytes);
+	for (auto _ : _state)
+	{
+		auto _data = OpenFile(_path);
+		if (!_data || (int64_t)_data->size() != _bytes)
+		{
+			_state.skip_with_error("OpenFile returned the wrong size");
+			break;
+		};
+		bench::do_not_optimize(_data);
+	};
+	_state.set_bytes_processed((int64_t)_state.iterations() * _bytes);
+
+	std::error_code _ec{};
+	std::filesystem::remove(_path, _ec);
+};
+SAE_BENCHMARK(BM_OpenFile)->arg(4 * 1024)->arg(64 * 1024)->arg(1024 * 1024)->arg(16 * 1024 * 1024)->arg(256 * 1024 * 1024);
+
+/*
+	Maps the file and reads one byte from each page so every page is faulted in, which is the least a loader parsing
+	or uploading the contents pays on top of the mapping
+*/
+static void BM_MappedFile(bench::State& _state)
+{
+	constexpr size_t PAGE = 4096;
+
+	const auto _bytes = _state.range(0);
+	const auto _path = make_file(_bytes);
+	for (auto _ : _state)
+	{
+		MappedFile _file{ _path };
+		if (!_file.good() || (int64_t)_file.size() != _bytes)
+		{
+			_state.skip_with_error("MappedFile returned the wrong size");
+			break;
+		};
+		const auto _data = _file.data();
+		uint64_t _sum = 0;
+		for (size_t n = 0; n < _data.size(); n += PAGE)
+		{
+			_sum += (uint8_t)_data[n];
+		};
+		bench::do_not_optimize(_sum);
+	};
+	_state.set_bytes_processed((int64_t)_state.iterations() * _bytes);
+
+	std::error_code _ec{};
+	std::filesystem::remove(_path, _ec);
+};
+SAE_BENCHMARK(BM_MappedFile)->arg(4 * 1024)->arg(1024 * 1024)->arg(256 * 1024 * 1024);
+
+namespace
+{
+	constexpr int64_t BATCH_FILES = 200;
+	constexpr int64_t BATCH_FILE_BYTES = 64 * 1024;
+
+	std::vector<std::filesystem::path> make_batch()
+	{
+		std::vector<std::filesystem::path> _out{};
+		for (int64_t n = 0; n != BATCH_FILES; ++n)
+		{
+			const auto _from = make_file(BATCH_FILE_BYTES);
+			_out.push_back(_from.parent_path() / ("sae_bench_batch_" + std::to_string(n) + ".bin"));
+			std::filesystem::rename(_from, _out.back());
+		};
+		return _out;
+	};
+
+	void remove_batch(const std::vector<std::filesystem::path>& _paths)
+	{
+		std::error_code _ec{};
+		for (auto& p : _paths)
+		{
+			std::filesystem::remove(p, _ec);
+		};
+	};
+}
+
+/*
+	A startup sized batch of files read one after another with OpenFile, the baseline for BM_AsyncFileLoader. Every file
+	is kept until the batch is done, as a loader's caller would, so buffers are not recycled between files.
+*/
+static void BM_LoadBatch_Sequential(bench::State& _state)
+{
+	const auto _paths = make_batch();
+	for (auto _ : _state)
+	{
+		std::vector<std::vector<unsigned char>> _loaded{};
+		_loaded.reserve(_paths.size());
+		for (auto& p : _paths)
+		{
+			_loaded.push_back(*OpenFile(p));
+		};
+		bench::do_not_optimize(_loaded);
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * BATCH_FILES);
+	_state.set_bytes_processed((int64_t)_state.iterations() * BATCH_FILES * BATCH_FILE_BYTES);
+	remove_batch(_paths);
+};
+SAE_BENCHMARK(BM_LoadBatch_Sequential);
+
+/*
+	The same batch through AsyncFileLoader, argument 0 is the backend, 0 for io_uring and 1 for the thread pool. The
+	backend actually used is written to the label.
+*/
+static void BM_AsyncFileLoader(bench::State& _state)
+{
+	const auto _paths = make_batch();
+	AsyncFileLoader _loader{ (_state.range(0) == 0) ? AsyncFileLoader::BACKEND::IO_URING : AsyncFileLoader::BACKEND::THREAD_POOL };
+	_state.set_label((_loader.backend() == AsyncFileLoader::BACKEND::IO_URING) ? "io_uring" : "thread pool");
+	for (auto _ : _state)
+	{
+		std::vector<std::vector<unsigned char>> _loaded{};
+		_loaded.reserve(_paths.size());
+		for (auto& f : _loader.load(_paths))
+		{
+			_loaded.push_back(f.get().data);
+		};
+		bench::do_not_optimize(_loaded);
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * BATCH_FILES);
+	_state.set_bytes_processed((int64_t)_state.iterations() * BATCH_FILES * BATCH_FILE_BYTES);
+	remove_batch(_paths);
+};
+SAE_BENCHMARK(BM_AsyncFileLoader)->arg(0)->arg(1);
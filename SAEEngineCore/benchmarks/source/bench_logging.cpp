@@ -0,0 +1,149 @@
+#include "SAEEngineCore_Benchmark.h"
+
+#include <SAEEngineCore_Logging.h>
+
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	LogStream overhead, writing into a stream that discards its output so only the logging path and formatting are timed.
+	Records are written by LogStream's background thread, so each benchmark flushes before reading the byte count.
+*/
+
+namespace
+{
+	/**
+	 * @brief Stream buffer that throws away everything written to it while counting the bytes
+	*/
+	class CountingBuffer : public std::streambuf
+	{
+	public:
+		size_t count() const noexcept { return this->count_; };
+
+	protected:
+		int_type overflow(int_type _ch) override
+		{
+			++this->count_;
+			return traits_type::not_eof(_ch);
+		};
+		std::streamsize xsputn(const char_type* _str, std::streamsize _count) override
+		{
+			this->count_ += (size_t)_count;
+			return _count;
+		};
+
+	private:
+		size_t count_ = 0;
+	};
+
+}
+
+static void BM_LogStream_String(bench::State& _state)
+{
+	CountingBuffer _buffer{};
+	std::ostream _ostr{ &_buffer };
+	LogStream _log{ &_ostr };
+	for (auto _ : _state)
+	{
+		_log << "window resized, rebuilding layout\n";
+	};
+	_log.flush();
+	_state.set_items_processed((int64_t)_state.iterations());
+	_state.set_bytes_processed((int64_t)_buffer.count());
+};
+SAE_BENCHMARK(BM_LogStream_String);
+
+static void BM_LogStream_Mixed(bench::State& _state)
+{
+	CountingBuffer _buffer{};
+	std::ostream _ostr{ &_buffer };
+	LogStream _log{ &_ostr };
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		_log << "frame " << n << " took " << 16.6 << " ms, " << (n * 3) << " draws\n";
+		++n;
+	};
+	_log.flush();
+	_state.set_items_processed((int64_t)_state.iterations());
+	_state.set_bytes_processed((int64_t)_buffer.count());
+};
+SAE_BENCHMARK(BM_LogStream_Mixed);
+
+/*
+	The same record as BM_LogStream_Mixed logged with structured(), only the argument bytes are copied on the calling
+	thread. Argument 0 is the output, 0 for LOG_OUTPUT::TEXT, formatted by the background thread, 1 for BINARY.
+*/
+static void BM_LogStream_Structured(bench::State& _state)
+{
+	CountingBuffer _buffer{};
+	std::ostream _ostr{ &_buffer };
+	LogStream _log{ &_ostr, 512 * 1024, LOG_OVERFLOW::BLOCK, (_state.range(0) == 0) ? LOG_OUTPUT::TEXT : LOG_OUTPUT::BINARY };
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		_log.structured<"frame {} took {} ms, {} draws\n">(n, 16.6, n * 3);
+		++n;
+	};
+	_log.flush();
+	_state.set_items_processed((int64_t)_state.iterations());
+	_state.set_bytes_processed((int64_t)_buffer.count());
+};
+SAE_BENCHMARK(BM_LogStream_Structured)->arg(0)->arg(1);
+
+static void BM_LogStream_Threads(bench::State& _state)
+{
+	constexpr int64_t RECORDS_PER_THREAD = 1000;
+
+	CountingBuffer _buffer{};
+	std::ostream _ostr{ &_buffer };
+	LogStream _log{ &_ostr };
+	const auto _threads = (size_t)_state.range(0);
+	for (auto _ : _state)
+	{
+		std::vector<std::thread> _writers{};
+		for (size_t t = 0; t != _threads; ++t)
+		{
+			_writers.emplace_back([&_log, t]()
+				{
+					for (int64_t n = 0; n != RECORDS_PER_THREAD; ++n)
+					{
+						_log << "thread " << t << " frame " << n << " took " << 16.6 << " ms\n";
+					};
+				});
+		};
+		for (auto& w : _writers)
+		{
+			w.join();
+		};
+	};
+	_log.flush();
+	_state.set_items_processed((int64_t)_state.iterations() * (int64_t)_threads * RECORDS_PER_THREAD);
+	_state.set_bytes_processed((int64_t)_buffer.count());
+	_state.counters["blocked"] = (double)_log.stats().blocked;
+};
+SAE_BENCHMARK(BM_LogStream_Threads)->arg(1)->arg(4)->arg(16);
+
+/*
+	SAE_LOG on a channel whose level is above the record's, the arguments are never evaluated
+*/
+static void BM_LogChannel_Disabled(bench::State& _state)
+{
+	auto& _channel = log_channel(LOG_CHANNEL::OBJECT);
+	const auto _level = _channel.level();
+	_channel.set_level(LOG_LEVEL::OFF);
+	int64_t n = 0;
+	for (auto _ : _state)
+	{
+		SAE_LOG(OBJECT, ERR) << "frame " << n << " took " << 16.6 << " ms\n";
+		++n;
+		bench::clobber_memory();
+	};
+	_channel.set_level(_level);
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_LogChannel_Disabled);
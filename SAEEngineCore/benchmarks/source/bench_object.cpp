@@ -0,0 +1,264 @@
+#include "SAEEngineCore_Benchmark.h"
+
+#include <SAEEngineCore_Object.h>
+
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	GFXView container operations, GFXGroup::refresh and grow over deep (chained) and wide (flat) trees, and the Rect
+	helpers everything else is built on.
+*/
+
+namespace
+{
+	constexpr Rect SCREEN{ { 0_px, 0_px }, { 1600_px, 900_px } };
+
+	Rect rect_for(int64_t _n)
+	{
+		const auto _x = (int)((_n * 37) % 1500);
+		const auto _y = (int)((_n * 53) % 800);
+		return Rect{ { _x, _y }, { _x + 20, _y + 20 } };
+	};
+
+	GrowMode grow_all()
+	{
+		GrowMode _gm{};
+		_gm.set(GrowMode::gmRight).set(GrowMode::gmBottom);
+		return _gm;
+	};
+
+	/**
+	 * @brief Adds _count objects directly below the context
+	*/
+	void build_wide(GFXContext& _context, int64_t _count)
+	{
+		for (int64_t n = 0; n != _count; ++n)
+		{
+			auto _obj = new GFXObject{ rect_for(n) };
+			_obj->grow_mode() = grow_all();
+			_context.emplace(_obj);
+		};
+	};
+
+	/**
+	 * @brief Adds a chain of _depth views, each holding the next, with a leaf object at the bottom
+	*/
+	void build_deep(GFXContext& _context, int64_t _depth)
+	{
+		GFXView* _parent = nullptr;
+		for (int64_t n = 0; n != _depth; ++n)
+		{
+			auto _view = new GFXView{ &_context, SCREEN };
+			_view->grow_mode() = grow_all();
+			if (_parent)
+			{
+				_parent->emplace(_view);
+			}
+			else
+			{
+				_context.emplace(_view);
+			};
+			_parent = _view;
+		};
+		_parent->emplace(new GFXObject{ rect_for(0) });
+	};
+
+	/**
+	 * @brief Marks the object at the bottom of a deep tree, or every object of a wide tree, as dirty
+	*/
+	void mark_leaves(GFXView& _view)
+	{
+		for (auto& c : _view)
+		{
+			if (auto _sub = dynamic_cast<GFXView*>(c.get()); _sub)
+			{
+				mark_leaves(*_sub);
+			}
+			else
+			{
+				c->mark_dirty();
+			};
+		};
+	};
+
+}
+
+static void BM_GFXView_Insert(bench::State& _state)
+{
+	const auto _count = _state.range(0);
+	std::vector<GFXObject*> _objects{};
+	_objects.reserve((size_t)_count);
+	for (auto _ : _state)
+	{
+		_state.pause_timing();
+		GFXContext _context{ nullptr, SCREEN };
+		_objects.clear();
+		for (int64_t n = 0; n != _count; ++n)
+		{
+			_objects.push_back(new GFXObject{ rect_for(n) });
+		};
+		_state.resume_timing();
+
+		for (auto& o : _objects)
+		{
+			_context.emplace(o);
+		};
+
+		_state.pause_timing();
+		_context.clear();
+		_state.resume_timing();
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _count);
+};
+SAE_BENCHMARK(BM_GFXView_Insert)->range(64, 4096);
+
+static void BM_GFXView_Remove(bench::State& _state)
+{
+	const auto _count = _state.range(0);
+	std::vector<GFXObject*> _objects{};
+	_objects.reserve((size_t)_count);
+	for (auto _ : _state)
+	{
+		_state.pause_timing();
+		GFXContext _context{ nullptr, SCREEN };
+		_objects.clear();
+		for (int64_t n = 0; n != _count; ++n)
+		{
+			_objects.push_back(new GFXObject{ rect_for(n) });
+			_context.emplace(_objects.back());
+		};
+		_state.resume_timing();
+
+		// Remove from the back so each removal does the same amount of searching
+		for (auto it = _objects.rbegin(); it != _objects.rend(); ++it)
+		{
+			_context.remove(*it);
+		};
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _count);
+};
+SAE_BENCHMARK(BM_GFXView_Remove)->range(64, 4096);
+
+static void BM_GFXGroup_Refresh_Wide(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	build_wide(_context, _state.range(0));
+	_context.refresh();
+	for (auto _ : _state)
+	{
+		_state.pause_timing();
+		mark_leaves(_context);
+		_state.resume_timing();
+		_context.refresh();
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _state.range(0));
+};
+SAE_BENCHMARK(BM_GFXGroup_Refresh_Wide)->range(64, 32768);
+
+static void BM_GFXGroup_Refresh_Deep(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	build_deep(_context, _state.range(0));
+	_context.refresh();
+	for (auto _ : _state)
+	{
+		_state.pause_timing();
+		mark_leaves(_context);
+		_state.resume_timing();
+		_context.refresh();
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _state.range(0));
+};
+SAE_BENCHMARK(BM_GFXGroup_Refresh_Deep)->range(8, 512);
+
+static void BM_GFXGroup_Grow_Wide(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	build_wide(_context, _state.range(0));
+	int _sign = 1;
+	for (auto _ : _state)
+	{
+		_context.grow(pixels_t{ _sign }, pixels_t{ -_sign });
+		_sign = -_sign;
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _state.range(0));
+};
+SAE_BENCHMARK(BM_GFXGroup_Grow_Wide)->range(64, 32768);
+
+static void BM_GFXGroup_Grow_Deep(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	build_deep(_context, _state.range(0));
+	int _sign = 1;
+	for (auto _ : _state)
+	{
+		_context.grow(pixels_t{ _sign }, pixels_t{ -_sign });
+		_sign = -_sign;
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _state.range(0));
+};
+SAE_BENCHMARK(BM_GFXGroup_Grow_Deep)->range(8, 512);
+
+static void BM_Rect_Shift(bench::State& _state)
+{
+	Rect _r = rect_for(1);
+	int _sign = 1;
+	for (auto _ : _state)
+	{
+		_r.shift(pixels_t{ _sign }, pixels_t{ -_sign });
+		_sign = -_sign;
+		bench::do_not_optimize(_r);
+	};
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_Rect_Shift);
+
+static void BM_Rect_Grow(bench::State& _state)
+{
+	Rect _r = rect_for(1);
+	int _sign = 1;
+	for (auto _ : _state)
+	{
+		_r.grow(pixels_t{ _sign }, pixels_t{ _sign });
+		_sign = -_sign;
+		bench::do_not_optimize(_r);
+	};
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_Rect_Grow);
+
+static void BM_Rect_Intersects(bench::State& _state)
+{
+	std::vector<Rect> _rects{};
+	for (int64_t n = 0; n != 1024; ++n)
+	{
+		_rects.push_back(rect_for(n));
+	};
+	const ScreenPoint _p{ 400_px, 300_px };
+	for (auto _ : _state)
+	{
+		size_t _hits = 0;
+		for (auto& r : _rects)
+		{
+			_hits += r.intersects(_p);
+		};
+		bench::do_not_optimize(_hits);
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * (int64_t)_rects.size());
+};
+SAE_BENCHMARK(BM_Rect_Intersects);
+
+static void BM_Rect_FindCenter(bench::State& _state)
+{
+	Rect _r = rect_for(1);
+	for (auto _ : _state)
+	{
+		bench::do_not_optimize(_r);
+		auto _c = _r.find_center();
+		bench::do_not_optimize(_c);
+	};
+	_state.set_items_processed((int64_t)_state.iterations());
+};
+SAE_BENCHMARK(BM_Rect_FindCenter);
@@ -0,0 +1,61 @@
+#include "SAEEngineCore_Benchmark.h"
+
+#include <SAEEngineCore_UI.h>
+
+using namespace sae::engine::core;
+
+/*
+	UIList layout, both a single list with many children and nested lists of rows.
+*/
+
+namespace
+{
+	constexpr Rect SCREEN{ { 0_px, 0_px }, { 1600_px, 900_px } };
+}
+
+static void BM_UIList_Refresh_Flat(bench::State& _state)
+{
+	GFXContext _context{ nullptr, SCREEN };
+	auto _list = new UIList{ &_context, SCREEN, UIList::VERTICAL, UIList::POSITIVE, 2_px };
+	for (int64_t n = 0; n != _state.range(0); ++n)
+	{
+		_list->emplace(new GFXObject{});
+	};
+	_context.emplace(_list);
+	_context.refresh();
+
+	for (auto _ : _state)
+	{
+		// Changing the margin asks for a new layout of every child
+		_list->set_margin((_list->margin() == 2_px) ? 3_px : 2_px);
+		_context.refresh();
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _state.range(0));
+};
+SAE_BENCHMARK(BM_UIList_Refresh_Flat)->range(16, 4096);
+
+static void BM_UIList_Refresh_Nested(bench::State& _state)
+{
+	constexpr int64_t ITEMS_PER_ROW = 16;
+	GFXContext _context{ nullptr, SCREEN };
+	auto _root = new UIList{ &_context, SCREEN, UIList::VERTICAL, UIList::POSITIVE, 0_px };
+	for (int64_t r = 0; r != _state.range(0); ++r)
+	{
+		auto _row = new UIList{ &_context, Rect{}, UIList::HORIZONTAL, UIList::POSITIVE, 1_px };
+		for (int64_t n = 0; n != ITEMS_PER_ROW; ++n)
+		{
+			_row->emplace(new GFXObject{});
+		};
+		_root->emplace(_row);
+	};
+	_context.emplace(_root);
+	_context.refresh();
+
+	for (auto _ : _state)
+	{
+		_root->set_margin((_root->margin() == 0_px) ? 1_px : 0_px);
+		_context.refresh();
+	};
+	_state.set_items_processed((int64_t)_state.iterations() * _state.range(0) * ITEMS_PER_ROW);
+};
+SAE_BENCHMARK(BM_UIList_Refresh_Nested)->range(4, 256);
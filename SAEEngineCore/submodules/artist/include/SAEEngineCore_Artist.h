@@ -4,19 +4,128 @@
 
 #include <SAEEngineCore_Event.h>
 
+#include <cassert>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
 #include <type_traits>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace sae::engine::core
 {
 	class GFXObject;
 
+	/**
+	 * @brief Sort key of a draw command. Commands are drawn in order of layer, then grouped by shader, vertex array and
+	 * texture so commands sharing state run back to back. Ids wider than 16 bits are truncated, which only costs grouping.
+	*/
+	struct RenderKey
+	{
+		// Z layer, lower layers are drawn first so higher ones end up in front
+		uint16_t layer = 0;
+		uint16_t shader = 0;
+		uint16_t vertex_array = 0;
+		uint16_t texture = 0;
+
+		constexpr uint64_t pack() const noexcept
+		{
+			return ((uint64_t)this->layer << 48) | ((uint64_t)this->shader << 32) | ((uint64_t)this->vertex_array << 16) |
+				(uint64_t)this->texture;
+		};
+		constexpr static RenderKey unpack(uint64_t _key) noexcept
+		{
+			return RenderKey{ (uint16_t)(_key >> 48), (uint16_t)(_key >> 32), (uint16_t)(_key >> 16), (uint16_t)_key };
+		};
+
+		constexpr bool operator==(const RenderKey&) const noexcept = default;
+	};
+
+	/**
+	 * @brief One draw recorded by an artist, handed back to the artist's execute() once the frame's commands are sorted
+	*/
+	struct RenderCommand
+	{
+		uint64_t key = 0;
+
+		// Index of the artist that recorded the command, in registration order
+		uint32_t artist = 0;
+
+		// Whatever the artist needs to find what to draw
+		uint32_t data = 0;
+	};
+	static_assert(sizeof(RenderCommand) == 16, "RenderCommand should pack into 16 bytes");
+
+	/**
+	 * @brief Per frame buffer of draw commands. Artists push commands while recording, sort() then orders them by key with a
+	 * stable radix sort so commands with equal keys keep the order they were recorded in.
+	*/
+	class RenderQueue
+	{
+	public:
+		/**
+		 * @brief Counters for the most recent sort() call
+		*/
+		struct Stats
+		{
+			size_t commands = 0;
+
+			// Shader, vertex array and texture changes between consecutive commands, each field counted separately
+			size_t state_switches = 0;
+
+			std::chrono::nanoseconds sort_time{ 0 };
+		};
+
+		/**
+		 * @brief Sets the artist index given to the commands pushed after this call
+		*/
+		void begin_artist(uint32_t _artist) noexcept;
+
+		void push(RenderKey _key, uint32_t _data = 0);
+
+		void sort();
+		void clear() noexcept;
+
+		std::span<const RenderCommand> commands() const noexcept;
+		size_t size() const noexcept;
+		bool empty() const noexcept;
+		void reserve(size_t _count);
+
+		const Stats& stats() const noexcept;
+
+	private:
+		std::vector<RenderCommand> commands_{};
+		std::vector<RenderCommand> scratch_{};
+		uint32_t artist_ = 0;
+		Stats stats_{};
+	};
+
 	class IArtist
 	{
 	public:
 		virtual bool good() = 0;
+
+		/**
+		 * @brief Sends changed art data to the GPU. GFXContext::draw() calls this on every artist before drawing any of them,
+		 * so a frame's uploads are done in one pass ahead of its draw calls.
+		*/
+		virtual void upload() {};
 		virtual void draw() = 0;
+
+		/**
+		 * @brief Adds this artist's draw commands for the frame, each is passed back to execute() once sorted. The default
+		 * adds one command with an all zero key, so artists that do not override this keep drawing in registration order
+		 * ahead of any layered commands.
+		*/
+		virtual void record(RenderQueue& _queue) { _queue.push(RenderKey{}); };
+
+		/**
+		 * @brief Draws one of the commands recorded by record(), the default draws everything
+		*/
+		virtual void execute(const RenderCommand& _cmd) { this->draw(); };
 		
 		virtual void remove(GFXObject* _obj) = 0;
 		virtual bool contains(GFXObject* _obj) const = 0;
@@ -27,6 +136,160 @@ namespace sae::engine::core
 
 	};
 
+	/**
+	 * @brief Stable handle to an entry in an ArtSlotMap. Stays valid while entries around it are added and removed, and is
+	 * never mistaken for a later entry that reuses the same slot.
+	*/
+	struct ArtHandle
+	{
+		using index_type = uint32_t;
+		constexpr static inline index_type npos = std::numeric_limits<index_type>::max();
+
+		constexpr bool good() const noexcept { return this->index != npos; };
+		constexpr explicit operator bool() const noexcept { return this->good(); };
+
+		constexpr bool operator==(const ArtHandle&) const noexcept = default;
+
+		index_type index = npos;
+		index_type generation = 0;
+	};
+
+	/**
+	 * @brief Dense storage for per art data addressed through stable handles. Values are kept contiguous so they can be
+	 * uploaded or iterated directly, erase() moves the last value into the erased position so it is O(1).
+	 *
+	 * Positions (dense indices) change when values are erased or swapped, handles do not. Artists that keep other arrays in
+	 * the same order as the values should repeat the move reported by erase() and any swap_positions() on them.
+	*/
+	template <typename T>
+	class ArtSlotMap
+	{
+	public:
+		using value_type = T;
+		using handle_type = ArtHandle;
+		using index_type = handle_type::index_type;
+		using size_type = size_t;
+
+		/**
+		 * @brief Appends a value, it is given the last dense position
+		 * @return Handle to the new value
+		*/
+		handle_type insert(value_type _value)
+		{
+			index_type _slot = this->free_head_;
+			if (_slot != handle_type::npos)
+			{
+				this->free_head_ = this->slots_[_slot].dense;
+			}
+			else
+			{
+				_slot = (index_type)this->slots_.size();
+				this->slots_.push_back(Slot{});
+			};
+
+			this->slots_[_slot].dense = (index_type)this->values_.size();
+			this->values_.push_back(std::move(_value));
+			this->owners_.push_back(_slot);
+			return handle_type{ _slot, this->slots_[_slot].generation };
+		};
+
+		/**
+		 * @brief Removes a value, the handle is no longer valid afterwards
+		 * @return Dense position the last value was moved into, npos if the erased value was the last one
+		*/
+		index_type erase(handle_type _h)
+		{
+			assert(this->contains(_h));
+			const auto _dense = this->slots_[_h.index].dense;
+			const auto _last = (index_type)(this->values_.size() - 1);
+
+			index_type _out = handle_type::npos;
+			if (_dense != _last)
+			{
+				this->values_[_dense] = std::move(this->values_[_last]);
+				this->owners_[_dense] = this->owners_[_last];
+				this->slots_[this->owners_[_dense]].dense = _dense;
+				_out = _dense;
+			};
+			this->values_.pop_back();
+			this->owners_.pop_back();
+
+			auto& _slot = this->slots_[_h.index];
+			++_slot.generation;
+			_slot.dense = this->free_head_;
+			this->free_head_ = _h.index;
+			return _out;
+		};
+
+		/**
+		 * @brief Exchanges the values at two dense positions, their handles follow them
+		*/
+		void swap_positions(index_type _a, index_type _b) noexcept
+		{
+			assert(_a < this->values_.size() && _b < this->values_.size());
+			std::swap(this->values_[_a], this->values_[_b]);
+			std::swap(this->owners_[_a], this->owners_[_b]);
+			this->slots_[this->owners_[_a]].dense = _a;
+			this->slots_[this->owners_[_b]].dense = _b;
+		};
+
+		bool contains(handle_type _h) const noexcept
+		{
+			return _h.good() && _h.index < this->slots_.size() && this->slots_[_h.index].generation == _h.generation &&
+				this->slots_[_h.index].dense < this->owners_.size() && this->owners_[this->slots_[_h.index].dense] == _h.index;
+		};
+
+		/**
+		 * @brief Returns the current dense position of a value
+		*/
+		index_type dense_index(handle_type _h) const noexcept
+		{
+			assert(this->contains(_h));
+			return this->slots_[_h.index].dense;
+		};
+
+		/**
+		 * @brief Returns the handle of the value at a dense position
+		*/
+		handle_type handle_at(index_type _dense) const noexcept
+		{
+			const auto _slot = this->owners_[_dense];
+			return handle_type{ _slot, this->slots_[_slot].generation };
+		};
+
+		value_type& operator[](handle_type _h) noexcept { return this->values_[this->dense_index(_h)]; };
+		const value_type& operator[](handle_type _h) const noexcept { return this->values_[this->dense_index(_h)]; };
+
+		std::span<value_type> values() noexcept { return this->values_; };
+		std::span<const value_type> values() const noexcept { return this->values_; };
+
+		size_type size() const noexcept { return this->values_.size(); };
+		bool empty() const noexcept { return this->values_.empty(); };
+
+		void reserve(size_type _count)
+		{
+			this->values_.reserve(_count);
+			this->owners_.reserve(_count);
+			this->slots_.reserve(_count);
+		};
+
+	private:
+		struct Slot
+		{
+			// Dense position while in use, next free slot while free
+			index_type dense = handle_type::npos;
+			index_type generation = 0;
+		};
+
+		std::vector<Slot> slots_{};
+		index_type free_head_ = handle_type::npos;
+
+		std::vector<value_type> values_{};
+
+		// Slot of the value at each dense position
+		std::vector<index_type> owners_{};
+	};
+
 	template <typename T>
 	class Artist;
 
@@ -0,0 +1,113 @@
+#include "SAEEngineCore_Artist.h"
+
+#include <algorithm>
+#include <array>
+
+namespace sae::engine::core
+{
+	void RenderQueue::begin_artist(uint32_t _artist) noexcept
+	{
+		this->artist_ = _artist;
+	};
+
+	void RenderQueue::push(RenderKey _key, uint32_t _data)
+	{
+		this->commands_.push_back(RenderCommand{ _key.pack(), this->artist_, _data });
+	};
+
+	void RenderQueue::sort()
+	{
+		const auto _start = std::chrono::steady_clock::now();
+		auto& _cmds = this->commands_;
+
+		// Below this std::stable_sort beats setting up the histograms
+		constexpr size_t RADIX_MIN_COUNT = 64;
+		if (_cmds.size() < RADIX_MIN_COUNT)
+		{
+			std::stable_sort(_cmds.begin(), _cmds.end(), [](const RenderCommand& _lhs, const RenderCommand& _rhs)
+				{
+					return _lhs.key < _rhs.key;
+				});
+		}
+		else
+		{
+			// Least significant byte first, every histogram is counted in one pass over the keys
+			std::array<std::array<uint32_t, 256>, 8> _counts{};
+			for (auto& c : _cmds)
+			{
+				for (size_t b = 0; b != 8; ++b)
+				{
+					++_counts[b][(c.key >> (b * 8)) & 0xFF];
+				};
+			};
+
+			this->scratch_.resize(_cmds.size());
+			for (size_t b = 0; b != 8; ++b)
+			{
+				// Every key has the same byte here, this pass would not move anything
+				auto& _hist = _counts[b];
+				if (_hist[(_cmds.front().key >> (b * 8)) & 0xFF] == _cmds.size())
+				{
+					continue;
+				};
+
+				uint32_t _offset = 0;
+				for (auto& h : _hist)
+				{
+					const auto _count = h;
+					h = _offset;
+					_offset += _count;
+				};
+				for (auto& c : _cmds)
+				{
+					this->scratch_[_hist[(c.key >> (b * 8)) & 0xFF]++] = c;
+				};
+				_cmds.swap(this->scratch_);
+			};
+		};
+
+		this->stats_.commands = _cmds.size();
+		this->stats_.state_switches = 0;
+		RenderKey _previous{};
+		for (size_t n = 0; n != _cmds.size(); ++n)
+		{
+			const auto _key = RenderKey::unpack(_cmds[n].key);
+			const bool _first = (n == 0);
+			this->stats_.state_switches += (size_t)(_first || _key.shader != _previous.shader);
+			this->stats_.state_switches += (size_t)(_first || _key.vertex_array != _previous.vertex_array);
+			this->stats_.state_switches += (size_t)(_first || _key.texture != _previous.texture);
+			_previous = _key;
+		};
+		this->stats_.sort_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+	};
+
+	void RenderQueue::clear() noexcept
+	{
+		this->commands_.clear();
+		this->artist_ = 0;
+	};
+
+	std::span<const RenderCommand> RenderQueue::commands() const noexcept
+	{
+		return this->commands_;
+	};
+	size_t RenderQueue::size() const noexcept
+	{
+		return this->commands_.size();
+	};
+	bool RenderQueue::empty() const noexcept
+	{
+		return this->commands_.empty();
+	};
+	void RenderQueue::reserve(size_t _count)
+	{
+		this->commands_.reserve(_count);
+		this->scratch_.reserve(_count);
+	};
+
+	const RenderQueue::Stats& RenderQueue::stats() const noexcept
+	{
+		return this->stats_;
+	};
+
+}
@@ -0,0 +1,138 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Artist.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Checks RenderQueue::sort() gives the same order as std::stable_sort on the key, on both sides of the radix cutoff, and
+	that the state switch count matches the sorted commands.
+*/
+
+static bool same_order(const RenderQueue& _queue, std::vector<RenderCommand> _expected)
+{
+	std::stable_sort(_expected.begin(), _expected.end(), [](const RenderCommand& _lhs, const RenderCommand& _rhs)
+		{
+			return _lhs.key < _rhs.key;
+		});
+	const auto _cmds = _queue.commands();
+	if (_cmds.size() != _expected.size())
+	{
+		return false;
+	};
+	for (size_t n = 0; n != _cmds.size(); ++n)
+	{
+		if (_cmds[n].key != _expected[n].key || _cmds[n].artist != _expected[n].artist || _cmds[n].data != _expected[n].data)
+		{
+			return false;
+		};
+	};
+	return true;
+};
+
+static int check_random(size_t _count, uint16_t _layers, uint16_t _shaders)
+{
+	std::mt19937 _rng{ (uint32_t)_count };
+	RenderQueue _queue{};
+	std::vector<RenderCommand> _expected{};
+
+	for (uint32_t a = 0; a != 4; ++a)
+	{
+		_queue.begin_artist(a);
+		for (size_t n = 0; n != _count / 4; ++n)
+		{
+			RenderKey _key{};
+			_key.layer = (uint16_t)(_rng() % _layers);
+			_key.shader = (uint16_t)(_rng() % _shaders);
+			_key.vertex_array = (uint16_t)(_rng() % 3);
+			_queue.push(_key, (uint32_t)n);
+			_expected.push_back(RenderCommand{ _key.pack(), a, (uint32_t)n });
+		};
+	};
+
+	_queue.sort();
+	if (!same_order(_queue, _expected))
+	{
+		std::cout << _count << " commands were not sorted stably by key\n";
+		return 1;
+	};
+	std::cout << _count << " commands sorted in " << _queue.stats().sort_time.count() << " ns, "
+		<< _queue.stats().state_switches << " state switches\n";
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	if (RenderKey::unpack(RenderKey{ 1, 2, 3, 4 }.pack()) != RenderKey{ 1, 2, 3, 4 } ||
+		RenderKey{ 1, 0, 0, 0 }.pack() <= RenderKey{ 0, 0xFFFF, 0xFFFF, 0xFFFF }.pack())
+	{
+		std::cout << "layer is not the most significant part of the key\n";
+		return 1;
+	};
+
+	for (auto _count : { 8, 48, 64, 1000, 20000 })
+	{
+		if (auto _res = check_random((size_t)_count, 4, 5); _res != GOOD_TEST)
+		{
+			return _res;
+		};
+	};
+
+	// Only the low byte varies, so most radix passes are skipped
+	if (auto _res = check_random(4096, 1, 200); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+
+	// Two shaders alternating across artists, sorting groups them
+	{
+		RenderQueue _queue{};
+		for (uint32_t a = 0; a != 100; ++a)
+		{
+			_queue.begin_artist(a);
+			_queue.push(RenderKey{ 0, (uint16_t)(1 + (a % 2)), 1, 0 });
+		};
+		_queue.sort();
+
+		// First command sets all three fields, then one shader change
+		if (_queue.stats().commands != 100 || _queue.stats().state_switches != 4)
+		{
+			std::cout << "expected 4 state switches after grouping, got " << _queue.stats().state_switches << '\n';
+			return 2;
+		};
+	};
+
+	// clear() empties the queue for the next frame
+	{
+		RenderQueue _queue{};
+		_queue.push(RenderKey{});
+		_queue.clear();
+		_queue.sort();
+		if (!_queue.empty() || _queue.stats().commands != 0)
+		{
+			std::cout << "queue was not emptied\n";
+			return 3;
+		};
+	};
+
+	return GOOD_TEST;
+};
@@ -0,0 +1,115 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Artist.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+int main(int argc, char* argv[], char* envp[])
+{
+	ArtSlotMap<int> _map{};
+
+	std::vector<ArtHandle> _handles{};
+	for (int n = 0; n != 8; ++n)
+	{
+		_handles.push_back(_map.insert(n));
+	};
+	if (_map.size() != 8 || _map.dense_index(_handles[3]) != 3)
+	{
+		std::cout << "values were not appended in order\n";
+		return 1;
+	};
+
+	// Erasing from the middle moves the last value into the hole
+	if (_map.erase(_handles[2]) != 2 || _map.values()[2] != 7 || _map.handle_at(2) != _handles[7])
+	{
+		std::cout << "erase did not move the last value into the erased position\n";
+		return 2;
+	};
+
+	// Erasing the last value moves nothing
+	const auto _lastValue = _map.values().back();
+	ArtHandle _last{};
+	for (auto& h : _handles)
+	{
+		if (_map.contains(h) && _map[h] == _lastValue)
+		{
+			_last = h;
+		};
+	};
+	if (_map.erase(_last) != ArtHandle::npos || _map.size() != 6)
+	{
+		std::cout << "erasing the last value reported a move\n";
+		return 3;
+	};
+
+	// Handles of the remaining values still reach them
+	for (int n = 0; n != 8; ++n)
+	{
+		const auto& h = _handles[n];
+		if (h == _handles[2] || h == _last)
+		{
+			if (_map.contains(h))
+			{
+				std::cout << "erased handle is still valid\n";
+				return 4;
+			};
+		}
+		else if (!_map.contains(h) || _map[h] != n)
+		{
+			std::cout << "handle " << n << " does not reach its value after erase\n";
+			return 5;
+		};
+	};
+
+	// A reused slot gets a new generation, the old handle stays invalid
+	const auto _reused = _map.insert(100);
+	if (_reused.index != _last.index && _reused.index != _handles[2].index)
+	{
+		std::cout << "freed slot was not reused\n";
+		return 6;
+	};
+	if (_reused == _last || _reused == _handles[2] || !_map.contains(_reused) || _map[_reused] != 100 ||
+		_map.contains(_last) || _map.contains(_handles[2]))
+	{
+		std::cout << "reused slot is reachable through a stale handle\n";
+		return 7;
+	};
+
+	if (_map.contains(ArtHandle{}))
+	{
+		std::cout << "empty handle reported as contained\n";
+		return 8;
+	};
+
+	// Swapping positions moves the values and keeps their handles pointing at them
+	const auto _first = _map.handle_at(0);
+	const auto _second = _map.handle_at(1);
+	const auto _firstValue = _map[_first];
+	const auto _secondValue = _map[_second];
+	_map.swap_positions(0, 1);
+	if (_map.dense_index(_first) != 1 || _map.dense_index(_second) != 0 || _map.values()[0] != _secondValue ||
+		_map[_first] != _firstValue || _map.handle_at(1) != _first)
+	{
+		std::cout << "handles did not follow their values through a swap\n";
+		return 9;
+	};
+
+	return GOOD_TEST;
+};
@@ -5,7 +5,34 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <array>
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <span>
+#include <string_view>
+
+// GL 4.4 / ARB_buffer_storage tokens, the glad loader in lib/glad stops at 4.3
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+#ifndef GL_CLIENT_STORAGE_BIT
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile tokens, the same values in both
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 namespace sae::engine::core
 {
@@ -60,6 +87,278 @@ namespace sae::engine::core
 	};
 	
 
+	namespace gl
+	{
+		/**
+		 * @brief OpenGL functions newer than the glad loader covers. Each is null if the current context does not provide it.
+		*/
+		struct Extensions
+		{
+			using buffer_storage_proc = void(APIENTRYP)(GLenum _target, GLsizeiptr _size, const void* _data, GLbitfield _flags);
+
+			using max_shader_compiler_threads_proc = void(APIENTRYP)(GLuint _count);
+
+			// glBufferStorage, core in 4.4 and otherwise from ARB_buffer_storage
+			buffer_storage_proc buffer_storage = nullptr;
+
+			// glMaxShaderCompilerThreadsKHR, or the ARB version. When set, glGetShaderiv and glGetProgramiv also answer
+			// GL_COMPLETION_STATUS_KHR without waiting on the compile or link.
+			max_shader_compiler_threads_proc max_shader_compiler_threads = nullptr;
+		};
+
+		/**
+		 * @brief Loads the functions in Extensions for the current context through glfwGetProcAddress. Called by Window when
+		 * it loads glad, call it again after making a different context current.
+		*/
+		void load_extensions();
+
+		const Extensions& extensions() noexcept;
+
+		/**
+		 * @brief Remembers the buffer, vertex array and program bindings of a GL context so binding what is already bound
+		 * can be skipped. The wrappers in the gl_object and shader submodules bind through the cache of the current
+		 * context, each Window owns the cache for its context.
+		 *
+		 * GL calls made around the cache leave it out of date, call invalidate() after them.
+		*/
+		class StateCache
+		{
+		public:
+			/**
+			 * @brief State changes asked for since construction or the last reset_counters() call
+			*/
+			struct Counters
+			{
+				// Changes passed on to GL
+				size_t issued = 0;
+
+				// Changes skipped because the state was already set
+				size_t elided = 0;
+			};
+
+			void bind_buffer(GLenum _target, GLuint _buffer);
+			void bind_buffer_base(GLenum _target, GLuint _index, GLuint _buffer);
+			void bind_vertex_array(GLuint _array);
+			void use_program(GLuint _program);
+
+			/**
+			 * @brief Delete the objects and clear any binding of them, as GL does
+			*/
+			void delete_buffers(GLsizei _count, const GLuint* _buffers);
+			void delete_vertex_arrays(GLsizei _count, const GLuint* _arrays);
+			void delete_program(GLuint _program);
+
+			/**
+			 * @brief Forgets every remembered binding, the next bind of each kind is always passed on
+			*/
+			void invalidate() noexcept;
+
+			const Counters& counters() const noexcept;
+			void reset_counters() noexcept;
+
+			/**
+			 * @brief Cache for the context current on this thread. Falls back to a per thread cache when no Window has made
+			 * its context current.
+			*/
+			static StateCache& current() noexcept;
+
+			/**
+			 * @brief Sets the cache returned by current() on this thread, nullptr restores the per thread fallback
+			*/
+			static void make_current(StateCache* _cache) noexcept;
+
+			StateCache() noexcept;
+
+		private:
+			// Binding stands for unknown state, any bind is passed on
+			constexpr static inline GLuint UNKNOWN = std::numeric_limits<GLuint>::max();
+
+			// Buffer targets with a cached binding, any other target is always passed on
+			constexpr static inline std::array<GLenum, 6> BUFFER_TARGETS
+			{
+				GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_UNIFORM_BUFFER,
+				GL_SHADER_STORAGE_BUFFER
+			};
+			constexpr static inline size_t ELEMENT_ARRAY_SLOT = 1;
+
+			static size_t buffer_slot(GLenum _target) noexcept;
+
+			std::array<GLuint, BUFFER_TARGETS.size()> buffers_{};
+			GLuint vertex_array_ = UNKNOWN;
+			GLuint program_ = UNKNOWN;
+
+			Counters counters_{};
+		};
+
+		/**
+		 * @brief Replaces the loaded OpenGL functions with stubs that count each call and keep buffer contents in memory, so
+		 * code that makes GL calls can be run and timed without a display or GPU. Object names are handed out from counters,
+		 * every compile and link succeeds and no pixels are drawn.
+		 *
+		 * Only the functions listed in CALL are replaced, any other GL function is left null.
+		 *
+		 * Linking reads the "uniform" declarations out of the attached sources, so programs report active uniforms and
+		 * std140 uniform blocks much like a driver would. Only plain declarations of float, int, bool, vec2-4, mat4 and
+		 * sampler2D are understood.
+		*/
+		class RecordingBackend
+		{
+		public:
+			enum CALL : uint8_t
+			{
+				GEN_BUFFERS,
+				DELETE_BUFFERS,
+				BIND_BUFFER,
+				BIND_BUFFER_BASE,
+				BUFFER_DATA,
+				BUFFER_SUB_DATA,
+				COPY_BUFFER_SUB_DATA,
+				MAP_BUFFER_RANGE,
+				FLUSH_MAPPED_BUFFER_RANGE,
+				UNMAP_BUFFER,
+				BUFFER_STORAGE,
+
+				GEN_VERTEX_ARRAYS,
+				DELETE_VERTEX_ARRAYS,
+				BIND_VERTEX_ARRAY,
+				ENABLE_VERTEX_ATTRIB_ARRAY,
+				VERTEX_ATTRIB_POINTER,
+				VERTEX_ATTRIB_I_POINTER,
+				VERTEX_ATTRIB_DIVISOR,
+
+				DRAW_ARRAYS,
+				DRAW_ARRAYS_INSTANCED,
+				DRAW_ARRAYS_INSTANCED_BASE_INSTANCE,
+				DRAW_ELEMENTS,
+				DRAW_ELEMENTS_INSTANCED,
+
+				CREATE_SHADER,
+				DELETE_SHADER,
+				SHADER_SOURCE,
+				COMPILE_SHADER,
+				GET_SHADER_IV,
+				GET_SHADER_INFO_LOG,
+				CREATE_PROGRAM,
+				DELETE_PROGRAM,
+				ATTACH_SHADER,
+				DETACH_SHADER,
+				LINK_PROGRAM,
+				GET_PROGRAM_IV,
+				GET_PROGRAM_INFO_LOG,
+				USE_PROGRAM,
+				PROGRAM_PARAMETER_I,
+				GET_PROGRAM_BINARY,
+				PROGRAM_BINARY,
+				MAX_SHADER_COMPILER_THREADS,
+
+				GET_UNIFORM_LOCATION,
+				UNIFORM_1I,
+				UNIFORM_1F,
+				UNIFORM_2F,
+				UNIFORM_4F,
+				UNIFORM_MATRIX_4FV,
+				GET_ACTIVE_UNIFORM,
+				GET_ACTIVE_UNIFORM_BLOCK_IV,
+				GET_ACTIVE_UNIFORM_BLOCK_NAME,
+				UNIFORM_BLOCK_BINDING,
+
+				ACTIVE_TEXTURE,
+				BIND_TEXTURE,
+
+				FENCE_SYNC,
+				CLIENT_WAIT_SYNC,
+				DELETE_SYNC,
+
+				ENABLE,
+				DISABLE,
+				BLEND_FUNC,
+
+				CLEAR,
+				VIEWPORT,
+				GET_STRING,
+				GET_INTEGER_V,
+				GET_ERROR,
+
+				CALL_COUNT
+			};
+
+			/**
+			 * @brief Totals since install() or the last reset_counters() call
+			*/
+			struct Counters
+			{
+				std::array<size_t, CALL_COUNT> calls{};
+
+				// Bytes given to glBufferData, glBufferStorage and glBufferSubData
+				size_t bytes_uploaded = 0;
+
+				// Bytes moved by glCopyBufferSubData
+				size_t bytes_copied = 0;
+
+				// Bytes made writable by glMapBufferRange
+				size_t bytes_mapped = 0;
+
+				// Draw calls of any kind, and the vertices and instances they asked for
+				size_t draw_calls = 0;
+				size_t vertices_drawn = 0;
+				size_t instances_drawn = 0;
+
+				size_t count(CALL _call) const noexcept { return this->calls[_call]; };
+				size_t total_calls() const noexcept;
+			};
+
+			/**
+			 * @brief Points the GL function pointers, including those in Extensions, at the recording stubs and resets all
+			 * state. Safe to call more than once.
+			*/
+			static void install();
+			static bool installed() noexcept;
+
+			static const Counters& counters() noexcept;
+			static void reset_counters() noexcept;
+
+			static std::string_view call_name(CALL _call) noexcept;
+
+			/**
+			 * @brief Contents of a buffer object as last written, empty if the name is not a live buffer
+			*/
+			static std::span<const std::byte> buffer_data(GLuint _buffer);
+
+			/**
+			 * @brief Usage hint last given to glBufferData for a buffer, GL_NONE if it was never given one
+			*/
+			static GLenum buffer_usage(GLuint _buffer);
+
+			/**
+			 * @brief Number of live buffer objects
+			*/
+			static size_t buffer_count() noexcept;
+
+			/**
+			 * @brief The only program binary format the backend reports. glGetProgramBinary hands out binaries tagged
+			 * with the GL_VERSION string at the time, and glProgramBinary fails to link any binary that is not in this
+			 * format or was produced under a different version string.
+			*/
+			constexpr static GLenum PROGRAM_BINARY_FORMAT = 0x5AE0;
+
+			/**
+			 * @brief Changes the string returned for GL_VERSION, as if the driver had been updated. Reset by install().
+			*/
+			static void set_driver_version(std::string_view _version);
+
+			/**
+			 * @brief Number of times GL_COMPLETION_STATUS_KHR reads GL_FALSE for each shader and program before it reads
+			 * GL_TRUE, as if the compile or link were still running. 0 after install().
+			*/
+			static void set_completion_latency(size_t _polls);
+
+			/**
+			 * @brief Clears the functions in Extensions, as if the driver offered none of them. Undone by install().
+			*/
+			static void clear_extensions();
+		};
+	};
+
 	/**
 	 * @brief Wraps a GLFWwindow and owns its memory. Destroys window on destructor
 	*/
@@ -100,6 +399,11 @@ namespace sae::engine::core
 
 		void destroy();
 
+		/**
+		 * @brief Binding cache for this window's GL context, made current along with the context
+		*/
+		gl::StateCache& gl_state() noexcept { return *this->gl_state_; };
+
 		/**
 		 * @brief Creates a new window
 		 * @param _ptr GLFWwindow pointer
@@ -116,6 +420,7 @@ namespace sae::engine::core
 
 	private:
 		pointer ptr_ = nullptr;
+		std::unique_ptr<gl::StateCache> gl_state_ = std::make_unique<gl::StateCache>();
 
 	};
 
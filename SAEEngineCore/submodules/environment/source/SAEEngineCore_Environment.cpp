@@ -1,7 +1,14 @@
 #include "SAEEngineCore_Environment.h"
 
+#include <algorithm>
 #include <functional>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace sae::engine::core
 {
@@ -95,6 +102,10 @@ namespace sae::engine::core
 	{
 		if (this->good())
 		{
+			if (this->gl_state_ && &gl::StateCache::current() == this->gl_state_.get())
+			{
+				gl::StateCache::make_current(nullptr);
+			};
 			glfwDestroyWindow(this->ptr_);
 			this->ptr_ = nullptr;
 		};
@@ -110,6 +121,7 @@ namespace sae::engine::core
 		if (!this->is_current())
 		{
 			glfwMakeContextCurrent(this->get());
+			gl::StateCache::make_current(this->gl_state_.get());
 		};
 	};
 
@@ -125,16 +137,20 @@ namespace sae::engine::core
 		{
 			glfwMakeContextCurrent(this->get());
 			gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+			gl::load_extensions();
+			gl::StateCache::make_current(this->gl_state_.get());
 		};
 	};
 
 	Window::Window(Window&& other) noexcept :
-		ptr_{ std::exchange(other.ptr_, nullptr) }
+		ptr_{ std::exchange(other.ptr_, nullptr) },
+		gl_state_{ std::exchange(other.gl_state_, std::make_unique<gl::StateCache>()) }
 	{};
 	Window& Window::operator=(Window&& other) noexcept
 	{
 		this->destroy();
 		this->ptr_ = std::exchange(other.ptr_, nullptr);
+		this->gl_state_ = std::exchange(other.gl_state_, std::make_unique<gl::StateCache>());
 		return *this;
 	};
 
@@ -160,4 +176,1165 @@ namespace sae::engine::core
 		return *this;
 	};
 
-};
\ No newline at end of file
+};
+
+namespace sae::engine::core::gl
+{
+	namespace
+	{
+		Extensions& extensions_storage() noexcept
+		{
+			static Extensions _ext{};
+			return _ext;
+		};
+
+		bool has_version(int _major, int _minor) noexcept
+		{
+			return GLVersion.major > _major || (GLVersion.major == _major && GLVersion.minor >= _minor);
+		};
+	}
+
+	void load_extensions()
+	{
+		auto& _ext = extensions_storage();
+		_ext = Extensions{};
+
+		if (has_version(4, 4) || glfwExtensionSupported("GL_ARB_buffer_storage"))
+		{
+			_ext.buffer_storage = (Extensions::buffer_storage_proc)glfwGetProcAddress("glBufferStorage");
+		};
+		if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+		{
+			_ext.max_shader_compiler_threads =
+				(Extensions::max_shader_compiler_threads_proc)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+		}
+		else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+		{
+			_ext.max_shader_compiler_threads =
+				(Extensions::max_shader_compiler_threads_proc)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+		};
+	};
+
+	const Extensions& extensions() noexcept
+	{
+		return extensions_storage();
+	};
+
+}
+
+namespace sae::engine::core::gl
+{
+	namespace
+	{
+		thread_local StateCache* current_state_cache = nullptr;
+	}
+
+	size_t StateCache::buffer_slot(GLenum _target) noexcept
+	{
+		for (size_t n = 0; n != BUFFER_TARGETS.size(); ++n)
+		{
+			if (BUFFER_TARGETS[n] == _target)
+			{
+				return n;
+			};
+		};
+		return BUFFER_TARGETS.size();
+	};
+
+	void StateCache::bind_buffer(GLenum _target, GLuint _buffer)
+	{
+		const auto _slot = buffer_slot(_target);
+		if (_slot != BUFFER_TARGETS.size())
+		{
+			if (this->buffers_[_slot] == _buffer)
+			{
+				++this->counters_.elided;
+				return;
+			};
+			this->buffers_[_slot] = _buffer;
+		};
+		++this->counters_.issued;
+		glBindBuffer(_target, _buffer);
+	};
+	void StateCache::bind_buffer_base(GLenum _target, GLuint _index, GLuint _buffer)
+	{
+		// Indexed binds always go through, they also set the generic binding
+		if (const auto _slot = buffer_slot(_target); _slot != BUFFER_TARGETS.size())
+		{
+			this->buffers_[_slot] = _buffer;
+		};
+		++this->counters_.issued;
+		glBindBufferBase(_target, _index, _buffer);
+	};
+	void StateCache::bind_vertex_array(GLuint _array)
+	{
+		if (this->vertex_array_ == _array)
+		{
+			++this->counters_.elided;
+			return;
+		};
+		this->vertex_array_ = _array;
+
+		// The element array binding belongs to the vertex array
+		this->buffers_[ELEMENT_ARRAY_SLOT] = UNKNOWN;
+
+		++this->counters_.issued;
+		glBindVertexArray(_array);
+	};
+	void StateCache::use_program(GLuint _program)
+	{
+		if (this->program_ == _program)
+		{
+			++this->counters_.elided;
+			return;
+		};
+		this->program_ = _program;
+		++this->counters_.issued;
+		glUseProgram(_program);
+	};
+
+	void StateCache::delete_buffers(GLsizei _count, const GLuint* _buffers)
+	{
+		for (GLsizei i = 0; i != _count; ++i)
+		{
+			if (_buffers[i] == 0)
+			{
+				continue;
+			};
+			for (size_t n = 0; n != this->buffers_.size(); ++n)
+			{
+				if (this->buffers_[n] == _buffers[i])
+				{
+					this->buffers_[n] = (n == ELEMENT_ARRAY_SLOT) ? UNKNOWN : 0;
+				};
+			};
+		};
+		glDeleteBuffers(_count, _buffers);
+	};
+	void StateCache::delete_vertex_arrays(GLsizei _count, const GLuint* _arrays)
+	{
+		for (GLsizei i = 0; i != _count; ++i)
+		{
+			if (_arrays[i] != 0 && this->vertex_array_ == _arrays[i])
+			{
+				this->vertex_array_ = 0;
+				this->buffers_[ELEMENT_ARRAY_SLOT] = UNKNOWN;
+			};
+		};
+		glDeleteVertexArrays(_count, _arrays);
+	};
+	void StateCache::delete_program(GLuint _program)
+	{
+		// A program in use is only flagged for deletion, it stays the current program
+		glDeleteProgram(_program);
+	};
+
+	void StateCache::invalidate() noexcept
+	{
+		this->buffers_.fill(UNKNOWN);
+		this->vertex_array_ = UNKNOWN;
+		this->program_ = UNKNOWN;
+	};
+
+	const StateCache::Counters& StateCache::counters() const noexcept
+	{
+		return this->counters_;
+	};
+	void StateCache::reset_counters() noexcept
+	{
+		this->counters_ = Counters{};
+	};
+
+	StateCache& StateCache::current() noexcept
+	{
+		if (current_state_cache)
+		{
+			return *current_state_cache;
+		};
+		thread_local StateCache _fallback{};
+		return _fallback;
+	};
+	void StateCache::make_current(StateCache* _cache) noexcept
+	{
+		current_state_cache = _cache;
+	};
+
+	StateCache::StateCache() noexcept
+	{
+		this->invalidate();
+	};
+
+}
+
+namespace sae::engine::core::gl
+{
+	namespace
+	{
+		using CALL = RecordingBackend::CALL;
+
+		struct ActiveUniform
+		{
+			std::string name;
+			GLenum type = GL_FLOAT;
+			GLint size = 1;
+
+			// -1 for members of uniform blocks
+			GLint location = -1;
+		};
+		struct ActiveUniformBlock
+		{
+			std::string name;
+			GLint data_size = 0;
+			GLuint binding = 0;
+		};
+
+		/**
+		 * @brief Uniforms and uniform blocks a linked program reports
+		*/
+		struct ProgramInterface
+		{
+			std::vector<ActiveUniform> uniforms{};
+			std::vector<ActiveUniformBlock> blocks{};
+		};
+
+		// Type enum, std140 size and std140 alignment of a GLSL type name
+		struct GLSLType
+		{
+			GLenum type;
+			GLint size;
+			GLint align;
+		};
+		GLSLType glsl_type(std::string_view _name)
+		{
+			if (_name == "int") { return { GL_INT, 4, 4 }; };
+			if (_name == "bool") { return { GL_BOOL, 4, 4 }; };
+			if (_name == "vec2") { return { GL_FLOAT_VEC2, 8, 8 }; };
+			if (_name == "vec3") { return { GL_FLOAT_VEC3, 12, 16 }; };
+			if (_name == "vec4") { return { GL_FLOAT_VEC4, 16, 16 }; };
+			if (_name == "mat4") { return { GL_FLOAT_MAT4, 64, 16 }; };
+			if (_name == "sampler2D") { return { GL_SAMPLER_2D, 4, 4 }; };
+			return { GL_FLOAT, 4, 4 };
+		};
+
+		// Splits GLSL source into identifiers, numbers and single punctuation characters, dropping comments
+		std::vector<std::string_view> glsl_tokens(std::string_view _source)
+		{
+			std::vector<std::string_view> _out{};
+			size_t n = 0;
+			while (n < _source.size())
+			{
+				const char c = _source[n];
+				if (_source.substr(n, 2) == "//")
+				{
+					n = _source.find('\n', n);
+					n = (n == std::string_view::npos) ? _source.size() : n;
+				}
+				else if (_source.substr(n, 2) == "/*")
+				{
+					n = _source.find("*/", n + 2);
+					n = (n == std::string_view::npos) ? _source.size() : n + 2;
+				}
+				else if (std::isalnum((unsigned char)c) || c == '_')
+				{
+					const auto _start = n;
+					while (n < _source.size() && (std::isalnum((unsigned char)_source[n]) || _source[n] == '_'))
+					{
+						++n;
+					};
+					_out.push_back(_source.substr(_start, n - _start));
+				}
+				else
+				{
+					if (!std::isspace((unsigned char)c))
+					{
+						_out.push_back(_source.substr(n, 1));
+					};
+					++n;
+				};
+			};
+			return _out;
+		};
+
+		void add_uniform(ProgramInterface& _interface, ActiveUniform _uniform)
+		{
+			for (auto& u : _interface.uniforms)
+			{
+				if (u.name == _uniform.name)
+				{
+					return;
+				};
+			};
+			_interface.uniforms.push_back(std::move(_uniform));
+		};
+
+		// Reads "uniform <type> <name>[<n>];" and "uniform <Block> { <type> <name>; ... } <instance>;" declarations
+		void read_uniforms(ProgramInterface& _interface, std::string_view _source)
+		{
+			const auto _tokens = glsl_tokens(_source);
+			auto _at = [&_tokens](size_t i) { return (i < _tokens.size()) ? _tokens[i] : std::string_view{}; };
+
+			for (size_t i = 0; i < _tokens.size(); ++i)
+			{
+				if (_tokens[i] != "uniform")
+				{
+					continue;
+				};
+
+				if (_at(i + 2) == "{")
+				{
+					ActiveUniformBlock _block{ std::string{ _at(i + 1) } };
+					std::vector<ActiveUniform> _members{};
+					size_t j = i + 3;
+					while (j < _tokens.size() && _tokens[j] != "}")
+					{
+						const auto _type = glsl_type(_at(j));
+						ActiveUniform _member{ std::string{ _at(j + 1) }, _type.type };
+						j += 2;
+						if (_at(j) == "[")
+						{
+							_member.size = std::atoi(std::string{ _at(j + 1) }.c_str());
+							j += 3;
+						};
+						const auto _align = (_member.size > 1) ? 16 : _type.align;
+						const auto _stride = (_member.size > 1) ? ((_type.size + 15) / 16) * 16 : _type.size;
+						_block.data_size = ((_block.data_size + _align - 1) / _align) * _align + _stride * _member.size;
+						_members.push_back(std::move(_member));
+						++j;
+					};
+					_block.data_size = ((_block.data_size + 15) / 16) * 16;
+
+					// Members of a block with an instance name are known as Block.member
+					const bool _named = _at(j + 1) != ";";
+					for (auto& m : _members)
+					{
+						if (_named)
+						{
+							m.name = _block.name + "." + m.name;
+						};
+						add_uniform(_interface, std::move(m));
+					};
+
+					bool _known = false;
+					for (auto& b : _interface.blocks)
+					{
+						_known = _known || b.name == _block.name;
+					};
+					if (!_known)
+					{
+						_interface.blocks.push_back(std::move(_block));
+					};
+					i = j;
+				}
+				else
+				{
+					ActiveUniform _uniform{ std::string{ _at(i + 2) }, glsl_type(_at(i + 1)).type };
+					if (_at(i + 3) == "[")
+					{
+						_uniform.size = std::atoi(std::string{ _at(i + 4) }.c_str());
+					};
+					_uniform.location = 0;
+					add_uniform(_interface, std::move(_uniform));
+					i += 2;
+				};
+			};
+		};
+
+		struct RecordingState
+		{
+			RecordingBackend::Counters counters{};
+			std::unordered_map<GLuint, std::vector<std::byte>> buffers{};
+			std::unordered_map<GLenum, GLuint> bound_buffers{};
+
+			// Usage hint each buffer was last given by glBufferData
+			std::unordered_map<GLuint, GLenum> buffer_usages{};
+
+			GLuint next_buffer = 1;
+			GLuint next_vertex_array = 1;
+			GLuint next_shader = 1;
+			GLuint next_program = 1;
+			uintptr_t next_sync = 1;
+
+			// Link status of each program, programs not in here report success
+			std::unordered_map<GLuint, bool> program_linked{};
+
+			std::unordered_map<GLuint, std::string> shader_sources{};
+			std::unordered_map<GLuint, std::vector<GLuint>> attached_shaders{};
+			std::unordered_map<GLuint, ProgramInterface> program_interfaces{};
+
+			std::string driver_version = "4.3.0 Recording";
+
+			// GL_COMPLETION_STATUS_KHR reads left before each shader and program reports complete
+			size_t completion_latency = 0;
+			std::unordered_map<GLuint, size_t> shader_polls{};
+			std::unordered_map<GLuint, size_t> program_polls{};
+
+			bool installed = false;
+		};
+
+		RecordingState& recording_state()
+		{
+			static RecordingState _state{};
+			return _state;
+		};
+
+		void record(CALL _call) noexcept
+		{
+			++recording_state().counters.calls[_call];
+		};
+
+		// Storage of the buffer bound to _target, nullptr if nothing is bound
+		std::vector<std::byte>* bound_buffer(GLenum _target)
+		{
+			auto& _state = recording_state();
+			auto _binding = _state.bound_buffers.find(_target);
+			if (_binding == _state.bound_buffers.end() || _binding->second == 0)
+			{
+				return nullptr;
+			};
+			auto _buffer = _state.buffers.find(_binding->second);
+			return (_buffer != _state.buffers.end()) ? &_buffer->second : nullptr;
+		};
+
+		void APIENTRY rec_gen_buffers(GLsizei n, GLuint* buffers)
+		{
+			record(CALL::GEN_BUFFERS);
+			auto& _state = recording_state();
+			for (GLsizei i = 0; i != n; ++i)
+			{
+				buffers[i] = _state.next_buffer++;
+				_state.buffers.insert({ buffers[i], {} });
+			};
+		};
+		void APIENTRY rec_delete_buffers(GLsizei n, const GLuint* buffers)
+		{
+			record(CALL::DELETE_BUFFERS);
+			auto& _state = recording_state();
+			for (GLsizei i = 0; i != n; ++i)
+			{
+				_state.buffers.erase(buffers[i]);
+				_state.buffer_usages.erase(buffers[i]);
+				for (auto& b : _state.bound_buffers)
+				{
+					if (b.second == buffers[i])
+					{
+						b.second = 0;
+					};
+				};
+			};
+		};
+		void APIENTRY rec_bind_buffer(GLenum target, GLuint buffer)
+		{
+			record(CALL::BIND_BUFFER);
+			recording_state().bound_buffers.insert_or_assign(target, buffer);
+		};
+		void APIENTRY rec_bind_buffer_base(GLenum target, GLuint index, GLuint buffer)
+		{
+			record(CALL::BIND_BUFFER_BASE);
+			recording_state().bound_buffers.insert_or_assign(target, buffer);
+		};
+		void APIENTRY rec_buffer_data(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+		{
+			record(CALL::BUFFER_DATA);
+			if (auto _buffer = bound_buffer(target); _buffer)
+			{
+				auto& _state = recording_state();
+				_state.buffer_usages.insert_or_assign(_state.bound_buffers.at(target), usage);
+				_buffer->assign((size_t)size, std::byte{ 0 });
+				if (data)
+				{
+					std::memcpy(_buffer->data(), data, (size_t)size);
+					recording_state().counters.bytes_uploaded += (size_t)size;
+				};
+			};
+		};
+		void APIENTRY rec_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+		{
+			record(CALL::BUFFER_SUB_DATA);
+			if (auto _buffer = bound_buffer(target); _buffer && (size_t)(offset + size) <= _buffer->size())
+			{
+				std::memcpy(_buffer->data() + offset, data, (size_t)size);
+				recording_state().counters.bytes_uploaded += (size_t)size;
+			};
+		};
+		void APIENTRY rec_copy_buffer_sub_data(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size)
+		{
+			record(CALL::COPY_BUFFER_SUB_DATA);
+			auto _read = bound_buffer(readTarget);
+			auto _write = bound_buffer(writeTarget);
+			if (_read && _write && (size_t)(readOffset + size) <= _read->size() && (size_t)(writeOffset + size) <= _write->size())
+			{
+				std::memmove(_write->data() + writeOffset, _read->data() + readOffset, (size_t)size);
+				recording_state().counters.bytes_copied += (size_t)size;
+			};
+		};
+		void* APIENTRY rec_map_buffer_range(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+		{
+			record(CALL::MAP_BUFFER_RANGE);
+			if (auto _buffer = bound_buffer(target); _buffer && (size_t)(offset + length) <= _buffer->size())
+			{
+				recording_state().counters.bytes_mapped += (size_t)length;
+				return _buffer->data() + offset;
+			};
+			return nullptr;
+		};
+		void APIENTRY rec_flush_mapped_buffer_range(GLenum target, GLintptr offset, GLsizeiptr length)
+		{
+			record(CALL::FLUSH_MAPPED_BUFFER_RANGE);
+		};
+		GLboolean APIENTRY rec_unmap_buffer(GLenum target)
+		{
+			record(CALL::UNMAP_BUFFER);
+			return GL_TRUE;
+		};
+		void APIENTRY rec_buffer_storage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+		{
+			record(CALL::BUFFER_STORAGE);
+			if (auto _buffer = bound_buffer(target); _buffer)
+			{
+				_buffer->assign((size_t)size, std::byte{ 0 });
+				if (data)
+				{
+					std::memcpy(_buffer->data(), data, (size_t)size);
+					recording_state().counters.bytes_uploaded += (size_t)size;
+				};
+			};
+		};
+
+		void APIENTRY rec_gen_vertex_arrays(GLsizei n, GLuint* arrays)
+		{
+			record(CALL::GEN_VERTEX_ARRAYS);
+			for (GLsizei i = 0; i != n; ++i)
+			{
+				arrays[i] = recording_state().next_vertex_array++;
+			};
+		};
+		void APIENTRY rec_delete_vertex_arrays(GLsizei n, const GLuint* arrays)
+		{
+			record(CALL::DELETE_VERTEX_ARRAYS);
+		};
+		void APIENTRY rec_bind_vertex_array(GLuint array)
+		{
+			record(CALL::BIND_VERTEX_ARRAY);
+		};
+		void APIENTRY rec_enable_vertex_attrib_array(GLuint index)
+		{
+			record(CALL::ENABLE_VERTEX_ATTRIB_ARRAY);
+		};
+		void APIENTRY rec_vertex_attrib_pointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+		{
+			record(CALL::VERTEX_ATTRIB_POINTER);
+		};
+		void APIENTRY rec_vertex_attrib_i_pointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer)
+		{
+			record(CALL::VERTEX_ATTRIB_I_POINTER);
+		};
+		void APIENTRY rec_vertex_attrib_divisor(GLuint index, GLuint divisor)
+		{
+			record(CALL::VERTEX_ATTRIB_DIVISOR);
+		};
+
+		void record_draw(CALL _call, GLsizei _vertices, GLsizei _instances) noexcept
+		{
+			record(_call);
+			auto& _counters = recording_state().counters;
+			++_counters.draw_calls;
+			_counters.vertices_drawn += (size_t)_vertices * (size_t)_instances;
+			_counters.instances_drawn += (size_t)_instances;
+		};
+		void APIENTRY rec_draw_arrays(GLenum mode, GLint first, GLsizei count)
+		{
+			record_draw(CALL::DRAW_ARRAYS, count, 1);
+		};
+		void APIENTRY rec_draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+		{
+			record_draw(CALL::DRAW_ARRAYS_INSTANCED, count, instancecount);
+		};
+		void APIENTRY rec_draw_arrays_instanced_base_instance(GLenum mode, GLint first, GLsizei count, GLsizei instancecount, GLuint baseinstance)
+		{
+			record_draw(CALL::DRAW_ARRAYS_INSTANCED_BASE_INSTANCE, count, instancecount);
+		};
+		void APIENTRY rec_draw_elements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+		{
+			record_draw(CALL::DRAW_ELEMENTS, count, 1);
+		};
+		void APIENTRY rec_draw_elements_instanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount)
+		{
+			record_draw(CALL::DRAW_ELEMENTS_INSTANCED, count, instancecount);
+		};
+
+		GLuint APIENTRY rec_create_shader(GLenum type)
+		{
+			record(CALL::CREATE_SHADER);
+			return recording_state().next_shader++;
+		};
+		void APIENTRY rec_delete_shader(GLuint shader)
+		{
+			record(CALL::DELETE_SHADER);
+			recording_state().shader_sources.erase(shader);
+		};
+		void APIENTRY rec_shader_source(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+		{
+			record(CALL::SHADER_SOURCE);
+			auto& _source = recording_state().shader_sources[shader];
+			_source.clear();
+			for (GLsizei i = 0; i != count; ++i)
+			{
+				if (length && length[i] >= 0)
+				{
+					_source.append(string[i], (size_t)length[i]);
+				}
+				else
+				{
+					_source.append(string[i]);
+				};
+			};
+		};
+		void APIENTRY rec_compile_shader(GLuint shader)
+		{
+			record(CALL::COMPILE_SHADER);
+		};
+
+		// Every compile and link succeeds with an empty log
+		void write_status(GLenum pname, GLint* params)
+		{
+			switch (pname)
+			{
+			case GL_COMPILE_STATUS:
+			case GL_LINK_STATUS:
+			case GL_VALIDATE_STATUS:
+				*params = GL_TRUE;
+				break;
+			default:
+				*params = 0;
+				break;
+			};
+		};
+		void write_log(GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+		{
+			if (length)
+			{
+				*length = 0;
+			};
+			if (infoLog && bufSize > 0)
+			{
+				infoLog[0] = '\0';
+			};
+		};
+
+		// Counts a GL_COMPLETION_STATUS_KHR read of an object, complete once the latency has been used up
+		GLint completion_status(std::unordered_map<GLuint, size_t>& _polls, GLuint _id)
+		{
+			auto& _count = _polls[_id];
+			return (_count++ >= recording_state().completion_latency) ? GL_TRUE : GL_FALSE;
+		};
+
+		void APIENTRY rec_get_shader_iv(GLuint shader, GLenum pname, GLint* params)
+		{
+			record(CALL::GET_SHADER_IV);
+			if (pname == GL_COMPLETION_STATUS_KHR)
+			{
+				*params = completion_status(recording_state().shader_polls, shader);
+				return;
+			};
+			write_status(pname, params);
+		};
+		void APIENTRY rec_get_shader_info_log(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+		{
+			record(CALL::GET_SHADER_INFO_LOG);
+			write_log(bufSize, length, infoLog);
+		};
+		GLuint APIENTRY rec_create_program()
+		{
+			record(CALL::CREATE_PROGRAM);
+			return recording_state().next_program++;
+		};
+		void APIENTRY rec_delete_program(GLuint program)
+		{
+			record(CALL::DELETE_PROGRAM);
+			auto& _state = recording_state();
+			_state.attached_shaders.erase(program);
+			_state.program_interfaces.erase(program);
+		};
+		void APIENTRY rec_attach_shader(GLuint program, GLuint shader)
+		{
+			record(CALL::ATTACH_SHADER);
+			recording_state().attached_shaders[program].push_back(shader);
+		};
+		void APIENTRY rec_detach_shader(GLuint program, GLuint shader)
+		{
+			record(CALL::DETACH_SHADER);
+			std::erase(recording_state().attached_shaders[program], shader);
+		};
+		void APIENTRY rec_link_program(GLuint program)
+		{
+			record(CALL::LINK_PROGRAM);
+			auto& _state = recording_state();
+			_state.program_linked[program] = true;
+
+			ProgramInterface _interface{};
+			for (auto& _shader : _state.attached_shaders[program])
+			{
+				read_uniforms(_interface, _state.shader_sources[_shader]);
+			};
+			GLint _location = 0;
+			for (auto& u : _interface.uniforms)
+			{
+				if (u.location != -1)
+				{
+					u.location = _location;
+					_location += u.size;
+				};
+			};
+			_state.program_interfaces[program] = std::move(_interface);
+		};
+
+		// Program binaries are a fixed tag followed by the GL_VERSION string they were made under
+		constexpr std::string_view PROGRAM_BINARY_TAG{ "SAEPROG:" };
+		std::string program_binary()
+		{
+			return std::string{ PROGRAM_BINARY_TAG } + recording_state().driver_version;
+		};
+
+		void APIENTRY rec_get_program_iv(GLuint program, GLenum pname, GLint* params)
+		{
+			record(CALL::GET_PROGRAM_IV);
+			switch (pname)
+			{
+			case GL_LINK_STATUS:
+			{
+				auto& _linked = recording_state().program_linked;
+				auto _it = _linked.find(program);
+				*params = (_it == _linked.end() || _it->second) ? GL_TRUE : GL_FALSE;
+				break;
+			}
+			case GL_PROGRAM_BINARY_LENGTH:
+				*params = (GLint)program_binary().size();
+				break;
+			case GL_COMPLETION_STATUS_KHR:
+				*params = completion_status(recording_state().program_polls, program);
+				break;
+			case GL_ACTIVE_UNIFORMS:
+				*params = (GLint)recording_state().program_interfaces[program].uniforms.size();
+				break;
+			case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+				*params = 0;
+				for (auto& u : recording_state().program_interfaces[program].uniforms)
+				{
+					*params = std::max(*params, (GLint)u.name.size() + 1);
+				};
+				break;
+			case GL_ACTIVE_UNIFORM_BLOCKS:
+				*params = (GLint)recording_state().program_interfaces[program].blocks.size();
+				break;
+			case GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH:
+				*params = 0;
+				for (auto& b : recording_state().program_interfaces[program].blocks)
+				{
+					*params = std::max(*params, (GLint)b.name.size() + 1);
+				};
+				break;
+			default:
+				write_status(pname, params);
+				break;
+			};
+		};
+		void APIENTRY rec_get_program_info_log(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+		{
+			record(CALL::GET_PROGRAM_INFO_LOG);
+			write_log(bufSize, length, infoLog);
+		};
+		void APIENTRY rec_use_program(GLuint program)
+		{
+			record(CALL::USE_PROGRAM);
+		};
+		void APIENTRY rec_max_shader_compiler_threads(GLuint count)
+		{
+			record(CALL::MAX_SHADER_COMPILER_THREADS);
+		};
+		void APIENTRY rec_program_parameter_i(GLuint program, GLenum pname, GLint value)
+		{
+			record(CALL::PROGRAM_PARAMETER_I);
+		};
+		void APIENTRY rec_get_program_binary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+		{
+			record(CALL::GET_PROGRAM_BINARY);
+			const auto _binary = program_binary();
+			const auto _count = std::min((size_t)std::max(bufSize, 0), _binary.size());
+			std::memcpy(binary, _binary.data(), _count);
+			if (length)
+			{
+				*length = (GLsizei)_count;
+			};
+			*binaryFormat = RecordingBackend::PROGRAM_BINARY_FORMAT;
+		};
+		void APIENTRY rec_program_binary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+		{
+			record(CALL::PROGRAM_BINARY);
+			const auto _expected = program_binary();
+			recording_state().program_linked[program] = binaryFormat == RecordingBackend::PROGRAM_BINARY_FORMAT &&
+				(size_t)length == _expected.size() && std::memcmp(binary, _expected.data(), _expected.size()) == 0;
+		};
+
+		// Copies a name out the way glGetActiveUniform and friends do, truncated to fit and null terminated
+		void write_name(std::string_view _name, GLsizei bufSize, GLsizei* length, GLchar* name)
+		{
+			const auto _count = (bufSize > 0) ? std::min(_name.size(), (size_t)bufSize - 1) : 0;
+			if (name && bufSize > 0)
+			{
+				std::memcpy(name, _name.data(), _count);
+				name[_count] = '\0';
+			};
+			if (length)
+			{
+				*length = (GLsizei)_count;
+			};
+		};
+
+		GLint APIENTRY rec_get_uniform_location(GLuint program, const GLchar* name)
+		{
+			record(CALL::GET_UNIFORM_LOCATION);
+			std::string_view _name{ name };
+			for (auto& u : recording_state().program_interfaces[program].uniforms)
+			{
+				if (u.name == _name)
+				{
+					return u.location;
+				};
+			};
+			return -1;
+		};
+		void APIENTRY rec_get_active_uniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size,
+			GLenum* type, GLchar* name)
+		{
+			record(CALL::GET_ACTIVE_UNIFORM);
+			const auto& _uniforms = recording_state().program_interfaces[program].uniforms;
+			if (index >= _uniforms.size())
+			{
+				return;
+			};
+			const auto& _uniform = _uniforms[index];
+			*size = _uniform.size;
+			*type = _uniform.type;
+
+			// Arrays are reported with a [0] suffix
+			write_name((_uniform.size > 1) ? _uniform.name + "[0]" : _uniform.name, bufSize, length, name);
+		};
+		void APIENTRY rec_get_active_uniform_block_iv(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint* params)
+		{
+			record(CALL::GET_ACTIVE_UNIFORM_BLOCK_IV);
+			const auto& _blocks = recording_state().program_interfaces[program].blocks;
+			if (uniformBlockIndex >= _blocks.size())
+			{
+				return;
+			};
+			const auto& _block = _blocks[uniformBlockIndex];
+			switch (pname)
+			{
+			case GL_UNIFORM_BLOCK_DATA_SIZE:
+				*params = _block.data_size;
+				break;
+			case GL_UNIFORM_BLOCK_BINDING:
+				*params = (GLint)_block.binding;
+				break;
+			case GL_UNIFORM_BLOCK_NAME_LENGTH:
+				*params = (GLint)_block.name.size() + 1;
+				break;
+			default:
+				*params = 0;
+				break;
+			};
+		};
+		void APIENTRY rec_get_active_uniform_block_name(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize,
+			GLsizei* length, GLchar* uniformBlockName)
+		{
+			record(CALL::GET_ACTIVE_UNIFORM_BLOCK_NAME);
+			const auto& _blocks = recording_state().program_interfaces[program].blocks;
+			if (uniformBlockIndex < _blocks.size())
+			{
+				write_name(_blocks[uniformBlockIndex].name, bufSize, length, uniformBlockName);
+			};
+		};
+		void APIENTRY rec_uniform_block_binding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+		{
+			record(CALL::UNIFORM_BLOCK_BINDING);
+			auto& _blocks = recording_state().program_interfaces[program].blocks;
+			if (uniformBlockIndex < _blocks.size())
+			{
+				_blocks[uniformBlockIndex].binding = uniformBlockBinding;
+			};
+		};
+		void APIENTRY rec_uniform_1i(GLint location, GLint v0)
+		{
+			record(CALL::UNIFORM_1I);
+		};
+		void APIENTRY rec_uniform_1f(GLint location, GLfloat v0)
+		{
+			record(CALL::UNIFORM_1F);
+		};
+		void APIENTRY rec_uniform_2f(GLint location, GLfloat v0, GLfloat v1)
+		{
+			record(CALL::UNIFORM_2F);
+		};
+		void APIENTRY rec_uniform_4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+		{
+			record(CALL::UNIFORM_4F);
+		};
+		void APIENTRY rec_uniform_matrix_4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+		{
+			record(CALL::UNIFORM_MATRIX_4FV);
+		};
+
+		void APIENTRY rec_active_texture(GLenum texture)
+		{
+			record(CALL::ACTIVE_TEXTURE);
+		};
+		void APIENTRY rec_bind_texture(GLenum target, GLuint texture)
+		{
+			record(CALL::BIND_TEXTURE);
+		};
+
+		GLsync APIENTRY rec_fence_sync(GLenum condition, GLbitfield flags)
+		{
+			record(CALL::FENCE_SYNC);
+			return (GLsync)recording_state().next_sync++;
+		};
+		GLenum APIENTRY rec_client_wait_sync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+		{
+			record(CALL::CLIENT_WAIT_SYNC);
+			return GL_ALREADY_SIGNALED;
+		};
+		void APIENTRY rec_delete_sync(GLsync sync)
+		{
+			record(CALL::DELETE_SYNC);
+		};
+
+		void APIENTRY rec_enable(GLenum cap)
+		{
+			record(CALL::ENABLE);
+		};
+		void APIENTRY rec_disable(GLenum cap)
+		{
+			record(CALL::DISABLE);
+		};
+		void APIENTRY rec_blend_func(GLenum sfactor, GLenum dfactor)
+		{
+			record(CALL::BLEND_FUNC);
+		};
+
+		void APIENTRY rec_clear(GLbitfield mask)
+		{
+			record(CALL::CLEAR);
+		};
+		void APIENTRY rec_viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+		{
+			record(CALL::VIEWPORT);
+		};
+		const GLubyte* APIENTRY rec_get_string(GLenum name)
+		{
+			record(CALL::GET_STRING);
+			switch (name)
+			{
+			case GL_VENDOR:
+				return (const GLubyte*)"SAEEngineCore";
+			case GL_RENDERER:
+				return (const GLubyte*)"Recording backend";
+			case GL_VERSION:
+				return (const GLubyte*)recording_state().driver_version.c_str();
+			case GL_SHADING_LANGUAGE_VERSION:
+				return (const GLubyte*)"4.30";
+			default:
+				return (const GLubyte*)"";
+			};
+		};
+		void APIENTRY rec_get_integer_v(GLenum pname, GLint* data)
+		{
+			record(CALL::GET_INTEGER_V);
+			switch (pname)
+			{
+			case GL_MAJOR_VERSION:
+				*data = 4;
+				break;
+			case GL_MINOR_VERSION:
+				*data = 3;
+				break;
+			case GL_NUM_PROGRAM_BINARY_FORMATS:
+				*data = 1;
+				break;
+			case GL_PROGRAM_BINARY_FORMATS:
+				*data = RecordingBackend::PROGRAM_BINARY_FORMAT;
+				break;
+			default:
+				*data = 0;
+				break;
+			};
+		};
+		GLenum APIENTRY rec_get_error()
+		{
+			record(CALL::GET_ERROR);
+			return GL_NO_ERROR;
+		};
+	}
+
+	size_t RecordingBackend::Counters::total_calls() const noexcept
+	{
+		size_t _out = 0;
+		for (auto& c : this->calls)
+		{
+			_out += c;
+		};
+		return _out;
+	};
+
+	void RecordingBackend::install()
+	{
+		auto& _state = recording_state();
+		_state = RecordingState{};
+
+		// Bindings remembered from the previous backend no longer hold
+		StateCache::current().invalidate();
+		_state.installed = true;
+
+		glad_glGenBuffers = &rec_gen_buffers;
+		glad_glDeleteBuffers = &rec_delete_buffers;
+		glad_glBindBuffer = &rec_bind_buffer;
+		glad_glBindBufferBase = &rec_bind_buffer_base;
+		glad_glBufferData = &rec_buffer_data;
+		glad_glBufferSubData = &rec_buffer_sub_data;
+		glad_glCopyBufferSubData = &rec_copy_buffer_sub_data;
+		glad_glMapBufferRange = &rec_map_buffer_range;
+		glad_glFlushMappedBufferRange = &rec_flush_mapped_buffer_range;
+		glad_glUnmapBuffer = &rec_unmap_buffer;
+		extensions_storage().buffer_storage = &rec_buffer_storage;
+
+		glad_glGenVertexArrays = &rec_gen_vertex_arrays;
+		glad_glDeleteVertexArrays = &rec_delete_vertex_arrays;
+		glad_glBindVertexArray = &rec_bind_vertex_array;
+		glad_glEnableVertexAttribArray = &rec_enable_vertex_attrib_array;
+		glad_glVertexAttribPointer = &rec_vertex_attrib_pointer;
+		glad_glVertexAttribIPointer = &rec_vertex_attrib_i_pointer;
+		glad_glVertexAttribDivisor = &rec_vertex_attrib_divisor;
+
+		glad_glDrawArrays = &rec_draw_arrays;
+		glad_glDrawArraysInstanced = &rec_draw_arrays_instanced;
+		glad_glDrawArraysInstancedBaseInstance = &rec_draw_arrays_instanced_base_instance;
+		glad_glDrawElements = &rec_draw_elements;
+		glad_glDrawElementsInstanced = &rec_draw_elements_instanced;
+
+		glad_glCreateShader = &rec_create_shader;
+		glad_glDeleteShader = &rec_delete_shader;
+		glad_glShaderSource = &rec_shader_source;
+		glad_glCompileShader = &rec_compile_shader;
+		glad_glGetShaderiv = &rec_get_shader_iv;
+		glad_glGetShaderInfoLog = &rec_get_shader_info_log;
+		glad_glCreateProgram = &rec_create_program;
+		glad_glDeleteProgram = &rec_delete_program;
+		glad_glAttachShader = &rec_attach_shader;
+		glad_glDetachShader = &rec_detach_shader;
+		glad_glLinkProgram = &rec_link_program;
+		glad_glGetProgramiv = &rec_get_program_iv;
+		glad_glGetProgramInfoLog = &rec_get_program_info_log;
+		glad_glUseProgram = &rec_use_program;
+		glad_glProgramParameteri = &rec_program_parameter_i;
+		glad_glGetProgramBinary = &rec_get_program_binary;
+		glad_glProgramBinary = &rec_program_binary;
+		extensions_storage().max_shader_compiler_threads = &rec_max_shader_compiler_threads;
+
+		glad_glGetUniformLocation = &rec_get_uniform_location;
+		glad_glUniform1i = &rec_uniform_1i;
+		glad_glUniform1f = &rec_uniform_1f;
+		glad_glUniform2f = &rec_uniform_2f;
+		glad_glUniform4f = &rec_uniform_4f;
+		glad_glUniformMatrix4fv = &rec_uniform_matrix_4fv;
+		glad_glGetActiveUniform = &rec_get_active_uniform;
+		glad_glGetActiveUniformBlockiv = &rec_get_active_uniform_block_iv;
+		glad_glGetActiveUniformBlockName = &rec_get_active_uniform_block_name;
+		glad_glUniformBlockBinding = &rec_uniform_block_binding;
+
+		glad_glActiveTexture = &rec_active_texture;
+		glad_glBindTexture = &rec_bind_texture;
+
+		glad_glFenceSync = &rec_fence_sync;
+		glad_glClientWaitSync = &rec_client_wait_sync;
+		glad_glDeleteSync = &rec_delete_sync;
+
+		glad_glEnable = &rec_enable;
+		glad_glDisable = &rec_disable;
+		glad_glBlendFunc = &rec_blend_func;
+
+		glad_glClear = &rec_clear;
+		glad_glViewport = &rec_viewport;
+		glad_glGetString = &rec_get_string;
+		glad_glGetIntegerv = &rec_get_integer_v;
+		glad_glGetError = &rec_get_error;
+
+		GLVersion.major = 4;
+		GLVersion.minor = 3;
+	};
+	bool RecordingBackend::installed() noexcept
+	{
+		return recording_state().installed;
+	};
+
+	const RecordingBackend::Counters& RecordingBackend::counters() noexcept
+	{
+		return recording_state().counters;
+	};
+	void RecordingBackend::reset_counters() noexcept
+	{
+		recording_state().counters = Counters{};
+	};
+
+	std::string_view RecordingBackend::call_name(CALL _call) noexcept
+	{
+		constexpr static std::array<std::string_view, CALL_COUNT> NAMES
+		{
+			"glGenBuffers", "glDeleteBuffers", "glBindBuffer", "glBindBufferBase", "glBufferData", "glBufferSubData",
+			"glCopyBufferSubData", "glMapBufferRange", "glFlushMappedBufferRange", "glUnmapBuffer", "glBufferStorage",
+			"glGenVertexArrays", "glDeleteVertexArrays", "glBindVertexArray", "glEnableVertexAttribArray",
+			"glVertexAttribPointer", "glVertexAttribIPointer", "glVertexAttribDivisor",
+			"glDrawArrays", "glDrawArraysInstanced", "glDrawArraysInstancedBaseInstance", "glDrawElements",
+			"glDrawElementsInstanced",
+			"glCreateShader", "glDeleteShader", "glShaderSource", "glCompileShader", "glGetShaderiv", "glGetShaderInfoLog",
+			"glCreateProgram", "glDeleteProgram", "glAttachShader", "glDetachShader", "glLinkProgram", "glGetProgramiv",
+			"glGetProgramInfoLog", "glUseProgram", "glProgramParameteri", "glGetProgramBinary", "glProgramBinary",
+			"glMaxShaderCompilerThreadsKHR",
+			"glGetUniformLocation", "glUniform1i", "glUniform1f", "glUniform2f", "glUniform4f", "glUniformMatrix4fv",
+			"glGetActiveUniform", "glGetActiveUniformBlockiv", "glGetActiveUniformBlockName", "glUniformBlockBinding",
+			"glActiveTexture", "glBindTexture",
+			"glFenceSync", "glClientWaitSync", "glDeleteSync",
+			"glEnable", "glDisable", "glBlendFunc",
+			"glClear", "glViewport", "glGetString", "glGetIntegerv", "glGetError"
+		};
+		return (_call < CALL_COUNT) ? NAMES[_call] : std::string_view{};
+	};
+
+	std::span<const std::byte> RecordingBackend::buffer_data(GLuint _buffer)
+	{
+		auto& _buffers = recording_state().buffers;
+		auto _it = _buffers.find(_buffer);
+		return (_it != _buffers.end()) ? std::span<const std::byte>{ _it->second } : std::span<const std::byte>{};
+	};
+	GLenum RecordingBackend::buffer_usage(GLuint _buffer)
+	{
+		auto& _usages = recording_state().buffer_usages;
+		auto _it = _usages.find(_buffer);
+		return (_it != _usages.end()) ? _it->second : GL_NONE;
+	};
+	size_t RecordingBackend::buffer_count() noexcept
+	{
+		return recording_state().buffers.size();
+	};
+	void RecordingBackend::set_driver_version(std::string_view _version)
+	{
+		recording_state().driver_version = std::string{ _version };
+	};
+	void RecordingBackend::set_completion_latency(size_t _polls)
+	{
+		recording_state().completion_latency = _polls;
+	};
+	void RecordingBackend::clear_extensions()
+	{
+		extensions_storage() = Extensions{};
+	};
+
+}
@@ -0,0 +1,129 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Environment.h>
+
+#include <iostream>
+
+using namespace sae::engine::core;
+
+/*
+	Checks gl::StateCache against the recording backend, counting the bind calls that actually reach GL.
+*/
+
+using CALL = gl::RecordingBackend::CALL;
+
+static size_t gl_calls(CALL _call)
+{
+	return gl::RecordingBackend::counters().count(_call);
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	gl::RecordingBackend::install();
+
+	gl::StateCache _cache{};
+	gl::StateCache::make_current(&_cache);
+	if (&gl::StateCache::current() != &_cache)
+	{
+		std::cout << "cache was not made current\n";
+		return 1;
+	};
+
+	GLuint _buffers[2]{};
+	glGenBuffers(2, _buffers);
+
+	// Repeated binds of the same buffer only reach GL once
+	for (int n = 0; n != 10; ++n)
+	{
+		_cache.bind_buffer(GL_ARRAY_BUFFER, _buffers[0]);
+	};
+	if (gl_calls(CALL::BIND_BUFFER) != 1 || _cache.counters().issued != 1 || _cache.counters().elided != 9)
+	{
+		std::cout << "redundant buffer binds were not skipped\n";
+		return 2;
+	};
+
+	// Targets are tracked separately
+	_cache.bind_buffer(GL_COPY_READ_BUFFER, _buffers[0]);
+	_cache.bind_buffer(GL_ARRAY_BUFFER, _buffers[1]);
+	_cache.bind_buffer(GL_ARRAY_BUFFER, _buffers[1]);
+	if (gl_calls(CALL::BIND_BUFFER) != 3)
+	{
+		std::cout << "binds to different targets or buffers were skipped\n";
+		return 3;
+	};
+
+	// Programs and vertex arrays
+	_cache.reset_counters();
+	for (int n = 0; n != 4; ++n)
+	{
+		_cache.use_program(7);
+		_cache.bind_vertex_array(3);
+	};
+	if (gl_calls(CALL::USE_PROGRAM) != 1 || gl_calls(CALL::BIND_VERTEX_ARRAY) != 1 || _cache.counters().elided != 6)
+	{
+		std::cout << "redundant program or vertex array binds were not skipped\n";
+		return 4;
+	};
+
+	// The element array binding belongs to the vertex array, so changing vertex array makes it unknown
+	_cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[0]);
+	_cache.bind_vertex_array(4);
+	_cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[0]);
+	if (gl_calls(CALL::BIND_BUFFER) != 5)
+	{
+		std::cout << "element array bind was skipped after the vertex array changed\n";
+		return 5;
+	};
+
+	// Deleting a bound buffer unbinds it, so binding 0 afterwards is already done
+	_cache.delete_buffers(1, &_buffers[1]);
+	_cache.bind_buffer(GL_ARRAY_BUFFER, 0);
+	if (gl_calls(CALL::BIND_BUFFER) != 5 || gl_calls(CALL::DELETE_BUFFERS) != 1)
+	{
+		std::cout << "deleting a bound buffer did not clear its binding\n";
+		return 6;
+	};
+
+	// After invalidate() every bind is passed on again
+	_cache.invalidate();
+	_cache.use_program(7);
+	_cache.bind_buffer(GL_COPY_READ_BUFFER, _buffers[0]);
+	if (gl_calls(CALL::USE_PROGRAM) != 2 || gl_calls(CALL::BIND_BUFFER) != 6)
+	{
+		std::cout << "binds were skipped after invalidate()\n";
+		return 7;
+	};
+
+	// Other targets are never cached
+	_cache.bind_buffer(GL_TEXTURE_BUFFER, _buffers[0]);
+	_cache.bind_buffer(GL_TEXTURE_BUFFER, _buffers[0]);
+	if (gl_calls(CALL::BIND_BUFFER) != 8)
+	{
+		std::cout << "bind to an uncached target was skipped\n";
+		return 8;
+	};
+
+	gl::StateCache::make_current(nullptr);
+	if (&gl::StateCache::current() == &_cache)
+	{
+		std::cout << "fallback cache was not restored\n";
+		return 9;
+	};
+
+	return GOOD_TEST;
+};
@@ -7,7 +7,19 @@
 
 #include <SAELib_Functor.h>
 
+#include <string>
 #include <variant>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <array>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <istream>
+#include <ostream>
+#include <cstddef>
 
 namespace sae::engine::core
 {
@@ -148,6 +160,12 @@ namespace sae::engine::core
 			EventType<EVENT_TYPE_E::WINDOW_CLOSE>
 		>;
 
+	public:
+		/**
+		 * @brief Number of event types, one past the largest EVENT_TYPE value
+		*/
+		constexpr static inline size_t TYPE_COUNT = std::variant_size_v<variant_type>;
+
 		variant_type& get_variant() noexcept { return this->vt_; };
 		const variant_type& get_variant() const noexcept { return this->vt_; };
 
@@ -217,7 +235,448 @@ namespace sae::engine::core
 
 	using EventSet = std::vector<Event>;
 
+	/**
+	 * @brief Bounded multi-producer single-consumer queue of events. Any thread may push, a single thread (normally the one
+	 * that owns the GFXContext) pops. Pushing and popping from the ring are lock free, a mutex is only taken by the GROW
+	 * overflow policy once the ring is full.
+	*/
+	class EventQueue
+	{
+	public:
+		using size_type = size_t;
+		using clock_type = std::chrono::steady_clock;
+
+		/**
+		 * @brief What push() does when the ring is full
+		*/
+		enum class OVERFLOW_POLICY : uint8_t
+		{
+			// Discard the oldest queued event to make room
+			DROP_OLDEST,
+
+			// Wait for the consumer to make room
+			BLOCK,
+
+			// Spill into an unbounded list that is drained after the ring
+			GROW
+		};
+
+		/**
+		 * @brief Counters since construction or the last reset_stats() call. Latency is the time from push to pop.
+		*/
+		struct Stats
+		{
+			size_type pushed = 0;
+			size_type popped = 0;
+			size_type dropped = 0;
+			size_type overflowed = 0;
+			size_type blocked = 0;
+
+			int64_t total_latency_ns = 0;
+			int64_t max_latency_ns = 0;
+
+			double mean_latency_ns() const noexcept
+			{
+				return (this->popped != 0) ? (double)this->total_latency_ns / (double)this->popped : 0.0;
+			};
+		};
 
+		/**
+		 * @brief Adds an event to the queue, applying the overflow policy if the ring is full. Safe to call from any thread.
+		*/
+		void push(const Event& _event);
+		void push(Event&& _event);
+
+		/**
+		 * @brief Adds an event only if there is room in the ring, the overflow policy is not applied
+		 * @return true if the event was added
+		*/
+		bool try_push(Event&& _event);
+
+		/**
+		 * @brief Removes the oldest event. Must only be called from the consumer thread.
+		 * @return true if an event was removed
+		*/
+		bool try_pop(Event& _out);
+
+		/**
+		 * @brief Pops up to _max events and passes each one to _fn. Must only be called from the consumer thread.
+		 * @return Number of events popped
+		*/
+		template <typename FuncT>
+		size_type drain(FuncT&& _fn, size_type _max = std::numeric_limits<size_type>::max())
+		{
+			Event _ev{};
+			size_type _count = 0;
+			while (_count != _max && this->try_pop(_ev))
+			{
+				_fn(_ev);
+				++_count;
+			};
+			return _count;
+		};
+
+		/**
+		 * @brief Number of queued events, only exact while no other thread is pushing or popping
+		*/
+		size_type size_approx() const noexcept;
+		bool empty() const noexcept;
+
+		/**
+		 * @brief Number of events the ring can hold, always a power of two
+		*/
+		size_type capacity() const noexcept;
+
+		OVERFLOW_POLICY policy() const noexcept;
+		void set_policy(OVERFLOW_POLICY _policy) noexcept;
+
+		Stats stats() const noexcept;
+		void reset_stats() noexcept;
+
+		/**
+		 * @param _capacity Number of events the ring can hold, rounded up to a power of two
+		*/
+		explicit EventQueue(size_type _capacity = 1024, OVERFLOW_POLICY _policy = OVERFLOW_POLICY::DROP_OLDEST);
+
+		EventQueue(const EventQueue& other) = delete;
+		EventQueue& operator=(const EventQueue& other) = delete;
+
+	private:
+		using timestamp_type = clock_type::rep;
+
+		struct Cell
+		{
+			std::atomic<size_type> sequence{ 0 };
+			Event event{};
+			timestamp_type pushed_at = 0;
+		};
+
+		struct Overflowed
+		{
+			Event event{};
+			timestamp_type pushed_at = 0;
+		};
+
+		static timestamp_type now() noexcept;
+
+		// Pops from the ring without touching the latency counters, used by the consumer and by DROP_OLDEST producers
+		bool pop_ring(Event& _out, timestamp_type& _pushedAt);
+		bool pop_overflow(Event& _out, timestamp_type& _pushedAt);
+
+		void record_latency(timestamp_type _pushedAt) noexcept;
+
+		std::unique_ptr<Cell[]> cells_;
+		size_type mask_ = 0;
+		std::atomic<OVERFLOW_POLICY> policy_;
+
+		// Producers and the consumer touch different positions, keep them on separate cache lines
+		alignas(64) std::atomic<size_type> enqueue_pos_{ 0 };
+		alignas(64) std::atomic<size_type> dequeue_pos_{ 0 };
+
+		alignas(64) std::mutex overflow_mtx_{};
+		std::deque<Overflowed> overflow_{};
+		std::atomic<size_type> overflow_count_{ 0 };
+
+		std::atomic<size_type> pushed_{ 0 };
+		std::atomic<size_type> popped_{ 0 };
+		std::atomic<size_type> dropped_{ 0 };
+		std::atomic<size_type> overflowed_{ 0 };
+		std::atomic<size_type> blocked_{ 0 };
+		std::atomic<int64_t> total_latency_ns_{ 0 };
+		std::atomic<int64_t> max_latency_ns_{ 0 };
+
+	};
+
+
+
+	/**
+	 * @brief Folds runs of adjacent events of the same type into one so a burst of cursor moves, scrolls or resizes within a
+	 * frame is dispatched as a single net event. Only adjacent events are folded so the order relative to other events, such
+	 * as a click between two cursor moves, is kept.
+	*/
+	class EventCoalescer
+	{
+	public:
+		using size_type = size_t;
+		using EVENT_TYPE = Event::EVENT_TYPE;
+
+		/**
+		 * @brief How adjacent events of one type are folded
+		*/
+		enum class MODE : uint8_t
+		{
+			// Never fold
+			NONE,
+
+			// Replace the pending event with the newer one
+			KEEP_LAST,
+
+			// Add the newer event's deltas to the pending event, only valid for SCROLL_EVENT and GROW_EVENT
+			SUM
+		};
+
+		/**
+		 * @brief Counters since construction or the last reset_stats() call
+		*/
+		struct Stats
+		{
+			// Events given to push()
+			size_type received = 0;
+
+			// Events passed on by flush()
+			size_type emitted = 0;
+
+			// Events folded into another, by type
+			std::array<size_type, Event::TYPE_COUNT> folded{};
+
+			size_type total_folded() const noexcept
+			{
+				size_type _out = 0;
+				for (auto& n : this->folded)
+				{
+					_out += n;
+				};
+				return _out;
+			};
+		};
+
+		/**
+		 * @brief Returns true if the payload of the event type can be summed
+		*/
+		static bool can_sum(EVENT_TYPE _type) noexcept;
+
+		/**
+		 * @brief Sets how events of a type are folded, SUM is ignored for types that cannot be summed
+		*/
+		void set_mode(EVENT_TYPE _type, MODE _mode) noexcept;
+		MODE mode(EVENT_TYPE _type) const noexcept;
+
+		/**
+		 * @brief Adds an event to the pending list, folding it into the last pending event if possible
+		*/
+		void push(Event&& _event);
+		void push(const Event& _event);
+
+		/**
+		 * @brief Passes each pending event to _fn in order and clears the pending list
+		 * @return Number of events passed to _fn
+		*/
+		template <typename FuncT>
+		size_type flush(FuncT&& _fn)
+		{
+			const auto _count = this->pending_.size();
+			for (auto& e : this->pending_)
+			{
+				_fn(e);
+			};
+			this->pending_.clear();
+			this->stats_.emitted += _count;
+			return _count;
+		};
+
+		size_type pending() const noexcept;
+
+		const Stats& stats() const noexcept;
+		void reset_stats() noexcept;
+
+		/**
+		 * @brief Starts with CURSOR_MOVE set to KEEP_LAST, SCROLL_EVENT and GROW_EVENT set to SUM, and everything else NONE
+		*/
+		EventCoalescer();
+
+	private:
+
+		/**
+		 * @brief Folds _event into _into if both have the same type and broadcast flag and the type's mode allows it
+		*/
+		bool fold(Event& _into, const Event& _event) const;
+
+		std::array<MODE, Event::TYPE_COUNT> modes_{};
+		std::vector<Event> pending_{};
+		Stats stats_{};
+
+	};
+
+	/**
+	 * @brief Writes events to a stream in a compact binary form through an internal buffer.
+	 *
+	 * The stream starts with a short header. Each event is then a one byte tag, holding the event type in the low 7 bits and
+	 * the broadcast flag in the high bit, followed by the packed fields of that event type. Integers are written as
+	 * zigzag LEB128 varints, doubles as 8 raw little endian bytes and strings as a varint length followed by the bytes.
+	*/
+	class EventWriter
+	{
+	public:
+		using size_type = size_t;
+
+		/**
+		 * @brief Identifies a recording, written once at the start of the stream
+		*/
+		constexpr static inline std::array<char, 4> MAGIC{ 'S', 'A', 'E', 'V' };
+		constexpr static inline uint8_t VERSION = 1;
+
+		/**
+		 * @brief Longest string field a reader accepts, a longer length is treated as a damaged record
+		*/
+		constexpr static inline size_type MAX_STRING_SIZE = 64 * 1024;
+
+		void write(const Event& _event);
+
+		/**
+		 * @brief Writes any buffered bytes to the stream
+		*/
+		void flush();
+
+		size_type events_written() const noexcept;
+		size_type bytes_written() const noexcept;
+
+		/**
+		 * @param _ostr Stream to write to, must be opened in binary mode and outlive the writer
+		 * @param _bufferSize Bytes buffered before they are written to the stream
+		*/
+		explicit EventWriter(std::ostream& _ostr, size_type _bufferSize = 64 * 1024);
+
+		EventWriter(const EventWriter& other) = delete;
+		EventWriter& operator=(const EventWriter& other) = delete;
+
+		/**
+		 * @brief Flushes any buffered bytes
+		*/
+		~EventWriter();
+
+	private:
+		void put(uint8_t _byte);
+		void put_bytes(const void* _data, size_type _count);
+		void put_varint(uint64_t _value);
+		void put_signed(int64_t _value);
+		void put_double(double _value);
+
+		std::ostream* ostr_;
+		std::vector<uint8_t> buffer_{};
+		size_type capacity_ = 0;
+		size_type events_ = 0;
+		size_type bytes_ = 0;
+
+	};
+
+	/**
+	 * @brief Reads events written by an EventWriter back from a stream
+	*/
+	class EventReader
+	{
+	public:
+		using size_type = size_t;
+
+		/**
+		 * @brief Reads the next event
+		 * @return false at the end of the stream, or if the stream is not a recording or a record is truncated or invalid,
+		 * in which case good() also returns false
+		*/
+		bool read(Event& _out);
+
+		/**
+		 * @brief Returns false if the header or a record could not be parsed
+		*/
+		bool good() const noexcept;
+
+		size_type events_read() const noexcept;
+
+		/**
+		 * @param _istr Stream to read from, must be opened in binary mode and outlive the reader
+		 * @param _bufferSize Bytes read from the stream at a time
+		*/
+		explicit EventReader(std::istream& _istr, size_type _bufferSize = 64 * 1024);
+
+		EventReader(const EventReader& other) = delete;
+		EventReader& operator=(const EventReader& other) = delete;
+
+	private:
+		bool fill();
+		bool get(uint8_t& _byte);
+		bool get_bytes(void* _data, size_type _count);
+		bool get_varint(uint64_t& _value);
+		bool get_signed(int64_t& _value);
+		bool get_double(double& _value);
+
+		std::istream* istr_;
+		std::vector<uint8_t> buffer_{};
+		size_type pos_ = 0;
+		size_type events_ = 0;
+		bool good_ = true;
+
+	};
+
+	/**
+	 * @brief Feeds a recording into an event handler as fast as it will take them, timing each dispatch
+	*/
+	class EventReplayer
+	{
+	public:
+		using size_type = size_t;
+
+		/**
+		 * @brief Timing for one replay. The histogram counts dispatches by latency, bucket n holds latencies in
+		 * [2^n, 2^(n+1)) nanoseconds with bucket 0 also holding anything under 1 ns.
+		*/
+		struct Stats
+		{
+			constexpr static inline size_type BUCKETS = 40;
+
+			size_type events = 0;
+
+			// Wall time for the whole replay including decoding
+			int64_t total_ns = 0;
+
+			// Time spent inside the handler only
+			int64_t dispatch_ns = 0;
+
+			std::array<size_type, BUCKETS> latency_histogram{};
+
+			void record(int64_t _latencyNs) noexcept;
+
+			double events_per_second() const noexcept;
+
+			/**
+			 * @brief Upper bound of the histogram bucket containing the given percentile
+			 * @param _percentile Value in [0, 100]
+			*/
+			int64_t percentile_ns(double _percentile) const noexcept;
+		};
+
+		/**
+		 * @brief Reads every remaining event and passes it to _sink
+		 * @return Timing for the replay
+		*/
+		template <typename FuncT>
+		Stats replay(FuncT&& _sink)
+		{
+			using clock = std::chrono::steady_clock;
+
+			Stats _stats{};
+			Event _ev{};
+			const auto _start = clock::now();
+			while (this->reader_.read(_ev))
+			{
+				const auto _before = clock::now();
+				_sink(_ev);
+				const auto _latency = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _before).count();
+				_stats.record(_latency);
+			};
+			_stats.total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _start).count();
+			return _stats;
+		};
+
+		/**
+		 * @brief Returns false if the recording was invalid or truncated
+		*/
+		bool good() const noexcept;
+
+		explicit EventReplayer(std::istream& _istr);
+
+	private:
+		EventReader reader_;
+
+	};
 
 	using HandleEventCallback = functor<bool(const Event&)>;
 
@@ -1,14 +1,21 @@
 #pragma once
-#include <SAELib_DualMap.h>
+
+/*
+	Generated by tools/strenum.cmake from 12 enumerators, do not edit.
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
-#include <string>
+#include <string_view>
 
 namespace sae::engine::core
 {
 
-class EVENT_TYPE 
+class EVENT_TYPE
 {
-public: 
+public:
 	enum EVENT_TYPE_E
 	{
 		NULL_EVENT,
@@ -25,22 +32,57 @@ public:
 		WINDOW_CLOSE,
 	};
 
+	constexpr static inline size_t COUNT = 12;
+
 private:
-	const static inline ::sae::unordered_dualmap<std::string, EVENT_TYPE_E> STR_ENUM_DMAP
+	constexpr static inline std::array<std::string_view, COUNT> NAMES
+	{
+		"NULL_EVENT",
+		"BLACKBOARD_CHANGE",
+		"CURSOR_WINDOW_BOUNDS",
+		"CURSOR_MOVE",
+		"MOUSE_EVENT",
+		"KEY_EVENT",
+		"SCROLL_EVENT",
+		"TEXT_EVENT",
+		"USER_EVENT",
+		"GROW_EVENT",
+		"REFRESH_EVENT",
+		"WINDOW_CLOSE",
+	};
+
+	using slot_type = uint8_t;
+	constexpr static inline slot_type npos = 255;
+	constexpr static inline uint32_t HASH_SEED = 181;
+	constexpr static inline uint32_t HASH_SHIFT = 28;
+	constexpr static inline std::array<slot_type, 16> HASH_SLOTS
+	{
+		8, 2, 4, npos, 0, npos, 6, 1, 11, 9, 7, npos, 3, 10, npos, 5
+	};
+
+	constexpr static inline bool HASH_FULL = false;
+
+	constexpr static uint32_t hash(std::string_view _str) noexcept
 	{
-		{ "NULL_EVENT" , EVENT_TYPE_E::NULL_EVENT },
-		{ "BLACKBOARD_CHANGE" , EVENT_TYPE_E::BLACKBOARD_CHANGE },
-		{ "CURSOR_WINDOW_BOUNDS" , EVENT_TYPE_E::CURSOR_WINDOW_BOUNDS },
-		{ "CURSOR_MOVE" , EVENT_TYPE_E::CURSOR_MOVE },
-		{ "MOUSE_EVENT" , EVENT_TYPE_E::MOUSE_EVENT },
-		{ "KEY_EVENT" , EVENT_TYPE_E::KEY_EVENT },
-		{ "SCROLL_EVENT" , EVENT_TYPE_E::SCROLL_EVENT },
-		{ "TEXT_EVENT" , EVENT_TYPE_E::TEXT_EVENT },
-		{ "USER_EVENT" , EVENT_TYPE_E::USER_EVENT },
-		{ "GROW_EVENT" , EVENT_TYPE_E::GROW_EVENT },
-		{ "REFRESH_EVENT" , EVENT_TYPE_E::REFRESH_EVENT },
-		{ "WINDOW_CLOSE" , EVENT_TYPE_E::WINDOW_CLOSE }
+		uint32_t _k = 0;
+		if constexpr (HASH_FULL)
+		{
+			_k = 2166136261u;
+			for (auto c : _str)
+			{
+				_k = (_k ^ (uint32_t)(unsigned char)c) * 16777619u;
+			};
+		}
+		else if (!_str.empty())
+		{
+			_k = (uint32_t)_str.size();
+			_k = _k * 31u + (uint32_t)(unsigned char)_str.front();
+			_k = _k * 31u + (uint32_t)(unsigned char)_str[_str.size() / 2];
+			_k = _k * 31u + (uint32_t)(unsigned char)_str.back();
+		};
+		return ((_k ^ HASH_SEED) * 2654435761u) >> HASH_SHIFT;
 	};
+
 	EVENT_TYPE_E val_;
 
 public:
@@ -48,29 +90,28 @@ public:
 	friend constexpr inline bool operator!=(const EVENT_TYPE& _lhs, const EVENT_TYPE& _rhs) noexcept = default;
 	explicit operator bool() noexcept = delete;
 
-	static inline std::optional<EVENT_TYPE_E> from_string(const std::string& _str)
+	constexpr static inline std::optional<EVENT_TYPE_E> from_string(std::string_view _str) noexcept
 	{
-		std::optional<EVENT_TYPE_E> _out{ std::nullopt };
-		if(STR_ENUM_DMAP.contains_left(_str))
+		const auto _slot = HASH_SLOTS[hash(_str)];
+		if (_slot != npos && NAMES[_slot] == _str)
 		{
-			_out = STR_ENUM_DMAP.ltor(_str);
+			return (EVENT_TYPE_E)_slot;
 		};
-		return _out;
+		return std::nullopt;
 	};
-	const std::string& to_string() const
+	constexpr std::string_view to_string() const noexcept
 	{
-		return STR_ENUM_DMAP.rtol(this->val_);
+		return NAMES[this->val_];
 	};
 
 	constexpr inline operator EVENT_TYPE_E() const noexcept { return this->val_; };
-	constexpr EVENT_TYPE(EVENT_TYPE_E _val) noexcept : 
+	constexpr EVENT_TYPE(EVENT_TYPE_E _val) noexcept :
 		val_{ _val }
 	{};
-	EVENT_TYPE& operator=(EVENT_TYPE_E _val) noexcept {
+	constexpr EVENT_TYPE& operator=(EVENT_TYPE_E _val) noexcept {
 		this->val_ = _val;
 		return *this;
 	};
 };
 
-
 };
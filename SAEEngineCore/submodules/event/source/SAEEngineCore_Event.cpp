@@ -0,0 +1,777 @@
+#include "SAEEngineCore_Event.h"
+
+#include <cassert>
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace sae::engine::core
+{
+	EventQueue::timestamp_type EventQueue::now() noexcept
+	{
+		return clock_type::now().time_since_epoch().count();
+	};
+
+	bool EventQueue::try_push(Event&& _event)
+	{
+		Cell* _cell = nullptr;
+		auto _pos = this->enqueue_pos_.load(std::memory_order_relaxed);
+		while (true)
+		{
+			_cell = &this->cells_[_pos & this->mask_];
+			const auto _seq = _cell->sequence.load(std::memory_order_acquire);
+			const auto _diff = (intptr_t)_seq - (intptr_t)_pos;
+			if (_diff == 0)
+			{
+				if (this->enqueue_pos_.compare_exchange_weak(_pos, _pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				};
+			}
+			else if (_diff < 0)
+			{
+				// Ring is full
+				return false;
+			}
+			else
+			{
+				_pos = this->enqueue_pos_.load(std::memory_order_relaxed);
+			};
+		};
+
+		_cell->event = std::move(_event);
+		_cell->pushed_at = now();
+		_cell->sequence.store(_pos + 1, std::memory_order_release);
+		this->pushed_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	};
+
+	bool EventQueue::pop_ring(Event& _out, timestamp_type& _pushedAt)
+	{
+		Cell* _cell = nullptr;
+		auto _pos = this->dequeue_pos_.load(std::memory_order_relaxed);
+		while (true)
+		{
+			_cell = &this->cells_[_pos & this->mask_];
+			const auto _seq = _cell->sequence.load(std::memory_order_acquire);
+			const auto _diff = (intptr_t)_seq - (intptr_t)(_pos + 1);
+			if (_diff == 0)
+			{
+				// Producers may pop as well under DROP_OLDEST so the position still has to be claimed
+				if (this->dequeue_pos_.compare_exchange_weak(_pos, _pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				};
+			}
+			else if (_diff < 0)
+			{
+				// Ring is empty
+				return false;
+			}
+			else
+			{
+				_pos = this->dequeue_pos_.load(std::memory_order_relaxed);
+			};
+		};
+
+		_out = std::move(_cell->event);
+		_pushedAt = _cell->pushed_at;
+		_cell->sequence.store(_pos + this->mask_ + 1, std::memory_order_release);
+		return true;
+	};
+
+	bool EventQueue::pop_overflow(Event& _out, timestamp_type& _pushedAt)
+	{
+		if (this->overflow_count_.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		};
+
+		std::unique_lock _lck{ this->overflow_mtx_ };
+		if (this->overflow_.empty())
+		{
+			return false;
+		};
+		_out = std::move(this->overflow_.front().event);
+		_pushedAt = this->overflow_.front().pushed_at;
+		this->overflow_.pop_front();
+		this->overflow_count_.fetch_sub(1, std::memory_order_release);
+		return true;
+	};
+
+	void EventQueue::record_latency(timestamp_type _pushedAt) noexcept
+	{
+		const auto _latency = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::duration{ now() - _pushedAt }).count();
+		this->total_latency_ns_.fetch_add(_latency, std::memory_order_relaxed);
+		if (_latency > this->max_latency_ns_.load(std::memory_order_relaxed))
+		{
+			this->max_latency_ns_.store(_latency, std::memory_order_relaxed);
+		};
+		this->popped_.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	void EventQueue::push(Event&& _event)
+	{
+		switch (this->policy())
+		{
+		case OVERFLOW_POLICY::DROP_OLDEST:
+			while (!this->try_push(std::move(_event)))
+			{
+				Event _oldest{};
+				timestamp_type _pushedAt = 0;
+				if (this->pop_ring(_oldest, _pushedAt))
+				{
+					this->dropped_.fetch_add(1, std::memory_order_relaxed);
+				};
+			};
+			break;
+
+		case OVERFLOW_POLICY::BLOCK:
+			if (!this->try_push(std::move(_event)))
+			{
+				this->blocked_.fetch_add(1, std::memory_order_relaxed);
+				do
+				{
+					std::this_thread::yield();
+				} while (!this->try_push(std::move(_event)));
+			};
+			break;
+
+		case OVERFLOW_POLICY::GROW:
+			// Once anything has spilled, keep spilling until the consumer catches up so events from one producer stay in order
+			if (this->overflow_count_.load(std::memory_order_acquire) != 0 || !this->try_push(std::move(_event)))
+			{
+				std::unique_lock _lck{ this->overflow_mtx_ };
+				this->overflow_.push_back(Overflowed{ std::move(_event), now() });
+				this->overflow_count_.fetch_add(1, std::memory_order_release);
+				this->overflowed_.fetch_add(1, std::memory_order_relaxed);
+				this->pushed_.fetch_add(1, std::memory_order_relaxed);
+			};
+			break;
+		};
+	};
+	void EventQueue::push(const Event& _event)
+	{
+		this->push(Event{ _event });
+	};
+
+	bool EventQueue::try_pop(Event& _out)
+	{
+		timestamp_type _pushedAt = 0;
+		if (this->pop_ring(_out, _pushedAt) || this->pop_overflow(_out, _pushedAt))
+		{
+			this->record_latency(_pushedAt);
+			return true;
+		}
+		else
+		{
+			return false;
+		};
+	};
+
+	EventQueue::size_type EventQueue::size_approx() const noexcept
+	{
+		const auto _enq = this->enqueue_pos_.load(std::memory_order_relaxed);
+		const auto _deq = this->dequeue_pos_.load(std::memory_order_relaxed);
+		const auto _ring = (_enq > _deq) ? _enq - _deq : 0;
+		return _ring + this->overflow_count_.load(std::memory_order_relaxed);
+	};
+	bool EventQueue::empty() const noexcept
+	{
+		return this->size_approx() == 0;
+	};
+
+	EventQueue::size_type EventQueue::capacity() const noexcept
+	{
+		return this->mask_ + 1;
+	};
+
+	EventQueue::OVERFLOW_POLICY EventQueue::policy() const noexcept
+	{
+		return this->policy_.load(std::memory_order_relaxed);
+	};
+	void EventQueue::set_policy(OVERFLOW_POLICY _policy) noexcept
+	{
+		this->policy_.store(_policy, std::memory_order_relaxed);
+	};
+
+	EventQueue::Stats EventQueue::stats() const noexcept
+	{
+		Stats _out{};
+		_out.pushed = this->pushed_.load(std::memory_order_relaxed);
+		_out.popped = this->popped_.load(std::memory_order_relaxed);
+		_out.dropped = this->dropped_.load(std::memory_order_relaxed);
+		_out.overflowed = this->overflowed_.load(std::memory_order_relaxed);
+		_out.blocked = this->blocked_.load(std::memory_order_relaxed);
+		_out.total_latency_ns = this->total_latency_ns_.load(std::memory_order_relaxed);
+		_out.max_latency_ns = this->max_latency_ns_.load(std::memory_order_relaxed);
+		return _out;
+	};
+	void EventQueue::reset_stats() noexcept
+	{
+		this->pushed_.store(0, std::memory_order_relaxed);
+		this->popped_.store(0, std::memory_order_relaxed);
+		this->dropped_.store(0, std::memory_order_relaxed);
+		this->overflowed_.store(0, std::memory_order_relaxed);
+		this->blocked_.store(0, std::memory_order_relaxed);
+		this->total_latency_ns_.store(0, std::memory_order_relaxed);
+		this->max_latency_ns_.store(0, std::memory_order_relaxed);
+	};
+
+	EventQueue::EventQueue(size_type _capacity, OVERFLOW_POLICY _policy) :
+		policy_{ _policy }
+	{
+		_capacity = std::bit_ceil(std::max<size_type>(_capacity, 2));
+		this->mask_ = _capacity - 1;
+		this->cells_ = std::make_unique<Cell[]>(_capacity);
+		for (size_type n = 0; n != _capacity; ++n)
+		{
+			this->cells_[n].sequence.store(n, std::memory_order_relaxed);
+		};
+	};
+
+
+	bool EventCoalescer::can_sum(EVENT_TYPE _type) noexcept
+	{
+		switch (_type)
+		{
+		case EVENT_TYPE::SCROLL_EVENT:
+		case EVENT_TYPE::GROW_EVENT:
+			return true;
+		default:
+			return false;
+		};
+	};
+
+	void EventCoalescer::set_mode(EVENT_TYPE _type, MODE _mode) noexcept
+	{
+		if (_mode == MODE::SUM && !can_sum(_type))
+		{
+			return;
+		};
+		this->modes_[(size_t)_type] = _mode;
+	};
+	EventCoalescer::MODE EventCoalescer::mode(EVENT_TYPE _type) const noexcept
+	{
+		return this->modes_[(size_t)_type];
+	};
+
+	bool EventCoalescer::fold(Event& _into, const Event& _event) const
+	{
+		if (_into.index() != _event.index() || _into.is_broadcast() != _event.is_broadcast())
+		{
+			return false;
+		};
+
+		switch (this->mode(_event.index()))
+		{
+		case MODE::KEEP_LAST:
+			_into = _event;
+			return true;
+
+		case MODE::SUM:
+			switch (_event.index())
+			{
+			case EVENT_TYPE::SCROLL_EVENT:
+			{
+				auto& _sum = _into.get<EVENT_TYPE::SCROLL_EVENT>();
+				const auto& _add = _event.get<EVENT_TYPE::SCROLL_EVENT>();
+				_sum.x += _add.x;
+				_sum.y += _add.y;
+			};
+				return true;
+			case EVENT_TYPE::GROW_EVENT:
+			{
+				auto& _sum = _into.get<EVENT_TYPE::GROW_EVENT>();
+				const auto& _add = _event.get<EVENT_TYPE::GROW_EVENT>();
+				_sum.dw += _add.dw;
+				_sum.dh += _add.dh;
+			};
+				return true;
+			default:
+				return false;
+			};
+
+		default:
+			return false;
+		};
+	};
+
+	void EventCoalescer::push(Event&& _event)
+	{
+		++this->stats_.received;
+		if (!this->pending_.empty() && this->fold(this->pending_.back(), _event))
+		{
+			++this->stats_.folded[(size_t)_event.index()];
+		}
+		else
+		{
+			this->pending_.push_back(std::move(_event));
+		};
+	};
+	void EventCoalescer::push(const Event& _event)
+	{
+		this->push(Event{ _event });
+	};
+
+	EventCoalescer::size_type EventCoalescer::pending() const noexcept
+	{
+		return this->pending_.size();
+	};
+
+	const EventCoalescer::Stats& EventCoalescer::stats() const noexcept
+	{
+		return this->stats_;
+	};
+	void EventCoalescer::reset_stats() noexcept
+	{
+		this->stats_ = Stats{};
+	};
+
+	EventCoalescer::EventCoalescer()
+	{
+		this->modes_.fill(MODE::NONE);
+		this->set_mode(EVENT_TYPE::CURSOR_MOVE, MODE::KEEP_LAST);
+		this->set_mode(EVENT_TYPE::SCROLL_EVENT, MODE::SUM);
+		this->set_mode(EVENT_TYPE::GROW_EVENT, MODE::SUM);
+	};
+
+
+	void EventWriter::put(uint8_t _byte)
+	{
+		if (this->buffer_.size() == this->capacity_)
+		{
+			this->flush();
+		};
+		this->buffer_.push_back(_byte);
+		++this->bytes_;
+	};
+	void EventWriter::put_bytes(const void* _data, size_type _count)
+	{
+		auto _bytes = (const uint8_t*)_data;
+		for (size_type n = 0; n != _count; ++n)
+		{
+			this->put(_bytes[n]);
+		};
+	};
+	void EventWriter::put_varint(uint64_t _value)
+	{
+		while (_value >= 0x80)
+		{
+			this->put((uint8_t)(_value | 0x80));
+			_value >>= 7;
+		};
+		this->put((uint8_t)_value);
+	};
+	void EventWriter::put_signed(int64_t _value)
+	{
+		// Zigzag so small negative values stay small
+		this->put_varint(((uint64_t)_value << 1) ^ (uint64_t)(_value >> 63));
+	};
+	void EventWriter::put_double(double _value)
+	{
+		const auto _bits = std::bit_cast<uint64_t>(_value);
+		for (int n = 0; n != 8; ++n)
+		{
+			this->put((uint8_t)(_bits >> (n * 8)));
+		};
+	};
+
+	void EventWriter::write(const Event& _event)
+	{
+		using EVENT_TYPE = Event::EVENT_TYPE;
+
+		const auto _type = _event.index();
+		this->put((uint8_t)((uint8_t)(EVENT_TYPE::EVENT_TYPE_E)_type | (_event.is_broadcast() ? 0x80 : 0x00)));
+
+		switch (_type)
+		{
+		case EVENT_TYPE::BLACKBOARD_CHANGE:
+		{
+			const auto& _ev = _event.get<EVENT_TYPE::BLACKBOARD_CHANGE>();
+			assert(_ev.key.size() <= MAX_STRING_SIZE);
+			this->put_varint(_ev.key.size());
+			this->put_bytes(_ev.key.data(), _ev.key.size());
+		};
+			break;
+		case EVENT_TYPE::CURSOR_WINDOW_BOUNDS:
+			this->put_varint((uint64_t)_event.get<EVENT_TYPE::CURSOR_WINDOW_BOUNDS>().action);
+			break;
+		case EVENT_TYPE::CURSOR_MOVE:
+		{
+			const auto& _ev = _event.get<EVENT_TYPE::CURSOR_MOVE>();
+			this->put_signed(_ev.cursor_x);
+			this->put_signed(_ev.cursor_y);
+		};
+			break;
+		case EVENT_TYPE::MOUSE_EVENT:
+		{
+			const auto& _ev = _event.get<EVENT_TYPE::MOUSE_EVENT>();
+			this->put_signed(_ev.button);
+			this->put_signed(_ev.action);
+			this->put_signed(_ev.mods);
+			this->put_signed(_ev.cursor_x);
+			this->put_signed(_ev.cursor_y);
+		};
+			break;
+		case EVENT_TYPE::KEY_EVENT:
+		{
+			const auto& _ev = _event.get<EVENT_TYPE::KEY_EVENT>();
+			this->put_signed(_ev.key);
+			this->put_signed(_ev.scancode);
+			this->put_signed(_ev.action);
+			this->put_signed(_ev.mods);
+		};
+			break;
+		case EVENT_TYPE::SCROLL_EVENT:
+		{
+			const auto& _ev = _event.get<EVENT_TYPE::SCROLL_EVENT>();
+			this->put_double(_ev.x);
+			this->put_double(_ev.y);
+		};
+			break;
+		case EVENT_TYPE::TEXT_EVENT:
+			this->put_varint(_event.get<EVENT_TYPE::TEXT_EVENT>().codepoint);
+			break;
+		case EVENT_TYPE::USER_EVENT:
+		{
+			const auto& _ev = _event.get<EVENT_TYPE::USER_EVENT>();
+			this->put_signed(_ev.ev);
+			this->put_signed(_ev.content);
+		};
+			break;
+		case EVENT_TYPE::GROW_EVENT:
+		{
+			const auto& _ev = _event.get<EVENT_TYPE::GROW_EVENT>();
+			this->put_signed(_ev.dw.count);
+			this->put_signed(_ev.dh.count);
+		};
+			break;
+		default:
+			// No payload
+			break;
+		};
+
+		++this->events_;
+	};
+
+	void EventWriter::flush()
+	{
+		if (!this->buffer_.empty())
+		{
+			this->ostr_->write((const char*)this->buffer_.data(), (std::streamsize)this->buffer_.size());
+			this->buffer_.clear();
+		};
+		this->ostr_->flush();
+	};
+
+	EventWriter::size_type EventWriter::events_written() const noexcept
+	{
+		return this->events_;
+	};
+	EventWriter::size_type EventWriter::bytes_written() const noexcept
+	{
+		return this->bytes_;
+	};
+
+	EventWriter::EventWriter(std::ostream& _ostr, size_type _bufferSize) :
+		ostr_{ &_ostr }, capacity_{ std::max<size_type>(_bufferSize, 16) }
+	{
+		this->buffer_.reserve(this->capacity_);
+		this->put_bytes(MAGIC.data(), MAGIC.size());
+		this->put(VERSION);
+	};
+
+	EventWriter::~EventWriter()
+	{
+		this->flush();
+	};
+
+
+
+	bool EventReader::fill()
+	{
+		// Keep any unread bytes and top the buffer back up from the stream
+		const auto _remaining = this->buffer_.size() - this->pos_;
+		std::copy(this->buffer_.begin() + this->pos_, this->buffer_.end(), this->buffer_.begin());
+		this->buffer_.resize(this->buffer_.capacity());
+		this->pos_ = 0;
+
+		this->istr_->read((char*)this->buffer_.data() + _remaining, (std::streamsize)(this->buffer_.size() - _remaining));
+		this->buffer_.resize(_remaining + (size_type)this->istr_->gcount());
+		return this->buffer_.size() != _remaining;
+	};
+	bool EventReader::get(uint8_t& _byte)
+	{
+		if (this->pos_ == this->buffer_.size() && !this->fill())
+		{
+			return false;
+		};
+		_byte = this->buffer_[this->pos_++];
+		return true;
+	};
+	bool EventReader::get_bytes(void* _data, size_type _count)
+	{
+		auto _bytes = (uint8_t*)_data;
+		for (size_type n = 0; n != _count; ++n)
+		{
+			if (!this->get(_bytes[n]))
+			{
+				return false;
+			};
+		};
+		return true;
+	};
+	bool EventReader::get_varint(uint64_t& _value)
+	{
+		_value = 0;
+		for (int _shift = 0; _shift < 64; _shift += 7)
+		{
+			uint8_t _byte = 0;
+			if (!this->get(_byte))
+			{
+				return false;
+			};
+			_value |= (uint64_t)(_byte & 0x7F) << _shift;
+			if ((_byte & 0x80) == 0)
+			{
+				return true;
+			};
+		};
+		return false;
+	};
+	bool EventReader::get_signed(int64_t& _value)
+	{
+		uint64_t _raw = 0;
+		if (!this->get_varint(_raw))
+		{
+			return false;
+		};
+		_value = (int64_t)(_raw >> 1) ^ -(int64_t)(_raw & 1);
+		return true;
+	};
+	bool EventReader::get_double(double& _value)
+	{
+		uint64_t _bits = 0;
+		for (int n = 0; n != 8; ++n)
+		{
+			uint8_t _byte = 0;
+			if (!this->get(_byte))
+			{
+				return false;
+			};
+			_bits |= (uint64_t)_byte << (n * 8);
+		};
+		_value = std::bit_cast<double>(_bits);
+		return true;
+	};
+
+	bool EventReader::read(Event& _out)
+	{
+		using EVENT_TYPE = Event::EVENT_TYPE;
+
+		if (!this->good_)
+		{
+			return false;
+		};
+
+		uint8_t _tag = 0;
+		if (!this->get(_tag))
+		{
+			// Clean end of the recording
+			return false;
+		};
+
+		const auto _typeIndex = (size_t)(_tag & 0x7F);
+		const bool _broadcast = (_tag & 0x80) != 0;
+		if (_typeIndex >= Event::TYPE_COUNT)
+		{
+			this->good_ = false;
+			return false;
+		};
+
+		bool _ok = true;
+		int64_t _a = 0;
+		int64_t _b = 0;
+		uint64_t _u = 0;
+
+		switch ((EVENT_TYPE::EVENT_TYPE_E)_typeIndex)
+		{
+		case EVENT_TYPE::NULL_EVENT:
+			_out = Event{ Event::evNull{}, _broadcast };
+			break;
+		case EVENT_TYPE::BLACKBOARD_CHANGE:
+		{
+			Event::evBlackboardChange _ev{};
+			_ok = this->get_varint(_u) && _u <= EventWriter::MAX_STRING_SIZE;
+			if (_ok)
+			{
+				_ev.key.resize((size_t)_u);
+				_ok = this->get_bytes(_ev.key.data(), _ev.key.size());
+			};
+			_out = Event{ std::move(_ev), _broadcast };
+		};
+			break;
+		case EVENT_TYPE::CURSOR_WINDOW_BOUNDS:
+		{
+			Event::evCursorWindowBounds _ev{};
+			_ok = this->get_varint(_u);
+			_ev.action = (Event::evCursorWindowBounds::CURSOR_ACTION)_u;
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::CURSOR_MOVE:
+		{
+			Event::evCursorMove _ev{};
+			_ok = this->get_signed(_a) && this->get_signed(_b);
+			_ev.cursor_x = (int16_t)_a;
+			_ev.cursor_y = (int16_t)_b;
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::MOUSE_EVENT:
+		{
+			Event::evMouse _ev{};
+			int64_t _c = 0;
+			_ok = this->get_signed(_a) && this->get_signed(_b) && this->get_signed(_c);
+			_ev.button = (int)_a;
+			_ev.action = (int)_b;
+			_ev.mods = (int)_c;
+			_ok = _ok && this->get_signed(_a) && this->get_signed(_b);
+			_ev.cursor_x = (int16_t)_a;
+			_ev.cursor_y = (int16_t)_b;
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::KEY_EVENT:
+		{
+			Event::evKey _ev{};
+			_ok = this->get_signed(_a) && this->get_signed(_b);
+			_ev.key = (int)_a;
+			_ev.scancode = (int)_b;
+			_ok = _ok && this->get_signed(_a) && this->get_signed(_b);
+			_ev.action = (int)_a;
+			_ev.mods = (int)_b;
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::SCROLL_EVENT:
+		{
+			Event::evScroll _ev{};
+			_ok = this->get_double(_ev.x) && this->get_double(_ev.y);
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::TEXT_EVENT:
+		{
+			Event::evText _ev{};
+			_ok = this->get_varint(_u);
+			_ev.codepoint = (unsigned)_u;
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::USER_EVENT:
+		{
+			Event::evUser _ev{};
+			_ok = this->get_signed(_a) && this->get_signed(_b);
+			_ev.ev = (int)_a;
+			_ev.content = (int)_b;
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::GROW_EVENT:
+		{
+			Event::evGrow _ev{};
+			_ok = this->get_signed(_a) && this->get_signed(_b);
+			_ev.dw = pixels_t{ (pixels_t::value_type)_a };
+			_ev.dh = pixels_t{ (pixels_t::value_type)_b };
+			_out = Event{ _ev, _broadcast };
+		};
+			break;
+		case EVENT_TYPE::REFRESH_EVENT:
+			_out = Event{ Event::evRefresh{}, _broadcast };
+			break;
+		case EVENT_TYPE::WINDOW_CLOSE:
+			_out = Event{ Event::evWindowClose{}, _broadcast };
+			break;
+		default:
+			_ok = false;
+			break;
+		};
+
+		if (!_ok)
+		{
+			this->good_ = false;
+			return false;
+		};
+
+		++this->events_;
+		return true;
+	};
+
+	bool EventReader::good() const noexcept
+	{
+		return this->good_;
+	};
+	EventReader::size_type EventReader::events_read() const noexcept
+	{
+		return this->events_;
+	};
+
+	EventReader::EventReader(std::istream& _istr, size_type _bufferSize) :
+		istr_{ &_istr }
+	{
+		this->buffer_.reserve(std::max<size_type>(_bufferSize, 16));
+
+		std::array<char, EventWriter::MAGIC.size()> _magic{};
+		uint8_t _version = 0;
+		this->good_ = this->get_bytes(_magic.data(), _magic.size()) && this->get(_version) &&
+			_magic == EventWriter::MAGIC && _version == EventWriter::VERSION;
+	};
+
+
+
+	void EventReplayer::Stats::record(int64_t _latencyNs) noexcept
+	{
+		this->dispatch_ns += _latencyNs;
+
+		size_type _bucket = 0;
+		while (_latencyNs > 1 && _bucket + 1 != BUCKETS)
+		{
+			_latencyNs >>= 1;
+			++_bucket;
+		};
+		++this->latency_histogram[_bucket];
+		++this->events;
+	};
+
+	double EventReplayer::Stats::events_per_second() const noexcept
+	{
+		return (this->total_ns != 0) ? (double)this->events * 1e9 / (double)this->total_ns : 0.0;
+	};
+
+	int64_t EventReplayer::Stats::percentile_ns(double _percentile) const noexcept
+	{
+		const auto _target = (size_type)((double)this->events * std::clamp(_percentile, 0.0, 100.0) / 100.0);
+		size_type _seen = 0;
+		for (size_type n = 0; n != BUCKETS; ++n)
+		{
+			_seen += this->latency_histogram[n];
+			if (_seen >= _target && _seen != 0)
+			{
+				return (int64_t)1 << (n + 1);
+			};
+		};
+		return 0;
+	};
+
+	bool EventReplayer::good() const noexcept
+	{
+		return this->reader_.good();
+	};
+
+	EventReplayer::EventReplayer(std::istream& _istr) :
+		reader_{ _istr }
+	{};
+
+}
@@ -0,0 +1,89 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Event.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+int main(int argc, char* argv[], char* envp[])
+{
+	using EVENT_TYPE = Event::EVENT_TYPE;
+
+	EventCoalescer _coalescer{};
+
+	// A frame's worth of input : a burst of cursor moves split by a click, then scrolls and resizes
+	for (int16_t n = 0; n != 20; ++n)
+	{
+		_coalescer.push(Event{ Event::evCursorMove{ n, (int16_t)(n * 2) }, true });
+	};
+	_coalescer.push(Event{ Event::evMouse{ 0, 1, 0, 19, 38 }, true });
+	for (int16_t n = 20; n != 30; ++n)
+	{
+		_coalescer.push(Event{ Event::evCursorMove{ n, (int16_t)(n * 2) }, true });
+	};
+	for (int n = 0; n != 8; ++n)
+	{
+		_coalescer.push(Event{ Event::evScroll{ 0.5, -1.0 } });
+	};
+	for (int n = 0; n != 5; ++n)
+	{
+		_coalescer.push(Event{ Event::evGrow{ 2_px, -1_px }, true });
+	};
+	_coalescer.push(Event{ Event::evKey{ 65, 0, 1, 0 } });
+	_coalescer.push(Event{ Event::evKey{ 65, 0, 0, 0 } });
+
+	std::vector<Event> _out{};
+	const auto _emitted = _coalescer.flush([&_out](Event& _ev) { _out.push_back(_ev); });
+	assert(_emitted == 7);
+	assert(_coalescer.pending() == 0);
+
+	assert(_out[0].index() == EVENT_TYPE{ EVENT_TYPE::CURSOR_MOVE });
+	assert(_out[0].get<EVENT_TYPE::CURSOR_MOVE>().cursor_x == 19);
+	assert(_out[1].index() == EVENT_TYPE{ EVENT_TYPE::MOUSE_EVENT });
+	assert(_out[2].get<EVENT_TYPE::CURSOR_MOVE>().cursor_x == 29);
+	assert(_out[2].get<EVENT_TYPE::CURSOR_MOVE>().cursor_y == 58);
+	assert(_out[3].get<EVENT_TYPE::SCROLL_EVENT>().x == 4.0);
+	assert(_out[3].get<EVENT_TYPE::SCROLL_EVENT>().y == -8.0);
+	assert(_out[4].get<EVENT_TYPE::GROW_EVENT>().dw == 10_px);
+	assert(_out[4].get<EVENT_TYPE::GROW_EVENT>().dh == -5_px);
+	assert(_out[4].is_broadcast());
+	assert(_out[5].index() == EVENT_TYPE{ EVENT_TYPE::KEY_EVENT });
+	assert(_out[6].index() == EVENT_TYPE{ EVENT_TYPE::KEY_EVENT });
+
+	const auto& _stats = _coalescer.stats();
+	assert(_stats.received == 46);
+	assert(_stats.emitted == 7);
+	assert(_stats.folded[EVENT_TYPE::CURSOR_MOVE] == 28);
+	assert(_stats.folded[EVENT_TYPE::SCROLL_EVENT] == 7);
+	assert(_stats.folded[EVENT_TYPE::GROW_EVENT] == 4);
+	assert(_stats.total_folded() == _stats.received - _stats.emitted);
+
+	// Turning folding off for a type passes every event through, SUM is refused for types without deltas
+	_coalescer.set_mode(EVENT_TYPE::CURSOR_MOVE, EventCoalescer::MODE::NONE);
+	_coalescer.set_mode(EVENT_TYPE::KEY_EVENT, EventCoalescer::MODE::SUM);
+	assert(_coalescer.mode(EVENT_TYPE::KEY_EVENT) == EventCoalescer::MODE::NONE);
+	for (int16_t n = 0; n != 3; ++n)
+	{
+		_coalescer.push(Event{ Event::evCursorMove{ n, n }, true });
+	};
+	assert(_coalescer.flush([](Event&) {}) == 3);
+
+	std::cout << _stats.received << " events in, " << _stats.emitted << " out, " << _stats.total_folded() << " folded\n";
+	return GOOD_TEST;
+};
@@ -0,0 +1,165 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Event.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Pushes user events tagged with a producer id and sequence number from several threads while the main thread drains.
+	Checks that each producer's events arrive in order and that the counters add up for each overflow policy.
+*/
+
+constexpr static inline int PRODUCERS = 4;
+constexpr static inline int EVENTS_PER_PRODUCER = 200000;
+
+static const char* policy_name(EventQueue::OVERFLOW_POLICY _policy)
+{
+	switch (_policy)
+	{
+	case EventQueue::OVERFLOW_POLICY::DROP_OLDEST:
+		return "drop oldest";
+	case EventQueue::OVERFLOW_POLICY::BLOCK:
+		return "block";
+	case EventQueue::OVERFLOW_POLICY::GROW:
+		return "grow";
+	default:
+		return "?";
+	};
+};
+
+static int run(EventQueue::OVERFLOW_POLICY _policy, size_t _capacity)
+{
+	EventQueue _queue{ _capacity, _policy };
+
+	std::vector<int> _next(PRODUCERS, 0);
+	size_t _received = 0;
+	bool _inOrder = true;
+	auto _consume = [&](const Event& _ev)
+	{
+		auto& _user = _ev.get<Event::EVENT_TYPE::USER_EVENT>();
+		// Dropped events leave gaps, but a producer's events must never arrive out of order
+		if (_user.content < _next[_user.ev])
+		{
+			_inOrder = false;
+		};
+		_next[_user.ev] = _user.content + 1;
+		++_received;
+	};
+
+	const auto _start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> _producers{};
+	std::atomic<int> _finished{ 0 };
+	for (int p = 0; p != PRODUCERS; ++p)
+	{
+		_producers.push_back(std::thread{ [&_queue, &_finished, p]()
+			{
+				for (int n = 0; n != EVENTS_PER_PRODUCER; ++n)
+				{
+					Event::evUser _user{};
+					_user.ev = p;
+					_user.content = n;
+					_queue.push(Event{ _user });
+				};
+				++_finished;
+			} });
+	};
+
+	while (_finished.load() != PRODUCERS || !_queue.empty())
+	{
+		_queue.drain(_consume);
+	};
+	for (auto& t : _producers)
+	{
+		t.join();
+	};
+	_queue.drain(_consume);
+
+	const auto _seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+	const auto _stats = _queue.stats();
+
+	std::cout << policy_name(_policy) << " (capacity " << _queue.capacity() << ") : " << (double)_stats.popped / _seconds << " events/s, "
+		<< "mean latency " << _stats.mean_latency_ns() << " ns, max latency " << _stats.max_latency_ns << " ns, "
+		<< _stats.dropped << " dropped, " << _stats.overflowed << " overflowed, " << _stats.blocked << " blocked\n";
+
+	if (!_inOrder)
+	{
+		std::cout << "events from a producer arrived out of order\n";
+		return 1;
+	};
+	if (_stats.pushed != (size_t)PRODUCERS * EVENTS_PER_PRODUCER || _stats.popped != _received || _stats.pushed != _stats.popped + _stats.dropped)
+	{
+		std::cout << "counters do not add up\n";
+		return 1;
+	};
+	if (_policy != EventQueue::OVERFLOW_POLICY::DROP_OLDEST && _stats.dropped != 0)
+	{
+		std::cout << "events were dropped\n";
+		return 1;
+	};
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	// Single threaded behaviour of a small queue
+	{
+		EventQueue _queue{ 3 };
+		assert(_queue.capacity() == 4);
+		for (int n = 0; n != 6; ++n)
+		{
+			_queue.push(Event{ Event::evUser{ n, n } });
+		};
+
+		// The two oldest events were dropped to make room
+		Event _ev{};
+		assert(_queue.try_pop(_ev));
+		assert(_ev.get<Event::EVENT_TYPE::USER_EVENT>().content == 2);
+		assert(_queue.stats().dropped == 2);
+		assert(_queue.size_approx() == 3);
+
+		_queue.set_policy(EventQueue::OVERFLOW_POLICY::GROW);
+		for (int n = 6; n != 10; ++n)
+		{
+			_queue.push(Event{ Event::evUser{ n, n } });
+		};
+		assert(_queue.stats().overflowed == 3);
+
+		int _expected = 3;
+		_queue.drain([&_expected](const Event& _ev)
+			{
+				assert(_ev.get<Event::EVENT_TYPE::USER_EVENT>().content == _expected);
+				++_expected;
+			});
+		assert(_expected == 10);
+		assert(_queue.empty());
+	};
+
+	for (auto _policy : { EventQueue::OVERFLOW_POLICY::DROP_OLDEST, EventQueue::OVERFLOW_POLICY::BLOCK, EventQueue::OVERFLOW_POLICY::GROW })
+	{
+		if (auto _res = run(_policy, 1024); _res != GOOD_TEST)
+		{
+			return _res;
+		};
+	};
+	return GOOD_TEST;
+};
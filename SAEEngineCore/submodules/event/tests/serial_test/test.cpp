@@ -16,16 +16,161 @@ constexpr static inline int GOOD_TEST = 0;
 
 #include <SAEEngineCore_Event.h>
 
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
 
+using namespace sae::engine::core;
 
+/*
+	Round trips every event type through the binary recording format, then records a long synthetic session to a file and
+	replays it into a counting handler to report throughput and the dispatch latency histogram.
+*/
+
+static std::vector<Event> every_event_type()
+{
+	std::vector<Event> _out{};
+	_out.push_back(Event{});
+	_out.push_back(Event{ Event::evBlackboardChange{ "player.health" }, true });
+	_out.push_back(Event{ Event::evBlackboardChange{ "" } });
+	_out.push_back(Event{ Event::evCursorWindowBounds{ Event::evCursorWindowBounds::EXIT } });
+	_out.push_back(Event{ Event::evCursorMove{ -12, 1080 }, true });
+	_out.push_back(Event{ Event::evMouse{ 1, 1, 6, 400, 300 }, true });
+	_out.push_back(Event{ Event::evKey{ 256, 9, 2, 1 } });
+	_out.push_back(Event{ Event::evScroll{ -0.25, 3.5 } });
+	_out.push_back(Event{ Event::evText{ 0x1F600 } });
+	_out.push_back(Event{ Event::evUser{ -7, 1 << 30 } });
+	_out.push_back(Event{ Event::evGrow{ -32_px, 200_px }, true });
+	_out.push_back(Event{ Event::evRefresh{} });
+	_out.push_back(Event{ Event::evWindowClose{}, true });
+	return _out;
+};
+
+static std::string serialize(const std::vector<Event>& _events)
+{
+	std::ostringstream _ostr{ std::ios::binary };
+	{
+		EventWriter _writer{ _ostr, 16 };
+		for (auto& e : _events)
+		{
+			_writer.write(e);
+		};
+	};
+	return _ostr.str();
+};
 
 int main(int argc, char* argv[], char* envp[])
 {
+	using EVENT_TYPE = Event::EVENT_TYPE;
+
+	// Round trip
+	{
+		const auto _events = every_event_type();
+		const auto _bytes = serialize(_events);
+
+		std::istringstream _istr{ _bytes, std::ios::binary };
+		EventReader _reader{ _istr, 16 };
+		std::vector<Event> _read{};
+		Event _ev{};
+		while (_reader.read(_ev))
+		{
+			_read.push_back(_ev);
+		};
+		assert(_reader.good());
+		assert(_read.size() == _events.size());
+		for (size_t n = 0; n != _read.size(); ++n)
+		{
+			assert(_read[n].index() == _events[n].index());
+			assert(_read[n].is_broadcast() == _events[n].is_broadcast());
+		};
+
+		// Writing what was read gives the same bytes, so every field survived
+		assert(serialize(_read) == _bytes);
+		assert(_read[1].get<EVENT_TYPE::BLACKBOARD_CHANGE>().key == "player.health");
+		assert(_read[4].get<EVENT_TYPE::CURSOR_MOVE>().cursor_x == -12);
+		assert(_read[7].get<EVENT_TYPE::SCROLL_EVENT>().x == -0.25);
+		assert(_read[10].get<EVENT_TYPE::GROW_EVENT>().dw == -32_px);
+
+		// Truncated and foreign streams are rejected
+		std::istringstream _truncated{ _bytes.substr(0, _bytes.size() - 3), std::ios::binary };
+		EventReader _truncatedReader{ _truncated };
+		while (_truncatedReader.read(_ev)) {};
+		assert(!_truncatedReader.good());
+
+		std::istringstream _foreign{ std::string{ "not a recording" }, std::ios::binary };
+		EventReader _foreignReader{ _foreign };
+		assert(!_foreignReader.good());
+		assert(!_foreignReader.read(_ev));
 
+		// A string length far beyond anything written is rejected instead of allocated
+		std::string _damaged{ EventWriter::MAGIC.begin(), EventWriter::MAGIC.end() };
+		_damaged += (char)EventWriter::VERSION;
+		_damaged += (char)EVENT_TYPE::BLACKBOARD_CHANGE;
+		_damaged += "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x7F" "abc";
+		std::istringstream _damagedStream{ _damaged, std::ios::binary };
+		EventReader _damagedReader{ _damagedStream };
+		assert(!_damagedReader.read(_ev));
+		assert(!_damagedReader.good());
+	};
 
+	// Record a synthetic input session to a file and replay it
+	{
+		const auto _path = std::filesystem::temp_directory_path() / "SAEEngineCore_Event_SerialTest.saev";
+		constexpr size_t _count = 500000;
+		size_t _bytes = 0;
+		{
+			std::ofstream _file{ _path, std::ios::binary };
+			EventWriter _writer{ _file };
+			for (size_t n = 0; n != _count; ++n)
+			{
+				switch (n % 10)
+				{
+				case 0:
+					_writer.write(Event{ Event::evMouse{ 0, (int)(n / 10) % 2, 0, (int16_t)(n % 1600), (int16_t)(n % 900) }, true });
+					break;
+				case 1:
+					_writer.write(Event{ Event::evScroll{ 0.0, 1.0 } });
+					break;
+				case 2:
+					_writer.write(Event{ Event::evKey{ (int)(65 + n % 26), 0, 1, 0 } });
+					break;
+				default:
+					_writer.write(Event{ Event::evCursorMove{ (int16_t)(n % 1600), (int16_t)(n % 900) }, true });
+					break;
+				};
+			};
+			_writer.flush();
+			_bytes = _writer.bytes_written();
+			assert(_writer.events_written() == _count);
+		};
 
+		std::ifstream _file{ _path, std::ios::binary };
+		EventReplayer _replayer{ _file };
+		size_t _seen = 0;
+		const auto _stats = _replayer.replay([&_seen](Event& _ev)
+			{
+				_seen += (size_t)(EVENT_TYPE::EVENT_TYPE_E)_ev.index();
+			});
+		_file.close();
+		std::filesystem::remove(_path);
 
+		assert(_replayer.good());
+		assert(_stats.events == _count);
+		assert(_seen != 0);
 
+		std::cout << _count << " events, " << (double)_bytes / (double)_count << " bytes/event, "
+			<< _stats.events_per_second() << " events/s, p50 " << _stats.percentile_ns(50.0) << " ns, p99 "
+			<< _stats.percentile_ns(99.0) << " ns\n";
+		for (size_t n = 0; n != _stats.BUCKETS; ++n)
+		{
+			if (_stats.latency_histogram[n] != 0)
+			{
+				std::cout << "  [" << ((int64_t)1 << n) << ", " << ((int64_t)1 << (n + 1)) << ") ns : " << _stats.latency_histogram[n] << '\n';
+			};
+		};
+	};
 
 	return GOOD_TEST;
-};
\ No newline at end of file
+};
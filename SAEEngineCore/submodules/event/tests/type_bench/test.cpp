@@ -0,0 +1,113 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_EventType.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Checks the generated EVENT_TYPE string conversions and times them against the runtime string map they replaced.
+*/
+
+// Both conversions work in constant expressions
+static_assert(EVENT_TYPE{ EVENT_TYPE::CURSOR_MOVE }.to_string() == "CURSOR_MOVE");
+static_assert(EVENT_TYPE::from_string("WINDOW_CLOSE").value() == EVENT_TYPE::WINDOW_CLOSE);
+static_assert(!EVENT_TYPE::from_string("NOT_AN_EVENT"));
+static_assert(!EVENT_TYPE::from_string(""));
+
+constexpr static inline size_t LOOKUPS = 1000000;
+
+template <typename FuncT>
+static double time_ns(FuncT&& _fn)
+{
+	const auto _start = std::chrono::steady_clock::now();
+	_fn();
+	const auto _end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(_end - _start).count() / (double)LOOKUPS;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	// The map the old generator emitted, rebuilt here with standard containers
+	std::unordered_map<std::string, EVENT_TYPE::EVENT_TYPE_E> _ltor{};
+	std::unordered_map<EVENT_TYPE::EVENT_TYPE_E, std::string> _rtol{};
+
+	std::vector<std::string> _names{};
+	for (size_t n = 0; n != EVENT_TYPE::COUNT; ++n)
+	{
+		const EVENT_TYPE _type{ (EVENT_TYPE::EVENT_TYPE_E)n };
+		const auto _name = _type.to_string();
+		assert(!_name.empty());
+
+		// Every name round trips and near misses are rejected
+		assert(EVENT_TYPE::from_string(_name).value() == (EVENT_TYPE::EVENT_TYPE_E)_type);
+		assert(!EVENT_TYPE::from_string(std::string{ _name } + "_"));
+		assert(!EVENT_TYPE::from_string(_name.substr(1)));
+
+		_names.push_back(std::string{ _name });
+		_ltor.insert({ std::string{ _name }, _type });
+		_rtol.insert({ _type, std::string{ _name } });
+	};
+
+	// Cycle through the inputs without a division in the timed loops
+	std::vector<size_t> _order(LOOKUPS);
+	for (size_t n = 0; n != LOOKUPS; ++n)
+	{
+		_order[n] = (n * 7) % EVENT_TYPE::COUNT;
+	};
+
+	size_t _sink = 0;
+	const auto _mapFrom = time_ns([&]()
+		{
+			for (size_t n = 0; n != LOOKUPS; ++n)
+			{
+				_sink += _ltor.at(_names[_order[n]]);
+			};
+		});
+	const auto _tableFrom = time_ns([&]()
+		{
+			for (size_t n = 0; n != LOOKUPS; ++n)
+			{
+				_sink += *EVENT_TYPE::from_string(_names[_order[n]]);
+			};
+		});
+	const auto _mapTo = time_ns([&]()
+		{
+			for (size_t n = 0; n != LOOKUPS; ++n)
+			{
+				_sink += _rtol.at((EVENT_TYPE::EVENT_TYPE_E)_order[n]).size();
+			};
+		});
+	const auto _tableTo = time_ns([&]()
+		{
+			for (size_t n = 0; n != LOOKUPS; ++n)
+			{
+				_sink += EVENT_TYPE{ (EVENT_TYPE::EVENT_TYPE_E)_order[n] }.to_string().size();
+			};
+		});
+
+	std::cout << "from_string : map " << _mapFrom << " ns, table " << _tableFrom << " ns\n"
+		<< "to_string : map " << _mapTo << " ns, table " << _tableTo << " ns\n"
+		<< "(" << _sink << ")\n";
+
+	return GOOD_TEST;
+};
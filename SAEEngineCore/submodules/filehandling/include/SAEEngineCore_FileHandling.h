@@ -3,11 +3,18 @@
 #include "../../error/Error.h"
 #include <SAEEngineCore_Logging.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <optional>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
 #include <string>
 #include <istream>
+#include <system_error>
 #include <variant>
 
 #ifdef SAE_ENGINE_CORE_USE_EXCEPTIONS
@@ -171,6 +178,141 @@ namespace sae::engine::core
 	};
 
 
+	/**
+	 * @brief Read only view of a whole file mapped into memory, unmapped when destroyed.
+	 *
+	 * Pages are read in by the OS as they are first touched instead of being copied through a buffer, which makes this
+	 * the cheaper way to load large assets that are parsed or uploaded straight from the file contents.
+	*/
+	class MappedFile
+	{
+	public:
+		/**
+		 * @brief Returns true if the file was mapped, an empty file is good with no data
+		*/
+		bool good() const noexcept { return this->good_; };
+		explicit operator bool() const noexcept { return this->good(); };
+
+		std::span<const std::byte> data() const noexcept
+		{
+			return std::span<const std::byte>{ this->data_, this->size_ };
+		};
+		size_t size() const noexcept { return this->size_; };
+
+		/**
+		 * @brief Unmaps the file, data() is empty afterwards
+		*/
+		void close() noexcept;
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		/**
+		 * @brief Maps the file at _path, check good() for success
+		*/
+		explicit MappedFile(const std::filesystem::path& _path);
+		MappedFile() = default;
+		~MappedFile();
+
+	private:
+		const std::byte* data_ = nullptr;
+		size_t size_ = 0;
+		bool good_ = false;
+
+#ifdef _WIN32
+		// File and file mapping HANDLEs
+		void* file_ = nullptr;
+		void* mapping_ = nullptr;
+#endif
+	};
+
+	/**
+	 * @brief Reads the whole file in binary mode. The contents are copied out of a MappedFile when the file can be mapped,
+	 * otherwise they are read with a single read sized from the file. Use MappedFile directly to avoid the copy.
+	*/
 	std::optional<std::vector<unsigned char>> OpenFile(std::filesystem::path _filename);
+
+	/**
+	 * @brief Loads files in the background so startup I/O can overlap other work such as shader compilation.
+	 *
+	 * On Linux the reads of a whole batch are queued to the kernel at once through io_uring, elsewhere or when io_uring
+	 * is unavailable a pool of threads reads the files with pread. Each file completes its future or callback as soon as
+	 * it has been read, callbacks run on a loader thread so they should hand the data off rather than process it.
+	*/
+	class AsyncFileLoader
+	{
+	public:
+		enum class BACKEND : uint8_t
+		{
+			IO_URING,
+			THREAD_POOL,
+		};
+
+		struct Result
+		{
+			std::filesystem::path path{};
+			std::vector<unsigned char> data{};
+
+			// Set if the file could not be opened or read, data is empty then
+			std::error_code error{};
+
+			bool good() const noexcept { return !this->error; };
+		};
+
+		using callback_type = std::function<void(Result&& _result)>;
+
+		/**
+		 * @brief Backend in use, THREAD_POOL if IO_URING was asked for but is not available
+		*/
+		BACKEND backend() const noexcept;
+
+		std::future<Result> load(std::filesystem::path _path);
+
+		/**
+		 * @brief Queues every file of the batch at once
+		 * @return One future per path, in the same order
+		*/
+		std::vector<std::future<Result>> load(std::span<const std::filesystem::path> _paths);
+
+		/**
+		 * @brief Queues every file of the batch at once, _callback is called once per file in completion order
+		*/
+		void load(std::span<const std::filesystem::path> _paths, callback_type _callback);
+
+		/**
+		 * @brief Number of files queued or being read
+		*/
+		size_t pending() const noexcept;
+
+		/**
+		 * @brief Blocks until every file queued so far has completed
+		*/
+		void wait();
+
+		AsyncFileLoader(const AsyncFileLoader& other) = delete;
+		AsyncFileLoader& operator=(const AsyncFileLoader& other) = delete;
+
+		/**
+		 * @param _backend Preferred backend
+		 * @param _threads Thread pool size, 0 for the hardware concurrency
+		 * @param _queueDepth Reads kept in flight by the io_uring backend
+		*/
+		explicit AsyncFileLoader(BACKEND _backend = BACKEND::IO_URING, size_t _threads = 0, uint32_t _queueDepth = 64);
+
+		/**
+		 * @brief Finishes every queued file before returning
+		*/
+		~AsyncFileLoader();
+
+	private:
+		class Backend;
+		class ThreadPool;
+		class IoUring;
+
+		std::unique_ptr<Backend> backend_;
+	};
 	std::optional<std::string> GetFileType(std::filesystem::path _filename);
 }
@@ -4,6 +4,32 @@
 #include <unordered_map>
 #include <filesystem>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define SAE_ENGINE_CORE_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
 
 namespace sae::engine::core
 {
@@ -110,29 +136,50 @@ namespace sae::engine::core
 	 */
 	std::optional<std::vector<unsigned char>> OpenFile(std::filesystem::path _filename)
 	{
-
-		std::ifstream _file(_filename.native());
-
-		if (_file.is_open())
+		// Copying out of a mapping skips the stream's buffer. Only regular files are mapped, opening a pipe twice could lose
+		// its writer. Files that fail to map or map empty, which includes some that only report their size once read, go
+		// through the single read below instead.
+		std::error_code _ec{};
+		if (std::filesystem::is_regular_file(_filename, _ec))
 		{
-			
-			std::vector<unsigned char> _out {};
-			unsigned char _readbuffer[512] {};
-			while(!_file.eof())
+			if (MappedFile _mapped{ _filename }; _mapped.good() && _mapped.size() != 0)
 			{
+				const auto _data = (const unsigned char*)_mapped.data().data();
+				return std::vector<unsigned char>(_data, _data + _mapped.size());
+			};
+		};
 
+		std::ifstream _file(_filename.native(), std::ios::binary);
+		if (!_file.is_open())
+		{
+			return std::nullopt;
+		};
 
-				_file.read((char*)_readbuffer,sizeof(_readbuffer));
-				_out.insert(_out.end(), _readbuffer, _readbuffer + _file.gcount());
-
-
-			}
-			return _out;
-
-		}
+		// Size from the open file rather than the path, -1 if it can't seek
+		_file.seekg(0, std::ios::end);
+		const auto _size = (std::streamoff)_file.tellg();
+		_file.seekg(0, std::ios::beg);
 
-		return std::nullopt;
+		std::vector<unsigned char> _out{};
+		if (_size >= 0)
+		{
+			_out.resize((size_t)_size);
+			_file.read((char*)_out.data(), (std::streamsize)_out.size());
+			if (_file.gcount() == (std::streamsize)_out.size())
+			{
+				return _out;
+			};
+			_out.resize((size_t)_file.gcount());
+		};
 
+		// Not seekable, or it shrank since its size was read
+		unsigned char _readbuffer[64 * 1024]{};
+		_file.clear();
+		while (_file.read((char*)_readbuffer, sizeof(_readbuffer)) || _file.gcount() != 0)
+		{
+			_out.insert(_out.end(), _readbuffer, _readbuffer + _file.gcount());
+		};
+		return _out;
 	}
 
 	/**
@@ -153,6 +200,135 @@ namespace sae::engine::core
 		 return std::nullopt;
 	}
 
+	MappedFile::MappedFile(const std::filesystem::path& _path)
+	{
+#ifdef _WIN32
+		const auto _file = CreateFileW(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (_file == INVALID_HANDLE_VALUE)
+		{
+			return;
+		};
+		this->file_ = _file;
+
+		LARGE_INTEGER _size{};
+		if (!GetFileSizeEx(_file, &_size))
+		{
+			this->close();
+			return;
+		};
+		if (_size.QuadPart == 0)
+		{
+			// Empty files can't be mapped
+			this->good_ = true;
+			return;
+		};
+
+		this->mapping_ = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!this->mapping_)
+		{
+			this->close();
+			return;
+		};
+		const auto _view = MapViewOfFile(this->mapping_, FILE_MAP_READ, 0, 0, 0);
+		if (!_view)
+		{
+			this->close();
+			return;
+		};
+		this->data_ = static_cast<const std::byte*>(_view);
+		this->size_ = (size_t)_size.QuadPart;
+		this->good_ = true;
+#else
+		const auto _fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (_fd < 0)
+		{
+			return;
+		};
+
+		struct stat _stat {};
+		if (::fstat(_fd, &_stat) != 0 || !S_ISREG(_stat.st_mode))
+		{
+			::close(_fd);
+			return;
+		};
+		if (_stat.st_size != 0)
+		{
+			const auto _view = ::mmap(nullptr, (size_t)_stat.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+			if (_view == MAP_FAILED)
+			{
+				::close(_fd);
+				return;
+			};
+			::madvise(_view, (size_t)_stat.st_size, MADV_SEQUENTIAL);
+			this->data_ = static_cast<const std::byte*>(_view);
+			this->size_ = (size_t)_stat.st_size;
+		};
+
+		// The mapping keeps the file alive
+		::close(_fd);
+		this->good_ = true;
+#endif
+	};
+
+	void MappedFile::close() noexcept
+	{
+#ifdef _WIN32
+		if (this->data_)
+		{
+			UnmapViewOfFile(this->data_);
+		};
+		if (this->mapping_)
+		{
+			CloseHandle(this->mapping_);
+		};
+		if (this->file_)
+		{
+			CloseHandle(this->file_);
+		};
+		this->mapping_ = nullptr;
+		this->file_ = nullptr;
+#else
+		if (this->data_)
+		{
+			::munmap(const_cast<std::byte*>(this->data_), this->size_);
+		};
+#endif
+		this->data_ = nullptr;
+		this->size_ = 0;
+		this->good_ = false;
+	};
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept :
+		data_{ std::exchange(other.data_, nullptr) },
+		size_{ std::exchange(other.size_, 0) },
+		good_{ std::exchange(other.good_, false) }
+#ifdef _WIN32
+		, file_{ std::exchange(other.file_, nullptr) },
+		mapping_{ std::exchange(other.mapping_, nullptr) }
+#endif
+	{};
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			this->close();
+			this->data_ = std::exchange(other.data_, nullptr);
+			this->size_ = std::exchange(other.size_, 0);
+			this->good_ = std::exchange(other.good_, false);
+#ifdef _WIN32
+			this->file_ = std::exchange(other.file_, nullptr);
+			this->mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+		};
+		return *this;
+	};
+
+	MappedFile::~MappedFile()
+	{
+		this->close();
+	};
+
 	FileIO::FileIO(const char* _path) :
 		path_(_path)
 	{
@@ -164,7 +340,7 @@ namespace sae::engine::core
 		std::fstream s(_filename);
 		if (!s.is_open())
 		{
-			core::lout << "file: " << _filename << " could not be found\n";
+			SAE_LOG(FILEHANDLING, WARN) << "file: " << _filename << " could not be found\n";
 			return;
 		}
 		s << _data;
@@ -176,4 +352,657 @@ namespace sae::engine::core
 		s.open(_filename);
 	}
 
+	namespace
+	{
+		/**
+		 * @brief One file queued on an AsyncFileLoader
+		*/
+		struct LoadRequest
+		{
+			AsyncFileLoader::Result result{};
+			std::promise<AsyncFileLoader::Result> promise{};
+
+			// Shared by every request of a callback batch, used instead of promise when set
+			std::shared_ptr<AsyncFileLoader::callback_type> callback{};
+
+			// Read state, file descriptor and bytes read so far
+			int fd = -1;
+			size_t done = 0;
+#ifdef SAE_ENGINE_CORE_HAS_IO_URING
+			iovec iov{};
+#endif
+		};
+
+		std::error_code last_error() noexcept
+		{
+			return std::error_code{ errno, std::system_category() };
+		};
+
+#ifndef _WIN32
+		/**
+		 * @brief Opens the request's file and sizes its buffer
+		 * @return False if it could not be opened, the error is set on the result
+		*/
+		bool open_request(LoadRequest& _request)
+		{
+			_request.fd = ::open(_request.result.path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (_request.fd < 0)
+			{
+				_request.result.error = last_error();
+				return false;
+			};
+
+			struct stat _stat {};
+			if (::fstat(_request.fd, &_stat) != 0)
+			{
+				_request.result.error = last_error();
+				return false;
+			};
+			if (!S_ISREG(_stat.st_mode))
+			{
+				_request.result.error = std::make_error_code(std::errc::invalid_argument);
+				return false;
+			};
+			_request.result.data.resize((size_t)_stat.st_size);
+			return true;
+		};
+
+		/**
+		 * @brief Reads the rest of an opened request's file with pread, from the offset it has reached so far
+		*/
+		void read_rest(LoadRequest& _request)
+		{
+			auto& _data = _request.result.data;
+			while (_request.done != _data.size())
+			{
+				const auto _read = ::pread(_request.fd, _data.data() + _request.done, _data.size() - _request.done,
+					(off_t)_request.done);
+				if (_read < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					};
+					_request.result.error = last_error();
+					return;
+				};
+				if (_read == 0)
+				{
+					// Shrank since it was opened
+					_data.resize(_request.done);
+					return;
+				};
+				_request.done += (size_t)_read;
+			};
+		};
+#endif
+	}
+
+	/**
+	 * @brief Request queue shared by both backends, the backends only differ in how they read
+	*/
+	class AsyncFileLoader::Backend
+	{
+	public:
+		virtual AsyncFileLoader::BACKEND type() const noexcept = 0;
+
+		void submit(std::vector<std::unique_ptr<LoadRequest>>& _batch)
+		{
+			{
+				std::scoped_lock _lck{ this->mtx_ };
+				this->pending_ += _batch.size();
+				for (auto& r : _batch)
+				{
+					this->queue_.push_back(std::move(r));
+				};
+			};
+			this->work_.notify_all();
+		};
+
+		size_t pending() const noexcept
+		{
+			std::scoped_lock _lck{ this->mtx_ };
+			return this->pending_;
+		};
+
+		void wait()
+		{
+			std::unique_lock _lck{ this->mtx_ };
+			this->idle_.wait(_lck, [this]() { return this->pending_ == 0; });
+		};
+
+		virtual ~Backend() = default;
+
+	protected:
+		/**
+		 * @brief Blocks until there is a request or stop() was called with nothing left
+		 * @return nullptr once stopped and empty
+		*/
+		std::unique_ptr<LoadRequest> take(bool _block)
+		{
+			std::unique_lock _lck{ this->mtx_ };
+			if (_block)
+			{
+				this->work_.wait(_lck, [this]() { return this->stop_ || !this->queue_.empty(); });
+			};
+			if (this->queue_.empty())
+			{
+				return nullptr;
+			};
+			auto _out = std::move(this->queue_.front());
+			this->queue_.pop_front();
+			return _out;
+		};
+
+		bool stopping() const
+		{
+			std::scoped_lock _lck{ this->mtx_ };
+			return this->stop_;
+		};
+
+		void stop()
+		{
+			{
+				std::scoped_lock _lck{ this->mtx_ };
+				this->stop_ = true;
+			};
+			this->work_.notify_all();
+		};
+
+		/**
+		 * @brief Closes the file and hands the result to its future or callback
+		*/
+		void finish(std::unique_ptr<LoadRequest> _request)
+		{
+#ifndef _WIN32
+			if (_request->fd >= 0)
+			{
+				::close(_request->fd);
+				_request->fd = -1;
+			};
+#endif
+			if (_request->result.error)
+			{
+				_request->result.data.clear();
+			};
+			if (_request->callback)
+			{
+				(*_request->callback)(std::move(_request->result));
+			}
+			else
+			{
+				_request->promise.set_value(std::move(_request->result));
+			};
+
+			{
+				std::scoped_lock _lck{ this->mtx_ };
+				--this->pending_;
+				if (this->pending_ != 0)
+				{
+					return;
+				};
+			};
+			this->idle_.notify_all();
+		};
+
+	private:
+		mutable std::mutex mtx_{};
+		std::condition_variable work_{};
+		std::condition_variable idle_{};
+		std::deque<std::unique_ptr<LoadRequest>> queue_{};
+		size_t pending_ = 0;
+		bool stop_ = false;
+	};
+
+	/**
+	 * @brief Each thread reads one whole file at a time with pread
+	*/
+	class AsyncFileLoader::ThreadPool : public AsyncFileLoader::Backend
+	{
+	public:
+		AsyncFileLoader::BACKEND type() const noexcept override
+		{
+			return AsyncFileLoader::BACKEND::THREAD_POOL;
+		};
+
+		explicit ThreadPool(size_t _threads)
+		{
+			if (_threads == 0)
+			{
+				_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+			};
+			for (size_t n = 0; n != _threads; ++n)
+			{
+				this->threads_.emplace_back([this]() { this->run(); });
+			};
+		};
+		~ThreadPool()
+		{
+			this->stop();
+			for (auto& t : this->threads_)
+			{
+				t.join();
+			};
+		};
+
+	private:
+		void run()
+		{
+			while (auto _request = this->take(true))
+			{
+				this->read(*_request);
+				this->finish(std::move(_request));
+			};
+		};
+
+		void read(LoadRequest& _request)
+		{
+#ifdef _WIN32
+			auto _data = OpenFile(_request.result.path);
+			if (_data)
+			{
+				_request.result.data = std::move(*_data);
+			}
+			else
+			{
+				_request.result.error = std::make_error_code(std::errc::no_such_file_or_directory);
+			};
+#else
+			if (open_request(_request))
+			{
+				read_rest(_request);
+			};
+#endif
+		};
+
+		std::vector<std::thread> threads_{};
+	};
+
+#ifdef SAE_ENGINE_CORE_HAS_IO_URING
+	/**
+	 * @brief One thread opens the queued files and keeps up to the queue depth reads in flight on an io_uring, set up with
+	 * the raw syscalls so there is no liburing dependency
+	*/
+	class AsyncFileLoader::IoUring : public AsyncFileLoader::Backend
+	{
+	public:
+		// Largest read queued at once, larger files are read in several
+		constexpr static size_t MAX_READ = 1 << 30;
+
+		AsyncFileLoader::BACKEND type() const noexcept override
+		{
+			return AsyncFileLoader::BACKEND::IO_URING;
+		};
+
+		/**
+		 * @brief Returns false if the kernel refused to create the ring, the object must not be used then
+		*/
+		bool good() const noexcept
+		{
+			return this->thread_.joinable();
+		};
+
+		explicit IoUring(uint32_t _depth)
+		{
+			io_uring_params _params{};
+			this->fd_ = (int)::syscall(__NR_io_uring_setup, std::max<uint32_t>(_depth, 1), &_params);
+			if (this->fd_ < 0)
+			{
+				return;
+			};
+
+			this->sq_size_ = _params.sq_off.array + _params.sq_entries * sizeof(unsigned);
+			this->cq_size_ = _params.cq_off.cqes + _params.cq_entries * sizeof(io_uring_cqe);
+			const bool _single = (_params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (_single)
+			{
+				this->sq_size_ = this->cq_size_ = std::max(this->sq_size_, this->cq_size_);
+			};
+
+			this->sq_ring_ = ::mmap(nullptr, this->sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				this->fd_, IORING_OFF_SQ_RING);
+			if (this->sq_ring_ == MAP_FAILED)
+			{
+				this->sq_ring_ = nullptr;
+				return;
+			};
+			if (_single)
+			{
+				this->cq_ring_ = this->sq_ring_;
+			}
+			else
+			{
+				this->cq_ring_ = ::mmap(nullptr, this->cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+					this->fd_, IORING_OFF_CQ_RING);
+				if (this->cq_ring_ == MAP_FAILED)
+				{
+					this->cq_ring_ = nullptr;
+					return;
+				};
+			};
+			this->sqes_size_ = _params.sq_entries * sizeof(io_uring_sqe);
+			const auto _sqes = ::mmap(nullptr, this->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				this->fd_, IORING_OFF_SQES);
+			if (_sqes == MAP_FAILED)
+			{
+				return;
+			};
+			this->sqes_ = static_cast<io_uring_sqe*>(_sqes);
+
+			auto _sq = static_cast<char*>(this->sq_ring_);
+			this->sq_tail_ = reinterpret_cast<unsigned*>(_sq + _params.sq_off.tail);
+			this->sq_mask_ = *reinterpret_cast<unsigned*>(_sq + _params.sq_off.ring_mask);
+			this->sq_array_ = reinterpret_cast<unsigned*>(_sq + _params.sq_off.array);
+			this->sq_entries_ = _params.sq_entries;
+
+			auto _cq = static_cast<char*>(this->cq_ring_);
+			this->cq_head_ = reinterpret_cast<unsigned*>(_cq + _params.cq_off.head);
+			this->cq_tail_ = reinterpret_cast<unsigned*>(_cq + _params.cq_off.tail);
+			this->cq_mask_ = *reinterpret_cast<unsigned*>(_cq + _params.cq_off.ring_mask);
+			this->cqes_ = reinterpret_cast<io_uring_cqe*>(_cq + _params.cq_off.cqes);
+
+			this->thread_ = std::thread{ [this]() { this->run(); } };
+		};
+
+		~IoUring()
+		{
+			this->stop();
+			if (this->thread_.joinable())
+			{
+				this->thread_.join();
+			};
+			if (this->sqes_)
+			{
+				::munmap(this->sqes_, this->sqes_size_);
+			};
+			if (this->cq_ring_ && this->cq_ring_ != this->sq_ring_)
+			{
+				::munmap(this->cq_ring_, this->cq_size_);
+			};
+			if (this->sq_ring_)
+			{
+				::munmap(this->sq_ring_, this->sq_size_);
+			};
+			if (this->fd_ >= 0)
+			{
+				::close(this->fd_);
+			};
+		};
+
+	private:
+		/**
+		 * @brief Queues a read of the rest of the request's file, the ring must have a free entry
+		*/
+		void queue_read(LoadRequest& _request)
+		{
+			auto& _data = _request.result.data;
+			_request.iov.iov_base = _data.data() + _request.done;
+			_request.iov.iov_len = std::min(_data.size() - _request.done, MAX_READ);
+
+			const auto _tail = std::atomic_ref<unsigned>{ *this->sq_tail_ }.load(std::memory_order_relaxed);
+			const auto _index = _tail & this->sq_mask_;
+			auto& _sqe = this->sqes_[_index];
+			_sqe = io_uring_sqe{};
+			_sqe.opcode = IORING_OP_READV;
+			_sqe.fd = _request.fd;
+			_sqe.addr = (uint64_t)(uintptr_t)&_request.iov;
+			_sqe.len = 1;
+			_sqe.off = (uint64_t)_request.done;
+			_sqe.user_data = (uint64_t)(uintptr_t)&_request;
+			this->sq_array_[_index] = _index;
+			std::atomic_ref<unsigned>{ *this->sq_tail_ }.store(_tail + 1, std::memory_order_release);
+
+			++this->to_submit_;
+			++this->in_flight_;
+		};
+
+		/**
+		 * @brief Handles every completion posted so far
+		*/
+		void reap()
+		{
+			auto _head = std::atomic_ref<unsigned>{ *this->cq_head_ }.load(std::memory_order_relaxed);
+			const auto _tail = std::atomic_ref<unsigned>{ *this->cq_tail_ }.load(std::memory_order_acquire);
+			for (; _head != _tail; ++_head)
+			{
+				const auto& _cqe = this->cqes_[_head & this->cq_mask_];
+				auto _request = reinterpret_cast<LoadRequest*>((uintptr_t)_cqe.user_data);
+				const auto _res = _cqe.res;
+				--this->in_flight_;
+
+				if (_res == -EINTR || _res == -EAGAIN)
+				{
+					this->retry_.push_back(_request);
+					continue;
+				};
+				if (_res < 0)
+				{
+					_request->result.error = std::error_code{ -_res, std::system_category() };
+				}
+				else if (_res == 0)
+				{
+					// Shrank since it was opened
+					_request->result.data.resize(_request->done);
+				}
+				else
+				{
+					_request->done += (size_t)_res;
+					if (_request->done != _request->result.data.size())
+					{
+						this->retry_.push_back(_request);
+						continue;
+					};
+				};
+				this->finish(std::unique_ptr<LoadRequest>{ _request });
+			};
+			std::atomic_ref<unsigned>{ *this->cq_head_ }.store(_head, std::memory_order_release);
+		};
+
+		/**
+		 * @brief Stops using the ring after io_uring_enter failed with _error. Reads the kernel never took are handed back
+		 * to be finished with pread, reads it did take own their buffers until they complete so they are waited for.
+		*/
+		void abandon_ring(std::error_code _error)
+		{
+			SAE_LOG(FILEHANDLING, WARN) << "io_uring_enter failed (" << _error.message() << "), reading with pread instead\n";
+			this->ring_failed_ = true;
+
+			const auto _tail = std::atomic_ref<unsigned>{ *this->sq_tail_ }.load(std::memory_order_relaxed);
+			for (unsigned n = this->to_submit_; n != 0; --n)
+			{
+				const auto& _sqe = this->sqes_[this->sq_array_[(_tail - n) & this->sq_mask_]];
+				this->retry_.push_back(reinterpret_cast<LoadRequest*>((uintptr_t)_sqe.user_data));
+				--this->in_flight_;
+			};
+			this->to_submit_ = 0;
+
+			// Completions are posted to the shared ring memory, so no more syscalls are needed to collect them
+			while (this->in_flight_ != 0)
+			{
+				this->reap();
+				if (this->in_flight_ != 0)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+				};
+			};
+		};
+
+		/**
+		 * @brief Finishes every request with pread on this thread, used once the ring has been abandoned
+		*/
+		void run_without_ring()
+		{
+			for (auto _request : std::exchange(this->retry_, {}))
+			{
+				read_rest(*_request);
+				this->finish(std::unique_ptr<LoadRequest>{ _request });
+			};
+			while (auto _request = this->take(true))
+			{
+				if (open_request(*_request))
+				{
+					read_rest(*_request);
+				};
+				this->finish(std::move(_request));
+			};
+		};
+
+		void run()
+		{
+			while (!this->ring_failed_)
+			{
+				// Short reads first, then new files, as long as the ring has room
+				while (!this->retry_.empty() && this->in_flight_ != this->sq_entries_)
+				{
+					this->queue_read(*this->retry_.back());
+					this->retry_.pop_back();
+				};
+				while (this->in_flight_ != this->sq_entries_)
+				{
+					// Only wait for new files when there is nothing to reap
+					auto _request = this->take(this->in_flight_ == 0 && this->retry_.empty());
+					if (!_request)
+					{
+						break;
+					};
+					if (!open_request(*_request) || _request->result.data.empty())
+					{
+						this->finish(std::move(_request));
+						continue;
+					};
+					this->queue_read(*_request.release());
+				};
+
+				if (this->in_flight_ == 0 && this->retry_.empty())
+				{
+					if (this->stopping() && this->pending() == 0)
+					{
+						break;
+					};
+					continue;
+				};
+
+				// Submits the new reads and waits for at least one to complete. An interrupted wait is simply retried, and a
+				// full completion queue is emptied by reap() before trying again.
+				const auto _entered = ::syscall(__NR_io_uring_enter, this->fd_, this->to_submit_, 1u,
+					IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (_entered > 0)
+				{
+					this->to_submit_ -= std::min<unsigned>((unsigned)_entered, this->to_submit_);
+				}
+				else if (_entered < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+				{
+					this->abandon_ring(last_error());
+					break;
+				};
+				this->reap();
+			};
+
+			if (this->ring_failed_)
+			{
+				this->run_without_ring();
+			};
+		};
+
+		int fd_ = -1;
+		std::thread thread_{};
+
+		void* sq_ring_ = nullptr;
+		void* cq_ring_ = nullptr;
+		size_t sq_size_ = 0;
+		size_t cq_size_ = 0;
+		io_uring_sqe* sqes_ = nullptr;
+		size_t sqes_size_ = 0;
+
+		unsigned* sq_tail_ = nullptr;
+		unsigned* sq_array_ = nullptr;
+		unsigned sq_mask_ = 0;
+		unsigned sq_entries_ = 0;
+
+		unsigned* cq_head_ = nullptr;
+		unsigned* cq_tail_ = nullptr;
+		unsigned cq_mask_ = 0;
+		io_uring_cqe* cqes_ = nullptr;
+
+		// Ring thread only
+		unsigned to_submit_ = 0;
+		unsigned in_flight_ = 0;
+		std::vector<LoadRequest*> retry_{};
+		bool ring_failed_ = false;
+	};
+#endif
+
+	AsyncFileLoader::BACKEND AsyncFileLoader::backend() const noexcept
+	{
+		return this->backend_->type();
+	};
+
+	std::future<AsyncFileLoader::Result> AsyncFileLoader::load(std::filesystem::path _path)
+	{
+		return std::move(this->load(std::span<const std::filesystem::path>{ &_path, 1 }).front());
+	};
+
+	std::vector<std::future<AsyncFileLoader::Result>> AsyncFileLoader::load(std::span<const std::filesystem::path> _paths)
+	{
+		std::vector<std::unique_ptr<LoadRequest>> _batch{};
+		std::vector<std::future<Result>> _out{};
+		_batch.reserve(_paths.size());
+		_out.reserve(_paths.size());
+		for (auto& p : _paths)
+		{
+			auto _request = std::make_unique<LoadRequest>();
+			_request->result.path = p;
+			_out.push_back(_request->promise.get_future());
+			_batch.push_back(std::move(_request));
+		};
+		this->backend_->submit(_batch);
+		return _out;
+	};
+
+	void AsyncFileLoader::load(std::span<const std::filesystem::path> _paths, callback_type _callback)
+	{
+		const auto _shared = std::make_shared<callback_type>(std::move(_callback));
+		std::vector<std::unique_ptr<LoadRequest>> _batch{};
+		_batch.reserve(_paths.size());
+		for (auto& p : _paths)
+		{
+			auto _request = std::make_unique<LoadRequest>();
+			_request->result.path = p;
+			_request->callback = _shared;
+			_batch.push_back(std::move(_request));
+		};
+		this->backend_->submit(_batch);
+	};
+
+	size_t AsyncFileLoader::pending() const noexcept
+	{
+		return this->backend_->pending();
+	};
+
+	void AsyncFileLoader::wait()
+	{
+		this->backend_->wait();
+	};
+
+	AsyncFileLoader::AsyncFileLoader(BACKEND _backend, size_t _threads, uint32_t _queueDepth)
+	{
+#ifdef SAE_ENGINE_CORE_HAS_IO_URING
+		if (_backend == BACKEND::IO_URING)
+		{
+			auto _ring = std::make_unique<IoUring>(_queueDepth);
+			if (_ring->good())
+			{
+				this->backend_ = std::move(_ring);
+				return;
+			};
+		};
+#endif
+		this->backend_ = std::make_unique<ThreadPool>(_threads);
+	};
+
+	AsyncFileLoader::~AsyncFileLoader()
+	{
+		this->wait();
+	};
+
 }
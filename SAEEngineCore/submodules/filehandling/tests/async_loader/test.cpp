@@ -0,0 +1,147 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_FileHandling.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	AsyncFileLoader with both backends : a batch of files of mixed sizes, including empty and missing ones, loaded through
+	futures and through a callback, with more files than the io_uring queue depth so reads have to wait for room.
+*/
+
+static std::string make_contents(size_t _index, size_t _bytes)
+{
+	std::string _out(_bytes, '\0');
+	for (size_t n = 0; n != _bytes; ++n)
+	{
+		_out[n] = (char)((n * 31 + _index * 7) & 0xFF);
+	};
+	return _out;
+};
+
+static bool matches(const AsyncFileLoader::Result& _result, const std::string& _contents)
+{
+	return _result.good() && _result.data.size() == _contents.size() &&
+		(_contents.empty() || std::memcmp(_result.data.data(), _contents.data(), _contents.size()) == 0);
+};
+
+static int run(AsyncFileLoader::BACKEND _backend, const std::vector<std::filesystem::path>& _paths,
+	const std::vector<std::string>& _contents, const std::filesystem::path& _missing)
+{
+	AsyncFileLoader _loader{ _backend, 4, 8 };
+	const char* _name = (_loader.backend() == AsyncFileLoader::BACKEND::IO_URING) ? "io_uring" : "thread pool";
+	std::cout << "requested " << ((_backend == AsyncFileLoader::BACKEND::IO_URING) ? "io_uring" : "thread pool") <<
+		", using " << _name << '\n';
+
+	// Futures, in submission order
+	auto _futures = _loader.load(_paths);
+	for (size_t n = 0; n != _paths.size(); ++n)
+	{
+		auto _result = _futures[n].get();
+		if (_result.path != _paths[n] || !matches(_result, _contents[n]))
+		{
+			std::cout << _name << " : future " << n << " loaded the wrong data\n";
+			return 1;
+		};
+	};
+
+	// A missing file completes with an error
+	auto _failed = _loader.load(_missing).get();
+	if (_failed.good() || !_failed.data.empty())
+	{
+		std::cout << _name << " : a missing file loaded\n";
+		return 2;
+	};
+
+	// Callbacks, in completion order
+	std::mutex _mtx{};
+	std::vector<bool> _seen(_paths.size(), false);
+	std::atomic<size_t> _bad{ 0 };
+	_loader.load(_paths, [&](AsyncFileLoader::Result&& _result)
+		{
+			std::scoped_lock _lck{ _mtx };
+			const auto _it = std::find(_paths.begin(), _paths.end(), _result.path);
+			const auto _index = (size_t)(_it - _paths.begin());
+			if (_it == _paths.end() || _seen[_index] || !matches(_result, _contents[_index]))
+			{
+				++_bad;
+				return;
+			};
+			_seen[_index] = true;
+		});
+	_loader.wait();
+	if (_loader.pending() != 0 || _bad != 0 || std::find(_seen.begin(), _seen.end(), false) != _seen.end())
+	{
+		std::cout << _name << " : callbacks did not see every file once\n";
+		return 3;
+	};
+
+	// Destroying the loader finishes what is still queued
+	std::vector<std::future<AsyncFileLoader::Result>> _late{};
+	{
+		AsyncFileLoader _short{ _backend, 2, 4 };
+		_late = _short.load(_paths);
+	};
+	for (size_t n = 0; n != _paths.size(); ++n)
+	{
+		if (!matches(_late[n].get(), _contents[n]))
+		{
+			std::cout << _name << " : loads queued before destruction were lost\n";
+			return 4;
+		};
+	};
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	const auto _dir = std::filesystem::temp_directory_path() / "sae_async_loader_test";
+	std::filesystem::create_directories(_dir);
+
+	std::vector<std::filesystem::path> _paths{};
+	std::vector<std::string> _contents{};
+	for (size_t n = 0; n != 40; ++n)
+	{
+		const size_t _bytes = (n == 0) ? 0 : (n % 5 == 0) ? 3 * 1024 * 1024 + n : n * 997;
+		_paths.push_back(_dir / ("file_" + std::to_string(n) + ".bin"));
+		_contents.push_back(make_contents(n, _bytes));
+
+		std::ofstream _file{ _paths.back(), std::ios::binary | std::ios::trunc };
+		_file.write(_contents.back().data(), (std::streamsize)_contents.back().size());
+	};
+
+	int _result = run(AsyncFileLoader::BACKEND::IO_URING, _paths, _contents, _dir / "missing.bin");
+	if (_result == GOOD_TEST)
+	{
+		_result = run(AsyncFileLoader::BACKEND::THREAD_POOL, _paths, _contents, _dir / "missing.bin");
+		_result = (_result == GOOD_TEST) ? GOOD_TEST : _result + 10;
+	};
+
+	std::error_code _ec{};
+	std::filesystem::remove_all(_dir, _ec);
+	return _result;
+};
@@ -0,0 +1,134 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_FileHandling.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace sae::engine::core;
+
+/*
+	MappedFile and OpenFile return the exact bytes of files of several sizes, including line endings and bytes that a
+	text mode read would change, and report files that can't be opened. OpenFile still reads files that can't be mapped.
+*/
+
+static std::string make_contents(size_t _bytes)
+{
+	std::string _out(_bytes, '\0');
+	for (size_t n = 0; n != _bytes; ++n)
+	{
+		_out[n] = (char)((n * 131 + n / 7) & 0xFF);
+	};
+	if (_bytes >= 4)
+	{
+		std::memcpy(_out.data(), "\r\n\x1A\0", 4);
+	};
+	return _out;
+};
+
+static std::filesystem::path write_file(const std::string& _name, const std::string& _contents)
+{
+	auto _path = std::filesystem::temp_directory_path() / _name;
+	std::ofstream _file{ _path, std::ios::binary | std::ios::trunc };
+	_file.write(_contents.data(), (std::streamsize)_contents.size());
+	return _path;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	int _result = GOOD_TEST;
+	for (size_t _bytes : { (size_t)0, (size_t)1, (size_t)4096, (size_t)1024 * 1024 + 3 })
+	{
+		const auto _contents = make_contents(_bytes);
+		const auto _path = write_file("sae_mapped_file_test_" + std::to_string(_bytes) + ".bin", _contents);
+
+		MappedFile _mapped{ _path };
+		if (!_mapped.good() || _mapped.size() != _bytes ||
+			(_bytes != 0 && std::memcmp(_mapped.data().data(), _contents.data(), _bytes) != 0))
+		{
+			std::cout << "MappedFile read " << _bytes << " bytes wrong\n";
+			_result = 1;
+		};
+
+		// Moving hands over the mapping, closing leaves it empty
+		MappedFile _moved{ std::move(_mapped) };
+		if (_mapped.good() || _moved.size() != _bytes)
+		{
+			std::cout << "MappedFile did not move\n";
+			_result = 2;
+		};
+		_moved.close();
+		if (_moved.good() || !_moved.data().empty())
+		{
+			std::cout << "MappedFile did not close\n";
+			_result = 3;
+		};
+
+		const auto _read = OpenFile(_path);
+		if (!_read || _read->size() != _bytes ||
+			(_bytes != 0 && std::memcmp(_read->data(), _contents.data(), _bytes) != 0))
+		{
+			std::cout << "OpenFile read " << _bytes << " bytes wrong\n";
+			_result = 4;
+		};
+
+		std::error_code _ec{};
+		std::filesystem::remove(_path, _ec);
+	};
+
+	const auto _missing = std::filesystem::temp_directory_path() / "sae_mapped_file_test_missing.bin";
+	if (MappedFile{ _missing }.good() || OpenFile(_missing))
+	{
+		std::cout << "a missing file was opened\n";
+		_result = 5;
+	};
+
+#ifndef _WIN32
+	// A pipe isn't mapped, OpenFile reads it instead
+	const auto _pipe = std::filesystem::temp_directory_path() / "sae_mapped_file_test_pipe";
+	std::filesystem::remove(_pipe);
+	if (::mkfifo(_pipe.c_str(), 0600) == 0)
+	{
+		const auto _contents = make_contents(100 * 1024);
+		std::thread _writer{ [&_pipe, &_contents]()
+			{
+				std::ofstream _file{ _pipe, std::ios::binary };
+				_file.write(_contents.data(), (std::streamsize)_contents.size());
+			} };
+		const auto _read = OpenFile(_pipe);
+		_writer.join();
+		if (!_read || _read->size() != _contents.size() ||
+			std::memcmp(_read->data(), _contents.data(), _contents.size()) != 0)
+		{
+			std::cout << "OpenFile did not fall back to reading a pipe\n";
+			_result = 6;
+		};
+		std::filesystem::remove(_pipe);
+	};
+#endif
+
+	return _result;
+};
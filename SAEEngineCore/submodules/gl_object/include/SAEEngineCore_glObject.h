@@ -4,11 +4,19 @@
 
 #include <SAEEngineCore_Environment.h>
 #include <SAEEngineCore_Object.h>
+#include <SAEEngineCore_Shader.h>
 
+#include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <cstring>
 #include <memory>
 #include <optional>
+#include <span>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace sae::engine::core
 {
@@ -45,6 +53,19 @@ namespace sae::engine::core
 			DYNAMIC_DRAW = GL_DYNAMIC_DRAW
 		};
 
+		/**
+		 * @brief How a buffer picks its new capacity when a write runs past the end of it
+		*/
+		enum class GROWTH_POLICY : uint8_t
+		{
+			// Grow to exactly the size needed
+			EXACT,
+			// Grow to 1.5 times the current capacity, or the size needed if that is larger
+			ONE_AND_HALF,
+			// Grow to twice the current capacity, or the size needed if that is larger
+			DOUBLE
+		};
+
 		enum class TYPE : GLenum
 		{
 			FLOAT = GL_FLOAT,
@@ -218,6 +239,26 @@ namespace sae::engine::core
 	{
 	public:
 
+		/**
+		 * @brief Totals since construction or the last reset_stats() call
+		*/
+		struct Stats
+		{
+			// Times the GL buffer was replaced by a larger or smaller one
+			size_t reallocations = 0;
+
+			// Bytes moved between buffers by reallocation and erase()
+			size_t bytes_copied = 0;
+
+			// Shadowed buffers only, flush() calls that sent data and what they sent
+			size_t flushes = 0;
+			size_t ranges_uploaded = 0;
+			size_t bytes_uploaded = 0;
+
+			// Flushes that orphaned the buffer and sent it whole
+			size_t orphans = 0;
+		};
+
 		GLuint id() const noexcept { return this->id_; };
 
 		bool good() const noexcept
@@ -231,7 +272,7 @@ namespace sae::engine::core
 
 		void bind(GLenum _target) const noexcept
 		{
-			glBindBuffer(_target, this->id());
+			gl::StateCache::current().bind_buffer(_target, this->id());
 		};
 		void bind() const noexcept
 		{
@@ -240,7 +281,7 @@ namespace sae::engine::core
 
 		void unbind(GLenum _target) const noexcept
 		{
-			glBindBuffer(_target, 0);
+			gl::StateCache::current().bind_buffer(_target, 0);
 		};
 		void unbind() const noexcept
 		{
@@ -249,7 +290,7 @@ namespace sae::engine::core
 
 		void destroy()
 		{
-			glDeleteBuffers(1, &this->id_);
+			gl::StateCache::current().delete_buffers(1, &this->id_);
 			this->id_ = 0;
 		};
 
@@ -262,33 +303,176 @@ namespace sae::engine::core
 			return this->capacity_;
 		};
 
+		gl::BUFFER_MODE mode() const noexcept { return this->mode_; };
+
+		gl::GROWTH_POLICY growth_policy() const noexcept { return this->growth_; };
+		void set_growth_policy(gl::GROWTH_POLICY _growth) noexcept { this->growth_ = _growth; };
+
+		const Stats& stats() const noexcept { return this->stats_; };
+		void reset_stats() noexcept { this->stats_ = Stats{}; };
+
+		/**
+		 * @brief Keeps a copy of the contents in memory. Writes then only go to the copy and mark the bytes they touched,
+		 * and flush() sends the marked bytes with neighbouring and overlapping ranges merged. Must be enabled while the
+		 * buffer is empty.
+		*/
+		void enable_shadow()
+		{
+			assert(this->size() == Bytes{ 0 });
+			this->shadowed_ = true;
+			this->shadow_.resize(this->capacity().count());
+		};
+		bool shadowed() const noexcept { return this->shadowed_; };
+
+		/**
+		 * @brief Contents of a shadowed buffer as they will be after the next flush()
+		*/
+		std::span<const std::byte> shadow() const noexcept
+		{
+			return std::span<const std::byte>{ this->shadow_ }.first(this->shadowed_ ? this->size().count() : 0);
+		};
+
+		/**
+		 * @brief True if a shadowed buffer has writes that have not been flushed
+		*/
+		bool needs_flush() const noexcept
+		{
+			return this->flush_all_ || !this->dirty_.empty();
+		};
+
+		/**
+		 * @brief Fraction of the size that, once dirty, makes flush() orphan the buffer and send all of it in one call
+		 * instead of range by range
+		*/
+		float orphan_threshold() const noexcept { return this->orphan_threshold_; };
+		void set_orphan_threshold(float _fraction) noexcept { this->orphan_threshold_ = _fraction; };
+
+		/**
+		 * @brief Sends the writes made to a shadowed buffer since the last flush. Does nothing for a buffer without a shadow.
+		*/
+		void flush()
+		{
+			if (!this->shadowed_ || !this->needs_flush())
+			{
+				return;
+			};
+
+			size_t _dirtyBytes = 0;
+			if (!this->flush_all_)
+			{
+				// Merge overlapping and touching ranges in place
+				std::sort(this->dirty_.begin(), this->dirty_.end());
+				size_t _out = 0;
+				for (size_t n = 1; n < this->dirty_.size(); ++n)
+				{
+					if (this->dirty_[n].first <= this->dirty_[_out].second)
+					{
+						this->dirty_[_out].second = std::max(this->dirty_[_out].second, this->dirty_[n].second);
+					}
+					else
+					{
+						this->dirty_[++_out] = this->dirty_[n];
+					};
+				};
+				this->dirty_.resize(_out + 1);
+				for (auto& r : this->dirty_)
+				{
+					_dirtyBytes += r.second - r.first;
+				};
+			};
+
+			this->bind();
+			const auto _size = this->size().count();
+			if (this->flush_all_ || (float)_dirtyBytes >= this->orphan_threshold_ * (float)_size)
+			{
+				// New storage for the whole buffer lets the driver skip waiting on draws still reading the old one
+				glBufferData(BUFFER_TARGET, this->capacity().count(), NULL, (GLenum)this->mode_);
+				if (_size != 0)
+				{
+					glBufferSubData(BUFFER_TARGET, 0, _size, this->shadow_.data());
+				};
+				++this->stats_.orphans;
+				++this->stats_.ranges_uploaded;
+				this->stats_.bytes_uploaded += _size;
+			}
+			else
+			{
+				for (auto& r : this->dirty_)
+				{
+					glBufferSubData(BUFFER_TARGET, r.first, r.second - r.first, this->shadow_.data() + r.first);
+				};
+				this->stats_.ranges_uploaded += this->dirty_.size();
+				this->stats_.bytes_uploaded += _dirtyBytes;
+			};
+			++this->stats_.flushes;
+
+			this->dirty_.clear();
+			this->flush_all_ = false;
+		};
+
+		/**
+		 * @brief Reallocates the buffer to hold exactly _bytes, keeping as much of the current contents as fits. Does nothing if
+		 * the capacity is already _bytes.
+		*/
 		void reserve(Bytes _bytes)
 		{
-			if (this->capacity() > Bytes{ 0 })
+			if (_bytes == this->capacity() && this->capacity() > Bytes{ 0 })
+			{
+				return;
+			};
+
+			if (this->shadowed_)
+			{
+				// The contents are refilled from the shadow on the next flush, so nothing is copied on the gpu
+				this->shadow_.resize(_bytes.count());
+				this->bind();
+				glBufferData(BUFFER_TARGET, _bytes.count(), NULL, (GLenum)this->mode_);
+				if (this->capacity() > Bytes{ 0 })
+				{
+					++this->stats_.reallocations;
+				};
+				if (_bytes < this->size())
+				{
+					this->size_ = _bytes;
+				};
+				this->capacity_ = _bytes;
+				this->dirty_.clear();
+				this->flush_all_ = true;
+				return;
+			};
+
+			// Only the written part of the buffer is worth keeping
+			const auto _keep = std::min(_bytes, this->size());
+			if (_keep > Bytes{ 0 })
 			{
 				GLuint _cbuff = 0;
 
 				glGenBuffers(1, &_cbuff);
 
-				glBindBuffer(GL_COPY_WRITE_BUFFER, _cbuff);
-				glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)_bytes.count(), NULL, GL_STATIC_DRAW);
+				gl::StateCache::current().bind_buffer(GL_COPY_WRITE_BUFFER, _cbuff);
+				glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)_bytes.count(), NULL, (GLenum)this->mode_);
 
-				glBindBuffer(GL_COPY_READ_BUFFER, this->id());
+				gl::StateCache::current().bind_buffer(GL_COPY_READ_BUFFER, this->id());
 
-				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, std::min(_bytes, this->capacity()).count());
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, _keep.count());
 
-				glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
-				glBindBuffer(GL_COPY_READ_BUFFER, 0);
+				gl::StateCache::current().bind_buffer(GL_COPY_WRITE_BUFFER, 0);
+				gl::StateCache::current().bind_buffer(GL_COPY_READ_BUFFER, 0);
 
-				glDeleteBuffers(1, &this->id_);
+				gl::StateCache::current().delete_buffers(1, &this->id_);
 				this->id_ = _cbuff;
+				this->stats_.bytes_copied += _keep.count();
 			}
 			else
 			{
 				this->bind();
-				glBufferData(BUFFER_TARGET, _bytes.count(), NULL, GL_STATIC_DRAW);
+				glBufferData(BUFFER_TARGET, _bytes.count(), NULL, (GLenum)this->mode_);
 			};
 
+			if (this->capacity() > Bytes{ 0 })
+			{
+				++this->stats_.reallocations;
+			};
 			if (_bytes < this->size())
 			{
 				this->size_ = _bytes;
@@ -296,17 +480,33 @@ namespace sae::engine::core
 			this->capacity_ = _bytes;
 
 		};
+
+		/**
+		 * @brief Sets the size, growing the capacity by the growth policy if _bytes does not fit
+		*/
 		void resize(Bytes _bytes)
 		{
 			if (_bytes > this->capacity())
 			{
-				this->reserve(_bytes);
+				this->reserve(this->grown_capacity(_bytes));
 			};
 			this->size_ = _bytes;
 		};
 
 		/**
-		 * @brief Writes _bytes length of data from _dataIn into the buffer, starting at _offset
+		 * @brief Reallocates the buffer to hold only its current size
+		*/
+		void shrink_to_fit()
+		{
+			if (this->size() != this->capacity())
+			{
+				this->reserve(this->size());
+			};
+		};
+
+		/**
+		 * @brief Writes _bytes length of data from _dataIn into the buffer, starting at _offset. Shadowed buffers only take
+		 * the data into the shadow, it reaches the gpu on the next flush()
 		 * @param _offset Offset from this buffer start in bytes
 		 * @param _dataIn Pointer to data to copy from
 		 * @param _bytes Length of data to copy in bytes
@@ -318,6 +518,16 @@ namespace sae::engine::core
 			{
 				this->resize(_offset + _bytes);
 			};
+			if (this->shadowed_)
+			{
+				std::memcpy(this->shadow_.data() + _offset.count(), _dataIn, _bytes.count());
+				this->mark_dirty(_offset.count(), (_offset + _bytes).count());
+				if (_offset + _bytes > this->size())
+				{
+					this->size_ = _offset + _bytes;
+				};
+				return;
+			};
 			this->bind(_target);
 			glBufferSubData(_target, _offset.count(), _bytes.count(), _dataIn);
 			if (_offset + _bytes > this->size())
@@ -347,24 +557,39 @@ namespace sae::engine::core
 			auto _rangeEnd = _offset + _bytes;
 			assert(_rangeEnd <= this->size());
 
-			GLuint _bid = 0;
-			glGenBuffers(1, &_bid);
-			glBindBuffer(GL_COPY_WRITE_BUFFER, _bid);
-			glBufferData(GL_COPY_WRITE_BUFFER, this->size().count(), NULL, GL_STATIC_DRAW);
-			this->bind(GL_COPY_READ_BUFFER);
+			if (this->shadowed_)
+			{
+				std::memmove(this->shadow_.data() + _offset.count(), this->shadow_.data() + _rangeEnd.count(),
+					(this->size() - _rangeEnd).count());
+				this->size_ = this->size() - _bytes;
+				if (_offset < this->size())
+				{
+					this->mark_dirty(_offset.count(), this->size().count());
+				};
+				return;
+			};
 
-			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, this->size().count());
-			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, _rangeEnd.count(), _offset.count(), (this->size() - _rangeEnd).count());
+			// Only the data after the erased range moves, through a scratch buffer since the ranges may overlap
+			const auto _tail = this->size() - _rangeEnd;
+			if (_tail > Bytes{ 0 })
+			{
+				GLuint _bid = 0;
+				glGenBuffers(1, &_bid);
+				gl::StateCache::current().bind_buffer(GL_COPY_WRITE_BUFFER, _bid);
+				glBufferData(GL_COPY_WRITE_BUFFER, _tail.count(), NULL, GL_STREAM_COPY);
+				this->bind(GL_COPY_READ_BUFFER);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, _rangeEnd.count(), 0, _tail.count());
+
+				gl::StateCache::current().bind_buffer(GL_COPY_READ_BUFFER, _bid);
+				this->bind(GL_COPY_WRITE_BUFFER);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, _offset.count(), _tail.count());
+
+				gl::StateCache::current().delete_buffers(1, &_bid);
+				this->unbind(GL_COPY_WRITE_BUFFER);
+				this->stats_.bytes_copied += _tail.count() * 2;
+			};
 			this->size_ = this->size() - _bytes;
 
-			glBindBuffer(GL_COPY_READ_BUFFER, _bid);
-			this->bind(GL_COPY_WRITE_BUFFER);
-			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, this->size().count());
-			
-			glDeleteBuffers(1, &_bid);
-
-			this->unbind(GL_COPY_WRITE_BUFFER);
-			
 		};
 
 		void append(const void* _dataIn, Bytes _bytes, GLenum _target = BUFFER_TARGET)
@@ -372,13 +597,18 @@ namespace sae::engine::core
 			this->overwrite(this->size(), _dataIn, _bytes, _target);
 		};
 
-		explicit VBO(Bytes _reserveCount) :
-			id_{ 0 }
+		explicit VBO(Bytes _reserveCount, gl::BUFFER_MODE _mode = gl::BUFFER_MODE::STATIC_DRAW,
+			gl::GROWTH_POLICY _growth = gl::GROWTH_POLICY::DOUBLE) :
+			id_{ 0 }, mode_{ _mode }, growth_{ _growth }
 		{
 			this->init();
 			this->reserve(_reserveCount);
 		};
 
+		explicit VBO(gl::BUFFER_MODE _mode, gl::GROWTH_POLICY _growth = gl::GROWTH_POLICY::DOUBLE) :
+			VBO{ Bytes{ 0 }, _mode, _growth }
+		{};
+
 		VBO() :
 			VBO{ Bytes{ 0 } }
 		{};
@@ -388,7 +618,10 @@ namespace sae::engine::core
 
 		VBO(VBO&& other) noexcept :
 			id_{ std::exchange(other.id_, 0) },
-			size_{ other.size_ }, capacity_{ other.capacity_ }
+			size_{ other.size_ }, capacity_{ other.capacity_ },
+			mode_{ other.mode_ }, growth_{ other.growth_ }, stats_{ other.stats_ },
+			shadowed_{ other.shadowed_ }, shadow_{ std::move(other.shadow_) }, dirty_{ std::move(other.dirty_) },
+			flush_all_{ other.flush_all_ }, orphan_threshold_{ other.orphan_threshold_ }
 		{};
 		VBO& operator=(VBO&& other) noexcept
 		{
@@ -396,6 +629,14 @@ namespace sae::engine::core
 			this->id_ = std::exchange(other.id_, 0);
 			this->size_ = other.size();
 			this->capacity_ = other.capacity();
+			this->mode_ = other.mode_;
+			this->growth_ = other.growth_;
+			this->stats_ = other.stats_;
+			this->shadowed_ = other.shadowed_;
+			this->shadow_ = std::move(other.shadow_);
+			this->dirty_ = std::move(other.dirty_);
+			this->flush_all_ = other.flush_all_;
+			this->orphan_threshold_ = other.orphan_threshold_;
 			return *this;
 		};
 
@@ -405,9 +646,333 @@ namespace sae::engine::core
 		};
 
 	private:
+		void mark_dirty(size_t _begin, size_t _end)
+		{
+			if (this->flush_all_)
+			{
+				return;
+			};
+
+			// Writes usually follow on from the previous one, so extend it when they touch
+			if (!this->dirty_.empty() && _begin <= this->dirty_.back().second && _end >= this->dirty_.back().first)
+			{
+				auto& _last = this->dirty_.back();
+				_last.first = std::min(_last.first, _begin);
+				_last.second = std::max(_last.second, _end);
+			}
+			else
+			{
+				this->dirty_.push_back({ _begin, _end });
+			};
+		};
+
+		Bytes grown_capacity(Bytes _needed) const noexcept
+		{
+			auto _out = this->capacity();
+			switch (this->growth_)
+			{
+			case gl::GROWTH_POLICY::DOUBLE:
+				_out = this->capacity() * 2;
+				break;
+			case gl::GROWTH_POLICY::ONE_AND_HALF:
+				_out = this->capacity() + (this->capacity() / 2);
+				break;
+			default:
+				break;
+			};
+			return std::max(_out, _needed);
+		};
+
 		GLuint id_ = 0;
 		Bytes size_{ 0 };
 		Bytes capacity_{ 0 };
+
+		gl::BUFFER_MODE mode_ = gl::BUFFER_MODE::STATIC_DRAW;
+		gl::GROWTH_POLICY growth_ = gl::GROWTH_POLICY::DOUBLE;
+		Stats stats_{};
+
+		bool shadowed_ = false;
+		std::vector<std::byte> shadow_{};
+
+		// Byte ranges [first, second) written since the last flush
+		std::vector<std::pair<size_t, size_t>> dirty_{};
+
+		// Set when the gpu storage was replaced, the next flush sends everything
+		bool flush_all_ = false;
+
+		float orphan_threshold_ = 0.5f;
+	};
+
+	/**
+	 * @brief Vertex buffer for data that is rewritten every frame. The buffer is split into regions, one per frame in flight,
+	 * and callers write straight into the mapped memory of the current region instead of going through glBufferSubData.
+	 *
+	 * Uses a persistent coherent mapping made with glBufferStorage when the context provides it. Otherwise each region is
+	 * mapped with GL_MAP_UNSYNCHRONIZED_BIT while it is written and unmapped by end().
+	 *
+	 * A region is fenced when the next one is begun, and begin() waits on that fence before the region is written again.
+	 * Draws reading a region must therefore be issued between its end() and the next begin().
+	*/
+	template <GLenum BUFFER_TARGET>
+	class StreamingVBO
+	{
+	public:
+		constexpr static inline size_t DEFAULT_REGION_COUNT = 3;
+
+		// Region sizes are rounded up to this so every region starts suitably aligned for any vertex type
+		constexpr static inline size_t REGION_ALIGNMENT = 256;
+
+		struct Stats
+		{
+			size_t regions_submitted = 0;
+
+			// Times begin() found its region still in use by the GPU and had to wait for it
+			size_t fence_waits = 0;
+
+			// Bytes handed out by allocate()
+			size_t bytes_written = 0;
+		};
+
+		GLuint id() const noexcept { return this->id_; };
+
+		bool good() const noexcept
+		{
+			return this->id() != 0 && (!this->persistent_ || this->mapped_ != nullptr);
+		};
+
+		/**
+		 * @brief True if the buffer is persistently mapped, false if regions are mapped one at a time
+		*/
+		bool persistent() const noexcept { return this->persistent_; };
+
+		void bind() const noexcept
+		{
+			gl::StateCache::current().bind_buffer(BUFFER_TARGET, this->id());
+		};
+		void unbind() const noexcept
+		{
+			gl::StateCache::current().bind_buffer(BUFFER_TARGET, 0);
+		};
+
+		Bytes region_size() const noexcept { return this->region_size_; };
+		size_t region_count() const noexcept { return this->fences_.size(); };
+		size_t region_index() const noexcept { return this->region_; };
+
+		/**
+		 * @brief Offset of the current region from the start of the buffer
+		*/
+		Bytes region_offset() const noexcept { return this->region_size_ * this->region_; };
+
+		/**
+		 * @brief Bytes allocated so far in the current region
+		*/
+		Bytes written() const noexcept { return this->used_; };
+
+		bool writing() const noexcept { return this->region_ptr_ != nullptr; };
+
+		const Stats& stats() const noexcept { return this->stats_; };
+
+		/**
+		 * @brief Moves on to the next region and makes it writable, waiting for the GPU to finish with it if needed
+		*/
+		void begin()
+		{
+			assert(!this->writing());
+
+			// Everything drawn from the previous region has been issued by now
+			auto& _previous = this->fences_[this->region_];
+			if (this->stats_.regions_submitted != 0)
+			{
+				assert(_previous == nullptr);
+				_previous = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+				this->region_ = (this->region_ + 1) % this->region_count();
+			};
+
+			this->wait(this->fences_[this->region_]);
+			this->used_ = Bytes{ 0 };
+
+			if (this->persistent_)
+			{
+				this->region_ptr_ = this->mapped_ + this->region_offset().count();
+			}
+			else
+			{
+				this->bind();
+				this->region_ptr_ = (std::byte*)glMapBufferRange(BUFFER_TARGET, this->region_offset().count(), this->region_size_.count(),
+					GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+			};
+		};
+
+		/**
+		 * @brief Reserves room for _count values of T in the current region
+		 * @return Memory to write the values into, empty if the region does not have enough room left
+		*/
+		template <typename T>
+		std::span<T> allocate(size_t _count)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be written to a buffer");
+			assert(this->writing());
+
+			const auto _begin = ((this->used_.count() + alignof(T) - 1) / alignof(T)) * alignof(T);
+			const auto _end = _begin + (_count * sizeof(T));
+			if (_end > this->region_size_.count())
+			{
+				return {};
+			};
+
+			this->used_ = Bytes{ _end };
+			this->stats_.bytes_written += _count * sizeof(T);
+			return std::span<T>{ reinterpret_cast<T*>(this->region_ptr_ + _begin), _count };
+		};
+
+		/**
+		 * @brief Finishes writing the current region, it can be drawn from until the next begin()
+		 * @return Offset of the region from the start of the buffer
+		*/
+		Bytes end()
+		{
+			assert(this->writing());
+			if (!this->persistent_)
+			{
+				this->bind();
+				if (this->used_ > Bytes{ 0 })
+				{
+					glFlushMappedBufferRange(BUFFER_TARGET, 0, this->used_.count());
+				};
+				glUnmapBuffer(BUFFER_TARGET);
+			};
+			this->region_ptr_ = nullptr;
+			++this->stats_.regions_submitted;
+			return this->region_offset();
+		};
+
+		void destroy()
+		{
+			if (this->id_ == 0)
+			{
+				return;
+			};
+			for (auto& f : this->fences_)
+			{
+				if (f)
+				{
+					glDeleteSync(f);
+					f = nullptr;
+				};
+			};
+			if (this->mapped_ || this->region_ptr_)
+			{
+				this->bind();
+				glUnmapBuffer(BUFFER_TARGET);
+			};
+			gl::StateCache::current().delete_buffers(1, &this->id_);
+			this->id_ = 0;
+			this->mapped_ = nullptr;
+			this->region_ptr_ = nullptr;
+		};
+
+		/**
+		 * @brief Creates the buffer
+		 * @param _regionSize Bytes available to each frame, rounded up to REGION_ALIGNMENT
+		 * @param _regionCount Number of frames that can be in flight at once
+		 * @param _allowPersistent Set to false to always use the map per region path
+		*/
+		explicit StreamingVBO(Bytes _regionSize, size_t _regionCount = DEFAULT_REGION_COUNT, bool _allowPersistent = true) :
+			region_size_{ ((_regionSize.count() + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT) * REGION_ALIGNMENT },
+			fences_(std::max<size_t>(_regionCount, 1), nullptr)
+		{
+			const auto _total = (this->region_size_ * this->region_count()).count();
+
+			glGenBuffers(1, &this->id_);
+			this->bind();
+
+			const auto _bufferStorage = gl::extensions().buffer_storage;
+			if (_allowPersistent && _bufferStorage)
+			{
+				constexpr GLbitfield FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+				_bufferStorage(BUFFER_TARGET, (GLsizeiptr)_total, nullptr, FLAGS);
+				this->mapped_ = (std::byte*)glMapBufferRange(BUFFER_TARGET, 0, (GLsizeiptr)_total, FLAGS);
+				this->persistent_ = true;
+			}
+			else
+			{
+				glBufferData(BUFFER_TARGET, (GLsizeiptr)_total, NULL, GL_STREAM_DRAW);
+			};
+		};
+
+		StreamingVBO(const StreamingVBO& other) = delete;
+		StreamingVBO& operator=(const StreamingVBO& other) = delete;
+
+		StreamingVBO(StreamingVBO&& other) noexcept :
+			id_{ std::exchange(other.id_, 0) },
+			persistent_{ other.persistent_ },
+			mapped_{ std::exchange(other.mapped_, nullptr) },
+			region_size_{ other.region_size_ },
+			fences_{ std::move(other.fences_) },
+			region_{ other.region_ },
+			region_ptr_{ std::exchange(other.region_ptr_, nullptr) },
+			used_{ other.used_ },
+			stats_{ other.stats_ }
+		{};
+		StreamingVBO& operator=(StreamingVBO&& other) noexcept
+		{
+			this->destroy();
+			this->id_ = std::exchange(other.id_, 0);
+			this->persistent_ = other.persistent_;
+			this->mapped_ = std::exchange(other.mapped_, nullptr);
+			this->region_size_ = other.region_size_;
+			this->fences_ = std::move(other.fences_);
+			this->region_ = other.region_;
+			this->region_ptr_ = std::exchange(other.region_ptr_, nullptr);
+			this->used_ = other.used_;
+			this->stats_ = other.stats_;
+			return *this;
+		};
+
+		~StreamingVBO()
+		{
+			this->destroy();
+		};
+
+	private:
+		void wait(GLsync& _fence)
+		{
+			if (!_fence)
+			{
+				return;
+			};
+
+			auto _res = glClientWaitSync(_fence, 0, 0);
+			if (_res == GL_TIMEOUT_EXPIRED)
+			{
+				++this->stats_.fence_waits;
+				do
+				{
+					_res = glClientWaitSync(_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+				} while (_res == GL_TIMEOUT_EXPIRED);
+			};
+
+			glDeleteSync(_fence);
+			_fence = nullptr;
+		};
+
+		GLuint id_ = 0;
+		bool persistent_ = false;
+
+		// Start of the whole buffer when persistently mapped
+		std::byte* mapped_ = nullptr;
+
+		Bytes region_size_{ 0 };
+
+		// Fence placed after the last use of each region, null once waited on
+		std::vector<GLsync> fences_{};
+		size_t region_ = 0;
+
+		// Start of the current region while between begin() and end()
+		std::byte* region_ptr_ = nullptr;
+		Bytes used_{ 0 };
+
+		Stats stats_{};
 	};
 
 	/**
@@ -443,15 +1008,15 @@ namespace sae::engine::core
 		};
 		void bind() const noexcept
 		{
-			glBindBuffer(GL_ARRAY_BUFFER, this->id());
+			gl::StateCache::current().bind_buffer(GL_ARRAY_BUFFER, this->id());
 		};
 		void unbind() const noexcept
 		{
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			gl::StateCache::current().bind_buffer(GL_ARRAY_BUFFER, 0);
 		};
 		void destroy()
 		{
-			glDeleteBuffers(1, &this->id_);
+			gl::StateCache::current().delete_buffers(1, &this->id_);
 			this->id_ = 0;
 		};
 
@@ -470,17 +1035,17 @@ namespace sae::engine::core
 
 			glGenBuffers(1, &_cbuff);
 
-			glBindBuffer(GL_COPY_WRITE_BUFFER, _cbuff);
+			gl::StateCache::current().bind_buffer(GL_COPY_WRITE_BUFFER, _cbuff);
 			glBufferData(GL_COPY_WRITE_BUFFER, _count * sizeof(value_type), NULL, GL_STATIC_DRAW);
 
-			glBindBuffer(GL_COPY_READ_BUFFER, this->id());
+			gl::StateCache::current().bind_buffer(GL_COPY_READ_BUFFER, this->id());
 
 			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, std::min(_count * sizeof(value_type), this->capacity() * sizeof(value_type)));
 
-			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
-			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			gl::StateCache::current().bind_buffer(GL_COPY_WRITE_BUFFER, 0);
+			gl::StateCache::current().bind_buffer(GL_COPY_READ_BUFFER, 0);
 
-			glDeleteBuffers(1, &this->id_);
+			gl::StateCache::current().delete_buffers(1, &this->id_);
 
 			this->id_ = _cbuff;
 			if (_count < this->size())
@@ -591,15 +1156,15 @@ namespace sae::engine::core
 		};
 		void bind() const
 		{
-			glBindVertexArray(this->id());
+			gl::StateCache::current().bind_vertex_array(this->id());
 		};
 		void unbind() const
 		{
-			glBindVertexArray(0);
+			gl::StateCache::current().bind_vertex_array(0);
 		};
 		void destroy()
 		{
-			glDeleteVertexArrays(1, &this->id_);
+			gl::StateCache::current().delete_vertex_arrays(1, &this->id_);
 			this->id_ = 0;
 		};
 
@@ -632,9 +1197,243 @@ namespace sae::engine::core
 		GLuint id_ = 0;
 	};
 
+	class glQuadArtist;
+
+	/**
+	 * @brief Solid colored rectangle drawn by a glQuadArtist. Changes to the bounds, z layer or color are picked up on the
+	 * next refresh, call mark_dirty() after changing the z layer directly.
+	*/
+	class glQuad : public GFXObject
+	{
+	public:
+		using color_type = ColorRGBA_8;
+		using artist_type = glQuadArtist;
+
+		void refresh() override;
+
+		color_type color() const noexcept;
+		void set_color(color_type _col) noexcept;
+
+		artist_type* artist() const noexcept;
+
+		/**
+		 * @brief Handle to this quad's instance record, empty while not registered with an artist
+		*/
+		ArtHandle art_handle() const noexcept;
+
+		glQuad(artist_type* _artist, Rect _r, color_type _col);
+		glQuad(artist_type* _artist, Rect _r);
+
+		~glQuad();
+
+	private:
+		friend artist_type;
+		artist_type* artist_ = nullptr;
+		ArtHandle art_handle_{};
+		color_type color_{};
+	};
+
+	/**
+	 * @brief Draws the glQuads registered with it with one instanced draw call per z layer. Each quad is one packed instance
+	 * record in a persistent buffer, and only the records of quads that changed since the last draw are uploaded, with
+	 * neighbouring changed records sent in a single glBufferSubData call.
+	 *
+	 * Records are kept in an ArtSlotMap grouped into one contiguous range per z layer, lowest layer first. Each range is
+	 * recorded as its own command keyed by its layer, so quads are painted back to front by layer and interleave with other
+	 * artists' layers, and blending is enabled so transparent quads show what is behind them. Adding, removing or moving a
+	 * quad to another layer moves one record at its layer and one per layer above it, so the cost stays small while there
+	 * are few layers. The order of quads within a layer is not kept and may change as quads are removed, overlapping quads
+	 * that must stack in a particular order need different layers.
+	*/
+	class glQuadArtist : public IArtist
+	{
+	public:
+		using art_type = glQuad;
+
+		/**
+		 * @brief Per quad record as laid out in the instance buffer
+		*/
+		struct Instance
+		{
+			Rect bounds;
+			ZLayer::value_type z;
+			ColorRGBA_8 color;
+			uint16_t padding_ = 0;
+		};
+		static_assert(sizeof(Instance) == 16, "glQuadArtist::Instance should pack into 16 bytes");
+
+		/**
+		 * @brief Counters for the upload made by the most recent GFXContext::draw() call
+		*/
+		struct DrawStats
+		{
+			// Instance records sent to the gpu
+			size_t instances_uploaded = 0;
+
+			// glBufferSubData calls made for the records
+			size_t upload_calls = 0;
+
+			// True if the instance buffer had to grow, which uploads every record
+			bool reallocated = false;
+		};
+
+		/**
+		 * @brief Shader sources matching the instance layout, the vertex stage expects a vec2 "viewport" uniform set to the
+		 * context size in pixels
+		*/
+		constexpr static inline const char* VERTEX_SHADER_SOURCE =
+			"#version 430 core\n"
+			"layout(location = 0) in vec2 corner;\n"
+			"layout(location = 1) in ivec4 bounds;\n"
+			"layout(location = 3) in vec4 color;\n"
+			"uniform vec2 viewport;\n"
+			"out vec4 frag_color;\n"
+			"void main()\n"
+			"{\n"
+			"	vec2 pos = mix(vec2(bounds.xy), vec2(bounds.zw), corner);\n"
+			"	gl_Position = vec4(pos.x / viewport.x * 2.0 - 1.0, 1.0 - pos.y / viewport.y * 2.0, 0.0, 1.0);\n"
+			"	frag_color = color;\n"
+			"}\n";
+		constexpr static inline const char* FRAGMENT_SHADER_SOURCE =
+			"#version 430 core\n"
+			"in vec4 frag_color;\n"
+			"out vec4 out_color;\n"
+			"void main()\n"
+			"{\n"
+			"	out_color = frag_color;\n"
+			"}\n";
+
+		bool good() override;
+
+		/**
+		 * @brief Uploads the changed instance records, with neighbouring records merged into one call
+		*/
+		void upload() override;
+
+		/**
+		 * @brief Draws every quad with one instanced draw call, the records are in layer order so this paints back to front
+		*/
+		void draw() override;
+
+		/**
+		 * @brief Records one command per z layer keyed by the layer, this artist's shader and its vertex array. The command
+		 * data is the position of the layer's range in layers().
+		*/
+		void record(RenderQueue& _queue) override;
+
+		/**
+		 * @brief Draws the quads of the layer a recorded command refers to
+		*/
+		void execute(const RenderCommand& _cmd) override;
+
+		void insert(art_type* _art);
+		void refresh(art_type* _art);
+
+		void remove(GFXObject* _obj) override;
+		bool contains(GFXObject* _obj) const override;
 
+		/**
+		 * @brief Number of registered quads
+		*/
+		size_t size() const noexcept;
+
+		/**
+		 * @brief Number of instance records the gpu buffer can hold before it has to grow
+		*/
+		size_t capacity() const noexcept;
+
+		/**
+		 * @brief Instance records as they will be after the next upload, in draw order
+		*/
+		std::span<const Instance> instances() const noexcept;
+
+		/**
+		 * @brief Range of instance records holding the quads of one z layer
+		*/
+		struct LayerRange
+		{
+			ZLayer::value_type layer = 0;
+			ArtHandle::index_type first = 0;
+			ArtHandle::index_type count = 0;
+		};
+
+		/**
+		 * @brief Instance ranges of each z layer that has quads, lowest layer first
+		*/
+		std::span<const LayerRange> layers() const noexcept;
+
+		GLuint instance_buffer_id() const noexcept;
+
+		const DrawStats& last_draw_stats() const noexcept;
+
+		ShaderProgram* get_shader() const noexcept;
+		void set_shader(ShaderProgram* _shader);
+
+		/**
+		 * @param _context Context whose bounds are used as the viewport size
+		 * @param _shader Shader built from VERTEX_SHADER_SOURCE and FRAGMENT_SHADER_SOURCE or compatible, not owned
+		 * @param _reserveCount Number of instance records to allocate up front
+		*/
+		glQuadArtist(GFXContext* _context, ShaderProgram* _shader, size_t _reserveCount = 256);
 
+		glQuadArtist(const glQuadArtist& other) = delete;
+		glQuadArtist& operator=(const glQuadArtist& other) = delete;
+		glQuadArtist(glQuadArtist&& other) noexcept = delete;
+		glQuadArtist& operator=(glQuadArtist&& other) noexcept = delete;
 
+		~glQuadArtist();
+
+	private:
+		static Instance make_instance(const art_type* _art) noexcept;
+
+		/**
+		 * @brief Points the instanced attributes at the instance buffer, needed again whenever the buffer is reallocated
+		*/
+		void bind_instance_attributes();
+
+		void mark_instance(ArtHandle::index_type _dense);
+
+		/**
+		 * @brief Binds the shader, vertex array and blend state shared by draw() and execute()
+		*/
+		void bind_draw_state();
+
+		// Position in layers_ of the range for a layer, find_layer() requires it to exist while add_layer() creates it
+		size_t find_layer(ZLayer::value_type _layer) const noexcept;
+		size_t add_layer(ZLayer::value_type _layer);
+
+		// Swaps two records along with their quads and marks both positions for upload
+		void swap_records(ArtHandle::index_type _a, ArtHandle::index_type _b);
+
+		// Moves the record at _dense out of its layer to the last position, shifting the layers above it down by one
+		void take_out(ArtHandle::index_type _dense, ZLayer::value_type _layer);
+
+		// Moves the record at the last position into a layer, shifting the layers above it up by one
+		void put_in(ZLayer::value_type _layer);
+
+		GFXContext* context_ = nullptr;
+		ShaderProgram* shader_ = nullptr;
+
+		VAO vao_{};
+		VBO<GL_ARRAY_BUFFER> corners_{};
+		VBO<GL_ARRAY_BUFFER> instance_buffer_{ gl::BUFFER_MODE::DYNAMIC_DRAW };
+		size_t capacity_ = 0;
+
+		ArtSlotMap<Instance> records_{};
+
+		// Quad drawn by each record, kept in the same order as the records
+		std::vector<art_type*> quads_{};
+
+		// Contiguous range of records for each layer, sorted by layer. Layers without quads are dropped.
+		std::vector<LayerRange> layers_{};
+
+		// Dense positions of records changed since the last upload, each listed once
+		std::vector<ArtHandle::index_type> dirty_{};
+		std::vector<bool> is_dirty_{};
+		bool upload_all_ = false;
+
+		DrawStats draw_stats_{};
+	};
 
 #if false
 
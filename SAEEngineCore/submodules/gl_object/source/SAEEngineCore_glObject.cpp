@@ -1,5 +1,10 @@
 #include "SAEEngineCore_glObject.h"
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
 #if false
 namespace sae::engine::core
 {
@@ -20,3 +25,410 @@ namespace sae::engine::core
 
 }
 #endif
+
+namespace sae::engine::core
+{
+	void glQuad::refresh()
+	{
+		GFXObject::refresh();
+		if (this->artist_)
+		{
+			this->artist_->refresh(this);
+		};
+	};
+
+	glQuad::color_type glQuad::color() const noexcept
+	{
+		return this->color_;
+	};
+	void glQuad::set_color(color_type _col) noexcept
+	{
+		this->color_ = _col;
+		this->mark_dirty();
+	};
+
+	glQuad::artist_type* glQuad::artist() const noexcept
+	{
+		return this->artist_;
+	};
+
+	ArtHandle glQuad::art_handle() const noexcept
+	{
+		return this->art_handle_;
+	};
+
+	glQuad::glQuad(artist_type* _artist, Rect _r, color_type _col) :
+		GFXObject{ _r }, artist_{ _artist }, color_{ _col }
+	{
+		assert(this->artist_);
+		this->artist_->insert(this);
+	};
+	glQuad::glQuad(artist_type* _artist, Rect _r) :
+		glQuad{ _artist, _r, color_type{} }
+	{};
+
+	glQuad::~glQuad()
+	{
+		if (this->artist_)
+		{
+			this->artist_->remove(this);
+		};
+	};
+
+}
+
+namespace sae::engine::core
+{
+	static_assert(cx_artist<glQuadArtist>, "glQuadArtist must satisfy cx_artist");
+
+	glQuadArtist::Instance glQuadArtist::make_instance(const art_type* _art) noexcept
+	{
+		Instance _out{};
+		_out.bounds = _art->bounds();
+		_out.z = _art->zlayer().layer();
+		_out.color = _art->color();
+		return _out;
+	};
+
+	void glQuadArtist::bind_instance_attributes()
+	{
+		this->vao_.bind();
+		this->instance_buffer_.bind();
+
+		glEnableVertexAttribArray(1);
+		glVertexAttribIPointer(1, 4, GL_SHORT, sizeof(Instance), (void*)offsetof(Instance, bounds));
+		glVertexAttribDivisor(1, 1);
+
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (void*)offsetof(Instance, color));
+		glVertexAttribDivisor(3, 1);
+
+		this->vao_.unbind();
+	};
+
+	void glQuadArtist::mark_instance(ArtHandle::index_type _dense)
+	{
+		if (!this->is_dirty_[_dense])
+		{
+			this->is_dirty_[_dense] = true;
+			this->dirty_.push_back(_dense);
+		};
+	};
+
+	void glQuadArtist::bind_draw_state()
+	{
+		// Skipped while the viewport is unchanged, and does nothing for shaders taking it from FrameUniforms instead
+		const auto& _bounds = this->context_->bounds();
+		this->shader_->set_uniform("viewport", (GLfloat)_bounds.width(), (GLfloat)_bounds.height());
+		this->shader_->bind();
+		this->vao_.bind();
+
+		// Layers are painted back to front, so transparent quads blend over whatever was drawn below them
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	};
+
+	size_t glQuadArtist::find_layer(ZLayer::value_type _layer) const noexcept
+	{
+		const auto _it = std::lower_bound(this->layers_.begin(), this->layers_.end(), _layer, [](const LayerRange& _range, ZLayer::value_type _value) {
+			return _range.layer < _value;
+			});
+		assert(_it != this->layers_.end() && _it->layer == _layer);
+		return (size_t)(_it - this->layers_.begin());
+	};
+	size_t glQuadArtist::add_layer(ZLayer::value_type _layer)
+	{
+		auto _it = std::lower_bound(this->layers_.begin(), this->layers_.end(), _layer, [](const LayerRange& _range, ZLayer::value_type _value) {
+			return _range.layer < _value;
+			});
+		if (_it == this->layers_.end() || _it->layer != _layer)
+		{
+			// A new layer starts empty where the next one begins
+			const auto _first = (_it == this->layers_.begin()) ? 0 : std::prev(_it)->first + std::prev(_it)->count;
+			_it = this->layers_.insert(_it, LayerRange{ _layer, _first, 0 });
+		};
+		return (size_t)(_it - this->layers_.begin());
+	};
+
+	void glQuadArtist::swap_records(ArtHandle::index_type _a, ArtHandle::index_type _b)
+	{
+		if (_a != _b)
+		{
+			this->records_.swap_positions(_a, _b);
+			std::swap(this->quads_[_a], this->quads_[_b]);
+			this->mark_instance(_a);
+			this->mark_instance(_b);
+		};
+	};
+
+	void glQuadArtist::take_out(ArtHandle::index_type _dense, ZLayer::value_type _layer)
+	{
+		const auto _index = this->find_layer(_layer);
+
+		// Move the record to the end of its layer, then keep swapping the hole with the last record of each layer above
+		auto& _range = this->layers_[_index];
+		auto _at = _range.first + _range.count - 1;
+		this->swap_records(_dense, _at);
+		--_range.count;
+		for (auto n = _index + 1; n != this->layers_.size(); ++n)
+		{
+			auto& _above = this->layers_[n];
+			const auto _last = _above.first + _above.count - 1;
+			this->swap_records(_at, _last);
+			_above.first = _at;
+			_at = _last;
+		};
+
+		if (this->layers_[_index].count == 0)
+		{
+			this->layers_.erase(this->layers_.begin() + _index);
+		};
+	};
+	void glQuadArtist::put_in(ZLayer::value_type _layer)
+	{
+		const auto _index = this->add_layer(_layer);
+
+		// Swap the record with the first record of each layer above, from the top down, until it sits after its layer
+		auto _at = (ArtHandle::index_type)(this->records_.size() - 1);
+		for (auto n = this->layers_.size() - 1; n != _index; --n)
+		{
+			auto& _above = this->layers_[n];
+			const auto _first = _above.first;
+			this->swap_records(_at, _first);
+			_above.first = _first + 1;
+			_at = _first;
+		};
+		++this->layers_[_index].count;
+		this->mark_instance(_at);
+	};
+
+	void glQuadArtist::upload()
+	{
+		this->draw_stats_ = DrawStats{};
+		const auto _staged = this->records_.values();
+
+		if (_staged.size() > this->capacity_)
+		{
+			auto _newCapacity = std::max<size_t>(this->capacity_ * 2, 64);
+			while (_newCapacity < _staged.size())
+			{
+				_newCapacity *= 2;
+			};
+			// Everything is uploaded below, so the old contents are dropped instead of copied into the new buffer
+			this->instance_buffer_.resize(Bytes{ 0 });
+			this->instance_buffer_.reserve(Bytes{ _newCapacity * sizeof(Instance) });
+			this->capacity_ = _newCapacity;
+			this->bind_instance_attributes();
+			this->upload_all_ = true;
+			this->draw_stats_.reallocated = true;
+		};
+
+		if (this->upload_all_)
+		{
+			if (!_staged.empty())
+			{
+				this->instance_buffer_.overwrite(Bytes{ 0 }, _staged.data(), Bytes{ _staged.size() * sizeof(Instance) });
+				this->draw_stats_.instances_uploaded = _staged.size();
+				this->draw_stats_.upload_calls = 1;
+			};
+		}
+		else if (!this->dirty_.empty())
+		{
+			// Neighbouring records go up together
+			std::sort(this->dirty_.begin(), this->dirty_.end());
+			size_t _first = 0;
+			while (_first != this->dirty_.size())
+			{
+				size_t _last = _first;
+				while (_last + 1 != this->dirty_.size() && this->dirty_[_last + 1] == this->dirty_[_last] + 1)
+				{
+					++_last;
+				};
+
+				const size_t _begin = this->dirty_[_first];
+				const size_t _count = (size_t)this->dirty_[_last] - _begin + 1;
+				this->instance_buffer_.overwrite(Bytes{ _begin * sizeof(Instance) }, _staged.data() + _begin,
+					Bytes{ _count * sizeof(Instance) });
+
+				this->draw_stats_.instances_uploaded += _count;
+				++this->draw_stats_.upload_calls;
+				_first = _last + 1;
+			};
+		};
+
+		for (auto& d : this->dirty_)
+		{
+			this->is_dirty_[d] = false;
+		};
+		this->dirty_.clear();
+		this->upload_all_ = false;
+	};
+
+	bool glQuadArtist::good()
+	{
+		return this->vao_.good() && this->instance_buffer_.good() && this->shader_ != nullptr;
+	};
+
+	void glQuadArtist::draw()
+	{
+		if (this->quads_.empty())
+		{
+			return;
+		};
+		this->bind_draw_state();
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)this->quads_.size());
+		this->vao_.unbind();
+	};
+
+	void glQuadArtist::record(RenderQueue& _queue)
+	{
+		if (!this->shader_)
+		{
+			return;
+		};
+		RenderKey _key{};
+		_key.shader = (uint16_t)this->shader_->id();
+		_key.vertex_array = (uint16_t)this->vao_.id();
+		for (uint32_t n = 0; n != (uint32_t)this->layers_.size(); ++n)
+		{
+			_key.layer = this->layers_[n].layer;
+			_queue.push(_key, n);
+		};
+	};
+	void glQuadArtist::execute(const RenderCommand& _cmd)
+	{
+		const auto& _range = this->layers_[_cmd.data];
+		this->bind_draw_state();
+		glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)_range.count, _range.first);
+		this->vao_.unbind();
+	};
+
+	void glQuadArtist::insert(art_type* _art)
+	{
+		assert(_art);
+		assert(!_art->art_handle_);
+
+		const auto _instance = make_instance(_art);
+		_art->art_handle_ = this->records_.insert(_instance);
+		this->quads_.push_back(_art);
+		this->is_dirty_.push_back(false);
+		this->put_in(_instance.z);
+	};
+
+	void glQuadArtist::refresh(art_type* _art)
+	{
+		assert(_art);
+		assert(this->records_.contains(_art->art_handle_));
+		auto& _record = this->records_[_art->art_handle_];
+		const auto _instance = make_instance(_art);
+		const auto _oldLayer = _record.z;
+		_record = _instance;
+		if (_instance.z == _oldLayer)
+		{
+			this->mark_instance(this->records_.dense_index(_art->art_handle_));
+		}
+		else
+		{
+			this->take_out(this->records_.dense_index(_art->art_handle_), _oldLayer);
+			this->put_in(_instance.z);
+		};
+	};
+
+	void glQuadArtist::remove(GFXObject* _obj)
+	{
+		auto _art = dynamic_cast<art_type*>(_obj);
+		if (!_art || _art->artist_ != this || !this->records_.contains(_art->art_handle_))
+		{
+			return;
+		};
+
+		// Moving the record to the end fills its position and the hole left in each layer above, one record upload each
+		this->take_out(this->records_.dense_index(_art->art_handle_), this->records_[_art->art_handle_].z);
+		this->records_.erase(_art->art_handle_);
+		_art->art_handle_ = ArtHandle{};
+		this->quads_.pop_back();
+
+		const auto _size = (ArtHandle::index_type)this->records_.size();
+		if (this->is_dirty_.back())
+		{
+			std::erase(this->dirty_, _size);
+		};
+		this->is_dirty_.pop_back();
+	};
+
+	bool glQuadArtist::contains(GFXObject* _obj) const
+	{
+		auto _art = dynamic_cast<const art_type*>(_obj);
+		return _art && _art->artist_ == this && this->records_.contains(_art->art_handle_);
+	};
+
+	size_t glQuadArtist::size() const noexcept
+	{
+		return this->quads_.size();
+	};
+	size_t glQuadArtist::capacity() const noexcept
+	{
+		return this->capacity_;
+	};
+
+	std::span<const glQuadArtist::Instance> glQuadArtist::instances() const noexcept
+	{
+		return this->records_.values();
+	};
+	std::span<const glQuadArtist::LayerRange> glQuadArtist::layers() const noexcept
+	{
+		return this->layers_;
+	};
+
+	GLuint glQuadArtist::instance_buffer_id() const noexcept
+	{
+		return this->instance_buffer_.id();
+	};
+
+	const glQuadArtist::DrawStats& glQuadArtist::last_draw_stats() const noexcept
+	{
+		return this->draw_stats_;
+	};
+
+	ShaderProgram* glQuadArtist::get_shader() const noexcept
+	{
+		return this->shader_;
+	};
+	void glQuadArtist::set_shader(ShaderProgram* _shader)
+	{
+		this->shader_ = _shader;
+	};
+
+	glQuadArtist::glQuadArtist(GFXContext* _context, ShaderProgram* _shader, size_t _reserveCount) :
+		context_{ _context }
+	{
+		assert(this->context_);
+		this->set_shader(_shader);
+
+		// Unit square as a triangle strip, scaled to each quad's bounds in the vertex shader
+		constexpr float_t CORNERS[8]{ 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f };
+		this->vao_.bind();
+		this->corners_.assign(CORNERS, Bytes{ sizeof(CORNERS) });
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float_t), (void*)0);
+		this->vao_.unbind();
+
+		if (_reserveCount != 0)
+		{
+			this->instance_buffer_.reserve(Bytes{ _reserveCount * sizeof(Instance) });
+			this->capacity_ = _reserveCount;
+		};
+		this->bind_instance_attributes();
+	};
+
+	glQuadArtist::~glQuadArtist()
+	{
+		// Quads outliving the artist must not call back into it
+		for (auto& q : this->quads_)
+		{
+			q->artist_ = nullptr;
+			q->art_handle_ = ArtHandle{};
+		};
+	};
+
+}
@@ -0,0 +1,240 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_glObject.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Stacks overlapping glQuads on several z layers on the recording backend and checks glQuadArtist keeps their records
+	grouped by layer as quads are added, removed and moved between layers, and draws each layer with its own command so
+	another artist's command on a middle layer is painted between them.
+*/
+
+/**
+ * @brief Records one command on a fixed layer and notes how many quad instances had been drawn when it ran
+*/
+class MarkerArtist : public IArtist
+{
+public:
+	bool good() override { return true; };
+	void draw() override {};
+
+	void remove(GFXObject* _obj) override {};
+	bool contains(GFXObject* _obj) const override { return false; };
+
+	void record(RenderQueue& _queue) override
+	{
+		// The widest shader id sorts after the quads on the same layer
+		_queue.push(RenderKey{ this->layer_, 0xFFFF, 0, 0 });
+	};
+	void execute(const RenderCommand& _cmd) override
+	{
+		this->drawn_before = gl::RecordingBackend::counters().instances_drawn;
+	};
+
+	MarkerArtist(uint16_t _layer) :
+		layer_{ _layer }
+	{};
+
+	size_t drawn_before = 0;
+
+private:
+	uint16_t layer_;
+};
+
+static std::optional<ShaderProgram> make_shader()
+{
+	std::stringstream _vertex{ glQuadArtist::VERTEX_SHADER_SOURCE };
+	std::stringstream _fragment{ glQuadArtist::FRAGMENT_SHADER_SOURCE };
+	return HACK_generate_shader(_vertex, _fragment);
+};
+
+static bool buffer_matches(const glQuadArtist& _artist)
+{
+	const auto _data = gl::RecordingBackend::buffer_data(_artist.instance_buffer_id());
+	const auto _bytes = _artist.instances().size() * sizeof(glQuadArtist::Instance);
+	return _data.size() >= _bytes && std::memcmp(_data.data(), _artist.instances().data(), _bytes) == 0;
+};
+
+/**
+ * @brief Checks the records are grouped by layer in ascending order, each range covers exactly its layer's records and
+ * every live quad's record carries its own color
+*/
+static bool layers_match(const glQuadArtist& _artist, const std::vector<glQuad*>& _quads)
+{
+	const auto _instances = _artist.instances();
+	ArtHandle::index_type _next = 0;
+	for (size_t n = 0; n != _artist.layers().size(); ++n)
+	{
+		const auto& _range = _artist.layers()[n];
+		if (_range.first != _next || _range.count == 0 || (n != 0 && _artist.layers()[n - 1].layer >= _range.layer))
+		{
+			return false;
+		};
+		for (auto i = _range.first; i != _range.first + _range.count; ++i)
+		{
+			if (_instances[i].z != _range.layer)
+			{
+				return false;
+			};
+		};
+		_next = _range.first + _range.count;
+	};
+	if (_next != _instances.size())
+	{
+		return false;
+	};
+
+	for (auto& q : _quads)
+	{
+		if (!q)
+		{
+			continue;
+		};
+		const auto _it = std::find_if(_instances.begin(), _instances.end(), [q](const glQuadArtist::Instance& _instance) {
+			return _instance.color.r == q->color().r;
+			});
+		if (_it == _instances.end() || _it->z != q->zlayer().layer())
+		{
+			return false;
+		};
+	};
+	return true;
+};
+
+static ColorRGBA_8 color_for(uint8_t _id, uint8_t _alpha)
+{
+	ColorRGBA_8 _out{};
+	_out.r = _id;
+	_out.a = _alpha;
+	return _out;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	gl::RecordingBackend::install();
+	auto _shader = make_shader();
+	if (!_shader || !_shader->good())
+	{
+		std::cout << "shader did not build against the recording backend\n";
+		return 1;
+	};
+
+	GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 400_px, 400_px }} };
+	_context.register_artist("quad", std::make_unique<glQuadArtist>(&_context, &*_shader));
+	_context.register_artist("marker", std::make_unique<MarkerArtist>(2));
+	auto _artist = static_cast<glQuadArtist*>(_context.find_artist("quad"));
+	auto _marker = static_cast<MarkerArtist*>(_context.find_artist("marker"));
+
+	// Every quad overlaps the others, half of them are transparent. Created out of layer order so records have to move.
+	const ZLayer::value_type LAYERS[]{ 3, 1, 2, 3, 1, 1 };
+	std::vector<glQuad*> _quads{};
+	for (uint8_t n = 0; n != std::size(LAYERS); ++n)
+	{
+		_quads.push_back(new glQuad{ _artist, Rect{{ 10_px * n, 10_px * n }, { 200_px, 200_px }}, color_for(n, (n % 2) ? 128 : 255) });
+		_quads.back()->zlayer() = LAYERS[n];
+		_quads.back()->mark_dirty();
+		_context.emplace(_quads.back());
+	};
+
+	gl::RecordingBackend::reset_counters();
+	_context.refresh();
+	_context.draw();
+	if (!layers_match(*_artist, _quads) || _artist->layers().size() != 3 || !buffer_matches(*_artist))
+	{
+		std::cout << "records were not grouped by layer\n";
+		return 2;
+	};
+
+	// One draw per layer, with the marker on layer 2 drawn after layers 1 and 2 and before layer 3
+	const auto& _counters = gl::RecordingBackend::counters();
+	if (_counters.count(gl::RecordingBackend::DRAW_ARRAYS_INSTANCED_BASE_INSTANCE) != 3 ||
+		_counters.instances_drawn != _quads.size())
+	{
+		std::cout << "expected one instanced draw per layer, got " << _counters.draw_calls << '\n';
+		return 3;
+	};
+	if (_marker->drawn_before != 4)
+	{
+		std::cout << "marker on layer 2 ran after " << _marker->drawn_before << " quads instead of 4\n";
+		return 4;
+	};
+	if (_counters.count(gl::RecordingBackend::ENABLE) == 0 || _counters.count(gl::RecordingBackend::BLEND_FUNC) == 0)
+	{
+		std::cout << "blending was not enabled for transparent quads\n";
+		return 5;
+	};
+
+	// Removing a quad from the bottom layer keeps every layer together and moves one record per layer it passes
+	_context.remove(_quads[1]);
+	_quads[1] = nullptr;
+	gl::RecordingBackend::reset_counters();
+	_context.draw();
+	if (!layers_match(*_artist, _quads) || !buffer_matches(*_artist) || _artist->last_draw_stats().instances_uploaded > 3)
+	{
+		std::cout << "removal did not keep the layers together\n";
+		return 6;
+	};
+	if (_marker->drawn_before != 3)
+	{
+		std::cout << "marker ran after " << _marker->drawn_before << " quads instead of 3 after removal\n";
+		return 7;
+	};
+
+	// Moving the only quad on layer 2 to the top drops layer 2, so the marker now runs after layer 1 alone
+	_quads[2]->zlayer() = 4;
+	_quads[2]->mark_dirty();
+	_context.refresh();
+	gl::RecordingBackend::reset_counters();
+	_context.draw();
+	if (!layers_match(*_artist, _quads) || _artist->layers().size() != 3 || _artist->layers().back().layer != 4 ||
+		!buffer_matches(*_artist))
+	{
+		std::cout << "moving a quad to another layer did not regroup the records\n";
+		return 8;
+	};
+	if (_marker->drawn_before != 2)
+	{
+		std::cout << "marker ran after " << _marker->drawn_before << " quads instead of 2 after moving a quad\n";
+		return 9;
+	};
+
+	// Removing everything leaves no layers and records no quad commands
+	for (auto& q : _quads)
+	{
+		if (q)
+		{
+			_context.remove(q);
+			q = nullptr;
+		};
+	};
+	_context.draw();
+	if (_artist->size() != 0 || !_artist->layers().empty() || _context.last_draw_stats().commands != 1)
+	{
+		std::cout << "empty artist still recorded commands\n";
+		return 10;
+	};
+
+	return GOOD_TEST;
+};
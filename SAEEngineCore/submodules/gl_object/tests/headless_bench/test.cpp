@@ -0,0 +1,264 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_glObject.h>
+#include <SAEEngineCore_Shader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Drives a windowless GFXContext through event handling, refresh and drawing with the gl calls going to the recording
+	backend, so the whole frame can be timed on a machine without a display. Every box is drawn by one artist that
+	rebuilds its vertex buffer whenever a box changed.
+*/
+
+constexpr static inline size_t BOXES_PER_VIEW = 100;
+constexpr static inline size_t FRAMES = 200;
+constexpr static inline size_t GROW_EVERY = 10;
+constexpr static inline size_t VERTICES_PER_BOX = 6;
+
+struct Vertex
+{
+	float x;
+	float y;
+};
+
+class BoxArtist;
+
+class Box : public GFXObject
+{
+public:
+	void refresh() override;
+
+	Box(BoxArtist* _artist, Rect _r);
+	~Box();
+
+private:
+	BoxArtist* artist_ = nullptr;
+};
+
+class BoxArtist : public IArtist
+{
+public:
+	using art_type = Box;
+
+	bool good() override
+	{
+		return this->vao_.good() && this->vbo_.good();
+	};
+
+	void insert(Box* _box)
+	{
+		this->boxes_.push_back(_box);
+		this->dirty_ = true;
+	};
+	void refresh(Box* _box)
+	{
+		this->dirty_ = true;
+	};
+
+	void remove(GFXObject* _obj) override
+	{
+		auto _it = std::find(this->boxes_.begin(), this->boxes_.end(), _obj);
+		if (_it != this->boxes_.end())
+		{
+			this->boxes_.erase(_it);
+			this->dirty_ = true;
+		};
+	};
+	bool contains(GFXObject* _obj) const override
+	{
+		return std::find(this->boxes_.begin(), this->boxes_.end(), _obj) != this->boxes_.end();
+	};
+
+	void draw() override
+	{
+		if (this->dirty_)
+		{
+			this->vertices_.clear();
+			for (auto& b : this->boxes_)
+			{
+				const auto& _r = b->bounds();
+				const Vertex _tl{ (float)_r.left(), (float)_r.top() };
+				const Vertex _tr{ (float)_r.right(), (float)_r.top() };
+				const Vertex _bl{ (float)_r.left(), (float)_r.bottom() };
+				const Vertex _br{ (float)_r.right(), (float)_r.bottom() };
+				this->vertices_.insert(this->vertices_.end(), { _tl, _bl, _tr, _tr, _bl, _br });
+			};
+			this->vbo_.assign(this->vertices_.data(), Bytes{ this->vertices_.size() * sizeof(Vertex) });
+			this->dirty_ = false;
+		};
+
+		this->shader_.bind();
+		this->vao_.bind();
+		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)this->vertices_.size());
+		this->vao_.unbind();
+		this->shader_.unbind();
+	};
+
+	GLuint buffer_id() const noexcept
+	{
+		return this->vbo_.id();
+	};
+
+	BoxArtist(ShaderProgram _shader) :
+		shader_{ std::move(_shader) }
+	{
+		this->vbo_.bind();
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+		this->vao_.unbind();
+	};
+
+private:
+	ShaderProgram shader_;
+	VAO vao_{};
+	VBO<GL_ARRAY_BUFFER> vbo_{};
+	std::vector<Box*> boxes_{};
+	std::vector<Vertex> vertices_{};
+	bool dirty_ = false;
+};
+
+void Box::refresh()
+{
+	GFXObject::refresh();
+	this->artist_->refresh(this);
+};
+
+Box::Box(BoxArtist* _artist, Rect _r) :
+	GFXObject{ _r }, artist_{ _artist }
+{
+	this->artist_->insert(this);
+};
+Box::~Box()
+{
+	this->artist_->remove(this);
+};
+
+static std::optional<ShaderProgram> make_shader()
+{
+	std::stringstream _vertex{ "#version 430 core\nlayout(location = 0) in vec2 pos;\nvoid main() { gl_Position = vec4(pos, 0.0, 1.0); }\n" };
+	std::stringstream _fragment{ "#version 430 core\nout vec4 col;\nvoid main() { col = vec4(1.0); }\n" };
+	return HACK_generate_shader(_vertex, _fragment);
+};
+
+static int run(size_t _count)
+{
+	gl::RecordingBackend::install();
+
+	auto _shader = make_shader();
+	if (!_shader || !_shader->good())
+	{
+		std::cout << "shader did not build against the recording backend\n";
+		return 1;
+	};
+
+	GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+	_context.register_artist("box", std::make_unique<BoxArtist>(std::move(*_shader)));
+	auto _artist = static_cast<BoxArtist*>(_context.find_artist("box"));
+
+	Box* _last = nullptr;
+	for (size_t _made = 0; _made < _count;)
+	{
+		auto _view = new GFXView{ &_context, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+		_view->grow_mode().set(GrowMode::gmRight).set(GrowMode::gmBottom);
+		for (size_t n = 0; n != BOXES_PER_VIEW && _made < _count; ++n, ++_made)
+		{
+			const auto _x = (int)((_made * 37) % 1500);
+			const auto _y = (int)((_made * 53) % 800);
+			_last = new Box{ _artist, Rect{{ _x, _y }, { _x + 20, _y + 20 }} };
+			_last->grow_mode().set(GrowMode::gmRight);
+			_view->emplace(_last);
+		};
+		_context.emplace(_view);
+	};
+	_context.refresh();
+	_context.draw();
+
+	gl::RecordingBackend::reset_counters();
+	const auto _start = std::chrono::steady_clock::now();
+	for (size_t f = 0; f != FRAMES; ++f)
+	{
+		Event::evCursorMove _move{};
+		_move.cursor_x = (int16_t)(f * 7 % 1600);
+		_move.cursor_y = (int16_t)(f * 3 % 900);
+		_context.post_event(Event{ _move, true });
+
+		if (f % GROW_EVERY == 0)
+		{
+			_context.grow((f % (GROW_EVERY * 2) == 0) ? 2_px : -2_px, 0_px);
+		};
+
+		_context.draw();
+	};
+	const auto _end = std::chrono::steady_clock::now();
+
+	const auto& _counters = gl::RecordingBackend::counters();
+	if (_counters.draw_calls != FRAMES || _counters.vertices_drawn != FRAMES * _count * VERTICES_PER_BOX)
+	{
+		std::cout << "expected one draw of every box per frame, got " << _counters.draw_calls << " draws\n";
+		return 1;
+	};
+
+	// The recorded buffer should hold the last box at its grown position
+	const auto _data = gl::RecordingBackend::buffer_data(_artist->buffer_id());
+	if (_data.size() != _count * VERTICES_PER_BOX * sizeof(Vertex))
+	{
+		std::cout << "vertex buffer is " << _data.size() << " bytes\n";
+		return 1;
+	};
+	Vertex _lastTopLeft{};
+	std::memcpy(&_lastTopLeft, _data.data() + (_count - 1) * VERTICES_PER_BOX * sizeof(Vertex), sizeof(Vertex));
+	if (_lastTopLeft.x != (float)_last->bounds().left() || _lastTopLeft.y != (float)_last->bounds().top())
+	{
+		std::cout << "vertex buffer does not match the last box\n";
+		return 1;
+	};
+
+	const auto _frameTime = std::chrono::duration<double, std::micro>(_end - _start).count() / (double)FRAMES;
+	std::cout << _count << " boxes : " << _frameTime << " us/frame, "
+		<< ((double)_counters.total_calls() / (double)FRAMES) << " gl calls/frame, "
+		<< ((double)_counters.bytes_uploaded / (double)FRAMES) << " bytes uploaded/frame\n";
+	for (size_t n = 0; n != gl::RecordingBackend::CALL_COUNT; ++n)
+	{
+		const auto _call = (gl::RecordingBackend::CALL)n;
+		if (_counters.count(_call) != 0)
+		{
+			std::cout << "\t" << gl::RecordingBackend::call_name(_call) << " : " << _counters.count(_call) << '\n';
+		};
+	};
+
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	for (auto _count : { 1000, 10000 })
+	{
+		if (auto _res = run(_count); _res != GOOD_TEST)
+		{
+			return _res;
+		};
+	};
+	return GOOD_TEST;
+};
@@ -0,0 +1,347 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_glObject.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Compares glQuadArtist against the per vertex upload scheme of the old glWidgetArtist (two glBufferSubData calls per
+	vertex, six vertices per widget) on the recording backend. Each frame recolors a scattered 1% of the quads and a
+	contiguous block, and every few frames the context grows so every quad changes.
+*/
+
+constexpr static inline size_t FRAMES = 100;
+constexpr static inline size_t GROW_EVERY = 20;
+constexpr static inline size_t BLOCK = 64;
+
+/**
+ * @brief Same upload pattern as the disabled glWidgetArtist, kept here as the baseline
+*/
+class PerVertexArtist : public IArtist
+{
+public:
+	struct Item : public GFXObject
+	{
+		void refresh() override
+		{
+			GFXObject::refresh();
+			this->artist->refresh(this);
+		};
+
+		Item(PerVertexArtist* _artist, Rect _r) :
+			GFXObject{ _r }, artist{ _artist }
+		{
+			this->artist->insert(this);
+		};
+
+		PerVertexArtist* artist;
+		ColorRGBA_8 color{};
+		size_t index = 0;
+	};
+
+	bool good() override { return true; };
+
+	void insert(Item* _item)
+	{
+		_item->index = this->items_.size();
+		this->items_.push_back(_item);
+		this->write_art(_item);
+	};
+	void refresh(Item* _item)
+	{
+		this->write_art(_item);
+	};
+	void remove(GFXObject* _obj) override {};
+	bool contains(GFXObject* _obj) const override { return false; };
+
+	void draw() override
+	{
+		this->shader_->bind();
+		this->vao_.bind();
+		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(this->items_.size() * 6));
+		this->vao_.unbind();
+	};
+
+	PerVertexArtist(ShaderProgram* _shader) :
+		shader_{ _shader }
+	{};
+
+private:
+	void write_vertex(size_t _vert, float_t _x, float_t _y, float_t _z, ColorRGBA_8 _color)
+	{
+		float_t _pos[3]{ _x, _y, _z };
+		this->vbo_.overwrite(Bytes{ _vert * 16 }, _pos, Bytes{ sizeof(_pos) });
+		this->vbo_.overwrite(Bytes{ (_vert * 16) + 12 }, _color.col, Bytes{ sizeof(_color) });
+	};
+	void write_art(Item* _item)
+	{
+		auto _l = (float_t)_item->bounds().left();
+		auto _t = (float_t)_item->bounds().top();
+		auto _r = (float_t)_item->bounds().right();
+		auto _b = (float_t)_item->bounds().bottom();
+		auto _z = (float_t)_item->zlayer();
+		auto _v = _item->index * 6;
+
+		this->write_vertex(_v++, _l, _b, _z, _item->color);
+		this->write_vertex(_v++, _l, _t, _z, _item->color);
+		this->write_vertex(_v++, _r, _t, _z, _item->color);
+		this->write_vertex(_v++, _l, _b, _z, _item->color);
+		this->write_vertex(_v++, _r, _t, _z, _item->color);
+		this->write_vertex(_v++, _r, _b, _z, _item->color);
+	};
+
+	ShaderProgram* shader_;
+	VAO vao_{};
+	VBO<GL_ARRAY_BUFFER> vbo_{};
+	std::vector<Item*> items_{};
+};
+
+static std::optional<ShaderProgram> make_shader()
+{
+	std::stringstream _vertex{ glQuadArtist::VERTEX_SHADER_SOURCE };
+	std::stringstream _fragment{ glQuadArtist::FRAGMENT_SHADER_SOURCE };
+	return HACK_generate_shader(_vertex, _fragment);
+};
+
+static Rect rect_for(size_t _n)
+{
+	const auto _x = (int)((_n * 37) % 1500);
+	const auto _y = (int)((_n * 53) % 800);
+	return Rect{{ _x, _y }, { _x + 20, _y + 20 }};
+};
+
+static ColorRGBA_8 color_for(size_t _n)
+{
+	ColorRGBA_8 _out{};
+	_out.r = (uint8_t)_n;
+	_out.g = (uint8_t)(_n >> 8);
+	_out.b = (uint8_t)(_n * 7);
+	_out.a = 255;
+	return _out;
+};
+
+struct FrameResult
+{
+	double us_per_frame = 0.0;
+	double calls_per_frame = 0.0;
+	double bytes_per_frame = 0.0;
+	double draws_per_frame = 0.0;
+};
+
+template <typename SetColorT, typename DrawT>
+static FrameResult run_frames(GFXContext& _context, size_t _count, SetColorT&& _setColor, DrawT&& _draw)
+{
+	gl::RecordingBackend::reset_counters();
+	const auto _start = std::chrono::steady_clock::now();
+	for (size_t f = 0; f != FRAMES; ++f)
+	{
+		for (size_t n = f % 100; n < _count; n += 100)
+		{
+			_setColor(n, color_for(n + f));
+		};
+		const auto _blockStart = (f * BLOCK) % (_count - BLOCK);
+		for (size_t n = _blockStart; n != _blockStart + BLOCK; ++n)
+		{
+			_setColor(n, color_for(n * 3 + f));
+		};
+		if (f % GROW_EVERY == 0)
+		{
+			_context.grow((f % (GROW_EVERY * 2) == 0) ? 2_px : -2_px, 0_px);
+		};
+		_context.refresh();
+		_draw();
+	};
+	const auto _end = std::chrono::steady_clock::now();
+
+	const auto& _counters = gl::RecordingBackend::counters();
+	FrameResult _out{};
+	_out.us_per_frame = std::chrono::duration<double, std::micro>(_end - _start).count() / (double)FRAMES;
+	_out.calls_per_frame = (double)_counters.total_calls() / (double)FRAMES;
+	_out.bytes_per_frame = (double)_counters.bytes_uploaded / (double)FRAMES;
+	_out.draws_per_frame = (double)_counters.draw_calls / (double)FRAMES;
+	return _out;
+};
+
+static void print(const char* _name, size_t _count, const FrameResult& _res)
+{
+	std::cout << _count << " quads, " << _name << " : " << _res.us_per_frame << " us/frame, " << _res.calls_per_frame
+		<< " gl calls/frame, " << _res.bytes_per_frame << " bytes uploaded/frame, " << _res.draws_per_frame << " draws/frame\n";
+};
+
+static bool buffer_matches(const glQuadArtist& _artist)
+{
+	const auto _data = gl::RecordingBackend::buffer_data(_artist.instance_buffer_id());
+	const auto _bytes = _artist.instances().size() * sizeof(glQuadArtist::Instance);
+	return _data.size() >= _bytes && std::memcmp(_data.data(), _artist.instances().data(), _bytes) == 0;
+};
+
+static int run(size_t _count)
+{
+	gl::RecordingBackend::install();
+	auto _shader = make_shader();
+	if (!_shader || !_shader->good())
+	{
+		std::cout << "shader did not build against the recording backend\n";
+		return 1;
+	};
+
+	FrameResult _perVertex{};
+	{
+		GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+		_context.register_artist("quad", std::make_unique<PerVertexArtist>(&*_shader));
+		auto _artist = static_cast<PerVertexArtist*>(_context.find_artist("quad"));
+
+		std::vector<PerVertexArtist::Item*> _items{};
+		for (size_t n = 0; n != _count; ++n)
+		{
+			_items.push_back(new PerVertexArtist::Item{ _artist, rect_for(n) });
+			_items.back()->grow_mode().set(GrowMode::gmRight);
+			_context.emplace(_items.back());
+		};
+		_context.refresh();
+		_context.draw();
+
+		_perVertex = run_frames(_context, _count,
+			[&_items](size_t n, ColorRGBA_8 _col) { _items[n]->color = _col; _items[n]->mark_dirty(); },
+			[&_context]() { _context.draw(); });
+	};
+
+	FrameResult _instanced{};
+	{
+		GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+		_context.register_artist("quad", std::make_unique<glQuadArtist>(&_context, &*_shader, 64));
+		auto _artist = static_cast<glQuadArtist*>(_context.find_artist("quad"));
+
+		std::vector<glQuad*> _quads{};
+		for (size_t n = 0; n != _count; ++n)
+		{
+			_quads.push_back(new glQuad{ _artist, rect_for(n), color_for(n) });
+			_quads.back()->grow_mode().set(GrowMode::gmRight);
+			_context.emplace(_quads.back());
+		};
+		_context.refresh();
+		_context.draw();
+		if (!_artist->last_draw_stats().reallocated || _artist->capacity() < _count || !buffer_matches(*_artist))
+		{
+			std::cout << "first draw did not upload every instance\n";
+			return 1;
+		};
+
+		_instanced = run_frames(_context, _count,
+			[&_quads](size_t n, ColorRGBA_8 _col) { _quads[n]->set_color(_col); },
+			[&_context]() { _context.draw(); });
+
+		const auto& _counters = gl::RecordingBackend::counters();
+		if (_counters.draw_calls != FRAMES || _counters.instances_drawn != FRAMES * _count)
+		{
+			std::cout << "expected one instanced draw per frame, got " << _counters.draw_calls << '\n';
+			return 1;
+		};
+		if (!buffer_matches(*_artist))
+		{
+			std::cout << "instance buffer does not match the quads after updates\n";
+			return 1;
+		};
+
+		// A frame with only the block changed uploads it in one call
+		for (size_t n = 0; n != BLOCK; ++n)
+		{
+			_quads[n + 10]->set_color(color_for(n));
+		};
+		_context.refresh();
+		_context.draw();
+		if (_artist->last_draw_stats().upload_calls != 1 || _artist->last_draw_stats().instances_uploaded != BLOCK)
+		{
+			std::cout << "contiguous changes were not merged into one upload\n";
+			return 1;
+		};
+
+		// Removing quads keeps the buffer in step with the remaining ones
+		for (size_t n = 0; n < _count; n += _count / 8)
+		{
+			_context.remove(_quads[n]);
+			_quads[n] = nullptr;
+		};
+		_context.draw();
+		if (_artist->size() != _count - 8 || !buffer_matches(*_artist))
+		{
+			std::cout << "instance buffer does not match the quads after removal\n";
+			return 1;
+		};
+
+		// Each removal moves the last record into the hole, so it costs at most one record upload
+		size_t _removed = 0;
+		gl::RecordingBackend::reset_counters();
+		const auto _start = std::chrono::steady_clock::now();
+		for (size_t n = 1; n < _count; n += 2)
+		{
+			if (_quads[n])
+			{
+				_context.remove(_quads[n]);
+				_quads[n] = nullptr;
+				++_removed;
+			};
+		};
+		_context.draw();
+		const auto _end = std::chrono::steady_clock::now();
+
+		const auto& _removeStats = _artist->last_draw_stats();
+		if (_artist->size() != _count - 8 - _removed || _removeStats.instances_uploaded > _removed ||
+			_removeStats.upload_calls > _removed || !buffer_matches(*_artist))
+		{
+			std::cout << "removal uploaded more than one record per removed quad\n";
+			return 1;
+		};
+		for (auto& q : _quads)
+		{
+			if (q && (!q->art_handle() || !_artist->contains(q)))
+			{
+				std::cout << "handle of a remaining quad was invalidated by removal\n";
+				return 1;
+			};
+		};
+		std::cout << _count << " quads, removing " << _removed << " : "
+			<< std::chrono::duration<double, std::micro>(_end - _start).count() << " us, "
+			<< _removeStats.upload_calls << " upload calls, "
+			<< gl::RecordingBackend::counters().bytes_uploaded << " bytes uploaded\n";
+	};
+
+	print("per vertex", _count, _perVertex);
+	print("instanced", _count, _instanced);
+	std::cout << "\t" << (_perVertex.calls_per_frame / _instanced.calls_per_frame) << "x fewer gl calls, "
+		<< (_perVertex.us_per_frame / _instanced.us_per_frame) << "x faster\n";
+
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	for (auto _count : { 1000, 10000 })
+	{
+		if (auto _res = run(_count); _res != GOOD_TEST)
+		{
+			return _res;
+		};
+	};
+	return GOOD_TEST;
+};
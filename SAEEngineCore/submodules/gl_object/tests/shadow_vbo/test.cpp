@@ -0,0 +1,251 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_glObject.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Runs an artist that writes its vertices with many small VBO::overwrite calls, two per vertex and six vertices per box,
+	with and without a shadowed buffer on the recording backend. The shadowed run should send each frame's writes in a few
+	merged ranges from IArtist::upload(), and orphan the buffer on the frames where every box moves.
+*/
+
+constexpr static inline size_t BOXES = 5000;
+constexpr static inline size_t FRAMES = 100;
+constexpr static inline size_t GROW_EVERY = 20;
+constexpr static inline size_t BLOCK = 64;
+
+class BoxArtist : public IArtist
+{
+public:
+	struct Box : public GFXObject
+	{
+		void refresh() override
+		{
+			GFXObject::refresh();
+			this->artist->write_art(this);
+		};
+
+		Box(BoxArtist* _artist, Rect _r) :
+			GFXObject{ _r }, artist{ _artist }
+		{
+			this->index = this->artist->count_++;
+			this->artist->write_art(this);
+		};
+
+		BoxArtist* artist;
+		ColorRGBA_8 color{};
+		size_t index = 0;
+	};
+
+	bool good() override { return true; };
+
+	void upload() override
+	{
+		this->vbo_.flush();
+	};
+	void draw() override
+	{
+		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(this->count_ * 6));
+	};
+
+	void remove(GFXObject* _obj) override {};
+	bool contains(GFXObject* _obj) const override { return false; };
+
+	const VBO<GL_ARRAY_BUFFER>& vbo() const noexcept { return this->vbo_; };
+
+	BoxArtist(bool _shadowed) :
+		vbo_{ gl::BUFFER_MODE::DYNAMIC_DRAW }
+	{
+		if (_shadowed)
+		{
+			this->vbo_.enable_shadow();
+		};
+	};
+
+private:
+	void write_vertex(size_t _vert, float_t _x, float_t _y, float_t _z, ColorRGBA_8 _color)
+	{
+		float_t _pos[3]{ _x, _y, _z };
+		this->vbo_.overwrite(Bytes{ _vert * 16 }, _pos, Bytes{ sizeof(_pos) });
+		this->vbo_.overwrite(Bytes{ (_vert * 16) + 12 }, _color.col, Bytes{ sizeof(_color) });
+	};
+	void write_art(Box* _box)
+	{
+		auto _l = (float_t)_box->bounds().left();
+		auto _t = (float_t)_box->bounds().top();
+		auto _r = (float_t)_box->bounds().right();
+		auto _b = (float_t)_box->bounds().bottom();
+		auto _z = (float_t)_box->zlayer();
+		auto _v = _box->index * 6;
+
+		this->write_vertex(_v++, _l, _b, _z, _box->color);
+		this->write_vertex(_v++, _l, _t, _z, _box->color);
+		this->write_vertex(_v++, _r, _t, _z, _box->color);
+		this->write_vertex(_v++, _l, _b, _z, _box->color);
+		this->write_vertex(_v++, _r, _t, _z, _box->color);
+		this->write_vertex(_v++, _r, _b, _z, _box->color);
+	};
+
+	VBO<GL_ARRAY_BUFFER> vbo_;
+	size_t count_ = 0;
+};
+
+static Rect rect_for(size_t _n)
+{
+	const auto _x = (int)((_n * 37) % 1500);
+	const auto _y = (int)((_n * 53) % 800);
+	return Rect{{ _x, _y }, { _x + 20, _y + 20 }};
+};
+
+static ColorRGBA_8 color_for(size_t _n)
+{
+	ColorRGBA_8 _out{};
+	_out.r = (uint8_t)_n;
+	_out.g = (uint8_t)(_n >> 8);
+	_out.b = (uint8_t)(_n * 7);
+	_out.a = 255;
+	return _out;
+};
+
+struct Result
+{
+	double us_per_frame = 0.0;
+	double calls_per_frame = 0.0;
+	double bytes_per_frame = 0.0;
+};
+
+static int run(bool _shadowed, Result& _result)
+{
+	GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+	_context.register_artist("box", std::make_unique<BoxArtist>(_shadowed));
+	auto _artist = static_cast<BoxArtist*>(_context.find_artist("box"));
+
+	std::vector<BoxArtist::Box*> _boxes{};
+	for (size_t n = 0; n != BOXES; ++n)
+	{
+		_boxes.push_back(new BoxArtist::Box{ _artist, rect_for(n) });
+		_boxes.back()->grow_mode().set(GrowMode::gmRight);
+		_context.emplace(_boxes.back());
+	};
+	_context.refresh();
+	_context.draw();
+
+	const auto& _vbo = _artist->vbo();
+	gl::RecordingBackend::reset_counters();
+	const auto _start = std::chrono::steady_clock::now();
+	for (size_t f = 0; f != FRAMES; ++f)
+	{
+		for (size_t n = f % 100; n < BOXES; n += 100)
+		{
+			_boxes[n]->color = color_for(n + f);
+			_boxes[n]->mark_dirty();
+		};
+		const auto _blockStart = (f * BLOCK) % (BOXES - BLOCK);
+		for (size_t n = _blockStart; n != _blockStart + BLOCK; ++n)
+		{
+			_boxes[n]->color = color_for(n * 3 + f);
+			_boxes[n]->mark_dirty();
+		};
+		if (f % GROW_EVERY == 0)
+		{
+			_context.grow((f % (GROW_EVERY * 2) == 0) ? 2_px : -2_px, 0_px);
+		};
+		_context.refresh();
+		_context.draw();
+
+		if (_shadowed)
+		{
+			const auto _data = gl::RecordingBackend::buffer_data(_vbo.id());
+			const auto _shadow = _vbo.shadow();
+			if (_vbo.needs_flush() || _data.size() < _shadow.size() ||
+				std::memcmp(_data.data(), _shadow.data(), _shadow.size()) != 0)
+			{
+				std::cout << "buffer does not match its shadow after frame " << f << '\n';
+				return 1;
+			};
+		};
+	};
+	const auto _end = std::chrono::steady_clock::now();
+
+	const auto& _counters = gl::RecordingBackend::counters();
+	_result.us_per_frame = std::chrono::duration<double, std::micro>(_end - _start).count() / (double)FRAMES;
+	_result.calls_per_frame = (double)_counters.total_calls() / (double)FRAMES;
+	_result.bytes_per_frame = (double)_counters.bytes_uploaded / (double)FRAMES;
+
+	if (_shadowed)
+	{
+		// Grow frames touch every box and orphan, the others send one range per scattered box plus one for the block
+		const auto& _stats = _vbo.stats();
+		const auto _growFrames = FRAMES / GROW_EVERY;
+		if (_stats.orphans < _growFrames || _stats.orphans > _growFrames + 1 ||
+			_stats.ranges_uploaded > _stats.orphans + (FRAMES - _growFrames) * (BOXES / 100 + 1))
+		{
+			std::cout << "flushes were not merged as expected, " << _stats.orphans << " orphans, "
+				<< _stats.ranges_uploaded << " ranges\n";
+			return 2;
+		};
+
+		// A single write is merged into one range and stays below the orphan threshold
+		_boxes[10]->color = color_for(1);
+		_boxes[10]->mark_dirty();
+		_context.refresh();
+		const auto _before = _vbo.stats();
+		_context.draw();
+		if (_vbo.stats().ranges_uploaded != _before.ranges_uploaded + 1 || _vbo.stats().orphans != _before.orphans ||
+			_vbo.stats().bytes_uploaded != _before.bytes_uploaded + 6 * 16)
+		{
+			std::cout << "one changed box was not sent as one range\n";
+			return 3;
+		};
+	};
+
+	return GOOD_TEST;
+};
+
+static void print(const char* _name, const Result& _res)
+{
+	std::cout << BOXES << " boxes, " << _name << " : " << _res.us_per_frame << " us/frame, " << _res.calls_per_frame
+		<< " gl calls/frame, " << _res.bytes_per_frame << " bytes uploaded/frame\n";
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	gl::RecordingBackend::install();
+
+	Result _direct{};
+	if (auto _res = run(false, _direct); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+	Result _shadowed{};
+	if (auto _res = run(true, _shadowed); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+
+	print("overwrite per write", _direct);
+	print("shadowed", _shadowed);
+	std::cout << "\t" << (_direct.calls_per_frame / _shadowed.calls_per_frame) << "x fewer gl calls\n";
+
+	return GOOD_TEST;
+};
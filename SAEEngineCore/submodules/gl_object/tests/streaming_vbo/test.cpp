@@ -0,0 +1,192 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_glObject.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Streams a frame of vertices per iteration through StreamingVBO on both of its paths and through VBO::overwrite from
+	a staging vector, on the recording backend. Checks the regions rotate, every region is fenced and waited on before it
+	is reused, and the vertices land in the buffer where end() says they are.
+*/
+
+constexpr static inline size_t FRAMES = 300;
+constexpr static inline size_t VERTICES = 4096;
+
+struct Vertex
+{
+	float_t x;
+	float_t y;
+	float_t u;
+	float_t v;
+};
+
+static Vertex vertex_for(size_t _n, size_t _frame)
+{
+	const auto _f = (float_t)(_n + _frame);
+	return Vertex{ _f, _f * 0.5f, _f * 0.25f, 1.0f };
+};
+
+struct Result
+{
+	double us_per_frame = 0.0;
+	double calls_per_frame = 0.0;
+	double bytes_uploaded_per_frame = 0.0;
+};
+
+static Result finish(std::chrono::steady_clock::time_point _start)
+{
+	const auto _end = std::chrono::steady_clock::now();
+	const auto& _counters = gl::RecordingBackend::counters();
+	Result _out{};
+	_out.us_per_frame = std::chrono::duration<double, std::micro>(_end - _start).count() / (double)FRAMES;
+	_out.calls_per_frame = (double)_counters.total_calls() / (double)FRAMES;
+	_out.bytes_uploaded_per_frame = (double)_counters.bytes_uploaded / (double)FRAMES;
+	return _out;
+};
+
+static void print(const char* _name, const Result& _res)
+{
+	std::cout << _name << " : " << _res.us_per_frame << " us/frame, " << _res.calls_per_frame << " gl calls/frame, "
+		<< _res.bytes_uploaded_per_frame << " bytes uploaded/frame\n";
+};
+
+static Result run_staged()
+{
+	VBO<GL_ARRAY_BUFFER> _vbo{ Bytes{ VERTICES * sizeof(Vertex) } };
+	std::vector<Vertex> _staging(VERTICES);
+
+	gl::RecordingBackend::reset_counters();
+	const auto _start = std::chrono::steady_clock::now();
+	for (size_t f = 0; f != FRAMES; ++f)
+	{
+		for (size_t n = 0; n != VERTICES; ++n)
+		{
+			_staging[n] = vertex_for(n, f);
+		};
+		_vbo.overwrite(Bytes{ 0 }, _staging.data(), Bytes{ _staging.size() * sizeof(Vertex) });
+		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)VERTICES);
+	};
+	return finish(_start);
+};
+
+static int run_streaming(bool _persistent, Result& _result)
+{
+	StreamingVBO<GL_ARRAY_BUFFER> _vbo{ Bytes{ VERTICES * sizeof(Vertex) }, 3, _persistent };
+	if (!_vbo.good() || _vbo.persistent() != _persistent || _vbo.region_size().count() % 256 != 0)
+	{
+		std::cout << "streaming buffer was not created on the expected path\n";
+		return 1;
+	};
+
+	gl::RecordingBackend::reset_counters();
+	const auto _start = std::chrono::steady_clock::now();
+	for (size_t f = 0; f != FRAMES; ++f)
+	{
+		_vbo.begin();
+		auto _vertices = _vbo.allocate<Vertex>(VERTICES);
+		if (_vertices.size() != VERTICES || _vbo.region_index() != f % 3)
+		{
+			std::cout << "frame " << f << " did not get a full region in turn\n";
+			return 2;
+		};
+		for (size_t n = 0; n != VERTICES; ++n)
+		{
+			_vertices[n] = vertex_for(n, f);
+		};
+		const auto _offset = _vbo.end();
+		glDrawArrays(GL_TRIANGLES, (GLint)(_offset.count() / sizeof(Vertex)), (GLsizei)VERTICES);
+	};
+	_result = finish(_start);
+
+	const auto& _counters = gl::RecordingBackend::counters();
+	using CALL = gl::RecordingBackend::CALL;
+	if (_counters.count(CALL::BUFFER_SUB_DATA) != 0 || _counters.bytes_uploaded != 0)
+	{
+		std::cout << "streaming buffer copied vertex data instead of writing it in place\n";
+		return 3;
+	};
+	if (_counters.count(CALL::FENCE_SYNC) != FRAMES - 1 || _counters.count(CALL::CLIENT_WAIT_SYNC) != FRAMES - 3)
+	{
+		std::cout << "expected a fence per frame and a wait before each region was reused\n";
+		return 4;
+	};
+	if (_counters.count(CALL::MAP_BUFFER_RANGE) != (_persistent ? 0 : FRAMES))
+	{
+		std::cout << "unexpected number of map calls\n";
+		return 5;
+	};
+
+	// The last frame is in the buffer at the offset end() gave
+	const auto _data = gl::RecordingBackend::buffer_data(_vbo.id());
+	const auto _offset = _vbo.region_offset().count();
+	for (size_t n = 0; n != VERTICES; ++n)
+	{
+		const auto _expected = vertex_for(n, FRAMES - 1);
+		if (_data.size() < _offset + (n + 1) * sizeof(Vertex) ||
+			std::memcmp(_data.data() + _offset + n * sizeof(Vertex), &_expected, sizeof(Vertex)) != 0)
+		{
+			std::cout << "vertex " << n << " of the last frame is not in the buffer\n";
+			return 6;
+		};
+	};
+
+	// Allocations past the end of a region are refused
+	_vbo.begin();
+	if (!_vbo.allocate<Vertex>(VERTICES + 1024).empty() || _vbo.allocate<Vertex>(1).size() != 1)
+	{
+		std::cout << "region allowed an allocation past its end\n";
+		return 7;
+	};
+	_vbo.end();
+
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	gl::RecordingBackend::install();
+	if (!gl::extensions().buffer_storage)
+	{
+		std::cout << "recording backend did not provide glBufferStorage\n";
+		return 1;
+	};
+
+	const auto _staged = run_staged();
+
+	Result _persistent{};
+	if (auto _res = run_streaming(true, _persistent); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+	Result _mapped{};
+	if (auto _res = run_streaming(false, _mapped); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+
+	print("VBO::overwrite", _staged);
+	print("StreamingVBO persistent", _persistent);
+	print("StreamingVBO map per region", _mapped);
+
+	return GOOD_TEST;
+};
@@ -0,0 +1,171 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_glObject.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Fills a VBO one record at a time with append() under each growth policy on the recording backend, and reports the
+	reallocations and bytes copied along the way. Also checks reserve() and erase() keep the contents and that the usage
+	hint given to the VBO reaches glBufferData.
+*/
+
+constexpr static inline size_t RECORDS = 10000;
+
+struct Record
+{
+	uint32_t values[4];
+};
+
+static Record record_for(size_t _n)
+{
+	return Record{ { (uint32_t)_n, (uint32_t)(_n * 3), (uint32_t)(_n * 7), 0xFFu } };
+};
+
+static bool contents_match(const VBO<GL_ARRAY_BUFFER>& _vbo, const std::vector<Record>& _expected)
+{
+	const auto _data = gl::RecordingBackend::buffer_data(_vbo.id());
+	const auto _bytes = _expected.size() * sizeof(Record);
+	return _vbo.size().count() == _bytes && _data.size() >= _bytes && std::memcmp(_data.data(), _expected.data(), _bytes) == 0;
+};
+
+static const char* policy_name(gl::GROWTH_POLICY _growth)
+{
+	switch (_growth)
+	{
+	case gl::GROWTH_POLICY::EXACT:
+		return "exact";
+	case gl::GROWTH_POLICY::ONE_AND_HALF:
+		return "1.5x";
+	default:
+		return "double";
+	};
+};
+
+static int fill(gl::GROWTH_POLICY _growth, size_t& _reallocations)
+{
+	VBO<GL_ARRAY_BUFFER> _vbo{ gl::BUFFER_MODE::DYNAMIC_DRAW, _growth };
+	std::vector<Record> _expected{};
+
+	const auto _start = std::chrono::steady_clock::now();
+	for (size_t n = 0; n != RECORDS; ++n)
+	{
+		const auto _rec = record_for(n);
+		_vbo.append(&_rec, Bytes{ sizeof(Record) });
+		_expected.push_back(_rec);
+	};
+	const auto _end = std::chrono::steady_clock::now();
+
+	if (!contents_match(_vbo, _expected) || _vbo.capacity() < _vbo.size())
+	{
+		std::cout << policy_name(_growth) << " : buffer contents lost while growing\n";
+		return 1;
+	};
+	if (gl::RecordingBackend::buffer_usage(_vbo.id()) != GL_DYNAMIC_DRAW)
+	{
+		std::cout << policy_name(_growth) << " : usage hint was not passed to glBufferData\n";
+		return 2;
+	};
+
+	_reallocations = _vbo.stats().reallocations;
+	std::cout << policy_name(_growth) << " : " << RECORDS << " appends, " << _vbo.stats().reallocations << " reallocations, "
+		<< _vbo.stats().bytes_copied << " bytes copied, capacity " << _vbo.capacity().count() << " bytes, "
+		<< std::chrono::duration<double, std::micro>(_end - _start).count() << " us\n";
+
+	_vbo.shrink_to_fit();
+	if (_vbo.capacity() != _vbo.size() || !contents_match(_vbo, _expected))
+	{
+		std::cout << policy_name(_growth) << " : shrink_to_fit lost the contents\n";
+		return 3;
+	};
+
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	gl::RecordingBackend::install();
+
+	size_t _exact = 0;
+	size_t _half = 0;
+	size_t _double = 0;
+	if (auto _res = fill(gl::GROWTH_POLICY::EXACT, _exact); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+	if (auto _res = fill(gl::GROWTH_POLICY::ONE_AND_HALF, _half); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+	if (auto _res = fill(gl::GROWTH_POLICY::DOUBLE, _double); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+
+	// The first append allocates, every later one reallocates
+	if (_exact != RECORDS - 1 || _double > 16 || _half > 32 || _double >= _half)
+	{
+		std::cout << "reallocation counts do not follow the growth policies\n";
+		return 4;
+	};
+
+	// The default buffer keeps the old behaviour of a static draw buffer
+	{
+		VBO<GL_ARRAY_BUFFER> _vbo{ Bytes{ 64 } };
+		if (gl::RecordingBackend::buffer_usage(_vbo.id()) != GL_STATIC_DRAW || _vbo.growth_policy() != gl::GROWTH_POLICY::DOUBLE)
+		{
+			std::cout << "default buffer mode or growth policy changed\n";
+			return 5;
+		};
+	};
+
+	// erase() only moves the data after the erased range
+	{
+		VBO<GL_ARRAY_BUFFER> _vbo{};
+		std::vector<Record> _expected{};
+		for (size_t n = 0; n != 100; ++n)
+		{
+			_expected.push_back(record_for(n));
+		};
+		_vbo.assign(_expected.data(), Bytes{ _expected.size() * sizeof(Record) });
+		_vbo.reset_stats();
+
+		_vbo.erase(Bytes{ 90 * sizeof(Record) }, Bytes{ 5 * sizeof(Record) });
+		_expected.erase(_expected.begin() + 90, _expected.begin() + 95);
+		if (!contents_match(_vbo, _expected) || _vbo.stats().bytes_copied != 2 * 5 * sizeof(Record))
+		{
+			std::cout << "erase moved the wrong data\n";
+			return 6;
+		};
+
+		// Erasing the tail moves nothing
+		_vbo.erase(Bytes{ 90 * sizeof(Record) }, Bytes{ 5 * sizeof(Record) });
+		_expected.resize(90);
+		if (!contents_match(_vbo, _expected) || _vbo.stats().bytes_copied != 2 * 5 * sizeof(Record))
+		{
+			std::cout << "erasing the tail copied data\n";
+			return 7;
+		};
+	};
+
+	return GOOD_TEST;
+};
@@ -1,38 +1,533 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
 #include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace sae::engine::core
 {
+	/**
+	 * @brief What a LogStream does with a record when its queue is full
+	*/
+	enum class LOG_OVERFLOW : uint8_t
+	{
+		// Wait for the background thread to make room, nothing is lost
+		BLOCK,
 
-	struct LogStream
+		// Throw the record away and count it in LogStream::Stats::dropped
+		DROP,
+
+		// Write the record to the sink from the calling thread, it may land ahead of records still queued
+		WRITE_THROUGH,
+	};
+
+	/**
+	 * @brief How a LogStream writes records to its sink
+	*/
+	enum class LOG_OUTPUT : uint8_t
 	{
-	private:
-		void _Pre_Write() const noexcept;
-		void _Post_Write() const noexcept;
+		// Plain text, structured records are formatted by the background thread
+		TEXT,
+
+		// Binary stream read back with decode_log() or the SAEEngineCore_LogDecoder tool, structured records are written
+		// as their format id and argument bytes and never formatted by the program
+		BINARY,
+	};
+
+	/**
+	 * @brief Compile time format string for LogStream::structured, "{}" is replaced by the next argument and "{{" and
+	 * "}}" write a single brace
+	*/
+	template <size_t N>
+	struct LogFormat
+	{
+	public:
+		char str[N]{};
+
+		// FNV-1a hash of the format string, identifies it in the log
+		uint64_t id = 0;
+
+		// Number of "{}" placeholders
+		size_t args = 0;
+
+		constexpr std::string_view view() const noexcept
+		{
+			return std::string_view{ this->str, N - 1 };
+		};
+
+		consteval LogFormat(const char(&_str)[N])
+		{
+			uint64_t _hash = 14695981039346656037ull;
+			for (size_t n = 0; n != N - 1; ++n)
+			{
+				this->str[n] = _str[n];
+				_hash = (_hash ^ (uint8_t)_str[n]) * 1099511628211ull;
+			};
+			this->id = _hash;
+
+			for (size_t n = 0; n + 1 < N - 1; ++n)
+			{
+				if ((_str[n] == '{' && _str[n + 1] == '{') || (_str[n] == '}' && _str[n + 1] == '}'))
+				{
+					++n;
+				}
+				else if (_str[n] == '{' && _str[n + 1] == '}')
+				{
+					++this->args;
+					++n;
+				};
+			};
+		};
+	};
+
+	namespace log_detail
+	{
+		/**
+		 * @brief Tag written ahead of each argument of a structured record
+		*/
+		enum class ARG : uint8_t
+		{
+			I64 = 1,
+			U64,
+			F64,
+			BOOL,
+			CHAR,
+
+			// u32 length followed by the characters
+			STRING,
+
+			POINTER,
+		};
+
+		template <typename T>
+		constexpr bool is_string_v =
+			std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+			std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+		// Enums are logged as their value, even when the underlying type is char or bool
+		template <typename T>
+		using enum_integer_t = std::conditional_t<std::is_signed_v<std::underlying_type_t<T>>, int64_t, uint64_t>;
+
+		template <typename T>
+		inline size_t encoded_size(const T& _value)
+		{
+			using type = std::decay_t<T>;
+			if constexpr (is_string_v<type>)
+			{
+				return 1 + sizeof(uint32_t) + std::string_view{ _value }.size();
+			}
+			else if constexpr (std::is_same_v<type, bool> || std::is_same_v<type, char>)
+			{
+				return 2;
+			}
+			else if constexpr (std::is_enum_v<type>)
+			{
+				return encoded_size((enum_integer_t<type>)_value);
+			}
+			else
+			{
+				return 1 + 8;
+			};
+		};
+
+		template <typename T>
+		inline char* encode_value(char* _dest, ARG _tag, const T& _value)
+		{
+			*_dest = (char)_tag;
+			std::memcpy(_dest + 1, &_value, sizeof(T));
+			return _dest + 1 + sizeof(T);
+		};
+
+		template <typename T>
+		inline char* encode(char* _dest, const T& _value)
+		{
+			using type = std::decay_t<T>;
+			if constexpr (is_string_v<type>)
+			{
+				const std::string_view _str{ _value };
+				_dest = encode_value(_dest, ARG::STRING, (uint32_t)_str.size());
+				std::memcpy(_dest, _str.data(), _str.size());
+				return _dest + _str.size();
+			}
+			else if constexpr (std::is_same_v<type, bool>)
+			{
+				return encode_value(_dest, ARG::BOOL, (uint8_t)_value);
+			}
+			else if constexpr (std::is_same_v<type, char>)
+			{
+				return encode_value(_dest, ARG::CHAR, _value);
+			}
+			else if constexpr (std::is_enum_v<type>)
+			{
+				return encode(_dest, (enum_integer_t<type>)_value);
+			}
+			else if constexpr (std::is_integral_v<type> && std::is_signed_v<type>)
+			{
+				return encode_value(_dest, ARG::I64, (int64_t)_value);
+			}
+			else if constexpr (std::is_integral_v<type>)
+			{
+				return encode_value(_dest, ARG::U64, (uint64_t)_value);
+			}
+			else if constexpr (std::is_floating_point_v<type>)
+			{
+				return encode_value(_dest, ARG::F64, (double)_value);
+			}
+			else if constexpr (std::is_pointer_v<type>)
+			{
+				return encode_value(_dest, ARG::POINTER, (uint64_t)(uintptr_t)_value);
+			}
+			else
+			{
+				static_assert(std::is_pointer_v<type>, "type can't be written to a structured log record, convert it to a string or number");
+				return _dest;
+			};
+		};
+	}
+
+	/**
+	 * @brief Remembers the format string for a structured record id, called once per LogStream::structured call site
+	 * @return False if a different format string already has this id
+	*/
+	bool register_log_format(uint64_t _id, std::string_view _format);
 
+	/**
+	 * @brief Returns the format string registered for _id, or an empty view
+	*/
+	std::string_view find_log_format(uint64_t _id);
+
+	/**
+	 * @brief Appends a structured record's text to _out, _args being the encoded arguments that follow its format id
+	 * @return False if _args is malformed, what could be read is still written
+	*/
+	bool format_log_record(std::string_view _format, std::string_view _args, std::string& _out);
+
+	/**
+	 * @brief Converts a log written with LOG_OUTPUT::BINARY back to text
+	 * @return False if _in is not a binary log or is damaged, everything before the damage is still written
+	*/
+	bool decode_log(std::istream& _in, std::ostream& _out);
+
+	/**
+	 * @brief Thread safe log stream that writes to its sink from a background thread.
+	 *
+	 * Each "lout << a << b << c;" statement builds one record in a buffer owned by the calling thread and hands the
+	 * whole record to a lock free queue at the end of the statement, so records from different threads never interleave
+	 * and writers only wait when the queue is full and the overflow policy is BLOCK. The background thread is started by
+	 * the first record and drains the queue to the sink in batches.
+	*/
+	struct LogStream
+	{
 	public:
+		/**
+		 * @brief One log record being built, committed to its stream when destroyed at the end of the full expression
+		*/
+		class Record
+		{
+		public:
+			template <typename T>
+			Record& operator<<(const T& _t)
+			{
+				(*this->out_) << _t;
+				return *this;
+			};
+			Record& operator<<(std::ostream& (*_manip)(std::ostream&))
+			{
+				(*this->out_) << _manip;
+				return *this;
+			};
+
+			Record(const Record& other) = delete;
+			Record& operator=(const Record& other) = delete;
+
+			Record(Record&& other) noexcept;
+			Record& operator=(Record&& other) = delete;
+
+			explicit Record(LogStream& _owner);
+			~Record();
+
+		private:
+			LogStream* owner_ = nullptr;
+			std::ostream* out_ = nullptr;
+
+			// Formatting buffer, the calling thread's own unless that one is busy with an enclosing record
+			void* buffer_ = nullptr;
+		};
+
+		/**
+		 * @brief Totals since construction
+		*/
+		struct Stats
+		{
+			// Records written to the sink by the background thread
+			uint64_t records = 0;
+			uint64_t bytes = 0;
+
+			uint64_t dropped = 0;
+
+			// Records that found the queue full and waited under LOG_OVERFLOW::BLOCK
+			uint64_t blocked = 0;
+
+			// Records written from the calling thread, because of WRITE_THROUGH, after shutdown(), or because they were
+			// larger than the whole queue, in which case the queue is drained first
+			uint64_t written_through = 0;
+
+			// Records logged with structured(), also counted in the totals above
+			uint64_t structured = 0;
+		};
 
 		template <typename T>
-		friend inline LogStream& operator<<(LogStream& _lstr, const T& _t)
+		friend inline Record operator<<(LogStream& _lstr, const T& _t)
 		{
-			_lstr._Pre_Write();
-			(*_lstr.ostr_) << _t;
-			_lstr._Post_Write();
-			return _lstr;
+			Record _record{ _lstr };
+			_record << _t;
+			return _record;
 		};
-		
+
+		/**
+		 * @brief Logs a record whose formatting is left to the background thread, or to decode_log() for a BINARY stream.
+		 *
+		 * The calling thread only copies the format id and the raw argument values into the queue, e.g.
+		 *	lout.structured<"frame {} took {} ms\n">(_frame, _ms);
+		 * Arguments can be numbers, bools, chars, enums, pointers and strings, strings are copied.
+		*/
+		template <LogFormat Format, typename... Ts>
+		void structured(const Ts&... _args)
+		{
+			static_assert(sizeof...(Ts) == Format.args, "argument count doesn't match the number of {} in the format");
+
+			static const bool _registered = register_log_format(Format.id, Format.view());
+			(void)_registered;
+
+			constexpr size_t STACK_BYTES = 256;
+			const size_t _len = sizeof(uint64_t) + (log_detail::encoded_size(_args) + ... + 0);
+			if (_len <= STACK_BYTES)
+			{
+				char _buffer[STACK_BYTES];
+				this->encode_structured(_buffer, Format.id, _args...);
+				this->commit(_buffer, _len, RECORD::STRUCTURED);
+			}
+			else
+			{
+				std::string _buffer(_len, '\0');
+				this->encode_structured(_buffer.data(), Format.id, _args...);
+				this->commit(_buffer.data(), _len, RECORD::STRUCTURED);
+			};
+		};
+
+		/**
+		 * @brief Waits until everything committed so far has been written, then flushes the sink
+		*/
 		void flush();
 
-		LogStream(std::ostream* _ostr) noexcept;
+		/**
+		 * @brief Drains the queue and stops the background thread, later records are written from the calling thread
+		*/
+		void shutdown();
+
+		LOG_OVERFLOW overflow() const noexcept;
+		void set_overflow(LOG_OVERFLOW _policy) noexcept;
+
+		LOG_OUTPUT output() const noexcept;
+
+		Stats stats() const noexcept;
+
+		LogStream(const LogStream& other) = delete;
+		LogStream& operator=(const LogStream& other) = delete;
+
+		/**
+		 * @param _ostr Sink, only written to by the background thread and under the sink lock
+		 * @param _queueBytes Approximate size of the record queue
+		 * @param _output LOG_OUTPUT::BINARY needs a sink opened in binary mode
+		*/
+		LogStream(std::ostream* _ostr, size_t _queueBytes = 512 * 1024, LOG_OVERFLOW _policy = LOG_OVERFLOW::BLOCK,
+			LOG_OUTPUT _output = LOG_OUTPUT::TEXT);
+		~LogStream();
 
 	private:
-		std::ostream* ostr_ = nullptr;
+		class Queue;
+
+		enum class RECORD : uint8_t
+		{
+			TEXT,
+
+			// Format id followed by the encoded arguments
+			STRUCTURED,
+		};
+
+		template <typename... Ts>
+		static void encode_structured(char* _dest, uint64_t _id, const Ts&... _args)
+		{
+			std::memcpy(_dest, &_id, sizeof(_id));
+			_dest += sizeof(_id);
+			((_dest = log_detail::encode(_dest, _args)), ...);
+		};
 
+		void commit(const char* _data, size_t _len, RECORD _kind = RECORD::TEXT);
+		void write_through(const char* _data, size_t _len, RECORD _kind);
+
+		std::ostream* ostr_ = nullptr;
+		std::unique_ptr<Queue> queue_;
+		std::atomic<LOG_OVERFLOW> overflow_{ LOG_OVERFLOW::BLOCK };
 	};
 
 	using log_t = LogStream;
-	
+
 	extern log_t lout;
 
-}
\ No newline at end of file
+	/**
+	 * @brief Severity of a record logged through SAE_LOG. ERR is not named ERROR as windows.h defines that as a macro
+	*/
+	enum class LOG_LEVEL : uint8_t
+	{
+		TRACE,
+		DEBUG,
+		INFO,
+		WARN,
+		ERR,
+
+		// Only used as a threshold, turns everything off
+		OFF,
+	};
+
+/**
+ * @brief Lowest level compiled in, SAE_LOG statements below it compile to nothing. Set through the
+ * SAE_ENGINE_CORE_LOG_LEVEL cmake option
+*/
+#ifndef SAE_ENGINE_CORE_LOG_LEVEL
+#define SAE_ENGINE_CORE_LOG_LEVEL 0
+#endif
+
+	constexpr LOG_LEVEL LOG_LEVEL_COMPILED = (LOG_LEVEL)SAE_ENGINE_CORE_LOG_LEVEL;
+
+	/**
+	 * @brief One log channel per submodule, GENERAL for everything else
+	*/
+	enum class LOG_CHANNEL : uint8_t
+	{
+		GENERAL,
+		ARTIST,
+		ENVIRONMENT,
+		EVENT,
+		FILEHANDLING,
+		GL_OBJECT,
+		INPUT,
+		ISO,
+		OBJECT,
+		SHADER,
+		TEXTURE,
+		UI,
+		WIDGET,
+		WINDOW,
+
+		COUNT,
+	};
+
+	/**
+	 * @brief Runtime level and destination of one LOG_CHANNEL, can be changed from any thread
+	*/
+	class LogChannel
+	{
+	public:
+		/**
+		 * @brief Checked by SAE_LOG before the streamed arguments are evaluated, a single relaxed load
+		*/
+		bool enabled(LOG_LEVEL _level) const noexcept
+		{
+			return _level >= this->level_.load(std::memory_order_relaxed);
+		};
+
+		LOG_LEVEL level() const noexcept
+		{
+			return this->level_.load(std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Records below _level are skipped, LOG_LEVEL::OFF disables the channel
+		*/
+		void set_level(LOG_LEVEL _level) noexcept
+		{
+			this->level_.store(_level, std::memory_order_relaxed);
+		};
+
+		log_t& stream() const noexcept
+		{
+			return *this->stream_.load(std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Sends the channel's records to _stream instead of lout, _stream must outlive its use
+		*/
+		void set_stream(log_t& _stream) noexcept
+		{
+			this->stream_.store(&_stream, std::memory_order_relaxed);
+		};
+
+		std::string_view name() const noexcept
+		{
+			return this->name_;
+		};
+
+		constexpr LogChannel(std::string_view _name, log_t* _stream) noexcept :
+			name_{ _name }, stream_{ _stream }
+		{};
+
+	private:
+		std::string_view name_;
+		std::atomic<LOG_LEVEL> level_{ LOG_LEVEL::INFO };
+		std::atomic<log_t*> stream_;
+	};
+
+	/**
+	 * @brief Indexed by LOG_CHANNEL, every channel starts at LOG_LEVEL::INFO writing to lout
+	*/
+	extern LogChannel log_channels[(size_t)LOG_CHANNEL::COUNT];
+
+	inline LogChannel& log_channel(LOG_CHANNEL _channel) noexcept
+	{
+		return log_channels[(size_t)_channel];
+	};
+
+	/**
+	 * @brief Finds a channel by its lower case name, e.g. "filehandling"
+	 * @return nullptr if there is no such channel
+	*/
+	LogChannel* find_log_channel(std::string_view _name) noexcept;
+
+	/**
+	 * @brief Sets the level of every channel
+	*/
+	void set_log_level(LOG_LEVEL _level) noexcept;
+
+}
+
+/**
+ * @brief Starts a record on a channel, prefixed with its level and channel, e.g.
+ *	SAE_LOG(FILEHANDLING, WARN) << "file: " << _filename << " could not be found\n";
+ *
+ * Levels below SAE_ENGINE_CORE_LOG_LEVEL compile to nothing. Otherwise a disabled channel costs one relaxed load and the
+ * streamed arguments are not evaluated. Expands to an if / else, so use it as a whole statement.
+*/
+#define SAE_LOG(_channel, _level) \
+	if constexpr (::sae::engine::core::LOG_LEVEL::_level < ::sae::engine::core::LOG_LEVEL_COMPILED) {} \
+	else if (!::sae::engine::core::log_channel(::sae::engine::core::LOG_CHANNEL::_channel) \
+		.enabled(::sae::engine::core::LOG_LEVEL::_level)) {} \
+	else ::sae::engine::core::log_channel(::sae::engine::core::LOG_CHANNEL::_channel).stream() \
+		<< "[" #_level "][" #_channel "] "
+
+/**
+ * @brief SAE_LOG for a structured record, see LogStream::structured, e.g.
+ *	SAE_LOG_STRUCTURED(SHADER, INFO, "compiled {} in {} ms\n", _name, _ms);
+*/
+#define SAE_LOG_STRUCTURED(_channel, _level, _format, ...) \
+	if constexpr (::sae::engine::core::LOG_LEVEL::_level < ::sae::engine::core::LOG_LEVEL_COMPILED) {} \
+	else if (!::sae::engine::core::log_channel(::sae::engine::core::LOG_CHANNEL::_channel) \
+		.enabled(::sae::engine::core::LOG_LEVEL::_level)) {} \
+	else ::sae::engine::core::log_channel(::sae::engine::core::LOG_CHANNEL::_channel).stream() \
+		.structured<"[" #_level "][" #_channel "] " _format>(__VA_ARGS__)
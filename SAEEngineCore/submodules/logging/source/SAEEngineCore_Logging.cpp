@@ -1,40 +1,950 @@
 #include "SAEEngineCore_Logging.h"
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <mutex>
 #include <iostream>
+#include <istream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace sae::engine::core
 {
 
 	namespace
 	{
-		std::mutex LOG_MTX{};
+		/**
+		 * @brief Growable buffer a Record formats into, keeps its capacity between records
+		*/
+		struct RecordBuffer : public std::streambuf
+		{
+		public:
+			std::string data{};
+			std::ostream stream{ this };
+			bool in_use = false;
+
+			void reset()
+			{
+				this->data.clear();
+				this->stream.clear();
+				this->stream.flags(std::ios_base::dec | std::ios_base::skipws);
+				this->stream.precision(6);
+				this->stream.width(0);
+				this->stream.fill(' ');
+			};
+
+		protected:
+			int_type overflow(int_type _ch) override
+			{
+				if (!traits_type::eq_int_type(_ch, traits_type::eof()))
+				{
+					this->data.push_back(traits_type::to_char_type(_ch));
+				};
+				return traits_type::not_eof(_ch);
+			};
+			std::streamsize xsputn(const char_type* _str, std::streamsize _count) override
+			{
+				this->data.append(_str, (size_t)_count);
+				return _count;
+			};
+		};
+
+		thread_local RecordBuffer THREAD_BUFFER{};
+
+		/*
+			Binary log layout, values are in the byte order of the machine that wrote it :
+
+				header		"SAELOG", version, byte order (1 for little endian)
+				entries		u8 ENTRY, u32 payload length, payload
+
+			A FORMAT entry is written before the first RECORD entry using its id, so a log can be decoded on its own.
+		*/
+
+		constexpr char BINARY_MAGIC[6] = { 'S', 'A', 'E', 'L', 'O', 'G' };
+		constexpr uint8_t BINARY_VERSION = 1;
+		constexpr size_t BINARY_HEADER_SIZE = sizeof(BINARY_MAGIC) + 2;
+
+		// Most bytes decode_log() allocates for an entry before they have been read
+		constexpr size_t DECODE_CHUNK_SIZE = 64 * 1024;
+
+		enum class ENTRY : uint8_t
+		{
+			// Text record
+			TEXT = 1,
+
+			// u64 id followed by the format string
+			FORMAT,
+
+			// u64 id followed by the encoded arguments
+			RECORD,
+		};
+
+		uint8_t host_byte_order() noexcept
+		{
+			const uint16_t _value = 1;
+			uint8_t _first = 0;
+			std::memcpy(&_first, &_value, 1);
+			return _first;
+		};
+
+		void append_entry(std::string& _out, ENTRY _entry, std::string_view _a, std::string_view _b = {})
+		{
+			const auto _len = (uint32_t)(_a.size() + _b.size());
+			_out.push_back((char)_entry);
+			_out.append((const char*)&_len, sizeof(_len));
+			_out.append(_a);
+			_out.append(_b);
+		};
+
+		struct FormatRegistry
+		{
+			std::mutex mtx{};
+			std::unordered_map<uint64_t, std::string_view> formats{};
+		};
+
+		FormatRegistry& format_registry()
+		{
+			static FormatRegistry REGISTRY{};
+			return REGISTRY;
+		};
+
+		template <typename T>
+		bool read_value(std::string_view& _in, T& _value)
+		{
+			if (_in.size() < sizeof(T))
+			{
+				return false;
+			};
+			std::memcpy(&_value, _in.data(), sizeof(T));
+			_in.remove_prefix(sizeof(T));
+			return true;
+		};
+
+		template <typename T>
+		void append_number(std::string& _out, T _value)
+		{
+			char _chars[32];
+			const auto _result = std::to_chars(_chars, _chars + sizeof(_chars), _value);
+			_out.append(_chars, _result.ptr);
+		};
+
+		/**
+		 * @brief Appends the next argument in _args to _out and removes it from _args
+		 * @return False if _args is empty or malformed
+		*/
+		bool format_argument(std::string_view& _args, std::string& _out)
+		{
+			using log_detail::ARG;
+
+			uint8_t _tag = 0;
+			if (!read_value(_args, _tag))
+			{
+				return false;
+			};
+			switch ((ARG)_tag)
+			{
+			case ARG::I64:
+			{
+				int64_t _value = 0;
+				if (!read_value(_args, _value)) { return false; };
+				append_number(_out, _value);
+				return true;
+			}
+			case ARG::U64:
+			{
+				uint64_t _value = 0;
+				if (!read_value(_args, _value)) { return false; };
+				append_number(_out, _value);
+				return true;
+			}
+			case ARG::F64:
+			{
+				double _value = 0.0;
+				if (!read_value(_args, _value)) { return false; };
+				append_number(_out, _value);
+				return true;
+			}
+			case ARG::BOOL:
+			{
+				uint8_t _value = 0;
+				if (!read_value(_args, _value)) { return false; };
+				_out.append(_value ? "true" : "false");
+				return true;
+			}
+			case ARG::CHAR:
+			{
+				char _value = 0;
+				if (!read_value(_args, _value)) { return false; };
+				_out.push_back(_value);
+				return true;
+			}
+			case ARG::STRING:
+			{
+				uint32_t _len = 0;
+				if (!read_value(_args, _len) || _args.size() < _len) { return false; };
+				_out.append(_args.substr(0, _len));
+				_args.remove_prefix(_len);
+				return true;
+			}
+			case ARG::POINTER:
+			{
+				uint64_t _value = 0;
+				if (!read_value(_args, _value)) { return false; };
+				char _chars[32];
+				const auto _result = std::to_chars(_chars, _chars + sizeof(_chars), _value, 16);
+				_out.append("0x");
+				_out.append(_chars, _result.ptr);
+				return true;
+			}
+			default:
+				return false;
+			};
+		};
+
+		/**
+		 * @brief Appends the text of a structured record, _record starting with its format id
+		*/
+		void format_structured(std::string_view _format, std::string_view _record, std::string& _out)
+		{
+			uint64_t _id = 0;
+			read_value(_record, _id);
+			if (_format.empty())
+			{
+				char _chars[32];
+				const auto _result = std::to_chars(_chars, _chars + sizeof(_chars), _id, 16);
+				_out.append("<unknown log format 0x");
+				_out.append(_chars, _result.ptr);
+				_out.append(">\n");
+				return;
+			};
+			format_log_record(_format, _record, _out);
+		};
 	}
 
-	void LogStream::_Pre_Write() const noexcept
+	bool register_log_format(uint64_t _id, std::string_view _format)
+	{
+		auto& _registry = format_registry();
+		std::scoped_lock _lck{ _registry.mtx };
+		const auto [_it, _inserted] = _registry.formats.insert({ _id, _format });
+		return _inserted || _it->second == _format;
+	};
+
+	std::string_view find_log_format(uint64_t _id)
+	{
+		auto& _registry = format_registry();
+		std::scoped_lock _lck{ _registry.mtx };
+		const auto _it = _registry.formats.find(_id);
+		return (_it != _registry.formats.end()) ? _it->second : std::string_view{};
+	};
+
+	bool format_log_record(std::string_view _format, std::string_view _args, std::string& _out)
+	{
+		bool _good = true;
+		for (size_t n = 0; n != _format.size(); ++n)
+		{
+			const auto _ch = _format[n];
+			const auto _next = (n + 1 != _format.size()) ? _format[n + 1] : '\0';
+			if ((_ch == '{' || _ch == '}') && _next == _ch)
+			{
+				_out.push_back(_ch);
+				++n;
+			}
+			else if (_ch == '{' && _next == '}')
+			{
+				if (!_good || !format_argument(_args, _out))
+				{
+					_out.append("{}");
+					_good = false;
+				};
+				++n;
+			}
+			else
+			{
+				_out.push_back(_ch);
+			};
+		};
+		return _good && _args.empty();
+	};
+
+	bool decode_log(std::istream& _in, std::ostream& _out)
+	{
+		char _header[BINARY_HEADER_SIZE]{};
+		if (!_in.read(_header, sizeof(_header)) ||
+			std::memcmp(_header, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 ||
+			(uint8_t)_header[6] != BINARY_VERSION || (uint8_t)_header[7] != host_byte_order())
+		{
+			return false;
+		};
+
+		std::unordered_map<uint64_t, std::string> _formats{};
+		std::string _payload{};
+		std::string _text{};
+		while (true)
+		{
+			char _entryHeader[1 + sizeof(uint32_t)]{};
+			if (!_in.read(_entryHeader, sizeof(_entryHeader)))
+			{
+				// Clean end only if nothing of the next entry was read
+				return _in.gcount() == 0;
+			};
+
+			uint32_t _len = 0;
+			std::memcpy(&_len, _entryHeader + 1, sizeof(_len));
+
+			// The length comes from the file, so grow the payload as its bytes arrive instead of trusting it up front
+			_payload.clear();
+			while (_payload.size() != _len)
+			{
+				const auto _at = _payload.size();
+				const auto _chunk = std::min<size_t>(_len - _at, DECODE_CHUNK_SIZE);
+				_payload.resize(_at + _chunk);
+				if (!_in.read(_payload.data() + _at, (std::streamsize)_chunk))
+				{
+					return false;
+				};
+			};
+
+			std::string_view _view{ _payload };
+			uint64_t _id = 0;
+			switch ((ENTRY)_entryHeader[0])
+			{
+			case ENTRY::TEXT:
+				_out.write(_payload.data(), (std::streamsize)_payload.size());
+				break;
+			case ENTRY::FORMAT:
+				if (!read_value(_view, _id))
+				{
+					return false;
+				};
+				_formats.insert_or_assign(_id, std::string{ _view });
+				break;
+			case ENTRY::RECORD:
+			{
+				if (!read_value(_view, _id))
+				{
+					return false;
+				};
+				const auto _it = _formats.find(_id);
+				_text.clear();
+				format_structured((_it != _formats.end()) ? std::string_view{ _it->second } : std::string_view{}, _payload, _text);
+				_out.write(_text.data(), (std::streamsize)_text.size());
+				break;
+			}
+			default:
+				return false;
+			};
+		};
+	};
+
+	/**
+	 * @brief Bounded multi producer, single consumer queue of variable length records.
+	 *
+	 * Records are stored across consecutive fixed size slots. A writer claims all the slots it needs with one CAS on the
+	 * head, copies the record in and publishes it by setting the sequence of the first slot. The background thread is
+	 * the only consumer: it reads records in order and hands the slots back by advancing their sequence a lap.
+	*/
+	class LogStream::Queue
+	{
+	public:
+		constexpr static size_t SLOT_PAYLOAD = 48;
+
+		struct Slot
+		{
+			std::atomic<uint64_t> sequence{ 0 };
+
+			// Set on the first slot of a record only
+			uint32_t length = 0;
+			RECORD kind = RECORD::TEXT;
+
+			char data[SLOT_PAYLOAD]{};
+		};
+		static_assert(sizeof(Slot) == 64);
+
+		enum class PUSH : uint8_t
+		{
+			PUSHED,
+			FULL,
+			TOO_LARGE,
+		};
+
+		/**
+		 * @brief Where a drained record was put in the raw buffer
+		*/
+		struct Drained
+		{
+			RECORD kind;
+			size_t offset;
+			size_t length;
+		};
+
+		size_t capacity() const noexcept
+		{
+			return this->slots_.size();
+		};
+
+		static size_t slots_for(size_t _len) noexcept
+		{
+			return std::max<size_t>((_len + SLOT_PAYLOAD - 1) / SLOT_PAYLOAD, 1);
+		};
+
+		PUSH try_push(const char* _data, size_t _len, RECORD _kind)
+		{
+			const auto _count = slots_for(_len);
+			if (_count > this->capacity())
+			{
+				return PUSH::TOO_LARGE;
+			};
+
+			auto _pos = this->head_.load(std::memory_order_relaxed);
+			while (true)
+			{
+				// The consumer frees slots in order, so if the last slot needed is free all the ones before it are too
+				const auto _last = _pos + _count - 1;
+				const auto _seq = this->slot(_last).sequence.load(std::memory_order_acquire);
+				const auto _diff = (int64_t)(_seq - _last);
+				if (_diff == 0)
+				{
+					if (this->head_.compare_exchange_weak(_pos, _pos + _count, std::memory_order_relaxed))
+					{
+						break;
+					};
+				}
+				else if (_diff < 0)
+				{
+					return PUSH::FULL;
+				}
+				else
+				{
+					_pos = this->head_.load(std::memory_order_relaxed);
+				};
+			};
+
+			for (size_t n = 0; n != _count; ++n)
+			{
+				const auto _offset = n * SLOT_PAYLOAD;
+				std::memcpy(this->slot(_pos + n).data, _data + _offset, std::min(SLOT_PAYLOAD, _len - _offset));
+			};
+			auto& _first = this->slot(_pos);
+			_first.length = (uint32_t)_len;
+			_first.kind = _kind;
+			_first.sequence.store(_pos + 1, std::memory_order_release);
+			return PUSH::PUSHED;
+		};
+
+		/**
+		 * @brief Appends every published record to _out and where it was put to _records, consumer thread only
+		*/
+		void drain(std::string& _out, std::vector<Drained>& _records)
+		{
+			while (true)
+			{
+				auto& _first = this->slot(this->tail_);
+				if (_first.sequence.load(std::memory_order_acquire) != this->tail_ + 1)
+				{
+					break;
+				};
+
+				const auto _len = (size_t)_first.length;
+				const auto _count = slots_for(_len);
+				_records.push_back(Drained{ _first.kind, _out.size(), _len });
+				for (size_t n = 0; n != _count; ++n)
+				{
+					const auto _offset = n * SLOT_PAYLOAD;
+					_out.append(this->slot(this->tail_ + n).data, std::min(SLOT_PAYLOAD, _len - _offset));
+				};
+				for (size_t n = 0; n != _count; ++n)
+				{
+					const auto _pos = this->tail_ + n;
+					this->slot(_pos).sequence.store(_pos + this->capacity(), std::memory_order_release);
+				};
+				this->tail_ += _count;
+				this->drained_.store(this->tail_, std::memory_order_release);
+			};
+		};
+
+		uint64_t head() const noexcept
+		{
+			return this->head_.load(std::memory_order_acquire);
+		};
+		uint64_t drained() const noexcept
+		{
+			return this->drained_.load(std::memory_order_acquire);
+		};
+
+		Queue(size_t _bytes, LOG_OUTPUT _output) :
+			output{ _output }
+		{
+			size_t _slots = 64;
+			while (_slots * sizeof(Slot) < _bytes)
+			{
+				_slots *= 2;
+			};
+			this->slots_ = std::vector<Slot>(_slots);
+			for (size_t n = 0; n != _slots; ++n)
+			{
+				this->slots_[n].sequence.store(n, std::memory_order_relaxed);
+			};
+		};
+
+		/**
+		 * @brief Appends the sink's form of one record to _out, only called with sink_mtx held
+		*/
+		void render(RECORD _kind, std::string_view _record, std::string& _out)
+		{
+			if (this->output == LOG_OUTPUT::TEXT)
+			{
+				if (_kind == RECORD::TEXT)
+				{
+					_out.append(_record);
+				}
+				else
+				{
+					uint64_t _id = 0;
+					std::memcpy(&_id, _record.data(), sizeof(_id));
+					format_structured(this->format(_id), _record, _out);
+				};
+				return;
+			};
+
+			if (_kind == RECORD::TEXT)
+			{
+				append_entry(_out, ENTRY::TEXT, _record);
+				return;
+			};
+
+			uint64_t _id = 0;
+			std::memcpy(&_id, _record.data(), sizeof(_id));
+			if (!this->formats.contains(_id))
+			{
+				append_entry(_out, ENTRY::FORMAT, _record.substr(0, sizeof(_id)), this->format(_id));
+			};
+			append_entry(_out, ENTRY::RECORD, _record);
+		};
+
+		/**
+		 * @brief Drains every published record and writes them to _sink as one batch, consumer thread only
+		 * @return false if there was nothing to drain
+		*/
+		bool write_pending(std::ostream* _sink)
+		{
+			auto& _raw = this->raw_;
+			auto& _batch = this->batch_;
+			auto& _drained = this->drained_records_;
+			_raw.clear();
+			_drained.clear();
+			this->drain(_raw, _drained);
+			if (_drained.empty())
+			{
+				return false;
+			};
+
+			const bool _plain = this->output == LOG_OUTPUT::TEXT &&
+				std::all_of(_drained.begin(), _drained.end(), [](const Drained& d) { return d.kind == RECORD::TEXT; });
+			size_t _bytes = 0;
+			{
+				std::scoped_lock _lck{ this->sink_mtx };
+				if (_plain)
+				{
+					_sink->write(_raw.data(), (std::streamsize)_raw.size());
+					_bytes = _raw.size();
+				}
+				else
+				{
+					_batch.clear();
+					for (const auto& d : _drained)
+					{
+						this->render(d.kind, std::string_view{ _raw }.substr(d.offset, d.length), _batch);
+					};
+					_sink->write(_batch.data(), (std::streamsize)_batch.size());
+					_bytes = _batch.size();
+				};
+			};
+			this->records.fetch_add(_drained.size(), std::memory_order_relaxed);
+			this->bytes.fetch_add(_bytes, std::memory_order_relaxed);
+			return true;
+		};
+
+		/**
+		 * @brief Background thread body, writes batches of records to _sink until stop is set and the queue is empty
+		*/
+		void run(std::ostream* _sink)
+		{
+			while (true)
+			{
+				if (this->write_pending(_sink))
+				{
+					continue;
+				};
+
+				// Writers may still have been finishing records when stop was set, so stop only on an empty drain
+				if (this->stop.load(std::memory_order_acquire))
+				{
+					break;
+				};
+
+				// Writers only notify while this is set, so a missed wakeup costs at most the timeout
+				std::unique_lock _lck{ this->wake_mtx };
+				this->sleeping.store(true, std::memory_order_seq_cst);
+				if (this->head() == this->drained())
+				{
+					this->wake.wait_for(_lck, std::chrono::milliseconds{ 5 });
+				};
+				this->sleeping.store(false, std::memory_order_relaxed);
+			};
+
+			std::scoped_lock _lck{ this->sink_mtx };
+			_sink->flush();
+		};
+
+		/**
+		 * @brief Waits until every record pushed before _target has been written, or until nothing is draining the queue
+		*/
+		void wait_drained(uint64_t _target)
+		{
+			while (this->running.load(std::memory_order_acquire) && this->drained() < _target)
+			{
+				this->wake.notify_one();
+				std::this_thread::yield();
+			};
+		};
+
+		/**
+		 * @brief Wakes the background thread if it is waiting for records
+		*/
+		void notify()
+		{
+			if (this->sleeping.load(std::memory_order_seq_cst))
+			{
+				this->wake.notify_one();
+			};
+		};
+
+		// Background thread state, see LogStream
+
+		std::thread thread{};
+		std::mutex wake_mtx{};
+		std::condition_variable wake{};
+		std::atomic<bool> sleeping{ false };
+		std::atomic<bool> stop{ false };
+		std::once_flag started{};
+		std::atomic<bool> running{ false };
+
+		// Writers between checking stop and finishing their push, shutdown() drains until this is zero
+		std::atomic<size_t> committing{ 0 };
+
+		// Held while writing to the sink
+		std::mutex sink_mtx{};
+
+		// Output state, guarded by sink_mtx
+
+		const LOG_OUTPUT output;
+
+		// Format strings already looked up, and for a BINARY stream already written to it
+		std::unordered_map<uint64_t, std::string_view> formats{};
+
+		std::atomic<uint64_t> records{ 0 };
+		std::atomic<uint64_t> bytes{ 0 };
+		std::atomic<uint64_t> dropped{ 0 };
+		std::atomic<uint64_t> blocked{ 0 };
+		std::atomic<uint64_t> written_through{ 0 };
+		std::atomic<uint64_t> structured{ 0 };
+
+	private:
+		std::string_view format(uint64_t _id)
+		{
+			auto _it = this->formats.find(_id);
+			if (_it == this->formats.end())
+			{
+				_it = this->formats.insert({ _id, find_log_format(_id) }).first;
+			};
+			return _it->second;
+		};
+
+		Slot& slot(uint64_t _pos) noexcept
+		{
+			return this->slots_[_pos & (this->slots_.size() - 1)];
+		};
+
+		std::vector<Slot> slots_{};
+
+		// Consumer scratch space for write_pending()
+		std::string raw_{};
+		std::string batch_{};
+		std::vector<Drained> drained_records_{};
+
+		alignas(64) std::atomic<uint64_t> head_{ 0 };
+		alignas(64) uint64_t tail_ = 0;
+		std::atomic<uint64_t> drained_{ 0 };
+	};
+
+	LogStream::Record::Record(LogStream& _owner) :
+		owner_{ &_owner }
+	{
+		auto _buffer = &THREAD_BUFFER;
+		if (_buffer->in_use)
+		{
+			// Something being logged is logging in turn
+			_buffer = new RecordBuffer{};
+		};
+		_buffer->in_use = true;
+		_buffer->reset();
+		this->buffer_ = _buffer;
+		this->out_ = &_buffer->stream;
+	};
+
+	LogStream::Record::Record(Record&& other) noexcept :
+		owner_{ std::exchange(other.owner_, nullptr) },
+		out_{ std::exchange(other.out_, nullptr) },
+		buffer_{ std::exchange(other.buffer_, nullptr) }
+	{};
+
+	LogStream::Record::~Record()
 	{
-		LOG_MTX.lock();
+		auto _buffer = static_cast<RecordBuffer*>(this->buffer_);
+		if (!_buffer)
+		{
+			return;
+		};
+		if (this->owner_ && !_buffer->data.empty())
+		{
+			this->owner_->commit(_buffer->data.data(), _buffer->data.size());
+		};
+		_buffer->in_use = false;
+		if (_buffer != &THREAD_BUFFER)
+		{
+			delete _buffer;
+		};
 	};
-	void LogStream::_Post_Write() const noexcept
+
+
+
+	void LogStream::commit(const char* _data, size_t _len, RECORD _kind)
 	{
-#pragma warning( suppress: 26110 )
-		LOG_MTX.unlock();
+		auto& _queue = *this->queue_;
+		if (_kind == RECORD::STRUCTURED)
+		{
+			_queue.structured.fetch_add(1, std::memory_order_relaxed);
+		};
+
+		std::call_once(_queue.started, [this, &_queue]()
+			{
+				if (!_queue.stop.load())
+				{
+					_queue.thread = std::thread{ [&_queue, _sink = this->ostr_]() { _queue.run(_sink); } };
+					_queue.running.store(true, std::memory_order_release);
+				};
+			});
+
+		// Either this sees stop, or shutdown() sees this writer and keeps draining until its record is in the queue and out
+		_queue.committing.fetch_add(1, std::memory_order_seq_cst);
+		if (_queue.stop.load(std::memory_order_seq_cst))
+		{
+			_queue.committing.fetch_sub(1, std::memory_order_release);
+
+			// Lets records this thread queued before stop was set go first
+			_queue.wait_drained(_queue.head());
+			this->write_through(_data, _len, _kind);
+			return;
+		};
+		struct CommitGuard
+		{
+			Queue& queue;
+			~CommitGuard() { this->queue.committing.fetch_sub(1, std::memory_order_release); };
+		} _guard{ _queue };
+
+		bool _blocked = false;
+		while (true)
+		{
+			switch (_queue.try_push(_data, _len, _kind))
+			{
+			case Queue::PUSH::PUSHED:
+				_queue.notify();
+				return;
+			case Queue::PUSH::TOO_LARGE:
+			{
+				// Lets what is already queued go first so the record keeps its place
+				_queue.wait_drained(_queue.head());
+				this->write_through(_data, _len, _kind);
+				return;
+			}
+			case Queue::PUSH::FULL:
+				break;
+			};
+
+			switch (this->overflow())
+			{
+			case LOG_OVERFLOW::DROP:
+				_queue.dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			case LOG_OVERFLOW::WRITE_THROUGH:
+				this->write_through(_data, _len, _kind);
+				return;
+			default:
+				if (!_blocked)
+				{
+					_queue.blocked.fetch_add(1, std::memory_order_relaxed);
+					_blocked = true;
+				};
+				_queue.wake.notify_one();
+				std::this_thread::yield();
+				break;
+			};
+		};
 	};
 
+	void LogStream::write_through(const char* _data, size_t _len, RECORD _kind)
+	{
+		auto& _queue = *this->queue_;
+		std::scoped_lock _lck{ _queue.sink_mtx };
+		if (_queue.output == LOG_OUTPUT::TEXT && _kind == RECORD::TEXT)
+		{
+			this->ostr_->write(_data, (std::streamsize)_len);
+		}
+		else
+		{
+			std::string _out{};
+			_queue.render(_kind, std::string_view{ _data, _len }, _out);
+			this->ostr_->write(_out.data(), (std::streamsize)_out.size());
+		};
+		_queue.written_through.fetch_add(1, std::memory_order_relaxed);
+	};
 
 	void LogStream::flush()
 	{
-		this->_Pre_Write();
+		auto& _queue = *this->queue_;
+		_queue.wait_drained(_queue.head());
+
+		std::scoped_lock _lck{ _queue.sink_mtx };
 		this->ostr_->flush();
-		this->_Post_Write();
-	}; 
-	
-	
-	LogStream::LogStream(std::ostream* _ostr) noexcept :
-		ostr_{ _ostr }
-	{};
+	};
+
+	void LogStream::shutdown()
+	{
+		auto& _queue = *this->queue_;
+		_queue.stop.store(true, std::memory_order_seq_cst);
+
+		// Keeps commit() from starting the thread after this point
+		std::call_once(_queue.started, []() {});
+		if (_queue.thread.joinable())
+		{
+			_queue.wake.notify_one();
+			_queue.thread.join();
+		};
+
+		// Writers that checked stop before it was set may still be pushing, some of them waiting for room. Nothing else
+		// drains the queue now, so do it here until they are all done.
+		bool _wrote = false;
+		while (_queue.committing.load(std::memory_order_seq_cst) != 0 || _queue.head() != _queue.drained())
+		{
+			if (_queue.write_pending(this->ostr_))
+			{
+				_wrote = true;
+			}
+			else
+			{
+				std::this_thread::yield();
+			};
+		};
+		if (_wrote)
+		{
+			std::scoped_lock _lck{ _queue.sink_mtx };
+			this->ostr_->flush();
+		};
+		_queue.running.store(false, std::memory_order_release);
+	};
+
+	LOG_OVERFLOW LogStream::overflow() const noexcept
+	{
+		return this->overflow_.load(std::memory_order_relaxed);
+	};
+	void LogStream::set_overflow(LOG_OVERFLOW _policy) noexcept
+	{
+		this->overflow_.store(_policy, std::memory_order_relaxed);
+	};
+
+	LOG_OUTPUT LogStream::output() const noexcept
+	{
+		return this->queue_->output;
+	};
+
+	LogStream::Stats LogStream::stats() const noexcept
+	{
+		const auto& _queue = *this->queue_;
+		Stats _out{};
+		_out.records = _queue.records.load(std::memory_order_relaxed);
+		_out.bytes = _queue.bytes.load(std::memory_order_relaxed);
+		_out.dropped = _queue.dropped.load(std::memory_order_relaxed);
+		_out.blocked = _queue.blocked.load(std::memory_order_relaxed);
+		_out.written_through = _queue.written_through.load(std::memory_order_relaxed);
+		_out.structured = _queue.structured.load(std::memory_order_relaxed);
+		return _out;
+	};
+
+
+	LogStream::LogStream(std::ostream* _ostr, size_t _queueBytes, LOG_OVERFLOW _policy, LOG_OUTPUT _output) :
+		ostr_{ _ostr },
+		queue_{ std::make_unique<Queue>(_queueBytes, _output) },
+		overflow_{ _policy }
+	{
+		if (_output == LOG_OUTPUT::BINARY)
+		{
+			char _header[BINARY_HEADER_SIZE]{};
+			std::memcpy(_header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+			_header[6] = (char)BINARY_VERSION;
+			_header[7] = (char)host_byte_order();
+			this->ostr_->write(_header, sizeof(_header));
+		};
+	};
+	LogStream::~LogStream()
+	{
+		this->shutdown();
+	};
 
 
 	log_t lout{ &std::cout };
 
-}
\ No newline at end of file
+	constinit LogChannel log_channels[(size_t)LOG_CHANNEL::COUNT] =
+	{
+		LogChannel{ "general", &lout },
+		LogChannel{ "artist", &lout },
+		LogChannel{ "environment", &lout },
+		LogChannel{ "event", &lout },
+		LogChannel{ "filehandling", &lout },
+		LogChannel{ "gl_object", &lout },
+		LogChannel{ "input", &lout },
+		LogChannel{ "iso", &lout },
+		LogChannel{ "object", &lout },
+		LogChannel{ "shader", &lout },
+		LogChannel{ "texture", &lout },
+		LogChannel{ "ui", &lout },
+		LogChannel{ "widget", &lout },
+		LogChannel{ "window", &lout },
+	};
+
+	LogChannel* find_log_channel(std::string_view _name) noexcept
+	{
+		for (auto& c : log_channels)
+		{
+			if (c.name() == _name)
+			{
+				return &c;
+			};
+		};
+		return nullptr;
+	};
+
+	void set_log_level(LOG_LEVEL _level) noexcept
+	{
+		for (auto& c : log_channels)
+		{
+			c.set_level(_level);
+		};
+	};
+
+}
@@ -0,0 +1,118 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Logging.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace sae::engine::core;
+
+/*
+	SAE_LOG only evaluates its arguments when the level is compiled in and enabled on the channel, records carry the level
+	and channel, and each channel can be pointed at its own stream.
+*/
+
+static int EVALUATED = 0;
+
+static int evaluate(int _value)
+{
+	++EVALUATED;
+	return _value;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	std::ostringstream _sink{};
+	LogStream _log{ &_sink };
+	log_channel(LOG_CHANNEL::OBJECT).set_stream(_log);
+	log_channel(LOG_CHANNEL::WINDOW).set_stream(_log);
+
+	// Channels start at INFO
+	if (log_channel(LOG_CHANNEL::OBJECT).level() != LOG_LEVEL::INFO)
+	{
+		std::cout << "channels did not start at INFO\n";
+		return 1;
+	};
+
+	// Disabled at runtime, the arguments are not evaluated
+	SAE_LOG(OBJECT, DEBUG) << "debug " << evaluate(1) << '\n';
+	if (EVALUATED != 0)
+	{
+		std::cout << "arguments of a disabled record were evaluated\n";
+		return 2;
+	};
+
+	// Enabled
+	SAE_LOG(OBJECT, WARN) << "warn " << evaluate(2) << '\n';
+	SAE_LOG_STRUCTURED(WINDOW, ERR, "resized to {}x{}\n", evaluate(800), 600);
+	SAE_LOG_STRUCTURED(WINDOW, INFO, "no arguments\n");
+	_log.flush();
+
+	std::string _expected{};
+	if constexpr (LOG_LEVEL::WARN >= LOG_LEVEL_COMPILED)
+	{
+		_expected += "[WARN][OBJECT] warn 2\n";
+	};
+	if constexpr (LOG_LEVEL::ERR >= LOG_LEVEL_COMPILED)
+	{
+		_expected += "[ERR][WINDOW] resized to 800x600\n";
+	};
+	if constexpr (LOG_LEVEL::INFO >= LOG_LEVEL_COMPILED)
+	{
+		_expected += "[INFO][WINDOW] no arguments\n";
+	};
+	if (_sink.str() != _expected)
+	{
+		std::cout << "records were\n" << _sink.str();
+		return 3;
+	};
+
+	// Every level on, only the ones compiled in are evaluated
+	EVALUATED = 0;
+	set_log_level(LOG_LEVEL::TRACE);
+	SAE_LOG(OBJECT, TRACE) << evaluate(0) << '\n';
+	SAE_LOG(OBJECT, DEBUG) << evaluate(0) << '\n';
+	SAE_LOG(OBJECT, INFO) << evaluate(0) << '\n';
+	SAE_LOG(OBJECT, WARN) << evaluate(0) << '\n';
+	SAE_LOG(OBJECT, ERR) << evaluate(0) << '\n';
+	if (EVALUATED != (int)LOG_LEVEL::OFF - (int)LOG_LEVEL_COMPILED)
+	{
+		std::cout << "levels below the compiled threshold were evaluated\n";
+		return 4;
+	};
+
+	// Looked up by name and turned off
+	auto _channel = find_log_channel("object");
+	if (_channel != &log_channel(LOG_CHANNEL::OBJECT) || find_log_channel("nope") != nullptr)
+	{
+		std::cout << "find_log_channel failed\n";
+		return 5;
+	};
+	_channel->set_level(LOG_LEVEL::OFF);
+	EVALUATED = 0;
+	SAE_LOG(OBJECT, ERR) << evaluate(0) << '\n';
+	if (EVALUATED != 0)
+	{
+		std::cout << "a channel set to OFF still logged\n";
+		return 6;
+	};
+
+	log_channel(LOG_CHANNEL::OBJECT).set_stream(lout);
+	log_channel(LOG_CHANNEL::WINDOW).set_stream(lout);
+	return GOOD_TEST;
+};
@@ -0,0 +1,235 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Logging.h>
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Structured records : formatted by the background thread for a TEXT stream, written as format id and argument bytes
+	for a BINARY stream and turned back into the same text by decode_log(), mixed with ordinary records in order.
+*/
+
+enum class Side : int8_t
+{
+	LEFT = -1,
+	RIGHT = 1,
+};
+
+enum class Grade : char
+{
+	A = 'A',
+	B = 'B',
+};
+
+/**
+ * @brief Logs the same records to _log, both ordinary and structured
+*/
+static void write_mixed(LogStream& _log)
+{
+	const std::string _name = "quad_shader";
+	const std::string_view _stage = "fragment";
+	_log.structured<"frame {} took {} ms\n">(120, 16.5);
+	_log << "plain record\n";
+	_log.structured<"{} {} {} {}\n">(-42, std::numeric_limits<uint64_t>::max(), true, 'x');
+	_log.structured<"compiled {} ({}) from \"{}\"\n">(_name, _stage, "shader.glsl");
+	_log.structured<"side {} {{escaped}} {} grade {}\n">(Side::LEFT, (uint8_t)7, Grade::B);
+	_log.structured<"no arguments\n">();
+	_log.structured<"{}\n">(std::string(1000, 'z'));
+};
+
+static std::string expected_mixed()
+{
+	return std::string{ "frame 120 took 16.5 ms\n" } +
+		"plain record\n" +
+		"-42 18446744073709551615 true x\n" +
+		"compiled quad_shader (fragment) from \"shader.glsl\"\n" +
+		"side -1 {escaped} 7 grade 66\n" +
+		"no arguments\n" +
+		std::string(1000, 'z') + "\n";
+};
+
+static size_t count_of(const std::string& _str, std::string_view _find)
+{
+	size_t _count = 0;
+	for (auto _pos = _str.find(_find); _pos != std::string::npos; _pos = _str.find(_find, _pos + 1))
+	{
+		++_count;
+	};
+	return _count;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	// Formatted by the background thread
+	{
+		std::ostringstream _sink{};
+		LogStream _log{ &_sink };
+		write_mixed(_log);
+		_log.flush();
+
+		if (_sink.str() != expected_mixed())
+		{
+			std::cout << "TEXT output was\n" << _sink.str();
+			return 1;
+		};
+		if (_log.stats().structured != 6 || _log.stats().records != 7)
+		{
+			std::cout << "structured records were not counted\n";
+			return 2;
+		};
+	};
+
+	// Written as binary and decoded, the format strings go into the log once each
+	std::string _binary{};
+	{
+		std::ostringstream _sink{ std::ios::binary };
+		LogStream _log{ &_sink, 512 * 1024, LOG_OVERFLOW::BLOCK, LOG_OUTPUT::BINARY };
+		write_mixed(_log);
+		write_mixed(_log);
+		_log.flush();
+		_binary = _sink.str();
+
+		if (count_of(_binary, "frame {} took {} ms") != 1 || count_of(_binary, "quad_shader") != 2)
+		{
+			std::cout << "BINARY output repeated format strings or lost arguments\n";
+			return 3;
+		};
+
+		std::istringstream _in{ _binary, std::ios::binary };
+		std::ostringstream _out{};
+		if (!decode_log(_in, _out) || _out.str() != expected_mixed() + expected_mixed())
+		{
+			std::cout << "decoded\n" << _out.str();
+			return 4;
+		};
+	};
+
+	// A damaged log decodes up to the damage, something that is not a binary log not at all
+	{
+		std::istringstream _in{ _binary.substr(0, _binary.size() - 3), std::ios::binary };
+		std::ostringstream _out{};
+		if (decode_log(_in, _out) || _out.str().find("plain record") == std::string::npos)
+		{
+			std::cout << "truncated log was not reported\n";
+			return 5;
+		};
+
+		std::istringstream _text{ expected_mixed() };
+		if (decode_log(_text, _out))
+		{
+			std::cout << "text was decoded as a binary log\n";
+			return 6;
+		};
+
+		// An entry claiming far more bytes than the log holds
+		std::string _damaged = _binary.substr(0, 8);
+		_damaged += "\x01\xFF\xFF\xFF\xFF" "abc";
+		std::istringstream _long{ _damaged, std::ios::binary };
+		if (decode_log(_long, _out))
+		{
+			std::cout << "an entry longer than the log was decoded\n";
+			return 11;
+		};
+	};
+
+	// Records larger than the queue and records after shutdown() are written from the calling thread
+	{
+		std::ostringstream _sink{ std::ios::binary };
+		LogStream _log{ &_sink, 4 * 1024, LOG_OVERFLOW::BLOCK, LOG_OUTPUT::BINARY };
+		_log.structured<"first {}\n">(1);
+		_log.structured<"large {}\n">(std::string(10000, 'y'));
+		_log.shutdown();
+		_log.structured<"after {}\n">("shutdown");
+
+		std::istringstream _in{ _sink.str(), std::ios::binary };
+		std::ostringstream _out{};
+		if (!decode_log(_in, _out) || _out.str() != "first 1\nlarge " + std::string(10000, 'y') + "\nafter shutdown\n")
+		{
+			std::cout << "oversized or late records were not written as expected\n";
+			return 7;
+		};
+	};
+
+	// Several threads, every record whole and in order per thread
+	{
+		constexpr size_t THREADS = 4;
+		constexpr size_t RECORDS = 5000;
+
+		std::ostringstream _sink{};
+		LogStream _log{ &_sink, 16 * 1024 };
+		std::vector<std::thread> _writers{};
+		for (size_t t = 0; t != THREADS; ++t)
+		{
+			_writers.emplace_back([&_log, t]()
+				{
+					for (size_t n = 0; n != RECORDS; ++n)
+					{
+						_log.structured<"t {} n {} payload {}\n">(t, n, std::string(n % 120, 'x'));
+					};
+				});
+		};
+		for (auto& w : _writers)
+		{
+			w.join();
+		};
+		_log.flush();
+
+		std::vector<long long> _last(THREADS, -1);
+		std::istringstream _lines{ _sink.str() };
+		size_t _found = 0;
+		for (std::string _line{}; std::getline(_lines, _line); ++_found)
+		{
+			size_t _thread = 0, _n = 0;
+			std::istringstream _fields{ _line };
+			std::string _t{}, _nLabel{}, _payloadLabel{}, _payload{};
+			_fields >> _t >> _thread >> _nLabel >> _n >> _payloadLabel;
+			std::getline(_fields, _payload);
+			if (_thread >= THREADS || (long long)_n != _last[_thread] + 1 || _payload != " " + std::string(_n % 120, 'x'))
+			{
+				std::cout << "damaged record : " << _line << '\n';
+				return 8;
+			};
+			_last[_thread] = (long long)_n;
+		};
+		if (_found != THREADS * RECORDS)
+		{
+			std::cout << "lost records\n";
+			return 9;
+		};
+	};
+
+	// Missing arguments are left as placeholders and reported
+	{
+		std::string _out{};
+		if (format_log_record("a {} b {}", std::string_view{}, _out) || _out != "a {} b {}")
+		{
+			std::cout << "malformed arguments were not reported\n";
+			return 10;
+		};
+	};
+
+	return GOOD_TEST;
+};
@@ -0,0 +1,268 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Logging.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Writes records built from several fragments to a LogStream from many threads at once and checks every record reaches
+	the sink whole and in order per thread under each overflow policy, including when shutdown() is called while they are
+	still writing. Ends by measuring records per second with 1, 4 and 16 writer threads, against a mutex taken for every
+	fragment the way LogStream used to.
+*/
+
+/**
+ * @brief Sink that throws everything away
+*/
+struct NullBuffer : public std::streambuf
+{
+protected:
+	int_type overflow(int_type _ch) override { return traits_type::not_eof(_ch); };
+	std::streamsize xsputn(const char_type* _str, std::streamsize _count) override { return _count; };
+};
+
+template <typename WriteT>
+static void run_writers(size_t _threads, WriteT _write)
+{
+	std::vector<std::thread> _writers{};
+	for (size_t t = 0; t != _threads; ++t)
+	{
+		_writers.emplace_back([t, &_write]() { _write(t); });
+	};
+	for (auto& w : _writers)
+	{
+		w.join();
+	};
+};
+
+static void write_records(LogStream& _log, size_t _thread, size_t _count)
+{
+	for (size_t n = 0; n != _count; ++n)
+	{
+		_log << "t" << _thread << " n " << n << " payload " << std::string(n % 120, 'x') << '\n';
+	};
+};
+
+/**
+ * @brief Checks every line in _out is a whole record and each thread's records are in order
+ * @return Number of records found, or 0 if a line was damaged
+*/
+static size_t check_records(const std::string& _out, size_t _threads)
+{
+	std::vector<long long> _last(_threads, -1);
+	std::istringstream _lines{ _out };
+	std::string _line{};
+	size_t _found = 0;
+	while (std::getline(_lines, _line))
+	{
+		size_t _thread = 0, _n = 0;
+		const auto _payload = _line.find(" payload ");
+		if (std::sscanf(_line.c_str(), "t%zu n %zu", &_thread, &_n) != 2 || _thread >= _threads ||
+			(long long)_n <= _last[_thread] || _payload == std::string::npos ||
+			_line.substr(_payload + 9) != std::string(_n % 120, 'x'))
+		{
+			std::cout << "damaged or out of order record \"" << _line << "\"\n";
+			return 0;
+		};
+		_last[_thread] = (long long)_n;
+		++_found;
+	};
+	return _found;
+};
+
+/**
+ * @brief Logs while being logged
+*/
+struct Nested
+{
+	LogStream* log;
+};
+static std::ostream& operator<<(std::ostream& _ostr, const Nested& _nested)
+{
+	(*_nested.log) << "inner record\n";
+	return _ostr << "outer";
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	constexpr size_t THREADS = 4;
+	constexpr size_t RECORDS = 5000;
+
+	// A small queue makes writers wait, nothing may be lost or torn
+	{
+		std::ostringstream _sink{};
+		LogStream _log{ &_sink, 16 * 1024, LOG_OVERFLOW::BLOCK };
+		run_writers(THREADS, [&_log](size_t t) { write_records(_log, t, RECORDS); });
+		_log.flush();
+
+		const auto _stats = _log.stats();
+		if (check_records(_sink.str(), THREADS) != THREADS * RECORDS || _stats.records != THREADS * RECORDS ||
+			_stats.dropped != 0)
+		{
+			std::cout << "BLOCK lost records\n";
+			return 1;
+		};
+		std::cout << "BLOCK : " << _stats.blocked << " records waited for room\n";
+	};
+
+	// Records that find the queue full are dropped whole
+	{
+		std::ostringstream _sink{};
+		LogStream _log{ &_sink, 4 * 1024, LOG_OVERFLOW::DROP };
+		run_writers(THREADS, [&_log](size_t t) { write_records(_log, t, RECORDS); });
+		_log.shutdown();
+
+		const auto _stats = _log.stats();
+		if (check_records(_sink.str(), THREADS) != _stats.records || _stats.records + _stats.dropped != THREADS * RECORDS)
+		{
+			std::cout << "DROP did not account for every record\n";
+			return 2;
+		};
+		std::cout << "DROP : " << _stats.dropped << " of " << THREADS * RECORDS << " records dropped\n";
+	};
+
+	// Or written from the calling thread, which keeps them whole but not ordered against queued ones
+	{
+		std::ostringstream _sink{};
+		LogStream _log{ &_sink, 4 * 1024, LOG_OVERFLOW::WRITE_THROUGH };
+		run_writers(1, [&_log](size_t t) { write_records(_log, t, RECORDS); });
+		_log.shutdown();
+
+		const auto _stats = _log.stats();
+		std::istringstream _lines{ _sink.str() };
+		size_t _count = 0;
+		for (std::string _line{}; std::getline(_lines, _line); ++_count) {};
+		if (_count != RECORDS || _stats.records + _stats.written_through != RECORDS)
+		{
+			std::cout << "WRITE_THROUGH lost records\n";
+			return 3;
+		};
+	};
+
+	// Records logged while building another record, records that do not fit the queue, and records after shutdown()
+	{
+		std::ostringstream _sink{};
+		LogStream _log{ &_sink, 4 * 1024 };
+		_log << std::hex << 255 << ' ' << Nested{ &_log } << '\n';
+		_log << 255 << '\n';
+		_log << std::string(10000, 'y') << '\n';
+		_log.shutdown();
+		_log << "after shutdown\n";
+		_log.flush();
+
+		const auto _expected = std::string{ "inner record\nff outer\n255\n" } + std::string(10000, 'y') + "\nafter shutdown\n";
+		if (_sink.str() != _expected)
+		{
+			std::cout << "nested, oversized or late records were not written as expected\n";
+			return 4;
+		};
+	};
+
+	// shutdown() while writers are still logging and waiting for room, every record is written once and none wait forever
+	for (size_t _round = 0; _round != 20; ++_round)
+	{
+		std::ostringstream _sink{};
+		LogStream _log{ &_sink, 4 * 1024, LOG_OVERFLOW::BLOCK };
+		std::vector<std::thread> _writers{};
+		for (size_t t = 0; t != THREADS; ++t)
+		{
+			_writers.emplace_back([&_log, t]() { write_records(_log, t, RECORDS / 10); });
+		};
+		std::this_thread::sleep_for(std::chrono::microseconds{ 100 * _round });
+		_log.shutdown();
+		for (auto& w : _writers)
+		{
+			w.join();
+		};
+
+		const auto _stats = _log.stats();
+		if (check_records(_sink.str(), THREADS) != THREADS * (RECORDS / 10) ||
+			_stats.records + _stats.written_through != THREADS * (RECORDS / 10))
+		{
+			std::cout << "records were lost when shutdown() raced writers\n";
+			return 6;
+		};
+	};
+
+	// Throughput
+	{
+		constexpr size_t TOTAL = 400000;
+
+		NullBuffer _null{};
+		std::ostream _sink{ &_null };
+		for (size_t _threads : { 1, 4, 16 })
+		{
+			const auto _perThread = TOTAL / _threads;
+
+			double _queued = 0.0;
+			{
+				LogStream _log{ &_sink };
+				const auto _start = std::chrono::steady_clock::now();
+				run_writers(_threads, [&_log, _perThread](size_t t)
+					{
+						for (size_t n = 0; n != _perThread; ++n)
+						{
+							_log << "thread " << t << " frame " << n << " value " << (double)n * 0.5 << '\n';
+						};
+					});
+				const auto _end = std::chrono::steady_clock::now();
+				_queued = (double)(_perThread * _threads) / std::chrono::duration<double>(_end - _start).count();
+				_log.shutdown();
+				if (_log.stats().records != _perThread * _threads)
+				{
+					std::cout << "records were lost\n";
+					return 5;
+				};
+			};
+
+			double _locked = 0.0;
+			{
+				std::mutex _mtx{};
+				auto _fragment = [&_mtx, &_sink](const auto& _value)
+				{
+					std::scoped_lock _lck{ _mtx };
+					_sink << _value;
+				};
+				const auto _start = std::chrono::steady_clock::now();
+				run_writers(_threads, [&_fragment, _perThread](size_t t)
+					{
+						for (size_t n = 0; n != _perThread; ++n)
+						{
+							_fragment("thread "); _fragment(t); _fragment(" frame "); _fragment(n);
+							_fragment(" value "); _fragment((double)n * 0.5); _fragment('\n');
+						};
+					});
+				const auto _end = std::chrono::steady_clock::now();
+				_locked = (double)(_perThread * _threads) / std::chrono::duration<double>(_end - _start).count();
+			};
+
+			std::cout << _threads << " writer threads : " << (size_t)_queued << " records/s queued, " << (size_t)_locked
+				<< " records/s locking per fragment\n";
+		};
+	};
+
+	return GOOD_TEST;
+};
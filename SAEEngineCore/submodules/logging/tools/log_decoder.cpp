@@ -0,0 +1,49 @@
+#include <SAEEngineCore_Logging.h>
+
+#include <fstream>
+#include <iostream>
+
+/*
+	Converts a binary log written by a LogStream with LOG_OUTPUT::BINARY back to text.
+
+		SAEEngineCore_LogDecoder <binary log> [output file]
+*/
+
+int main(int argc, char* argv[])
+{
+	using namespace sae::engine::core;
+
+	if (argc < 2 || argc > 3)
+	{
+		std::cerr << "usage : " << argv[0] << " <binary log> [output file]\n";
+		return 2;
+	};
+
+	std::ifstream _in{ argv[1], std::ios::binary };
+	if (!_in.is_open())
+	{
+		std::cerr << "failed to open " << argv[1] << '\n';
+		return 1;
+	};
+
+	std::ofstream _file{};
+	std::ostream* _out = &std::cout;
+	if (argc == 3)
+	{
+		_file.open(argv[2], std::ios::binary);
+		if (!_file.is_open())
+		{
+			std::cerr << "failed to open " << argv[2] << '\n';
+			return 1;
+		};
+		_out = &_file;
+	};
+
+	if (!decode_log(_in, *_out))
+	{
+		_out->flush();
+		std::cerr << argv[1] << " is not a binary log or is damaged, output stops at the damage\n";
+		return 1;
+	};
+	return 0;
+};
@@ -10,6 +10,9 @@
 #include <memory>
 #include <algorithm>
 #include <string>
+#include <span>
+#include <limits>
+#include <unordered_map>
 
 struct GLFWwindow;
 
@@ -63,6 +66,22 @@ namespace sae::engine::core
 			return !this->is_set(_bit);
 		};
 
+		/**
+		 * @brief Returns the raw grow bits
+		*/
+		constexpr uint8_t bits() const noexcept
+		{
+			return this->bits_;
+		};
+
+		/**
+		 * @brief Grows a rectangle by _dw and _dh along the sides that have their grow bit set
+		 * @param _r Rectangle to grow
+		 * @param _dw Change in width
+		 * @param _dh Change in height
+		*/
+		void apply(Rect& _r, pixels_t _dw, pixels_t _dh) const noexcept;
+
 		friend inline GrowMode& operator<<(GrowMode& _gm, GROW_BIT_E _bit) noexcept
 		{
 			_gm.set(_bit);
@@ -81,6 +100,17 @@ namespace sae::engine::core
 
 	};
 
+	/**
+	 * @brief Applies GrowMode::apply to a whole array of rectangles at once. Each grow mode is expanded into a lane mask over
+	 * the four int16 sides of its rectangle so several rectangles are grown per instruction (SSE2, or AVX2 when
+	 * SAE_ENGINE_CORE_USE_AVX2 is enabled). Falls back to a scalar loop on other targets.
+	 * @param _rects Rectangles to grow
+	 * @param _modes Grow mode for each rectangle, must be the same length as _rects
+	 * @param _dw Change in width
+	 * @param _dh Change in height
+	*/
+	void bulk_grow(std::span<Rect> _rects, std::span<const GrowMode> _modes, pixels_t _dw, pixels_t _dh) noexcept;
+
 	template <typename T>
 	concept cx_arithmetic = std::is_arithmetic_v<T>;
 
@@ -178,6 +208,198 @@ namespace sae::engine::core
 	class GFXView;
 	class GFXContext;
 
+	/**
+	 * @brief Stable handle to an entry in a GFXSceneStore. Stays valid while entries around it are added and removed.
+	*/
+	struct GFXHandle
+	{
+		using index_type = uint32_t;
+		constexpr static inline index_type npos = std::numeric_limits<index_type>::max();
+
+		constexpr bool good() const noexcept { return this->index != npos; };
+		constexpr explicit operator bool() const noexcept { return this->good(); };
+
+		constexpr bool operator==(const GFXHandle&) const noexcept = default;
+
+		index_type index = npos;
+		index_type generation = 0;
+	};
+
+	/**
+	 * @brief Packed storage for the per object data used by the layout and grow passes. Each field is kept in its own contiguous
+	 * array so a pass over every object in a context is a linear sweep instead of a walk through the object tree.
+	 *
+	 * Entries are kept dense by swapping the last entry into the place of an erased one, so references into the store are
+	 * invalidated by insert() and erase(). Use handles to refer to entries across those calls.
+	*/
+	class GFXSceneStore
+	{
+	public:
+		using handle_type = GFXHandle;
+		using index_type = handle_type::index_type;
+		using size_type = size_t;
+		using state_type = uint8_t;
+
+		/**
+		 * @brief Adds a new entry to the store
+		 * @param _obj Object that owns the entry
+		 * @param _parent Handle of the parent entry, an empty handle if the parent is not in the store
+		 * @return Handle to the new entry
+		*/
+		handle_type insert(GFXObject* _obj, handle_type _parent, Rect _bounds, ZLayer _z, GrowMode _gm, state_type _state);
+
+		/**
+		 * @brief Removes an entry from the store, the handle is no longer valid afterwards
+		*/
+		void erase(handle_type _h);
+
+		bool contains(handle_type _h) const noexcept;
+
+		size_type size() const noexcept;
+		bool empty() const noexcept;
+
+		void reserve(size_type _count);
+
+		Rect& bounds(handle_type _h) noexcept;
+		const Rect& bounds(handle_type _h) const noexcept;
+
+		ZLayer& zlayer(handle_type _h) noexcept;
+		const ZLayer& zlayer(handle_type _h) const noexcept;
+
+		GrowMode& grow_mode(handle_type _h) noexcept;
+		const GrowMode& grow_mode(handle_type _h) const noexcept;
+
+		state_type& state(handle_type _h) noexcept;
+		const state_type& state(handle_type _h) const noexcept;
+
+		handle_type parent(handle_type _h) const noexcept;
+		void set_parent(handle_type _h, handle_type _parent) noexcept;
+
+		GFXObject* object(handle_type _h) const noexcept;
+
+		/**
+		 * @brief Packed arrays, all indexed by the same dense position. Parents are given as dense positions as well, npos if the
+		 * entry has no parent in the store or its parent has since been erased.
+		*/
+		std::span<Rect> packed_bounds() noexcept;
+		std::span<const Rect> packed_bounds() const noexcept;
+		std::span<const ZLayer> packed_zlayers() const noexcept;
+		std::span<const GrowMode> packed_grow_modes() const noexcept;
+		std::span<const state_type> packed_states() const noexcept;
+		std::span<GFXObject* const> packed_objects() const noexcept;
+		index_type packed_parent(index_type _dense) const noexcept;
+
+		/**
+		 * @brief Applies a grow to every entry in the store in one pass
+		 * @param _dw Change in width
+		 * @param _dh Change in height
+		*/
+		void grow(pixels_t _dw, pixels_t _dh);
+
+		/**
+		 * @brief Applies a grow to an entry and all of its descendants in one pass
+		 * @param _root Entry at the top of the subtree
+		 * @param _dw Change in width
+		 * @param _dh Change in height
+		*/
+		void grow(handle_type _root, pixels_t _dw, pixels_t _dh);
+
+	private:
+		index_type dense_index(handle_type _h) const noexcept;
+
+		// Marks every entry with a non-empty grow mode as dirty after a grow
+		void mark_grown(std::span<const GrowMode> _modes, pixels_t _dw, pixels_t _dh);
+
+		struct Slot
+		{
+			// Dense position while in use, next free slot while free
+			index_type dense = handle_type::npos;
+			index_type generation = 0;
+		};
+
+		std::vector<Slot> slots_{};
+		index_type free_head_ = handle_type::npos;
+
+		std::vector<Rect> bounds_{};
+		std::vector<ZLayer> zlayers_{};
+		std::vector<GrowMode> grow_modes_{};
+		std::vector<state_type> states_{};
+		std::vector<handle_type> parents_{};
+		std::vector<index_type> owners_{};
+		std::vector<GFXObject*> objects_{};
+
+		// Scratch space for subtree grows, kept to avoid allocating on every resize
+		std::vector<GrowMode> grow_scratch_{};
+		std::vector<uint8_t> member_scratch_{};
+		std::vector<index_type> chain_scratch_{};
+
+	};
+
+	/**
+	 * @brief Uniform grid over a screen region used to find the objects under a point without walking the object tree.
+	 * Objects partly or fully outside the region are kept in the edge cells they would overlap.
+	*/
+	class GFXSpatialGrid
+	{
+	public:
+		using size_type = size_t;
+
+		/**
+		 * @brief Adds an object to the grid, or moves it if it is already in the grid and _bounds covers different cells
+		*/
+		void insert(GFXObject* _obj, const Rect& _bounds);
+
+		/**
+		 * @brief Removes an object from the grid, does nothing if it is not in the grid
+		*/
+		void erase(GFXObject* _obj);
+
+		bool contains(GFXObject* _obj) const;
+		size_type size() const noexcept;
+
+		/**
+		 * @brief Changes the region covered by the grid and re-buckets every object using its current bounds
+		*/
+		void rebuild(Rect _area);
+
+		/**
+		 * @brief Appends every object whose bounds contain _p to _out. Order is unspecified.
+		*/
+		void query(ScreenPoint _p, std::vector<GFXObject*>& _out) const;
+
+		const Rect& area() const noexcept;
+		pixels_t cell_size() const noexcept;
+
+		GFXSpatialGrid(Rect _area, pixels_t _cellSize);
+
+	private:
+		struct CellRange
+		{
+			int32_t x0 = 0;
+			int32_t y0 = 0;
+			int32_t x1 = 0;
+			int32_t y1 = 0;
+
+			constexpr bool operator==(const CellRange&) const noexcept = default;
+		};
+
+		int32_t column_of(pixels_t _x) const noexcept;
+		int32_t row_of(pixels_t _y) const noexcept;
+		CellRange cells_for(const Rect& _bounds) const noexcept;
+
+		void add_to_cells(GFXObject* _obj, CellRange _range);
+		void remove_from_cells(GFXObject* _obj, CellRange _range);
+
+		Rect area_{};
+		pixels_t cell_size_{};
+		int32_t columns_ = 0;
+		int32_t rows_ = 0;
+
+		std::vector<std::vector<GFXObject*>> cells_{};
+		std::unordered_map<GFXObject*, CellRange> ranges_{};
+
+	};
+
 	/**
 	 * @brief Basic object type defining an interface for interacting with a single object.
 	*/
@@ -191,6 +413,18 @@ namespace sae::engine::core
 			stDisplayed = 0x04
 		};
 
+		/**
+		 * @brief Reasons an object needs to be refreshed. Marking a bit also marks dtDescendant on every ancestor so refresh()
+		 * can skip subtrees with nothing to do.
+		*/
+		enum DIRTY_BITS : uint8_t
+		{
+			dtBounds = 0x01,
+			dtChildren = 0x02,
+			dtLayout = 0x04,
+			dtDescendant = 0x08
+		};
+
 	protected:
 		friend GFXGroup;
 		friend GFXView;
@@ -207,6 +441,23 @@ namespace sae::engine::core
 
 		void handle_event_type(const Event::evGrow& _event);
 
+		uint8_t& state_bits() noexcept;
+		const uint8_t& state_bits() const noexcept;
+
+		/**
+		 * @brief Clears the dirty bits for this object, dtDescendant is left alone as it is maintained by GFXGroup::refresh()
+		*/
+		void clear_dirty() noexcept;
+
+		void attach_scene_store(GFXSceneStore* _store);
+		void detach_scene_store();
+		GFXSceneStore* scene_store() const noexcept;
+
+		void detach_spatial_index() noexcept;
+
+		// Moves this object to the cells covering its current bounds if the context has a spatial index
+		void update_spatial_index();
+
 	protected:
 		void set_parent(GFXView* _to) noexcept;
 		virtual void set_context(GFXContext* _to);
@@ -219,15 +470,40 @@ namespace sae::engine::core
 
 		virtual void handle_event(Event& _event);
 
+		/**
+		 * @brief Changing the bounds through this reference does not mark the object dirty, use set_bounds() instead
+		*/
 		Rect& bounds() noexcept;
 		const Rect& bounds() const noexcept;
 
+		/**
+		 * @brief Sets the bounds, marking the object as needing a refresh if they changed
+		*/
+		void set_bounds(const Rect& _r);
+
 		ZLayer& zlayer() noexcept;
 		const ZLayer& zlayer() const noexcept;
 
 		GrowMode& grow_mode() noexcept;
 		const GrowMode& grow_mode() const noexcept;
 
+		/**
+		 * @brief Flags this object as needing a refresh. Call this after changing bounds() directly.
+		 * Marking dtBounds also moves the object within the context's spatial index so events routed before the next
+		 * refresh find it at its new position.
+		*/
+		void mark_dirty(DIRTY_BITS _bit = DIRTY_BITS::dtBounds);
+
+		/**
+		 * @brief Returns true if this object or any of its descendants need a refresh
+		*/
+		bool is_dirty() const noexcept;
+
+		/**
+		 * @brief Returns true if the specified dirty bit is set
+		*/
+		bool is_dirty(DIRTY_BITS _bit) const noexcept;
+
 		virtual void refresh();
 		virtual void grow(pixels_t _dw, pixels_t _dh);
 
@@ -249,6 +525,15 @@ namespace sae::engine::core
 		uint8_t state_ = 0x00;
 		Rect bounds_{};
 		ZLayer z_{};
+
+		// New objects start out needing a refresh
+		uint8_t dirty_ = DIRTY_BITS::dtBounds;
+
+		// Set while the object's data lives in its context's scene store instead of the members above
+		GFXHandle scene_handle_{};
+
+		// Position in the parent's children, kept by GFXGroup and checked before use by GFXGroup::child_index()
+		size_t child_index_ = 0;
 	};
 
 	/**
@@ -274,6 +559,11 @@ namespace sae::engine::core
 
 		void handle_event(Event& _event) override;
 
+		/**
+		 * @brief Returns the position of _child among the children of this group, the order events are passed down in
+		*/
+		size_t child_index(const GFXObject* _child) const noexcept;
+
 		GFXGroup(Rect _r);
 
 	private:
@@ -331,19 +621,119 @@ namespace sae::engine::core
 
 	/**
 	 * @brief Represents a graphics context - usually a window. This prevents the need for global state.
+	 * The window may be nullptr to run headless, events are then posted directly and draw() only makes the gl calls the
+	 * artists make, see gl::RecordingBackend for running those without a gpu.
 	*/
 	class GFXContext : public GFXView
 	{
 	public:
 
+		/**
+		 * @brief Counters for the most recent refresh() call
+		*/
+		struct RefreshStats
+		{
+			// Objects whose refresh() was called
+			size_t visited = 0;
+
+			// Objects that were skipped because nothing in their subtree was dirty
+			size_t skipped = 0;
+		};
+
+		/**
+		 * @brief Refreshes every dirty object in the tree, clean subtrees are skipped
+		*/
+		void refresh() override;
+
+		const RefreshStats& last_refresh_stats() const noexcept;
+
 		void handle_event(Event& _event) override;
+
+		/**
+		 * @brief Handles queued events and lets every artist upload its buffers. Each artist then records its draw commands,
+		 * and the commands are sorted by RenderKey and executed in one pass.
+		*/
 		virtual void draw();
 
+		/**
+		 * @brief Counters for the command buffer of the most recent draw() call
+		*/
+		const RenderQueue::Stats& last_draw_stats() const noexcept;
+
+		/**
+		 * @brief Queues an event to be handled by the next process_events() call. Safe to call from any thread.
+		*/
+		void post_event(const Event& _event);
+		void post_event(Event&& _event);
+
+		/**
+		 * @brief Handles the events that were queued before the call, then refreshes once if any were handled. Events posted
+		 * while handling are left for the next call. Adjacent events are folded by the event coalescer before being handled.
+		 * Called at the start of draw().
+		 * @return Number of queued events taken, before folding
+		*/
+		size_t process_events();
+
+		/**
+		 * @brief Queue used by post_event(), exposed to change the overflow policy and read its stats
+		*/
+		EventQueue& event_queue() noexcept;
+		const EventQueue& event_queue() const noexcept;
+
+		/**
+		 * @brief Coalescer used by process_events(), exposed to change the per type modes and read the fold counters
+		*/
+		EventCoalescer& event_coalescer() noexcept;
+		const EventCoalescer& event_coalescer() const noexcept;
+
 		void register_artist(const std::string& _name, std::unique_ptr<IArtist> _artist);
 		IArtist* find_artist(const std::string& _name);
 
+		/**
+		 * @brief Returns the window this context draws to, nullptr for a headless context
+		*/
 		GLFWwindow* window() const noexcept;
 
+		void grow(pixels_t _dw, pixels_t _dh) override;
+
+		/**
+		 * @brief Moves the bounds, z layer, grow mode and state of every object in this context into a packed GFXSceneStore.
+		 * While enabled, grow() on the context or on any group is applied to the whole subtree as one sweep over the store
+		 * using bulk_grow(), so GFXObject::grow overrides below that point are not called.
+		*/
+		void enable_scene_store();
+
+		/**
+		 * @brief Moves object data back out of the scene store and destroys it
+		*/
+		void disable_scene_store();
+
+		/**
+		 * @brief Returns the scene store if enabled, nullptr otherwise
+		*/
+		GFXSceneStore* scene_store() const noexcept;
+
+		/**
+		 * @brief Builds a GFXSpatialGrid over every object in this context. While enabled, cursor move and mouse events are
+		 * only given to the objects whose bounds contain the cursor, front most z layer first, instead of being passed down
+		 * the whole tree. Objects on the same z layer get the event in the order the tree walk would reach them. The grid
+		 * is updated for objects marked dtBounds on each refresh().
+		 * @param _cellSize Width and height of each grid cell
+		*/
+		void enable_spatial_index(pixels_t _cellSize = 64_px);
+		void disable_spatial_index();
+
+		/**
+		 * @brief Returns the spatial index if enabled, nullptr otherwise
+		*/
+		GFXSpatialGrid* spatial_index() const noexcept;
+
+		/**
+		 * @brief Returns true while a positional event is being routed through the spatial index. Groups do not pass events
+		 * on to their children while this is set as each intersecting object is given the event directly.
+		*/
+		bool is_routing_event() const noexcept;
+
 		GFXContext(GLFWwindow* _window, Rect _r);
 		GFXContext(GLFWwindow* _window);
 
@@ -353,6 +743,38 @@ namespace sae::engine::core
 		GLFWwindow* window_ = nullptr;
 		std::vector<std::unique_ptr<IArtist>> artists_{};
 		std::unordered_map<std::string, IArtist*> artist_names_{};
+		RenderQueue render_queue_{};
+		std::unique_ptr<GFXSceneStore> scene_store_{};
+		RefreshStats refresh_stats_{};
+
+		// Nothing posted from input callbacks should be lost, so spill rather than drop when the ring is full
+		EventQueue event_queue_{ 1024, EventQueue::OVERFLOW_POLICY::GROW };
+		EventCoalescer event_coalescer_{};
+
+		// A routed hit with the keys it is ordered by, its path is the child index at each level down from this context.
+		// The first two levels are also packed into head so most comparisons don't need to look at the path.
+		struct RoutedHit
+		{
+			GFXObject* object = nullptr;
+			ZLayer z{};
+			uint64_t head = 0;
+			uint32_t path_begin = 0;
+			uint32_t path_end = 0;
+		};
+
+		std::unique_ptr<GFXSpatialGrid> spatial_index_{};
+		std::vector<GFXObject*> routing_scratch_{};
+		std::vector<RoutedHit> routing_hits_{};
+		std::vector<uint32_t> routing_paths_{};
+		bool routing_ = false;
+
+		friend GFXGroup;
+
+		/**
+		 * @brief Gives a cursor move or mouse event to the objects under the cursor
+		 * @return false if the event is not positional and should be handled normally
+		*/
+		bool route_positional_event(Event& _event);
 
 	};
 
@@ -1,6 +1,15 @@
 #include "SAEEngineCore_Object.h"
 
 #include <cassert>
+#include <array>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAE_ENGINE_CORE_GROW_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace sae::engine::core
 {
@@ -39,6 +48,483 @@ namespace sae::engine::core
 		};
 	};
 
+	/**
+	 * @brief Grows a rectangle by _dw and _dh along the sides that have their grow bit set
+	 * @param _r Rectangle to grow
+	 * @param _dw Change in width
+	 * @param _dh Change in height
+	*/
+	void GrowMode::apply(Rect& _r, pixels_t _dw, pixels_t _dh) const noexcept
+	{
+		if (this->is_set(GROW_BIT_E::gmLeft))
+		{
+			_r.left() += _dw;
+		};
+		if (this->is_set(GROW_BIT_E::gmRight))
+		{
+			_r.right() += _dw;
+		};
+		if (this->is_set(GROW_BIT_E::gmTop))
+		{
+			_r.top() += _dh;
+		};
+		if (this->is_set(GROW_BIT_E::gmBottom))
+		{
+			_r.bottom() += _dh;
+		};
+	};
+
+}
+
+namespace sae::engine::core
+{
+	namespace
+	{
+		static_assert(sizeof(Rect) == 4 * sizeof(pixels_t::value_type), "bulk_grow expects Rect to be four packed int16 values");
+		static_assert(sizeof(GrowMode) == sizeof(uint8_t), "bulk_grow expects GrowMode to be a single byte");
+
+		/**
+		 * @brief Expands a set of grow bits into a mask over the 4 sides of a Rect, in memory order (left, top, right, bottom)
+		*/
+		constexpr uint64_t grow_bits_to_lane_mask(uint8_t _bits) noexcept
+		{
+			uint64_t _out = 0;
+			if (_bits & GrowMode::gmLeft)
+			{
+				_out |= 0x000000000000FFFF;
+			};
+			if (_bits & GrowMode::gmTop)
+			{
+				_out |= 0x00000000FFFF0000;
+			};
+			if (_bits & GrowMode::gmRight)
+			{
+				_out |= 0x0000FFFF00000000;
+			};
+			if (_bits & GrowMode::gmBottom)
+			{
+				_out |= 0xFFFF000000000000;
+			};
+			return _out;
+		};
+
+		constexpr auto make_lane_mask_table() noexcept
+		{
+			std::array<uint64_t, 16> _out{};
+			for (uint8_t n = 0; n != _out.size(); ++n)
+			{
+				_out[n] = grow_bits_to_lane_mask(n);
+			};
+			return _out;
+		};
+		constexpr static inline auto GROW_LANE_MASKS = make_lane_mask_table();
+
+		void bulk_grow_scalar(Rect* _rects, const GrowMode* _modes, size_t _count, pixels_t _dw, pixels_t _dh) noexcept
+		{
+			for (size_t n = 0; n != _count; ++n)
+			{
+				_modes[n].apply(_rects[n], _dw, _dh);
+			};
+		};
+
+	};
+
+	void bulk_grow(std::span<Rect> _rects, std::span<const GrowMode> _modes, pixels_t _dw, pixels_t _dh) noexcept
+	{
+		assert(_rects.size() == _modes.size());
+
+		auto _rect = _rects.data();
+		auto _mode = _modes.data();
+		size_t _count = _rects.size();
+
+#if defined(__AVX2__)
+		const auto _delta = _mm256_setr_epi16(
+			_dw.count, _dh.count, _dw.count, _dh.count, _dw.count, _dh.count, _dw.count, _dh.count,
+			_dw.count, _dh.count, _dw.count, _dh.count, _dw.count, _dh.count, _dw.count, _dh.count);
+		for (; _count >= 4; _count -= 4, _rect += 4, _mode += 4)
+		{
+			const auto _mask = _mm256_setr_epi64x(
+				(int64_t)GROW_LANE_MASKS[_mode[0].bits() & 0xF], (int64_t)GROW_LANE_MASKS[_mode[1].bits() & 0xF],
+				(int64_t)GROW_LANE_MASKS[_mode[2].bits() & 0xF], (int64_t)GROW_LANE_MASKS[_mode[3].bits() & 0xF]);
+			auto _v = _mm256_loadu_si256((const __m256i*)_rect);
+			_v = _mm256_add_epi16(_v, _mm256_and_si256(_mask, _delta));
+			_mm256_storeu_si256((__m256i*)_rect, _v);
+		};
+#elif defined(SAE_ENGINE_CORE_GROW_SSE2)
+		const auto _delta = _mm_setr_epi16(_dw.count, _dh.count, _dw.count, _dh.count, _dw.count, _dh.count, _dw.count, _dh.count);
+		for (; _count >= 2; _count -= 2, _rect += 2, _mode += 2)
+		{
+			const auto _mask = _mm_set_epi64x((int64_t)GROW_LANE_MASKS[_mode[1].bits() & 0xF], (int64_t)GROW_LANE_MASKS[_mode[0].bits() & 0xF]);
+			auto _v = _mm_loadu_si128((const __m128i*)_rect);
+			_v = _mm_add_epi16(_v, _mm_and_si128(_mask, _delta));
+			_mm_storeu_si128((__m128i*)_rect, _v);
+		};
+#endif
+		bulk_grow_scalar(_rect, _mode, _count, _dw, _dh);
+	};
+
+}
+
+namespace sae::engine::core
+{
+	GFXSceneStore::index_type GFXSceneStore::dense_index(handle_type _h) const noexcept
+	{
+		assert(this->contains(_h));
+		return this->slots_[_h.index].dense;
+	};
+
+	GFXSceneStore::handle_type GFXSceneStore::insert(GFXObject* _obj, handle_type _parent, Rect _bounds, ZLayer _z, GrowMode _gm, state_type _state)
+	{
+		index_type _slot = this->free_head_;
+		if (_slot != handle_type::npos)
+		{
+			this->free_head_ = this->slots_[_slot].dense;
+		}
+		else
+		{
+			_slot = (index_type)this->slots_.size();
+			this->slots_.push_back(Slot{});
+		};
+
+		const auto _dense = (index_type)this->objects_.size();
+		this->slots_[_slot].dense = _dense;
+
+		this->bounds_.push_back(_bounds);
+		this->zlayers_.push_back(_z);
+		this->grow_modes_.push_back(_gm);
+		this->states_.push_back(_state);
+		this->parents_.push_back((this->contains(_parent)) ? _parent : handle_type{});
+		this->owners_.push_back(_slot);
+		this->objects_.push_back(_obj);
+
+		return handle_type{ _slot, this->slots_[_slot].generation };
+	};
+	void GFXSceneStore::erase(handle_type _h)
+	{
+		const auto _dense = this->dense_index(_h);
+		const auto _last = (index_type)(this->objects_.size() - 1);
+
+		// Swap the last entry into the erased position so the arrays stay packed
+		if (_dense != _last)
+		{
+			this->bounds_[_dense] = this->bounds_[_last];
+			this->zlayers_[_dense] = this->zlayers_[_last];
+			this->grow_modes_[_dense] = this->grow_modes_[_last];
+			this->states_[_dense] = this->states_[_last];
+			this->parents_[_dense] = this->parents_[_last];
+			this->owners_[_dense] = this->owners_[_last];
+			this->objects_[_dense] = this->objects_[_last];
+			this->slots_[this->owners_[_dense]].dense = _dense;
+		};
+
+		this->bounds_.pop_back();
+		this->zlayers_.pop_back();
+		this->grow_modes_.pop_back();
+		this->states_.pop_back();
+		this->parents_.pop_back();
+		this->owners_.pop_back();
+		this->objects_.pop_back();
+
+		auto& _slot = this->slots_[_h.index];
+		++_slot.generation;
+		_slot.dense = this->free_head_;
+		this->free_head_ = _h.index;
+	};
+
+	bool GFXSceneStore::contains(handle_type _h) const noexcept
+	{
+		return _h.good() && _h.index < this->slots_.size() && this->slots_[_h.index].generation == _h.generation &&
+			this->slots_[_h.index].dense < this->objects_.size() && this->owners_[this->slots_[_h.index].dense] == _h.index;
+	};
+
+	GFXSceneStore::size_type GFXSceneStore::size() const noexcept
+	{
+		return this->objects_.size();
+	};
+	bool GFXSceneStore::empty() const noexcept
+	{
+		return this->objects_.empty();
+	};
+
+	void GFXSceneStore::reserve(size_type _count)
+	{
+		this->bounds_.reserve(_count);
+		this->zlayers_.reserve(_count);
+		this->grow_modes_.reserve(_count);
+		this->states_.reserve(_count);
+		this->parents_.reserve(_count);
+		this->owners_.reserve(_count);
+		this->objects_.reserve(_count);
+		this->slots_.reserve(_count);
+	};
+
+	Rect& GFXSceneStore::bounds(handle_type _h) noexcept
+	{
+		return this->bounds_[this->dense_index(_h)];
+	};
+	const Rect& GFXSceneStore::bounds(handle_type _h) const noexcept
+	{
+		return this->bounds_[this->dense_index(_h)];
+	};
+
+	ZLayer& GFXSceneStore::zlayer(handle_type _h) noexcept
+	{
+		return this->zlayers_[this->dense_index(_h)];
+	};
+	const ZLayer& GFXSceneStore::zlayer(handle_type _h) const noexcept
+	{
+		return this->zlayers_[this->dense_index(_h)];
+	};
+
+	GrowMode& GFXSceneStore::grow_mode(handle_type _h) noexcept
+	{
+		return this->grow_modes_[this->dense_index(_h)];
+	};
+	const GrowMode& GFXSceneStore::grow_mode(handle_type _h) const noexcept
+	{
+		return this->grow_modes_[this->dense_index(_h)];
+	};
+
+	GFXSceneStore::state_type& GFXSceneStore::state(handle_type _h) noexcept
+	{
+		return this->states_[this->dense_index(_h)];
+	};
+	const GFXSceneStore::state_type& GFXSceneStore::state(handle_type _h) const noexcept
+	{
+		return this->states_[this->dense_index(_h)];
+	};
+
+	GFXSceneStore::handle_type GFXSceneStore::parent(handle_type _h) const noexcept
+	{
+		const auto _parent = this->parents_[this->dense_index(_h)];
+		return (this->contains(_parent)) ? _parent : handle_type{};
+	};
+	void GFXSceneStore::set_parent(handle_type _h, handle_type _parent) noexcept
+	{
+		this->parents_[this->dense_index(_h)] = (this->contains(_parent)) ? _parent : handle_type{};
+	};
+
+	GFXObject* GFXSceneStore::object(handle_type _h) const noexcept
+	{
+		return this->objects_[this->dense_index(_h)];
+	};
+
+	std::span<Rect> GFXSceneStore::packed_bounds() noexcept
+	{
+		return this->bounds_;
+	};
+	std::span<const Rect> GFXSceneStore::packed_bounds() const noexcept
+	{
+		return this->bounds_;
+	};
+	std::span<const ZLayer> GFXSceneStore::packed_zlayers() const noexcept
+	{
+		return this->zlayers_;
+	};
+	std::span<const GrowMode> GFXSceneStore::packed_grow_modes() const noexcept
+	{
+		return this->grow_modes_;
+	};
+	std::span<const GFXSceneStore::state_type> GFXSceneStore::packed_states() const noexcept
+	{
+		return this->states_;
+	};
+	std::span<GFXObject* const> GFXSceneStore::packed_objects() const noexcept
+	{
+		return this->objects_;
+	};
+	GFXSceneStore::index_type GFXSceneStore::packed_parent(index_type _dense) const noexcept
+	{
+		// The parent is stored with its generation so an erased parent, or a new entry reusing its slot, is not taken for it
+		const auto _parent = this->parents_[_dense];
+		return (this->contains(_parent)) ? this->slots_[_parent.index].dense : handle_type::npos;
+	};
+
+	void GFXSceneStore::mark_grown(std::span<const GrowMode> _modes, pixels_t _dw, pixels_t _dh)
+	{
+		if (_dw != 0_px || _dh != 0_px)
+		{
+			for (size_type n = 0; n != _modes.size(); ++n)
+			{
+				if (_modes[n].bits() != 0)
+				{
+					this->objects_[n]->mark_dirty(GFXObject::dtBounds);
+				};
+			};
+		};
+	};
+
+	void GFXSceneStore::grow(pixels_t _dw, pixels_t _dh)
+	{
+		bulk_grow(this->bounds_, this->grow_modes_, _dw, _dh);
+		this->mark_grown(this->grow_modes_, _dw, _dh);
+	};
+	void GFXSceneStore::grow(handle_type _root, pixels_t _dw, pixels_t _dh)
+	{
+		constexpr uint8_t UNKNOWN = 0;
+		constexpr uint8_t MEMBER = 1;
+		constexpr uint8_t OUTSIDE = 2;
+
+		const auto _count = this->size();
+		const auto _rootDense = this->dense_index(_root);
+
+		auto& _member = this->member_scratch_;
+		_member.assign(_count, UNKNOWN);
+		_member[_rootDense] = MEMBER;
+
+		// Entries are not stored in tree order, so walk up each parent chain until reaching an entry with a known answer
+		// and then write that answer back down the chain. Every entry is resolved once.
+		auto& _chain = this->chain_scratch_;
+		_chain.clear();
+		for (index_type n = 0; n != _count; ++n)
+		{
+			auto _at = n;
+			while (_at != handle_type::npos && _member[_at] == UNKNOWN)
+			{
+				_chain.push_back(_at);
+				_at = this->packed_parent(_at);
+			};
+			const auto _result = (_at != handle_type::npos && _member[_at] == MEMBER) ? MEMBER : OUTSIDE;
+			for (auto& c : _chain)
+			{
+				_member[c] = _result;
+			};
+			_chain.clear();
+		};
+
+		// Entries outside the subtree get an empty grow mode so the kernel leaves them untouched
+		auto& _modes = this->grow_scratch_;
+		_modes.resize(_count);
+		for (index_type n = 0; n != _count; ++n)
+		{
+			_modes[n] = (_member[n] == MEMBER) ? this->grow_modes_[n] : GrowMode{};
+		};
+
+		bulk_grow(this->bounds_, _modes, _dw, _dh);
+		this->mark_grown(_modes, _dw, _dh);
+	};
+
+}
+
+namespace sae::engine::core
+{
+	int32_t GFXSpatialGrid::column_of(pixels_t _x) const noexcept
+	{
+		const auto _col = ((int32_t)_x.count - (int32_t)this->area_.left().count) / (int32_t)this->cell_size_.count;
+		return std::clamp(_col, 0, this->columns_ - 1);
+	};
+	int32_t GFXSpatialGrid::row_of(pixels_t _y) const noexcept
+	{
+		const auto _row = ((int32_t)_y.count - (int32_t)this->area_.top().count) / (int32_t)this->cell_size_.count;
+		return std::clamp(_row, 0, this->rows_ - 1);
+	};
+	GFXSpatialGrid::CellRange GFXSpatialGrid::cells_for(const Rect& _bounds) const noexcept
+	{
+		return CellRange{ this->column_of(_bounds.left()), this->row_of(_bounds.top()), this->column_of(_bounds.right()), this->row_of(_bounds.bottom()) };
+	};
+
+	void GFXSpatialGrid::add_to_cells(GFXObject* _obj, CellRange _range)
+	{
+		for (auto y = _range.y0; y <= _range.y1; ++y)
+		{
+			for (auto x = _range.x0; x <= _range.x1; ++x)
+			{
+				this->cells_[(size_t)y * this->columns_ + x].push_back(_obj);
+			};
+		};
+	};
+	void GFXSpatialGrid::remove_from_cells(GFXObject* _obj, CellRange _range)
+	{
+		for (auto y = _range.y0; y <= _range.y1; ++y)
+		{
+			for (auto x = _range.x0; x <= _range.x1; ++x)
+			{
+				auto& _cell = this->cells_[(size_t)y * this->columns_ + x];
+				auto _it = std::find(_cell.begin(), _cell.end(), _obj);
+				assert(_it != _cell.end());
+				*_it = _cell.back();
+				_cell.pop_back();
+			};
+		};
+	};
+
+	void GFXSpatialGrid::insert(GFXObject* _obj, const Rect& _bounds)
+	{
+		const auto _range = this->cells_for(_bounds);
+		auto _it = this->ranges_.find(_obj);
+		if (_it == this->ranges_.end())
+		{
+			this->ranges_.insert({ _obj, _range });
+			this->add_to_cells(_obj, _range);
+		}
+		else if (_it->second != _range)
+		{
+			this->remove_from_cells(_obj, _it->second);
+			this->add_to_cells(_obj, _range);
+			_it->second = _range;
+		};
+	};
+	void GFXSpatialGrid::erase(GFXObject* _obj)
+	{
+		auto _it = this->ranges_.find(_obj);
+		if (_it != this->ranges_.end())
+		{
+			this->remove_from_cells(_obj, _it->second);
+			this->ranges_.erase(_it);
+		};
+	};
+
+	bool GFXSpatialGrid::contains(GFXObject* _obj) const
+	{
+		return this->ranges_.contains(_obj);
+	};
+	GFXSpatialGrid::size_type GFXSpatialGrid::size() const noexcept
+	{
+		return this->ranges_.size();
+	};
+
+	void GFXSpatialGrid::rebuild(Rect _area)
+	{
+		this->area_ = _area;
+		this->columns_ = std::max(1, ((int32_t)_area.width().count + this->cell_size_.count - 1) / (int32_t)this->cell_size_.count);
+		this->rows_ = std::max(1, ((int32_t)_area.height().count + this->cell_size_.count - 1) / (int32_t)this->cell_size_.count);
+
+		this->cells_.clear();
+		this->cells_.resize((size_t)this->columns_ * this->rows_);
+		for (auto& r : this->ranges_)
+		{
+			r.second = this->cells_for(r.first->bounds());
+			this->add_to_cells(r.first, r.second);
+		};
+	};
+
+	void GFXSpatialGrid::query(ScreenPoint _p, std::vector<GFXObject*>& _out) const
+	{
+		const auto& _cell = this->cells_[(size_t)this->row_of(_p.y) * this->columns_ + this->column_of(_p.x)];
+		for (auto& o : _cell)
+		{
+			if (o->bounds().intersects(_p))
+			{
+				_out.push_back(o);
+			};
+		};
+	};
+
+	const Rect& GFXSpatialGrid::area() const noexcept
+	{
+		return this->area_;
+	};
+	pixels_t GFXSpatialGrid::cell_size() const noexcept
+	{
+		return this->cell_size_;
+	};
+
+	GFXSpatialGrid::GFXSpatialGrid(Rect _area, pixels_t _cellSize) :
+		cell_size_{ std::max(_cellSize, 1_px) }
+	{
+		this->rebuild(_area);
+	};
+
 }
 
 namespace sae::engine::core
@@ -48,27 +534,110 @@ namespace sae::engine::core
 
 	void GFXObject::set_state_bit(STATE_BITS _bit) noexcept
 	{
-		this->state_ |= _bit;
+		this->state_bits() |= _bit;
 		this->on_state_change(_bit, true);
 	};
 	void GFXObject::clear_state_bit(STATE_BITS _bit) noexcept
 	{
-		this->state_ &= ~_bit;
+		this->state_bits() &= ~_bit;
 		this->on_state_change(_bit, false);
 	};
 	bool GFXObject::check_state_bit(STATE_BITS _bit) const noexcept
 	{
-		return (this->state_ & _bit) != 0;
+		return (this->state_bits() & _bit) != 0;
+	};
+
+	uint8_t& GFXObject::state_bits() noexcept
+	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->state(this->scene_handle_);
+		};
+		return this->state_;
+	};
+	const uint8_t& GFXObject::state_bits() const noexcept
+	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->state(this->scene_handle_);
+		};
+		return this->state_;
+	};
+
+	GFXSceneStore* GFXObject::scene_store() const noexcept
+	{
+		return (this->context()) ? this->context()->scene_store() : nullptr;
+	};
+	void GFXObject::attach_scene_store(GFXSceneStore* _store)
+	{
+		assert(!this->scene_handle_);
+		GFXHandle _parent{};
+		if (this->has_parent())
+		{
+			_parent = this->parent()->scene_handle_;
+		};
+		this->scene_handle_ = _store->insert(this, _parent, this->bounds_, this->z_, this->grow_mode_, this->state_);
+	};
+	void GFXObject::detach_scene_store()
+	{
+		if (this->scene_handle_)
+		{
+			auto _store = this->scene_store();
+			assert(_store);
+
+			// Copy the packed values back so the object keeps its state
+			this->bounds_ = _store->bounds(this->scene_handle_);
+			this->z_ = _store->zlayer(this->scene_handle_);
+			this->grow_mode_ = _store->grow_mode(this->scene_handle_);
+			this->state_ = _store->state(this->scene_handle_);
+
+			_store->erase(this->scene_handle_);
+			this->scene_handle_ = GFXHandle{};
+		};
 	};
 
 	void GFXObject::set_parent(GFXView* _to) noexcept
 	{
 		this->parent_ = _to;
+		if (this->scene_handle_)
+		{
+			this->scene_store()->set_parent(this->scene_handle_, (_to) ? _to->scene_handle_ : GFXHandle{});
+		};
+	};
+	void GFXObject::detach_spatial_index() noexcept
+	{
+		if (this->context_ && (GFXObject*)this->context_ != this && this->context_->spatial_index())
+		{
+			this->context_->spatial_index()->erase(this);
+		};
 	};
+	void GFXObject::update_spatial_index()
+	{
+		if (this->context_ && (GFXObject*)this->context_ != this && this->context_->spatial_index())
+		{
+			this->context_->spatial_index()->insert(this, this->bounds());
+		};
+	};
+
 	void GFXObject::set_context(GFXContext* _to)
 	{
 		//assert(!this->context());
+		this->detach_scene_store();
+		this->detach_spatial_index();
 		this->context_ = _to;
+
+		// The root context is never placed in its own store or index, this also avoids touching the context before it is constructed
+		if (_to && (GFXObject*)_to != this)
+		{
+			if (_to->scene_store())
+			{
+				this->attach_scene_store(_to->scene_store());
+			};
+			if (_to->spatial_index())
+			{
+				_to->spatial_index()->insert(this, this->bounds());
+			};
+		};
 	};
 
 	GFXView* GFXObject::parent() const noexcept
@@ -92,58 +661,102 @@ namespace sae::engine::core
 
 	Rect& GFXObject::bounds() noexcept
 	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->bounds(this->scene_handle_);
+		};
 		return this->bounds_;
 	};
 	const Rect& GFXObject::bounds() const noexcept
 	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->bounds(this->scene_handle_);
+		};
 		return this->bounds_;
 	};
+	void GFXObject::set_bounds(const Rect& _r)
+	{
+		if (this->bounds() != _r)
+		{
+			this->bounds() = _r;
+			this->mark_dirty(DIRTY_BITS::dtBounds);
+		};
+	};
 
 	ZLayer& GFXObject::zlayer() noexcept
 	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->zlayer(this->scene_handle_);
+		};
 		return this->z_;
 	};
 	const ZLayer& GFXObject::zlayer() const noexcept
 	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->zlayer(this->scene_handle_);
+		};
 		return this->z_;
 	};
 
 	GrowMode& GFXObject::grow_mode() noexcept
 	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->grow_mode(this->scene_handle_);
+		};
 		return this->grow_mode_;
 	};
 	const GrowMode& GFXObject::grow_mode() const noexcept
 	{
+		if (this->scene_handle_)
+		{
+			return this->scene_store()->grow_mode(this->scene_handle_);
+		};
 		return this->grow_mode_;
 	};
 
-	void GFXObject::handle_event(Event& _event) {};
-
-	void GFXObject::refresh() {};
-	void GFXObject::grow(pixels_t _dw, pixels_t _dh)
+	void GFXObject::mark_dirty(DIRTY_BITS _bit)
 	{
-		using GBIT = GrowMode::GROW_BIT_E;
+		this->dirty_ |= _bit;
 
-		const auto& _gmode = this->grow_mode();
-		auto& _b = this->bounds();
-
-		if (_gmode.is_set(GBIT::gmLeft))
-		{
-			_b.left() += _dw;
-		};
-		if (_gmode.is_set(GBIT::gmRight))
+		// Events are dispatched before the next refresh, so the index is kept in step with the bounds as they change
+		if ((_bit & DIRTY_BITS::dtBounds) != 0)
 		{
-			_b.right() += _dw;
+			this->update_spatial_index();
 		};
-		if (_gmode.is_set(GBIT::gmTop))
+
+		// Stop once an ancestor is already marked, everything above it is marked as well
+		for (GFXObject* p = this->parent(); p && !p->is_dirty(DIRTY_BITS::dtDescendant); p = p->parent())
 		{
-			_b.top() += _dh;
+			p->dirty_ |= DIRTY_BITS::dtDescendant;
 		};
-		if (_gmode.is_set(GBIT::gmBottom))
+	};
+	bool GFXObject::is_dirty() const noexcept
+	{
+		return this->dirty_ != 0;
+	};
+	bool GFXObject::is_dirty(DIRTY_BITS _bit) const noexcept
+	{
+		return (this->dirty_ & _bit) != 0;
+	};
+	void GFXObject::clear_dirty() noexcept
+	{
+		this->dirty_ &= DIRTY_BITS::dtDescendant;
+	};
+
+	void GFXObject::handle_event(Event& _event) {};
+
+	void GFXObject::refresh() {};
+	void GFXObject::grow(pixels_t _dw, pixels_t _dh)
+	{
+		if (this->grow_mode().bits() != 0 && (_dw != 0_px || _dh != 0_px))
 		{
-			_b.bottom() += _dh;
+			this->grow_mode().apply(this->bounds(), _dw, _dh);
+			this->mark_dirty(DIRTY_BITS::dtBounds);
 		};
-
 	};
 
 	GFXObject::GFXObject(Rect _r) :
@@ -153,7 +766,11 @@ namespace sae::engine::core
 	GFXObject::GFXObject() :
 		GFXObject{ Rect{} }
 	{};
-	GFXObject::~GFXObject() {};
+	GFXObject::~GFXObject()
+	{
+		this->detach_scene_store();
+		this->detach_spatial_index();
+	};
 
 }
 
@@ -161,19 +778,48 @@ namespace sae::engine::core
 {
 	void GFXGroup::insert_child(value_type _obj)
 	{
+		_obj->child_index_ = this->children().size();
 		this->children().push_back(std::move(_obj));
+		this->children().back()->mark_dirty(DIRTY_BITS::dtBounds);
+		this->mark_dirty(DIRTY_BITS::dtChildren);
 	};
 	void GFXGroup::remove_child(GFXObject* _obj)
 	{
-		this->children().erase(std::find_if(this->children().begin(), this->children().end(), [_obj](const auto& o) {
+		auto _it = std::find_if(this->children().begin(), this->children().end(), [_obj](const auto& o) {
 			return o.get() == _obj;
-			}));
+			});
+		assert(_it != this->children().end());
+
+		// Leave the context so the object is no longer stored, indexed or routed to if it outlives its removal
+		(*_it)->set_context(nullptr);
+		(*_it)->set_parent(nullptr);
+
+		for (_it = this->children().erase(_it); _it != this->children().end(); ++_it)
+		{
+			--(*_it)->child_index_;
+		};
+		this->mark_dirty(DIRTY_BITS::dtChildren);
+	};
+	size_t GFXGroup::child_index(const GFXObject* _child) const noexcept
+	{
+		const auto& _children = this->children();
+		if (_child->child_index_ < _children.size() && _children[_child->child_index_].get() == _child)
+		{
+			return _child->child_index_;
+		};
+
+		// The children were reordered through GFXView's iterators, fall back to a search
+		const auto _it = std::find_if(_children.begin(), _children.end(), [_child](const auto& o) {
+			return o.get() == _child;
+			});
+		assert(_it != _children.end());
+		return (size_t)(_it - _children.begin());
 	};
 
 	void GFXGroup::handle_event(Event& _event)
 	{
 		GFXObject::handle_event(_event);
-		if (_event)
+		if (_event && !(this->context() && this->context()->is_routing_event()))
 		{
 			for (auto& o : this->children())
 			{
@@ -207,17 +853,47 @@ namespace sae::engine::core
 	void GFXGroup::refresh()
 	{
 		GFXObject::refresh();
+
+		auto _context = this->context();
 		for (auto& o : this->children())
 		{
-			o->refresh();
+			if (o->is_dirty())
+			{
+				o->refresh();
+				o->clear_dirty();
+				if (_context)
+				{
+					++_context->refresh_stats_.visited;
+				};
+			}
+			else if (_context)
+			{
+				++_context->refresh_stats_.skipped;
+			};
+		};
+
+		// Children can be marked again while their siblings refresh, only drop the flag if every child is now clean
+		const auto _pending = std::any_of(this->children().begin(), this->children().end(), [](const auto& o) {
+			return o->is_dirty();
+			});
+		if (!_pending)
+		{
+			this->dirty_ &= ~DIRTY_BITS::dtDescendant;
 		};
 	};
 	void GFXGroup::grow(pixels_t _dw, pixels_t _dh)
 	{
-		GFXObject::grow(_dw, _dh);
-		for (auto& o : this->children())
+		if (this->scene_handle_)
+		{
+			this->scene_store()->grow(this->scene_handle_, _dw, _dh);
+		}
+		else
 		{
-			o->grow(_dw, _dh);
+			GFXObject::grow(_dw, _dh);
+			for (auto& o : this->children())
+			{
+				o->grow(_dw, _dh);
+			};
 		};
 	};
 
@@ -290,7 +966,13 @@ namespace sae::engine::core
 	
 	void GFXView::clear() noexcept
 	{
+		for (auto& o : this->children())
+		{
+			o->set_context(nullptr);
+			o->set_parent(nullptr);
+		};
 		this->children().clear();
+		this->mark_dirty(DIRTY_BITS::dtChildren);
 	};
 
 	void GFXView::insert(value_type _obj)
@@ -331,10 +1013,174 @@ namespace sae::engine::core
 {
 	void GFXContext::draw()
 	{
+		this->process_events();
 		for (auto& o : this->artists_)
 		{
-			o->draw();
+			o->upload();
+		};
+
+		this->render_queue_.clear();
+		for (uint32_t n = 0; n != (uint32_t)this->artists_.size(); ++n)
+		{
+			this->render_queue_.begin_artist(n);
+			this->artists_[n]->record(this->render_queue_);
 		};
+		this->render_queue_.sort();
+		for (auto& c : this->render_queue_.commands())
+		{
+			this->artists_[c.artist]->execute(c);
+		};
+	};
+
+	const RenderQueue::Stats& GFXContext::last_draw_stats() const noexcept
+	{
+		return this->render_queue_.stats();
+	};
+
+	void GFXContext::post_event(const Event& _event)
+	{
+		this->event_queue_.push(_event);
+	};
+	void GFXContext::post_event(Event&& _event)
+	{
+		this->event_queue_.push(std::move(_event));
+	};
+
+	size_t GFXContext::process_events()
+	{
+		const auto _count = this->event_queue_.drain([this](Event& _ev)
+			{
+				this->event_coalescer_.push(std::move(_ev));
+			}, this->event_queue_.size_approx());
+		this->event_coalescer_.flush([this](Event& _ev)
+			{
+				this->handle_event(_ev);
+			});
+		if (_count != 0)
+		{
+			this->refresh();
+		};
+		return _count;
+	};
+
+	EventQueue& GFXContext::event_queue() noexcept
+	{
+		return this->event_queue_;
+	};
+	const EventQueue& GFXContext::event_queue() const noexcept
+	{
+		return this->event_queue_;
+	};
+
+	EventCoalescer& GFXContext::event_coalescer() noexcept
+	{
+		return this->event_coalescer_;
+	};
+	const EventCoalescer& GFXContext::event_coalescer() const noexcept
+	{
+		return this->event_coalescer_;
+	};
+
+	void GFXContext::refresh()
+	{
+		this->refresh_stats_ = RefreshStats{};
+		if (this->is_dirty())
+		{
+			if (this->spatial_index() && this->is_dirty(DIRTY_BITS::dtBounds))
+			{
+				this->spatial_index()->rebuild(this->bounds());
+			};
+			++this->refresh_stats_.visited;
+			GFXView::refresh();
+			this->clear_dirty();
+		}
+		else
+		{
+			++this->refresh_stats_.skipped;
+		};
+	};
+	const GFXContext::RefreshStats& GFXContext::last_refresh_stats() const noexcept
+	{
+		return this->refresh_stats_;
+	};
+
+	bool GFXContext::route_positional_event(Event& _event)
+	{
+		std::optional<ScreenPoint> _at{};
+		switch (_event.index())
+		{
+		case Event::EVENT_TYPE::CURSOR_MOVE:
+		{
+			const auto& _ev = _event.get<Event::EVENT_TYPE::CURSOR_MOVE>();
+			_at = ScreenPoint{ _ev.cursor_x, _ev.cursor_y };
+		};
+			break;
+		case Event::EVENT_TYPE::MOUSE_EVENT:
+		{
+			const auto& _ev = _event.get<Event::EVENT_TYPE::MOUSE_EVENT>();
+			_at = ScreenPoint{ _ev.cursor_x, _ev.cursor_y };
+		};
+			break;
+		default:
+			break;
+		};
+
+		if (!_at)
+		{
+			return false;
+		};
+
+		auto& _found = this->routing_scratch_;
+		_found.clear();
+		this->spatial_index()->query(*_at, _found);
+
+		// The grid returns hits in bucket order, which depends on insertion and removal history. Objects on the same z layer
+		// are given the event in the order the tree walk would reach them so both dispatch modes agree, found by comparing
+		// the path of child indices leading to each object.
+		auto& _hits = this->routing_hits_;
+		auto& _paths = this->routing_paths_;
+		_hits.clear();
+		_paths.clear();
+		for (auto& o : _found)
+		{
+			const auto _begin = (uint32_t)_paths.size();
+			for (const GFXObject* c = o; c->parent(); c = c->parent())
+			{
+				_paths.push_back((uint32_t)c->parent()->child_index(c));
+			};
+			std::reverse(_paths.begin() + _begin, _paths.end());
+
+			// Levels are stored one higher so a missing level sorts first, putting parents before their children
+			const auto _depth = (uint32_t)_paths.size() - _begin;
+			const uint64_t _first = (_depth > 0) ? (uint64_t)_paths[_begin] + 1 : 0;
+			const uint64_t _second = (_depth > 1) ? (uint64_t)_paths[_begin + 1] + 1 : 0;
+			_hits.push_back(RoutedHit{ o, o->zlayer(), (_first << 32) | _second, _begin, (uint32_t)_paths.size() });
+		};
+		std::stable_sort(_hits.begin(), _hits.end(), [&_paths](const RoutedHit& _lhs, const RoutedHit& _rhs) {
+			if (_lhs.z != _rhs.z)
+			{
+				return _lhs.z > _rhs.z;
+			};
+			if (_lhs.head != _rhs.head)
+			{
+				return _lhs.head < _rhs.head;
+			};
+			return std::lexicographical_compare(_paths.begin() + std::min(_lhs.path_begin + 2, _lhs.path_end), _paths.begin() + _lhs.path_end,
+				_paths.begin() + std::min(_rhs.path_begin + 2, _rhs.path_end), _paths.begin() + _rhs.path_end);
+			});
+
+		this->routing_ = true;
+		for (auto& h : _hits)
+		{
+			h.object->handle_event(_event);
+			if (!_event)
+			{
+				break;
+			};
+		};
+		this->routing_ = false;
+
+		return true;
 	};
 
 	void GFXContext::handle_event(Event& _event)
@@ -343,6 +1189,10 @@ namespace sae::engine::core
 		{
 			a->handle_event(_event);
 		};
+		if (_event && this->spatial_index() && this->route_positional_event(_event))
+		{
+			return;
+		};
 		GFXView::handle_event(_event);
 	};
 
@@ -361,6 +1211,74 @@ namespace sae::engine::core
 		return this->window_;
 	};
 
+	void GFXContext::grow(pixels_t _dw, pixels_t _dh)
+	{
+		if (this->scene_store())
+		{
+			GFXObject::grow(_dw, _dh);
+			this->scene_store()->grow(_dw, _dh);
+		}
+		else
+		{
+			GFXView::grow(_dw, _dh);
+		};
+	};
+
+	void GFXContext::enable_scene_store()
+	{
+		if (!this->scene_store())
+		{
+			this->scene_store_ = std::make_unique<GFXSceneStore>();
+
+			// Re-setting the context moves each object (and its children, parents first) into the store
+			for (auto& o : this->children())
+			{
+				o->set_context(this);
+			};
+		};
+	};
+	void GFXContext::disable_scene_store()
+	{
+		if (this->scene_store())
+		{
+			while (!this->scene_store()->empty())
+			{
+				this->scene_store()->packed_objects().back()->detach_scene_store();
+			};
+			this->scene_store_.reset();
+		};
+	};
+	GFXSceneStore* GFXContext::scene_store() const noexcept
+	{
+		return this->scene_store_.get();
+	};
+
+	void GFXContext::enable_spatial_index(pixels_t _cellSize)
+	{
+		if (!this->spatial_index())
+		{
+			this->spatial_index_ = std::make_unique<GFXSpatialGrid>(this->bounds(), _cellSize);
+
+			// Re-setting the context adds each object in the tree to the index
+			for (auto& o : this->children())
+			{
+				o->set_context(this);
+			};
+		};
+	};
+	void GFXContext::disable_spatial_index()
+	{
+		this->spatial_index_.reset();
+	};
+	GFXSpatialGrid* GFXContext::spatial_index() const noexcept
+	{
+		return this->spatial_index_.get();
+	};
+	bool GFXContext::is_routing_event() const noexcept
+	{
+		return this->routing_;
+	};
+
 	GFXContext::GFXContext(GLFWwindow* _window, Rect _r) :
 		GFXView{ this, _r }, window_{ _window }
 	{};
@@ -370,6 +1288,8 @@ namespace sae::engine::core
 
 	GFXContext::~GFXContext()
 	{
+		this->disable_spatial_index();
+		this->disable_scene_store();
 		this->clear();
 	};
 
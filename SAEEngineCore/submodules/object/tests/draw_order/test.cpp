@@ -0,0 +1,146 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Object.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Registers artists that record commands on several layers with a handful of shaders and checks GFXContext::draw()
+	executes them back to front, grouped by state within a layer, and leaves artists that do not record commands in
+	registration order.
+*/
+
+struct Executed
+{
+	int artist;
+	RenderKey key;
+	uint32_t data;
+};
+
+static std::vector<Executed> executed{};
+
+class LayeredArtist : public IArtist
+{
+public:
+	bool good() override { return true; };
+	void draw() override {};
+
+	void remove(GFXObject* _obj) override {};
+	bool contains(GFXObject* _obj) const override { return false; };
+
+	void record(RenderQueue& _queue) override
+	{
+		for (uint32_t n = 0; n != this->layers_; ++n)
+		{
+			_queue.push(RenderKey{ (uint16_t)(this->layers_ - n), this->shader_, this->vertex_array_, 0 }, n);
+		};
+	};
+	void execute(const RenderCommand& _cmd) override
+	{
+		executed.push_back(Executed{ this->name_, RenderKey::unpack(_cmd.key), _cmd.data });
+	};
+
+	LayeredArtist(int _name, uint16_t _shader, uint16_t _vertexArray, uint32_t _layers) :
+		name_{ _name }, shader_{ _shader }, vertex_array_{ _vertexArray }, layers_{ _layers }
+	{};
+
+private:
+	int name_;
+	uint16_t shader_;
+	uint16_t vertex_array_;
+	uint32_t layers_;
+};
+
+class PlainArtist : public IArtist
+{
+public:
+	bool good() override { return true; };
+	void draw() override
+	{
+		executed.push_back(Executed{ this->name_, RenderKey{}, 0 });
+	};
+
+	void remove(GFXObject* _obj) override {};
+	bool contains(GFXObject* _obj) const override { return false; };
+
+	PlainArtist(int _name) :
+		name_{ _name }
+	{};
+
+private:
+	int name_;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	constexpr uint32_t LAYERS = 8;
+	constexpr int LAYERED_ARTISTS = 12;
+
+	GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 800_px, 600_px }} };
+	_context.register_artist("plain_a", std::make_unique<PlainArtist>(-1));
+	for (int n = 0; n != LAYERED_ARTISTS; ++n)
+	{
+		// Artists alternate between three shaders and two vertex arrays in registration order
+		_context.register_artist("layered_" + std::to_string(n),
+			std::make_unique<LayeredArtist>(n, (uint16_t)(1 + n % 3), (uint16_t)(1 + n % 2), LAYERS));
+	};
+	_context.register_artist("plain_b", std::make_unique<PlainArtist>(-2));
+
+	_context.draw();
+
+	const auto& _stats = _context.last_draw_stats();
+	if (executed.size() != 2 + LAYERED_ARTISTS * LAYERS || _stats.commands != executed.size())
+	{
+		std::cout << "expected every recorded command to be executed once\n";
+		return 1;
+	};
+
+	// Artists without commands of their own go first, in registration order
+	if (executed[0].artist != -1 || executed[1].artist != -2)
+	{
+		std::cout << "artists using the default record() were not drawn first in registration order\n";
+		return 2;
+	};
+
+	for (size_t n = 3; n < executed.size(); ++n)
+	{
+		const auto& _prev = executed[n - 1].key;
+		const auto& _cur = executed[n].key;
+		if (_cur.layer < _prev.layer || (_cur.layer == _prev.layer && _cur.pack() < _prev.pack()))
+		{
+			std::cout << "command " << n << " is out of order\n";
+			return 3;
+		};
+	};
+
+	// Without sorting every layered command would switch shader and most would switch vertex array as well, sorted each
+	// layer needs at most one switch per distinct shader and vertex array pair
+	const size_t _unsortedSwitches = LAYERED_ARTISTS * LAYERS * 2;
+	if (_stats.state_switches >= _unsortedSwitches / 2)
+	{
+		std::cout << "sorting did not reduce state switches, " << _stats.state_switches << '\n';
+		return 4;
+	};
+
+	std::cout << _stats.commands << " commands, " << _stats.state_switches << " state switches (about "
+		<< _unsortedSwitches << " unsorted), sorted in " << _stats.sort_time.count() << " ns\n";
+
+	return GOOD_TEST;
+};
@@ -0,0 +1,120 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Object.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Compares the recursive virtual grow path against the batched bulk_grow path on the same tree shape.
+	Both trees are grown with the same deltas and compared afterwards so the benchmark also checks correctness.
+*/
+
+constexpr static inline size_t CHILDREN_PER_GROUP = 100;
+constexpr static inline size_t GROW_ITERATIONS = 100;
+
+static void populate(GFXContext& _context, std::vector<GFXObject*>& _objects, size_t _count)
+{
+	uint8_t _bits = 0;
+	auto _nextMode = [&_bits]()
+	{
+		GrowMode _gm{};
+		_gm.set_to(GrowMode::gmLeft, _bits & 0x1);
+		_gm.set_to(GrowMode::gmRight, _bits & 0x2);
+		_gm.set_to(GrowMode::gmTop, _bits & 0x4);
+		_gm.set_to(GrowMode::gmBottom, _bits & 0x8);
+		_bits = (_bits + 7) & 0xF;
+		return _gm;
+	};
+
+	for (size_t _made = 0; _made < _count;)
+	{
+		auto _group = new GFXView{ &_context, Rect{{ 0_px, 0_px }, { 100_px, 100_px }} };
+		_group->grow_mode() = _nextMode();
+		_objects.push_back(_group);
+		++_made;
+		for (size_t n = 0; n != CHILDREN_PER_GROUP && _made < _count; ++n, ++_made)
+		{
+			auto _obj = new GFXObject{ Rect{{ (int)n, (int)n }, { (int)n + 10, (int)n + 10 }} };
+			_obj->grow_mode() = _nextMode();
+			_group->emplace(_obj);
+			_objects.push_back(_obj);
+		};
+		_context.emplace(_group);
+	};
+};
+
+template <typename FuncT>
+static double time_grows(FuncT&& _grow)
+{
+	const auto _start = std::chrono::steady_clock::now();
+	for (size_t n = 0; n != GROW_ITERATIONS; ++n)
+	{
+		const auto _d = (n % 2 == 0) ? 3 : -2;
+		_grow(pixels_t{ _d }, pixels_t{ -_d });
+	};
+	const auto _end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::micro>(_end - _start).count() / (double)GROW_ITERATIONS;
+};
+
+static bool same_bounds(const Rect& _lhs, const Rect& _rhs)
+{
+	return _lhs.left() == _rhs.left() && _lhs.top() == _rhs.top() && _lhs.right() == _rhs.right() && _lhs.bottom() == _rhs.bottom();
+};
+
+static int run(size_t _count)
+{
+	GFXContext _recursive{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+	GFXContext _batched{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+
+	std::vector<GFXObject*> _recursiveObjects{};
+	std::vector<GFXObject*> _batchedObjects{};
+	populate(_recursive, _recursiveObjects, _count);
+	populate(_batched, _batchedObjects, _count);
+	_batched.enable_scene_store();
+
+	const auto _recursiveTime = time_grows([&_recursive](pixels_t _dw, pixels_t _dh) { _recursive.grow(_dw, _dh); });
+	const auto _batchedTime = time_grows([&_batched](pixels_t _dw, pixels_t _dh) { _batched.grow(_dw, _dh); });
+
+	for (size_t n = 0; n != _recursiveObjects.size(); ++n)
+	{
+		if (!same_bounds(_recursiveObjects[n]->bounds(), _batchedObjects[n]->bounds()))
+		{
+			std::cout << "bounds mismatch at object " << n << " of " << _count << '\n';
+			return 1;
+		};
+	};
+
+	std::cout << _count << " objects : recursive " << _recursiveTime << " us/grow, batched " << _batchedTime
+		<< " us/grow (" << (_recursiveTime / _batchedTime) << "x)\n";
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	for (auto _count : { 1000, 10000, 100000 })
+	{
+		if (auto _res = run(_count); _res != GOOD_TEST)
+		{
+			return _res;
+		};
+	};
+	return GOOD_TEST;
+};
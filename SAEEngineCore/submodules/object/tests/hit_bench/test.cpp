@@ -0,0 +1,150 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Object.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Measures cursor move throughput with and without the context's spatial index on the same tree shape.
+	Every object records the events it receives so the routed recipients can be checked against a brute force hit test.
+*/
+
+constexpr static inline size_t CHILDREN_PER_GROUP = 100;
+constexpr static inline size_t EVENT_COUNT = 2000;
+
+class HitRecorder : public GFXObject
+{
+public:
+	void handle_event(Event& _event) override
+	{
+		++this->hits;
+	};
+
+	size_t hits = 0;
+
+	using GFXObject::GFXObject;
+};
+
+static void populate(GFXContext& _context, std::vector<HitRecorder*>& _objects, size_t _count)
+{
+	uint32_t _seed = 12345;
+	auto _next = [&_seed](int _max)
+	{
+		_seed = _seed * 1664525u + 1013904223u;
+		return (int)((_seed >> 8) % (uint32_t)_max);
+	};
+
+	for (size_t _made = 0; _made < _count;)
+	{
+		auto _group = new GFXView{ &_context, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+		for (size_t n = 0; n != CHILDREN_PER_GROUP && _made < _count; ++n, ++_made)
+		{
+			const auto _x = _next(1560);
+			const auto _y = _next(860);
+			auto _obj = new HitRecorder{ Rect{{ _x, _y }, { _x + 8 + _next(32), _y + 8 + _next(32) }} };
+			_obj->zlayer() = ZLayer{ (ZLayer::value_type)_next(16) };
+			_group->emplace(_obj);
+			_objects.push_back(_obj);
+		};
+		_context.emplace(_group);
+	};
+};
+
+static std::vector<ScreenPoint> make_points()
+{
+	std::vector<ScreenPoint> _points{};
+	_points.reserve(EVENT_COUNT);
+	for (size_t n = 0; n != EVENT_COUNT; ++n)
+	{
+		_points.push_back(ScreenPoint{ (int)((n * 7919) % 1600), (int)((n * 104729) % 900) });
+	};
+	return _points;
+};
+
+static double time_events(GFXContext& _context, const std::vector<ScreenPoint>& _points)
+{
+	const auto _start = std::chrono::steady_clock::now();
+	for (auto& p : _points)
+	{
+		// Broadcast so no recipient consumes the event and every hit is counted
+		Event _event{ Event::evCursorMove{ (int16_t)p.x.count, (int16_t)p.y.count }, true };
+		_context.handle_event(_event);
+	};
+	const auto _end = std::chrono::steady_clock::now();
+	return (double)_points.size() / std::chrono::duration<double>(_end - _start).count();
+};
+
+static int run(size_t _count)
+{
+	GFXContext _walked{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+	GFXContext _indexed{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+
+	std::vector<HitRecorder*> _walkedObjects{};
+	std::vector<HitRecorder*> _indexedObjects{};
+	populate(_walked, _walkedObjects, _count);
+	populate(_indexed, _indexedObjects, _count);
+	_indexed.enable_spatial_index();
+	assert(_indexed.spatial_index()->size() == _count + (_count + CHILDREN_PER_GROUP - 1) / CHILDREN_PER_GROUP);
+
+	const auto _points = make_points();
+	const auto _walkedRate = time_events(_walked, _points);
+	const auto _indexedRate = time_events(_indexed, _points);
+
+	// Without the index every object sees every event, with it only the objects under the cursor do
+	for (size_t n = 0; n != _indexedObjects.size(); ++n)
+	{
+		if (_walkedObjects[n]->hits != _points.size())
+		{
+			std::cout << "walked object " << n << " missed events\n";
+			return 1;
+		};
+
+		size_t _expected = 0;
+		for (auto& p : _points)
+		{
+			if (_indexedObjects[n]->bounds().intersects(p))
+			{
+				++_expected;
+			};
+		};
+		if (_indexedObjects[n]->hits != _expected)
+		{
+			std::cout << "routing mismatch at object " << n << " of " << _count << '\n';
+			return 1;
+		};
+	};
+
+	std::cout << _count << " objects : walked " << _walkedRate << " events/s, indexed " << _indexedRate
+		<< " events/s (" << (_indexedRate / _walkedRate) << "x)\n";
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	for (auto _count : { 1000, 10000, 100000 })
+	{
+		if (auto _res = run(_count); _res != GOOD_TEST)
+		{
+			return _res;
+		};
+	};
+	return GOOD_TEST;
+};
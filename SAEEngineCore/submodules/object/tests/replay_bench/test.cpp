@@ -0,0 +1,117 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Object.h>
+
+#include <iostream>
+#include <sstream>
+
+using namespace sae::engine::core;
+
+/*
+	Records an input session and replays it into a windowless GFXContext as fast as it will go, once through the tree walk
+	and once through the spatial index. The recording can be swapped for one captured from a real session.
+*/
+
+constexpr static inline size_t EVENT_COUNT = 100000;
+constexpr static inline int GRID = 40;
+
+class CountingObject : public GFXObject
+{
+public:
+	void handle_event(Event& _event) override
+	{
+		++this->count;
+	};
+
+	size_t count = 0;
+
+	using GFXObject::GFXObject;
+};
+
+static std::string record_session()
+{
+	std::ostringstream _ostr{ std::ios::binary };
+	EventWriter _writer{ _ostr };
+	for (size_t n = 0; n != EVENT_COUNT; ++n)
+	{
+		const auto _x = (int16_t)((n * 37) % 1600);
+		const auto _y = (int16_t)((n * 23) % 900);
+		if (n % 20 == 0)
+		{
+			_writer.write(Event{ Event::evMouse{ 0, 1, 0, _x, _y }, true });
+		}
+		else
+		{
+			_writer.write(Event{ Event::evCursorMove{ _x, _y }, true });
+		};
+	};
+	_writer.flush();
+	return _ostr.str();
+};
+
+static void populate(GFXContext& _context)
+{
+	for (int y = 0; y != GRID; ++y)
+	{
+		auto _row = new GFXView{ &_context, Rect{{ 0_px, (int)(y * 900 / GRID) }, { 1600_px, (int)((y + 1) * 900 / GRID) }} };
+		for (int x = 0; x != GRID; ++x)
+		{
+			const auto _left = x * 1600 / GRID;
+			const auto _top = y * 900 / GRID;
+			_row->emplace(new CountingObject{ Rect{{ _left, _top }, { _left + 1600 / GRID - 1, _top + 900 / GRID - 1 }} });
+		};
+		_context.emplace(_row);
+	};
+};
+
+static EventReplayer::Stats replay(const std::string& _recording, bool _indexed)
+{
+	GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 1600_px, 900_px }} };
+	populate(_context);
+	if (_indexed)
+	{
+		_context.enable_spatial_index();
+	};
+
+	std::istringstream _istr{ _recording, std::ios::binary };
+	EventReplayer _replayer{ _istr };
+	auto _stats = _replayer.replay([&_context](Event& _ev)
+		{
+			_context.handle_event(_ev);
+		});
+	assert(_replayer.good());
+	return _stats;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	const auto _recording = record_session();
+
+	for (bool _indexed : { false, true })
+	{
+		const auto _stats = replay(_recording, _indexed);
+		if (_stats.events != EVENT_COUNT)
+		{
+			std::cout << "replayed " << _stats.events << " of " << EVENT_COUNT << " events\n";
+			return 1;
+		};
+		std::cout << (_indexed ? "indexed" : "walked") << " : " << _stats.events_per_second() << " events/s, p50 "
+			<< _stats.percentile_ns(50.0) << " ns, p99 " << _stats.percentile_ns(99.0) << " ns\n";
+	};
+
+	return GOOD_TEST;
+};
@@ -0,0 +1,182 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Object.h>
+
+#include <iostream>
+#include <optional>
+#include <vector>
+
+using namespace sae::engine::core;
+
+/*
+	Overlapping objects on the same z layer receive a positional event in the same order with and without the context's
+	spatial index, including after an object has been moved and re-bucketed by the grid. An object moved since the last
+	refresh is found at its new position by events dispatched before that refresh.
+*/
+
+class OrderRecorder : public GFXObject
+{
+public:
+	void handle_event(Event& _event) override
+	{
+		std::optional<ScreenPoint> _at{};
+		if (_event.index() == Event::EVENT_TYPE{ Event::EVENT_TYPE::CURSOR_MOVE })
+		{
+			const auto& _ev = _event.get<Event::EVENT_TYPE::CURSOR_MOVE>();
+			_at = ScreenPoint{ _ev.cursor_x, _ev.cursor_y };
+		}
+		else if (_event.index() == Event::EVENT_TYPE{ Event::EVENT_TYPE::MOUSE_EVENT })
+		{
+			const auto& _ev = _event.get<Event::EVENT_TYPE::MOUSE_EVENT>();
+			_at = ScreenPoint{ _ev.cursor_x, _ev.cursor_y };
+		};
+		if (_at && this->bounds().intersects(*_at))
+		{
+			this->order_->push_back(this->id_);
+			_event.clear();
+		};
+	};
+
+	OrderRecorder(Rect _r, int _id, std::vector<int>* _order) :
+		GFXObject{ _r }, id_{ _id }, order_{ _order }
+	{};
+
+private:
+	int id_;
+	std::vector<int>* order_;
+};
+
+struct Scene
+{
+	GFXContext context{ nullptr, Rect{{ 0_px, 0_px }, { 400_px, 400_px }} };
+	std::vector<int> order{};
+	OrderRecorder* first = nullptr;
+
+	Scene(bool _indexed)
+	{
+		auto _a = new GFXView{ &this->context, Rect{{ 0_px, 0_px }, { 400_px, 400_px }} };
+		this->first = new OrderRecorder{ Rect{{ 0_px, 0_px }, { 100_px, 100_px }}, 1, &this->order };
+		_a->emplace(this->first);
+		_a->emplace(new OrderRecorder{ Rect{{ 50_px, 50_px }, { 150_px, 150_px }}, 2, &this->order });
+
+		auto _b = new GFXView{ &this->context, Rect{{ 0_px, 0_px }, { 400_px, 400_px }} };
+		_b->emplace(new OrderRecorder{ Rect{{ 40_px, 40_px }, { 120_px, 120_px }}, 3, &this->order });
+		_b->emplace(new OrderRecorder{ Rect{{ 60_px, 60_px }, { 70_px, 70_px }}, 4, &this->order });
+
+		this->context.emplace(_a);
+		this->context.emplace(_b);
+		if (_indexed)
+		{
+			this->context.enable_spatial_index(32_px);
+		};
+		this->context.refresh();
+	};
+
+	std::vector<int> send(int16_t _x, int16_t _y, bool _broadcast)
+	{
+		this->order.clear();
+		Event _event{ Event::evCursorMove{ _x, _y }, _broadcast };
+		this->context.handle_event(_event);
+		return this->order;
+	};
+
+	// Posts a click to the queue so it is dispatched in the same batch as any change made since the last refresh
+	std::vector<int> click(int16_t _x, int16_t _y)
+	{
+		this->order.clear();
+		this->context.post_event(Event{ Event::evMouse{ 0, 1, 0, _x, _y }, false });
+		this->context.process_events();
+		return this->order;
+	};
+};
+
+static int compare(Scene& _walked, Scene& _indexed, const char* _when)
+{
+	for (auto _broadcast : { false, true })
+	{
+		for (int16_t _at : { 45, 55, 65, 95, 110 })
+		{
+			const auto _expected = _walked.send(_at, _at, _broadcast);
+			const auto _got = _indexed.send(_at, _at, _broadcast);
+			if (_got != _expected)
+			{
+				std::cout << _when << " : " << (_broadcast ? "broadcast" : "consumed") << " event at " << _at <<
+					" was routed in a different order\n";
+				return 1;
+			};
+		};
+	};
+	return GOOD_TEST;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	Scene _walked{ false };
+	Scene _indexed{ true };
+
+	// Everything overlapping at (65, 65) shares a z layer, the first object in the tree takes the event
+	assert(_walked.send(65, 65, false) == std::vector<int>{ 1 });
+	assert(_walked.send(65, 65, true) == (std::vector<int>{ 1, 2, 3, 4 }));
+	if (auto _res = compare(_walked, _indexed, "after build"); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+
+	// Moving the first object re-buckets it behind the others in the grid, the tree order still decides
+	for (auto _scene : { &_walked, &_indexed })
+	{
+		_scene->first->set_bounds(Rect{{ 1_px, 1_px }, { 101_px, 101_px }});
+		_scene->context.refresh();
+	};
+	if (auto _res = compare(_walked, _indexed, "after moving"); _res != GOOD_TEST)
+	{
+		return _res;
+	};
+
+	// Events in the batch are dispatched before the context refreshes, the index must already know where things moved
+	for (auto _scene : { &_walked, &_indexed })
+	{
+		_scene->first->set_bounds(Rect{{ 200_px, 200_px }, { 300_px, 300_px }});
+		if (_scene->click(250, 250) != std::vector<int>{ 1 })
+		{
+			std::cout << "click after set_bounds missed the moved object\n";
+			return 2;
+		};
+	};
+
+	// Moved through a grow, first without and then with the scene store
+	for (auto _store : { false, true })
+	{
+		for (auto _scene : { &_walked, &_indexed })
+		{
+			if (_store)
+			{
+				_scene->context.enable_scene_store();
+			};
+			_scene->first->grow_mode().set(GrowMode::gmLeft).set(GrowMode::gmRight).set(GrowMode::gmTop).set(GrowMode::gmBottom);
+			_scene->context.grow(40_px, 40_px);
+			const auto _at = (int16_t)_scene->first->bounds().left().count + 50;
+			if (_scene->click(_at, _at) != std::vector<int>{ 1 })
+			{
+				std::cout << "click after grow" << (_store ? " with the scene store" : "") << " missed the moved object\n";
+				return 3;
+			};
+		};
+	};
+
+	return GOOD_TEST;
+};
@@ -0,0 +1,90 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Object.h>
+
+using namespace sae::engine::core;
+
+int main(int argc, char* argv[], char* envp[])
+{
+	GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 800_px, 600_px }} };
+
+	auto _group = new GFXView{ &_context, Rect{{ 0_px, 0_px }, { 400_px, 300_px }} };
+	_group->grow_mode().set(GrowMode::gmRight);
+	auto _a = new GFXObject{ Rect{{ 10_px, 10_px }, { 20_px, 20_px }} };
+	_a->grow_mode().set(GrowMode::gmRight).set(GrowMode::gmBottom);
+	auto _b = new GFXObject{ Rect{{ 30_px, 30_px }, { 40_px, 40_px }} };
+	_group->emplace(_a);
+	_group->emplace(_b);
+	_context.emplace(_group);
+
+	_context.enable_scene_store();
+	auto _store = _context.scene_store();
+	assert(_store);
+	assert(_store->size() == 3);
+
+	// Values move into the store unchanged
+	assert(_a->bounds().right() == 20_px);
+	assert(_b->bounds().left() == 30_px);
+
+	// Parent links are stored as dense positions
+	for (GFXHandle::index_type n = 0; n != _store->size(); ++n)
+	{
+		auto _obj = _store->packed_objects()[n];
+		auto _parent = _store->packed_parent(n);
+		if (_obj == _group)
+		{
+			assert(_parent == GFXHandle::npos);
+		}
+		else
+		{
+			assert(_parent != GFXHandle::npos);
+			assert(_store->packed_objects()[_parent] == _group);
+		};
+	};
+
+	_context.grow(10_px, 5_px);
+	assert(_group->bounds().right() == 410_px);
+	assert(_a->bounds().right() == 30_px);
+	assert(_a->bounds().bottom() == 25_px);
+	assert(_b->bounds().right() == 40_px);
+
+	// Removing an entry keeps the remaining handles valid
+	_group->remove(_a);
+	assert(_store->size() == 2);
+	assert(_b->bounds().left() == 30_px);
+
+	_context.disable_scene_store();
+	assert(_context.scene_store() == nullptr);
+	assert(_group->bounds().right() == 410_px);
+	assert(_b->bounds().right() == 40_px);
+
+	// A parent that was erased is not found through its reused slot
+	GFXSceneStore _raw{};
+	auto _p = _raw.insert(nullptr, GFXHandle{}, Rect{}, ZLayer{}, GrowMode{}, 0);
+	auto _c = _raw.insert(nullptr, _p, Rect{}, ZLayer{}, GrowMode{}, 0);
+	assert(_raw.parent(_c) == _p);
+	_raw.erase(_p);
+	auto _reused = _raw.insert(nullptr, GFXHandle{}, Rect{}, ZLayer{}, GrowMode{}, 0);
+	assert(_reused.index == _p.index);
+	assert(!_raw.parent(_c));
+	for (GFXHandle::index_type n = 0; n != _raw.size(); ++n)
+	{
+		assert(_raw.packed_parent(n) == GFXHandle::npos);
+	};
+
+	return GOOD_TEST;
+};
@@ -4,8 +4,17 @@
 
 #include <SAEEngineCore_Environment.h>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <optional>
 #include <istream>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace sae::engine::core
 {
@@ -14,6 +23,37 @@ namespace sae::engine::core
 	class ShaderProgram
 	{
 	public:
+		/**
+		 * @brief An active uniform outside of any uniform block, arrays are named without the [0] suffix
+		*/
+		struct Uniform
+		{
+			std::string name;
+			GLint location = -1;
+			GLenum type = GL_NONE;
+			GLint count = 1;
+		};
+
+		struct UniformBlock
+		{
+			std::string name;
+			GLuint index = 0;
+			GLint data_size = 0;
+			GLuint binding = 0;
+		};
+
+		/**
+		 * @brief Uniform uploads asked for through the setters since construction
+		*/
+		struct UniformCounters
+		{
+			// Uploads passed on to GL
+			size_t issued = 0;
+
+			// Uploads skipped because the uniform already held the value
+			size_t elided = 0;
+		};
+
 		bool good() const noexcept;
 		
 		GLuint id() const noexcept;
@@ -22,6 +62,35 @@ namespace sae::engine::core
 		void bind();
 		void unbind();
 
+		/**
+		 * @brief Looks up an active uniform, nullptr if the program has none by that name
+		*/
+		const Uniform* find_uniform(std::string_view _name) const noexcept;
+		const UniformBlock* find_uniform_block(std::string_view _name) const noexcept;
+
+		std::span<const Uniform> uniforms() const noexcept;
+		std::span<const UniformBlock> uniform_blocks() const noexcept;
+
+		/*
+			Typed uniform setters, each binds the program and uploads the value unless the uniform already holds it.
+			They return false without uploading if there is no such uniform or its type does not match the setter.
+			Only the first element of an array uniform is set.
+		*/
+
+		bool set_uniform(std::string_view _name, GLint _value);
+		bool set_uniform(std::string_view _name, GLfloat _value);
+		bool set_uniform(std::string_view _name, GLfloat _x, GLfloat _y);
+		bool set_uniform(std::string_view _name, GLfloat _x, GLfloat _y, GLfloat _z, GLfloat _w);
+		bool set_uniform_matrix4(std::string_view _name, std::span<const GLfloat, 16> _columns);
+
+		/**
+		 * @brief Points a uniform block at a uniform buffer binding point
+		 * @return False if the program has no such block
+		*/
+		bool bind_uniform_block(std::string_view _name, GLuint _binding);
+
+		const UniformCounters& uniform_counters() const noexcept;
+
 		ShaderProgram(const ShaderProgram& other) = delete;
 		ShaderProgram& operator=(const ShaderProgram& other) = delete;
 
@@ -29,11 +98,114 @@ namespace sae::engine::core
 		ShaderProgram& operator=(ShaderProgram&& other);
 
 	protected:
+		/**
+		 * @brief Takes ownership of a linked program and reads its active uniforms and uniform blocks. A block named
+		 * FrameUniforms::BLOCK_NAME is bound to FrameUniforms::BINDING.
+		*/
 		explicit ShaderProgram(GLuint _id);
 
 	private:
+		// Reads the uniform interface of the linked program, once
+		void reflect();
+
+		// Index into uniforms_, or uniforms_.size() if there is no such uniform
+		size_t uniform_index(std::string_view _name) const noexcept;
+
+		// Uploads through _upload unless the uniform named _name, of type _type, already holds _value
+		template <typename UploadT>
+		bool set_uniform_value(std::string_view _name, GLenum _type, const void* _value, size_t _size, UploadT&& _upload);
+
 		GLuint id_ = 0;
-		friend std::optional<ShaderProgram> HACK_generate_shader(std::istream& _vertex, std::istream& _fragment);
+
+		std::vector<Uniform> uniforms_{};
+		std::vector<UniformBlock> blocks_{};
+
+		// Open addressed hash table over uniforms_, each slot holds an index + 1 or 0 if empty
+		std::vector<uint32_t> uniform_slots_{};
+		std::vector<uint64_t> uniform_hashes_{};
+
+		// Last value uploaded through a setter, by uniform, and whether there is one yet
+		std::vector<std::array<std::byte, 64>> uniform_values_{};
+		std::vector<bool> uniform_set_{};
+
+		UniformCounters uniform_counters_{};
+
+		friend class ShaderBuilder;
+		friend class ShaderProgramCache;
+		friend class ShaderLibrary;
+	};
+
+	/**
+	 * @brief Uniform buffer holding the data every program needs once per frame, shared by all programs through a fixed
+	 * binding point.
+	 *
+	 * Programs that declare FrameUniforms::GLSL_BLOCK are bound to it when they are created, so updating it once per
+	 * frame replaces setting the same uniforms on each program. Needs a current GL context.
+	*/
+	class FrameUniforms
+	{
+	public:
+		constexpr static std::string_view BLOCK_NAME = "SAEFrame";
+		constexpr static GLuint BINDING = 0;
+
+		/**
+		 * @brief Declaration to paste into shader sources
+		*/
+		constexpr static std::string_view GLSL_BLOCK =
+			"layout(std140) uniform SAEFrame\n"
+			"{\n"
+			"	vec2 viewport;\n"
+			"	mat4 projection;\n"
+			"};\n";
+
+		/**
+		 * @brief std140 layout of GLSL_BLOCK
+		*/
+		struct Data
+		{
+			GLfloat viewport[2]{};
+			GLfloat pad_[2]{};
+
+			// Column major, maps pixel coordinates with the origin at the top left to clip space
+			GLfloat projection[16]{};
+
+			friend bool operator==(const Data& _lhs, const Data& _rhs) noexcept = default;
+		};
+		static_assert(sizeof(Data) == 80);
+
+		struct Stats
+		{
+			size_t uploads = 0;
+			size_t skipped = 0;
+		};
+
+		/**
+		 * @brief Builds the frame data for a viewport of _width by _height pixels
+		*/
+		static Data make_data(GLfloat _width, GLfloat _height) noexcept;
+
+		/**
+		 * @brief Uploads _data if it differs from the last upload and binds the buffer to BINDING
+		 * @return True if the data was uploaded
+		*/
+		bool update(const Data& _data);
+		bool update(GLfloat _width, GLfloat _height) { return this->update(make_data(_width, _height)); };
+
+		const Data& data() const noexcept;
+		GLuint id() const noexcept;
+		const Stats& stats() const noexcept;
+
+		FrameUniforms(const FrameUniforms& other) = delete;
+		FrameUniforms& operator=(const FrameUniforms& other) = delete;
+
+		FrameUniforms();
+		~FrameUniforms();
+
+	private:
+		Data data_{};
+		Stats stats_{};
+		GLuint id_ = 0;
+		bool uploaded_ = false;
 	};
 
 	class ShaderStage
@@ -49,7 +221,282 @@ namespace sae::engine::core
 	
 	};
 
-	[[deprecated ("this is a temporary hack because im lazy as shit")]]
+	/**
+	 * @brief Stores linked program binaries on disk so later runs can skip compiling and linking.
+	 *
+	 * Entries are keyed by ShaderBuilder::key(), which covers the stage sources and the GL vendor, renderer and version
+	 * strings, so a driver update or an edited shader simply misses. A stored binary the driver refuses to link is
+	 * deleted and counted as a reject, and the caller falls back to compiling.
+	*/
+	class ShaderProgramCache
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Totals since construction or the last reset_stats() call
+		*/
+		struct Stats
+		{
+			size_t hits = 0;
+			size_t misses = 0;
+			size_t rejects = 0;
+			size_t stores = 0;
+
+			// Programs built from source, and the time spent compiling and linking them
+			size_t compiles = 0;
+			std::chrono::nanoseconds compile_time{ 0 };
+
+			// Time spent reading entries and loading them with glProgramBinary, for hits only
+			std::chrono::nanoseconds hit_time{ 0 };
+		};
+
+		/**
+		 * @brief False if the driver reports no program binary formats, in which case load() and store() do nothing
+		*/
+		bool supported() const noexcept;
+
+		const std::filesystem::path& directory() const noexcept;
+		std::filesystem::path path_for(uint64_t _key) const;
+
+		/**
+		 * @brief Loads the program stored under _key, std::nullopt if there is no usable entry
+		*/
+		std::optional<ShaderProgram> load(uint64_t _key);
+
+		/**
+		 * @brief Writes the binary of a linked program under _key, replacing any existing entry
+		 * @return True if the entry was written
+		*/
+		bool store(uint64_t _key, const ShaderProgram& _program);
+
+		void erase(uint64_t _key);
+
+		const Stats& stats() const noexcept;
+		void reset_stats() noexcept;
+
+		/**
+		 * @param _directory Directory entries are written to, created on first store if missing
+		*/
+		explicit ShaderProgramCache(std::filesystem::path _directory);
+
+	private:
+		friend class ShaderBuilder;
+
+		std::filesystem::path directory_;
+		Stats stats_{};
+		bool supported_ = false;
+	};
+
+	/**
+	 * @brief Collects shader stage sources and builds a linked ShaderProgram from them, optionally through a
+	 * ShaderProgramCache.
+	*/
+	class ShaderBuilder
+	{
+	public:
+		enum class PATH : uint8_t
+		{
+			NONE,
+			COMPILED,
+			CACHE_HIT,
+		};
+
+		/**
+		 * @brief How the last build() produced its program and how long it took
+		*/
+		struct BuildInfo
+		{
+			PATH path = PATH::NONE;
+			std::chrono::nanoseconds time{ 0 };
+		};
+
+		ShaderBuilder& stage(GLenum _stage, std::string _source);
+
+		/**
+		 * @brief Reads the rest of _source in one go and adds it as a stage
+		*/
+		ShaderBuilder& stage(GLenum _stage, std::istream& _source);
+
+		ShaderBuilder& vertex(std::string _source) { return this->stage(GL_VERTEX_SHADER, std::move(_source)); };
+		ShaderBuilder& vertex(std::istream& _source) { return this->stage(GL_VERTEX_SHADER, _source); };
+		ShaderBuilder& fragment(std::string _source) { return this->stage(GL_FRAGMENT_SHADER, std::move(_source)); };
+		ShaderBuilder& fragment(std::istream& _source) { return this->stage(GL_FRAGMENT_SHADER, _source); };
+
+		/**
+		 * @brief Compiles and links the stages
+		 * @return The program, or std::nullopt if a stage failed to compile or the program failed to link, see log()
+		*/
+		std::optional<ShaderProgram> build();
+
+		/**
+		 * @brief Loads the program from _cache if it holds a usable entry, otherwise compiles it and stores the result
+		*/
+		std::optional<ShaderProgram> build(ShaderProgramCache& _cache);
+
+		/**
+		 * @brief 64 bit FNV-1a hash of the stages and the GL vendor, renderer and version strings of the current context
+		*/
+		uint64_t key() const;
+
+		/**
+		 * @brief Info log of the stage or program that made the last build() fail
+		*/
+		const std::string& log() const noexcept;
+
+		const BuildInfo& last_build() const noexcept;
+
+		void clear();
+
+	private:
+		struct Stage
+		{
+			GLenum type;
+			std::string source;
+		};
+
+		friend class ShaderLibrary;
+
+		std::optional<ShaderProgram> compile(bool _retrievable);
+
+		std::vector<Stage> stages_{};
+		std::string log_{};
+		BuildInfo last_build_{};
+	};
+
+	/**
+	 * @brief Owns a set of named programs that are compiled without blocking the thread that submits them.
+	 *
+	 * submit() issues every stage compile straight away and poll() moves each program along as far as it can, so the
+	 * driver can work on all of them at once. With KHR_parallel_shader_compile (or the ARB version) poll() only asks
+	 * GL_COMPLETION_STATUS_KHR and never waits. Without it, each poll() finishes at most blocking_budget() programs,
+	 * waiting on them, so the rest of a frame still runs.
+	 *
+	 * find() returns nullptr until a program is ready, so a frame can draw whatever is available and skip the rest.
+	*/
+	class ShaderLibrary
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		enum class STATUS : uint8_t
+		{
+			COMPILING,
+			LINKING,
+			READY,
+			FAILED,
+		};
+
+		/**
+		 * @brief Totals since construction
+		*/
+		struct Stats
+		{
+			size_t submitted = 0;
+			size_t ready = 0;
+			size_t failed = 0;
+
+			// Programs made ready straight from the ShaderProgramCache by submit()
+			size_t cache_hits = 0;
+
+			size_t polls = 0;
+
+			// Time from the first submit() after the library was last idle to the poll() that left nothing pending
+			std::chrono::nanoseconds time_to_all_ready{ 0 };
+		};
+
+		/**
+		 * @brief True if the driver can report compile and link completion without waiting
+		*/
+		bool parallel() const noexcept;
+
+		/**
+		 * @brief Starts building a program from the stages in _builder. A program already submitted under _name is
+		 * replaced once this one is ready.
+		*/
+		void submit(std::string _name, const ShaderBuilder& _builder);
+
+		/**
+		 * @brief Moves pending programs along without waiting on the driver, except for the blocking budget when the
+		 * driver cannot report completion
+		 * @return True if nothing is left pending
+		*/
+		bool poll();
+
+		/**
+		 * @brief Waits for every pending program
+		*/
+		void finish();
+
+		/**
+		 * @brief The program submitted under _name, nullptr until one has become ready. While a resubmitted program
+		 * builds, or if it fails, the previous ready one is returned.
+		*/
+		ShaderProgram* find(std::string_view _name);
+
+		std::optional<STATUS> status(std::string_view _name) const;
+
+		/**
+		 * @brief Info log of a program that failed, empty otherwise
+		*/
+		std::string_view log(std::string_view _name) const;
+
+		size_t pending() const noexcept;
+		bool all_ready() const noexcept;
+
+		/**
+		 * @brief Time the last batch of submits took to become ready, std::nullopt while programs are pending
+		*/
+		std::optional<std::chrono::nanoseconds> time_to_all_ready() const noexcept;
+
+		const Stats& stats() const noexcept;
+
+		size_t blocking_budget() const noexcept;
+		void set_blocking_budget(size_t _programs) noexcept;
+
+		ShaderLibrary(const ShaderLibrary& other) = delete;
+		ShaderLibrary& operator=(const ShaderLibrary& other) = delete;
+
+		/**
+		 * @param _cache Ready programs are loaded from and stored to this cache if given, must outlive the library
+		*/
+		explicit ShaderLibrary(ShaderProgramCache* _cache = nullptr);
+		~ShaderLibrary();
+
+	private:
+		struct Entry
+		{
+			STATUS status = STATUS::COMPILING;
+			uint64_t key = 0;
+			std::vector<GLuint> shaders{};
+			GLuint program = 0;
+			std::string log{};
+
+			// The last ready program, kept while a resubmitted one builds
+			std::optional<ShaderProgram> ready{};
+		};
+
+		bool is_complete(const Entry& _entry, bool _block) const;
+
+		// Advances an entry one step, returns false if it had to stop and wait
+		bool advance(Entry& _entry, bool _block);
+
+		void finish_entry(Entry& _entry, bool _succeeded);
+		void release(Entry& _entry);
+		void close_batch_if_idle();
+
+		ShaderProgramCache* cache_;
+		std::map<std::string, Entry, std::less<>> entries_{};
+		Stats stats_{};
+		size_t pending_ = 0;
+		size_t blocking_budget_ = 1;
+		clock::time_point batch_start_{};
+		bool batch_open_ = false;
+		bool batch_done_ = false;
+		bool parallel_ = false;
+	};
+
+	[[deprecated ("use ShaderBuilder instead")]]
 	std::optional<ShaderProgram> HACK_generate_shader(std::istream& _vertex, std::istream& _fragment);
 
 
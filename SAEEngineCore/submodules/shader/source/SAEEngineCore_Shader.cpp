@@ -1,14 +1,144 @@
 #include "SAEEngineCore_Shader.h"
 
+#include <SAEEngineCore_FileHandling.h>
+#include <SAEEngineCore_Logging.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 #include <vector>
 
 
 namespace sae::engine::core
 {
 
+	namespace
+	{
+		constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+		constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+		uint64_t fnv1a(uint64_t _hash, const void* _data, size_t _len) noexcept
+		{
+			auto _bytes = static_cast<const unsigned char*>(_data);
+			for (size_t n = 0; n != _len; ++n)
+			{
+				_hash ^= _bytes[n];
+				_hash *= FNV_PRIME;
+			};
+			return _hash;
+		};
+
+		// Strings are hashed with their length so "ab" + "c" and "a" + "bc" differ
+		uint64_t fnv1a(uint64_t _hash, std::string_view _str) noexcept
+		{
+			const uint64_t _len = _str.size();
+			_hash = fnv1a(_hash, &_len, sizeof(_len));
+			return fnv1a(_hash, _str.data(), _str.size());
+		};
+
+		std::string_view gl_string(GLenum _name)
+		{
+			auto _str = glGetString(_name);
+			return (_str) ? std::string_view{ reinterpret_cast<const char*>(_str) } : std::string_view{};
+		};
+
+		/**
+		 * @brief Layout of the start of a cache entry, followed by the binary itself
+		*/
+		struct CacheHeader
+		{
+			constexpr static uint32_t MAGIC = 0x50454153; // "SAEP"
+			constexpr static uint32_t VERSION = 1;
+
+			uint32_t magic = MAGIC;
+			uint32_t version = VERSION;
+			uint64_t key = 0;
+			uint32_t format = 0;
+			uint32_t length = 0;
+		};
+
+		std::string info_log(GLuint _id, bool _program)
+		{
+			GLint _len = 0;
+			if (_program)
+			{
+				glGetProgramiv(_id, GL_INFO_LOG_LENGTH, &_len);
+			}
+			else
+			{
+				glGetShaderiv(_id, GL_INFO_LOG_LENGTH, &_len);
+			};
+			if (_len <= 0)
+			{
+				return std::string{};
+			};
+
+			std::string _out((size_t)_len, '\0');
+			GLsizei _written = 0;
+			if (_program)
+			{
+				glGetProgramInfoLog(_id, _len, &_written, _out.data());
+			}
+			else
+			{
+				glGetShaderInfoLog(_id, _len, &_written, _out.data());
+			};
+			_out.resize((size_t)std::max(_written, 0));
+			return _out;
+		};
+
+		bool link_succeeded(GLuint _program)
+		{
+			GLint _status = GL_FALSE;
+			glGetProgramiv(_program, GL_LINK_STATUS, &_status);
+			return _status == GL_TRUE;
+		};
+	}
+
+	namespace
+	{
+		uint64_t uniform_hash(std::string_view _name) noexcept
+		{
+			return fnv1a(FNV_OFFSET_BASIS, _name.data(), _name.size());
+		};
+
+		bool is_sampler(GLenum _type) noexcept
+		{
+			switch (_type)
+			{
+			case GL_SAMPLER_1D:
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_SHADOW:
+			case GL_SAMPLER_1D_ARRAY:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_2D_MULTISAMPLE:
+			case GL_SAMPLER_BUFFER:
+			case GL_INT_SAMPLER_2D:
+			case GL_UNSIGNED_INT_SAMPLER_2D:
+				return true;
+			default:
+				return false;
+			};
+		};
+
+		// Integer setters also set bools and samplers, the others need the exact type
+		bool type_matches(GLenum _uniform, GLenum _setter) noexcept
+		{
+			if (_setter == GL_INT)
+			{
+				return _uniform == GL_INT || _uniform == GL_BOOL || is_sampler(_uniform);
+			};
+			return _uniform == _setter;
+		};
+	}
+
 	bool ShaderProgram::good() const noexcept
 	{
-		return this->id() == 0;
+		return this->id() != 0;
 	};
 
 	GLuint ShaderProgram::id() const noexcept
@@ -17,118 +147,930 @@ namespace sae::engine::core
 	};
 	void ShaderProgram::destroy()
 	{
-		glDeleteProgram(this->id());
+		gl::StateCache::current().delete_program(this->id());
 		this->id_ = 0;
+
+		this->uniforms_.clear();
+		this->blocks_.clear();
+		this->uniform_slots_.clear();
+		this->uniform_hashes_.clear();
+		this->uniform_values_.clear();
+		this->uniform_set_.clear();
 	};
 
 	void ShaderProgram::bind()
 	{
-		glUseProgram(this->id());
+		gl::StateCache::current().use_program(this->id());
 	};
 	void ShaderProgram::unbind()
 	{
-		glUseProgram(0);
+		gl::StateCache::current().use_program(0);
 	};
 
+	size_t ShaderProgram::uniform_index(std::string_view _name) const noexcept
+	{
+		if (this->uniform_slots_.empty())
+		{
+			return this->uniforms_.size();
+		};
 
+		const auto _hash = uniform_hash(_name);
+		const auto _mask = this->uniform_slots_.size() - 1;
+		for (auto i = (size_t)_hash & _mask; this->uniform_slots_[i] != 0; i = (i + 1) & _mask)
+		{
+			const auto _index = (size_t)this->uniform_slots_[i] - 1;
+			if (this->uniform_hashes_[_index] == _hash && this->uniforms_[_index].name == _name)
+			{
+				return _index;
+			};
+		};
+		return this->uniforms_.size();
+	};
+
+	const ShaderProgram::Uniform* ShaderProgram::find_uniform(std::string_view _name) const noexcept
+	{
+		const auto _index = this->uniform_index(_name);
+		return (_index != this->uniforms_.size()) ? &this->uniforms_[_index] : nullptr;
+	};
+	const ShaderProgram::UniformBlock* ShaderProgram::find_uniform_block(std::string_view _name) const noexcept
+	{
+		// Programs have a handful of blocks at most
+		for (auto& _block : this->blocks_)
+		{
+			if (_block.name == _name)
+			{
+				return &_block;
+			};
+		};
+		return nullptr;
+	};
+
+	std::span<const ShaderProgram::Uniform> ShaderProgram::uniforms() const noexcept
+	{
+		return this->uniforms_;
+	};
+	std::span<const ShaderProgram::UniformBlock> ShaderProgram::uniform_blocks() const noexcept
+	{
+		return this->blocks_;
+	};
+
+	template <typename UploadT>
+	bool ShaderProgram::set_uniform_value(std::string_view _name, GLenum _type, const void* _value, size_t _size,
+		UploadT&& _upload)
+	{
+		const auto _index = this->uniform_index(_name);
+		if (_index == this->uniforms_.size() || !type_matches(this->uniforms_[_index].type, _type))
+		{
+			return false;
+		};
+
+		auto& _cached = this->uniform_values_[_index];
+		if (this->uniform_set_[_index] && std::memcmp(_cached.data(), _value, _size) == 0)
+		{
+			++this->uniform_counters_.elided;
+			return true;
+		};
+		std::memcpy(_cached.data(), _value, _size);
+		this->uniform_set_[_index] = true;
+
+		this->bind();
+		_upload(this->uniforms_[_index].location);
+		++this->uniform_counters_.issued;
+		return true;
+	};
+
+	bool ShaderProgram::set_uniform(std::string_view _name, GLint _value)
+	{
+		return this->set_uniform_value(_name, GL_INT, &_value, sizeof(_value), [_value](GLint _location)
+			{
+				glUniform1i(_location, _value);
+			});
+	};
+	bool ShaderProgram::set_uniform(std::string_view _name, GLfloat _value)
+	{
+		return this->set_uniform_value(_name, GL_FLOAT, &_value, sizeof(_value), [_value](GLint _location)
+			{
+				glUniform1f(_location, _value);
+			});
+	};
+	bool ShaderProgram::set_uniform(std::string_view _name, GLfloat _x, GLfloat _y)
+	{
+		const GLfloat _value[2]{ _x, _y };
+		return this->set_uniform_value(_name, GL_FLOAT_VEC2, _value, sizeof(_value), [&_value](GLint _location)
+			{
+				glUniform2f(_location, _value[0], _value[1]);
+			});
+	};
+	bool ShaderProgram::set_uniform(std::string_view _name, GLfloat _x, GLfloat _y, GLfloat _z, GLfloat _w)
+	{
+		const GLfloat _value[4]{ _x, _y, _z, _w };
+		return this->set_uniform_value(_name, GL_FLOAT_VEC4, _value, sizeof(_value), [&_value](GLint _location)
+			{
+				glUniform4f(_location, _value[0], _value[1], _value[2], _value[3]);
+			});
+	};
+	bool ShaderProgram::set_uniform_matrix4(std::string_view _name, std::span<const GLfloat, 16> _columns)
+	{
+		return this->set_uniform_value(_name, GL_FLOAT_MAT4, _columns.data(), _columns.size_bytes(),
+			[&_columns](GLint _location)
+			{
+				glUniformMatrix4fv(_location, 1, GL_FALSE, _columns.data());
+			});
+	};
+
+	bool ShaderProgram::bind_uniform_block(std::string_view _name, GLuint _binding)
+	{
+		for (auto& _block : this->blocks_)
+		{
+			if (_block.name == _name)
+			{
+				if (_block.binding != _binding)
+				{
+					glUniformBlockBinding(this->id(), _block.index, _binding);
+					_block.binding = _binding;
+				};
+				return true;
+			};
+		};
+		return false;
+	};
+
+	const ShaderProgram::UniformCounters& ShaderProgram::uniform_counters() const noexcept
+	{
+		return this->uniform_counters_;
+	};
+
+	void ShaderProgram::reflect()
+	{
+		GLint _count = 0;
+		GLint _maxLength = 0;
+		glGetProgramiv(this->id(), GL_ACTIVE_UNIFORMS, &_count);
+		glGetProgramiv(this->id(), GL_ACTIVE_UNIFORM_MAX_LENGTH, &_maxLength);
+
+		std::string _buff((size_t)std::max(_maxLength, 1), '\0');
+		for (GLint i = 0; i < _count; ++i)
+		{
+			GLsizei _length = 0;
+			Uniform _uniform{};
+			glGetActiveUniform(this->id(), (GLuint)i, (GLsizei)_buff.size(), &_length, &_uniform.count, &_uniform.type,
+				_buff.data());
+			_uniform.name.assign(_buff.data(), (size_t)std::max(_length, 0));
+			if (_uniform.name.ends_with("[0]"))
+			{
+				_uniform.name.resize(_uniform.name.size() - 3);
+			};
+
+			// Members of uniform blocks have no location and are set through the block's buffer
+			_uniform.location = glGetUniformLocation(this->id(), _uniform.name.c_str());
+			if (_uniform.location != -1)
+			{
+				this->uniforms_.push_back(std::move(_uniform));
+			};
+		};
+
+		_count = 0;
+		_maxLength = 0;
+		glGetProgramiv(this->id(), GL_ACTIVE_UNIFORM_BLOCKS, &_count);
+		glGetProgramiv(this->id(), GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &_maxLength);
+		_buff.assign((size_t)std::max(_maxLength, 1), '\0');
+		for (GLint i = 0; i < _count; ++i)
+		{
+			GLsizei _length = 0;
+			UniformBlock _block{};
+			_block.index = (GLuint)i;
+			glGetActiveUniformBlockName(this->id(), _block.index, (GLsizei)_buff.size(), &_length, _buff.data());
+			_block.name.assign(_buff.data(), (size_t)std::max(_length, 0));
+
+			GLint _value = 0;
+			glGetActiveUniformBlockiv(this->id(), _block.index, GL_UNIFORM_BLOCK_DATA_SIZE, &_value);
+			_block.data_size = _value;
+			glGetActiveUniformBlockiv(this->id(), _block.index, GL_UNIFORM_BLOCK_BINDING, &_value);
+			_block.binding = (GLuint)_value;
+			this->blocks_.push_back(std::move(_block));
+		};
+		this->bind_uniform_block(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING);
+
+		// Table at most half full so probes stay short
+		if (!this->uniforms_.empty())
+		{
+			size_t _slots = 8;
+			while (_slots < this->uniforms_.size() * 2)
+			{
+				_slots *= 2;
+			};
+			this->uniform_slots_.assign(_slots, 0);
+			for (size_t n = 0; n != this->uniforms_.size(); ++n)
+			{
+				const auto _hash = uniform_hash(this->uniforms_[n].name);
+				this->uniform_hashes_.push_back(_hash);
+
+				auto i = (size_t)_hash & (_slots - 1);
+				while (this->uniform_slots_[i] != 0)
+				{
+					i = (i + 1) & (_slots - 1);
+				};
+				this->uniform_slots_[i] = (uint32_t)(n + 1);
+			};
+		};
+		this->uniform_values_.resize(this->uniforms_.size());
+		this->uniform_set_.assign(this->uniforms_.size(), false);
+	};
 
 	ShaderProgram::ShaderProgram(GLuint _id) :
 		id_{ _id }
-	{};
+	{
+		if (this->id_ != 0)
+		{
+			this->reflect();
+		};
+	};
 
-	ShaderProgram::ShaderProgram(ShaderProgram&& other) : 
-		id_{ std::exchange(other.id_, 0) }
+	ShaderProgram::ShaderProgram(ShaderProgram&& other) :
+		id_{ std::exchange(other.id_, 0) },
+		uniforms_{ std::move(other.uniforms_) },
+		blocks_{ std::move(other.blocks_) },
+		uniform_slots_{ std::move(other.uniform_slots_) },
+		uniform_hashes_{ std::move(other.uniform_hashes_) },
+		uniform_values_{ std::move(other.uniform_values_) },
+		uniform_set_{ std::move(other.uniform_set_) },
+		uniform_counters_{ std::exchange(other.uniform_counters_, UniformCounters{}) }
 	{};
 	ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other)
 	{
 		this->destroy();
 		this->id_ = std::exchange(other.id_, 0);
+		this->uniforms_ = std::move(other.uniforms_);
+		this->blocks_ = std::move(other.blocks_);
+		this->uniform_slots_ = std::move(other.uniform_slots_);
+		this->uniform_hashes_ = std::move(other.uniform_hashes_);
+		this->uniform_values_ = std::move(other.uniform_values_);
+		this->uniform_set_ = std::move(other.uniform_set_);
+		this->uniform_counters_ = std::exchange(other.uniform_counters_, UniformCounters{});
 		return *this;
 	};
 
-	std::optional<ShaderProgram> HACK_generate_shader(std::istream& _vertex, std::istream& _fragment)
+
+
+	FrameUniforms::Data FrameUniforms::make_data(GLfloat _width, GLfloat _height) noexcept
+	{
+		_width = std::max(_width, 1.0f);
+		_height = std::max(_height, 1.0f);
+
+		Data _out{};
+		_out.viewport[0] = _width;
+		_out.viewport[1] = _height;
+		_out.projection[0] = 2.0f / _width;
+		_out.projection[5] = -2.0f / _height;
+		_out.projection[10] = 1.0f;
+		_out.projection[12] = -1.0f;
+		_out.projection[13] = 1.0f;
+		_out.projection[15] = 1.0f;
+		return _out;
+	};
+
+	bool FrameUniforms::update(const Data& _data)
+	{
+		auto& _state = gl::StateCache::current();
+		_state.bind_buffer_base(GL_UNIFORM_BUFFER, BINDING, this->id_);
+		if (this->uploaded_ && _data == this->data_)
+		{
+			++this->stats_.skipped;
+			return false;
+		};
+
+		this->data_ = _data;
+		this->uploaded_ = true;
+		_state.bind_buffer(GL_UNIFORM_BUFFER, this->id_);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Data), &this->data_);
+		++this->stats_.uploads;
+		return true;
+	};
+
+	const FrameUniforms::Data& FrameUniforms::data() const noexcept
+	{
+		return this->data_;
+	};
+	GLuint FrameUniforms::id() const noexcept
+	{
+		return this->id_;
+	};
+	const FrameUniforms::Stats& FrameUniforms::stats() const noexcept
+	{
+		return this->stats_;
+	};
+
+	FrameUniforms::FrameUniforms()
+	{
+		glGenBuffers(1, &this->id_);
+		auto& _state = gl::StateCache::current();
+		_state.bind_buffer(GL_UNIFORM_BUFFER, this->id_);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(Data), nullptr, GL_DYNAMIC_DRAW);
+		_state.bind_buffer_base(GL_UNIFORM_BUFFER, BINDING, this->id_);
+	};
+	FrameUniforms::~FrameUniforms()
+	{
+		gl::StateCache::current().delete_buffers(1, &this->id_);
+	};
+
+
+
+	bool ShaderProgramCache::supported() const noexcept
+	{
+		return this->supported_;
+	};
+
+	const std::filesystem::path& ShaderProgramCache::directory() const noexcept
+	{
+		return this->directory_;
+	};
+	std::filesystem::path ShaderProgramCache::path_for(uint64_t _key) const
+	{
+		char _name[32]{};
+		std::snprintf(_name, sizeof(_name), "%016llx.glbin", (unsigned long long)_key);
+		return this->directory_ / _name;
+	};
+
+	std::optional<ShaderProgram> ShaderProgramCache::load(uint64_t _key)
 	{
-		char _buff[256]{};
-		std::string _vertexSource = "";
-		while (!_vertex.eof())
+		if (!this->supported())
 		{
-			_vertex.read(_buff, sizeof(_buff) / sizeof(char));
-			_vertexSource.append(_buff, _vertex.gcount());
+			return std::nullopt;
 		};
-		
-		std::string _fragmentSource = "";
-		while (!_fragment.eof())
+
+		bool _linked = false;
+		GLuint _id = 0;
 		{
-			_fragment.read(_buff, sizeof(_buff) / sizeof(char));
-			_fragmentSource.append(_buff, _fragment.gcount());
+			// The binary is handed to the driver straight from the mapping, which is closed before erase() below
+			MappedFile _file{ this->path_for(_key) };
+			if (!_file.good())
+			{
+				++this->stats_.misses;
+				return std::nullopt;
+			};
+
+			const auto _data = _file.data();
+			CacheHeader _header{};
+			if (_data.size() >= sizeof(_header))
+			{
+				std::memcpy(&_header, _data.data(), sizeof(_header));
+			};
+			if (_data.size() >= sizeof(_header) && _header.magic == CacheHeader::MAGIC &&
+				_header.version == CacheHeader::VERSION && _header.key == _key && _header.length != 0 &&
+				_data.size() - sizeof(_header) >= _header.length)
+			{
+				_id = glCreateProgram();
+				glProgramBinary(_id, _header.format, _data.data() + sizeof(_header), (GLsizei)_header.length);
+				_linked = link_succeeded(_id);
+			};
 		};
 
+		if (_linked)
+		{
+			++this->stats_.hits;
+			return ShaderProgram{ _id };
+		};
+		if (_id != 0)
+		{
+			gl::StateCache::current().delete_program(_id);
+		};
 
-		// Create the shaders
-		GLuint VertexShaderID = glCreateShader(GL_VERTEX_SHADER);
-		GLuint FragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
+		// Truncated, from an older layout or refused by the driver, rebuilding will replace it
+		++this->stats_.rejects;
+		this->erase(_key);
+		return std::nullopt;
+	};
 
-		GLint Result = GL_FALSE;
-		int InfoLogLength;
+	bool ShaderProgramCache::store(uint64_t _key, const ShaderProgram& _program)
+	{
+		if (!this->supported() || !_program.good())
+		{
+			return false;
+		};
 
-		// Compile Vertex Shader
-		char const* VertexSourcePointer = _vertexSource.c_str();
-		glShaderSource(VertexShaderID, 1, &VertexSourcePointer, NULL);
-		glCompileShader(VertexShaderID);
+		GLint _length = 0;
+		glGetProgramiv(_program.id(), GL_PROGRAM_BINARY_LENGTH, &_length);
+		if (_length <= 0)
+		{
+			return false;
+		};
 
-		// Check Vertex Shader
-		glGetShaderiv(VertexShaderID, GL_COMPILE_STATUS, &Result);
-		glGetShaderiv(VertexShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-		if (InfoLogLength > 0) {
-			std::vector<char> VertexShaderErrorMessage(InfoLogLength + 1);
-			glGetShaderInfoLog(VertexShaderID, InfoLogLength, NULL, &VertexShaderErrorMessage[0]);
-			printf("%s\n", &VertexShaderErrorMessage[0]);
-		}
+		CacheHeader _header{};
+		_header.key = _key;
+		std::vector<char> _binary((size_t)_length);
+		GLsizei _written = 0;
+		glGetProgramBinary(_program.id(), _length, &_written, &_header.format, _binary.data());
+		if (_written <= 0)
+		{
+			return false;
+		};
+		_header.length = (uint32_t)_written;
 
-		// Compile Fragment Shader
-		char const* FragmentSourcePointer = _fragmentSource.c_str();
-		glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer, NULL);
-		glCompileShader(FragmentShaderID);
-
-		// Check Fragment Shader
-		glGetShaderiv(FragmentShaderID, GL_COMPILE_STATUS, &Result);
-		glGetShaderiv(FragmentShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-		if (InfoLogLength > 0) {
-			std::vector<char> FragmentShaderErrorMessage(InfoLogLength + 1);
-			glGetShaderInfoLog(FragmentShaderID, InfoLogLength, NULL, &FragmentShaderErrorMessage[0]);
-			abort();
-			//printf("%s\n", &FragmentShaderErrorMessage[0]);
-		}
+		std::error_code _ec{};
+		std::filesystem::create_directories(this->directory_, _ec);
+
+		// Written next to the entry and renamed over it, so a reader never sees half an entry
+		const auto _path = this->path_for(_key);
+		auto _tempPath = _path;
+		_tempPath += ".tmp";
+		{
+			std::ofstream _file{ _tempPath, std::ios::binary | std::ios::trunc };
+			_file.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+			_file.write(_binary.data(), _written);
+			if (!_file.good())
+			{
+				_file.close();
+				std::filesystem::remove(_tempPath, _ec);
+				return false;
+			};
+		};
+		std::filesystem::rename(_tempPath, _path, _ec);
+		if (_ec)
+		{
+			std::filesystem::remove(_tempPath, _ec);
+			return false;
+		};
+
+		++this->stats_.stores;
+		return true;
+	};
+
+	void ShaderProgramCache::erase(uint64_t _key)
+	{
+		std::error_code _ec{};
+		std::filesystem::remove(this->path_for(_key), _ec);
+	};
+
+	const ShaderProgramCache::Stats& ShaderProgramCache::stats() const noexcept
+	{
+		return this->stats_;
+	};
+	void ShaderProgramCache::reset_stats() noexcept
+	{
+		this->stats_ = Stats{};
+	};
+
+	ShaderProgramCache::ShaderProgramCache(std::filesystem::path _directory) :
+		directory_{ std::move(_directory) }
+	{
+		GLint _formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &_formats);
+		this->supported_ = _formats > 0;
+	};
+
+
+
+	ShaderBuilder& ShaderBuilder::stage(GLenum _stage, std::string _source)
+	{
+		this->stages_.push_back(Stage{ _stage, std::move(_source) });
+		return *this;
+	};
+	ShaderBuilder& ShaderBuilder::stage(GLenum _stage, std::istream& _source)
+	{
+		std::ostringstream _buff{};
+		_buff << _source.rdbuf();
+		return this->stage(_stage, std::move(_buff).str());
+	};
+
+	std::optional<ShaderProgram> ShaderBuilder::compile(bool _retrievable)
+	{
+		this->log_.clear();
+		if (this->stages_.empty())
+		{
+			this->log_ = "no shader stages were given";
+			return std::nullopt;
+		};
+
+		std::vector<GLuint> _shaders{};
+		_shaders.reserve(this->stages_.size());
+		auto _deleteShaders = [&_shaders]()
+		{
+			for (auto& _shader : _shaders)
+			{
+				glDeleteShader(_shader);
+			};
+		};
+
+		for (auto& _stage : this->stages_)
+		{
+			const auto _shader = glCreateShader(_stage.type);
+			_shaders.push_back(_shader);
+
+			const char* _source = _stage.source.c_str();
+			const GLint _length = (GLint)_stage.source.size();
+			glShaderSource(_shader, 1, &_source, &_length);
+			glCompileShader(_shader);
+
+			GLint _status = GL_FALSE;
+			glGetShaderiv(_shader, GL_COMPILE_STATUS, &_status);
+			if (_status != GL_TRUE)
+			{
+				this->log_ = info_log(_shader, false);
+				_deleteShaders();
+				return std::nullopt;
+			};
+		};
+
+		const auto _program = glCreateProgram();
+		for (auto& _shader : _shaders)
+		{
+			glAttachShader(_program, _shader);
+		};
+		if (_retrievable)
+		{
+			glProgramParameteri(_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		};
+		glLinkProgram(_program);
 
-		// Link the program
-		//printf("Linking program\n");
-		GLuint ProgramID = glCreateProgram();
-		glAttachShader(ProgramID, VertexShaderID);
-		glAttachShader(ProgramID, FragmentShaderID);
-		glLinkProgram(ProgramID);
-
-		// Check the program
-		glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
-		glGetProgramiv(ProgramID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-		if (InfoLogLength > 0) {
-			std::vector<char> ProgramErrorMessage(InfoLogLength + 1);
-			glGetProgramInfoLog(ProgramID, InfoLogLength, NULL, &ProgramErrorMessage[0]);
-			abort(); //printf("%s\n", &ProgramErrorMessage[0]);
+		const bool _linked = link_succeeded(_program);
+		if (!_linked)
+		{
+			this->log_ = info_log(_program, true);
+		};
+		for (auto& _shader : _shaders)
+		{
+			glDetachShader(_program, _shader);
+		};
+		_deleteShaders();
+
+		if (!_linked)
+		{
+			gl::StateCache::current().delete_program(_program);
+			return std::nullopt;
+		};
+		return ShaderProgram{ _program };
+	};
+
+	std::optional<ShaderProgram> ShaderBuilder::build()
+	{
+		const auto _start = ShaderProgramCache::clock::now();
+		auto _out = this->compile(false);
+		this->last_build_ = BuildInfo{ (_out) ? PATH::COMPILED : PATH::NONE, ShaderProgramCache::clock::now() - _start };
+		return _out;
+	};
+	std::optional<ShaderProgram> ShaderBuilder::build(ShaderProgramCache& _cache)
+	{
+		const auto _start = ShaderProgramCache::clock::now();
+		const auto _key = this->key();
+
+		if (auto _cached = _cache.load(_key); _cached)
+		{
+			this->log_.clear();
+			this->last_build_ = BuildInfo{ PATH::CACHE_HIT, ShaderProgramCache::clock::now() - _start };
+			_cache.stats_.hit_time += this->last_build_.time;
+			return _cached;
+		};
+
+		const auto _compileStart = ShaderProgramCache::clock::now();
+		auto _out = this->compile(_cache.supported());
+		const auto _compileEnd = ShaderProgramCache::clock::now();
+		if (!_out)
+		{
+			this->last_build_ = BuildInfo{ PATH::NONE, _compileEnd - _start };
+			return _out;
+		};
+		++_cache.stats_.compiles;
+		_cache.stats_.compile_time += _compileEnd - _compileStart;
+
+		_cache.store(_key, *_out);
+		this->last_build_ = BuildInfo{ PATH::COMPILED, ShaderProgramCache::clock::now() - _start };
+		return _out;
+	};
+
+	uint64_t ShaderBuilder::key() const
+	{
+		auto _hash = FNV_OFFSET_BASIS;
+		for (auto& _stage : this->stages_)
+		{
+			_hash = fnv1a(_hash, &_stage.type, sizeof(_stage.type));
+			_hash = fnv1a(_hash, _stage.source);
+		};
+		_hash = fnv1a(_hash, gl_string(GL_VENDOR));
+		_hash = fnv1a(_hash, gl_string(GL_RENDERER));
+		_hash = fnv1a(_hash, gl_string(GL_VERSION));
+		return _hash;
+	};
+
+	const std::string& ShaderBuilder::log() const noexcept
+	{
+		return this->log_;
+	};
+	const ShaderBuilder::BuildInfo& ShaderBuilder::last_build() const noexcept
+	{
+		return this->last_build_;
+	};
+
+	void ShaderBuilder::clear()
+	{
+		this->stages_.clear();
+		this->log_.clear();
+		this->last_build_ = BuildInfo{};
+	};
+
+
+
+	namespace
+	{
+		bool is_pending(ShaderLibrary::STATUS _status) noexcept
+		{
+			return _status == ShaderLibrary::STATUS::COMPILING || _status == ShaderLibrary::STATUS::LINKING;
+		};
+	}
+
+	bool ShaderLibrary::parallel() const noexcept
+	{
+		return this->parallel_;
+	};
+
+	void ShaderLibrary::submit(std::string _name, const ShaderBuilder& _builder)
+	{
+		if (!this->batch_open_)
+		{
+			this->batch_open_ = true;
+			this->batch_start_ = clock::now();
+		};
+		++this->stats_.submitted;
+
+		auto& _entry = this->entries_[std::move(_name)];
+		if (is_pending(_entry.status) && (_entry.program != 0 || !_entry.shaders.empty()))
+		{
+			this->release(_entry);
+			--this->pending_;
+		};
+		_entry.status = STATUS::COMPILING;
+		_entry.log.clear();
+		_entry.key = (this->cache_) ? _builder.key() : 0;
+
+		if (this->cache_)
+		{
+			if (auto _cached = this->cache_->load(_entry.key); _cached)
+			{
+				_entry.ready = std::move(*_cached);
+				_entry.status = STATUS::READY;
+				++this->stats_.ready;
+				++this->stats_.cache_hits;
+				return;
+			};
+		};
+
+		if (_builder.stages_.empty())
+		{
+			_entry.log = "no shader stages were given";
+			_entry.status = STATUS::FAILED;
+			++this->stats_.failed;
+			return;
+		};
+
+		// Every compile is issued now, the driver is free to work on them while the caller carries on
+		for (auto& _stage : _builder.stages_)
+		{
+			const auto _shader = glCreateShader(_stage.type);
+			const char* _source = _stage.source.c_str();
+			const GLint _length = (GLint)_stage.source.size();
+			glShaderSource(_shader, 1, &_source, &_length);
+			glCompileShader(_shader);
+			_entry.shaders.push_back(_shader);
+		};
+		++this->pending_;
+	};
+
+	bool ShaderLibrary::is_complete(const Entry& _entry, bool _block) const
+	{
+		if (_block)
+		{
+			return true;
+		};
+		if (!this->parallel_)
+		{
+			return false;
+		};
+
+		GLint _done = GL_FALSE;
+		if (_entry.status == STATUS::LINKING)
+		{
+			glGetProgramiv(_entry.program, GL_COMPLETION_STATUS_KHR, &_done);
+			return _done == GL_TRUE;
+		};
+		for (auto& _shader : _entry.shaders)
+		{
+			glGetShaderiv(_shader, GL_COMPLETION_STATUS_KHR, &_done);
+			if (_done != GL_TRUE)
+			{
+				return false;
+			};
+		};
+		return true;
+	};
+
+	bool ShaderLibrary::advance(Entry& _entry, bool _block)
+	{
+		if (!is_pending(_entry.status) || !this->is_complete(_entry, _block))
+		{
+			return false;
+		};
+
+		if (_entry.status == STATUS::LINKING)
+		{
+			const bool _linked = link_succeeded(_entry.program);
+			if (!_linked)
+			{
+				_entry.log = info_log(_entry.program, true);
+			};
+			this->finish_entry(_entry, _linked);
+			return true;
+		};
+
+		for (auto& _shader : _entry.shaders)
+		{
+			GLint _status = GL_FALSE;
+			glGetShaderiv(_shader, GL_COMPILE_STATUS, &_status);
+			if (_status != GL_TRUE)
+			{
+				_entry.log = info_log(_shader, false);
+				this->finish_entry(_entry, false);
+				return true;
+			};
+		};
+
+		_entry.program = glCreateProgram();
+		for (auto& _shader : _entry.shaders)
+		{
+			glAttachShader(_entry.program, _shader);
+		};
+		if (this->cache_ && this->cache_->supported())
+		{
+			glProgramParameteri(_entry.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		};
+		glLinkProgram(_entry.program);
+		_entry.status = STATUS::LINKING;
+		return true;
+	};
+
+	void ShaderLibrary::finish_entry(Entry& _entry, bool _succeeded)
+	{
+		if (_succeeded)
+		{
+			for (auto& _shader : _entry.shaders)
+			{
+				glDetachShader(_entry.program, _shader);
+			};
+			// Assigning over a previous program destroys it
+			_entry.ready = ShaderProgram{ std::exchange(_entry.program, 0) };
+			_entry.status = STATUS::READY;
+			++this->stats_.ready;
+
+			if (this->cache_)
+			{
+				this->cache_->store(_entry.key, *_entry.ready);
+			};
 		}
+		else
+		{
+			_entry.status = STATUS::FAILED;
+			++this->stats_.failed;
+		};
+		this->release(_entry);
+		--this->pending_;
+	};
+
+	void ShaderLibrary::release(Entry& _entry)
+	{
+		for (auto& _shader : _entry.shaders)
+		{
+			glDeleteShader(_shader);
+		};
+		_entry.shaders.clear();
+		if (_entry.program != 0)
+		{
+			gl::StateCache::current().delete_program(std::exchange(_entry.program, 0));
+		};
+	};
+
+	void ShaderLibrary::close_batch_if_idle()
+	{
+		if (this->batch_open_ && this->pending_ == 0)
+		{
+			this->stats_.time_to_all_ready = clock::now() - this->batch_start_;
+			this->batch_open_ = false;
+			this->batch_done_ = true;
+		};
+	};
+
+	bool ShaderLibrary::poll()
+	{
+		++this->stats_.polls;
 
-		glDetachShader(ProgramID, VertexShaderID);
-		glDetachShader(ProgramID, FragmentShaderID);
+		auto _budget = this->blocking_budget_;
+		for (auto& [_name, _entry] : this->entries_)
+		{
+			if (!is_pending(_entry.status))
+			{
+				continue;
+			};
+			const bool _block = !this->parallel_ && _budget != 0;
+			while (this->advance(_entry, _block))
+			{};
+			if (_block)
+			{
+				--_budget;
+			};
+		};
 
-		glDeleteShader(VertexShaderID);
-		glDeleteShader(FragmentShaderID);
+		this->close_batch_if_idle();
+		return this->pending_ == 0;
+	};
 
-		return ShaderProgram{ ProgramID };
+	void ShaderLibrary::finish()
+	{
+		for (auto& [_name, _entry] : this->entries_)
+		{
+			while (this->advance(_entry, true))
+			{};
+		};
+		this->close_batch_if_idle();
+	};
 
+	ShaderProgram* ShaderLibrary::find(std::string_view _name)
+	{
+		auto _it = this->entries_.find(_name);
+		return (_it != this->entries_.end() && _it->second.ready) ? &*_it->second.ready : nullptr;
 	};
 
+	std::optional<ShaderLibrary::STATUS> ShaderLibrary::status(std::string_view _name) const
+	{
+		auto _it = this->entries_.find(_name);
+		return (_it != this->entries_.end()) ? std::optional<STATUS>{ _it->second.status } : std::nullopt;
+	};
+	std::string_view ShaderLibrary::log(std::string_view _name) const
+	{
+		auto _it = this->entries_.find(_name);
+		return (_it != this->entries_.end()) ? std::string_view{ _it->second.log } : std::string_view{};
+	};
 
+	size_t ShaderLibrary::pending() const noexcept
+	{
+		return this->pending_;
+	};
+	bool ShaderLibrary::all_ready() const noexcept
+	{
+		return this->pending_ == 0 && this->stats_.failed == 0;
+	};
 
+	std::optional<std::chrono::nanoseconds> ShaderLibrary::time_to_all_ready() const noexcept
+	{
+		if (this->pending_ != 0 || !this->batch_done_)
+		{
+			return std::nullopt;
+		};
+		return this->stats_.time_to_all_ready;
+	};
 
+	const ShaderLibrary::Stats& ShaderLibrary::stats() const noexcept
+	{
+		return this->stats_;
+	};
 
+	size_t ShaderLibrary::blocking_budget() const noexcept
+	{
+		return this->blocking_budget_;
+	};
+	void ShaderLibrary::set_blocking_budget(size_t _programs) noexcept
+	{
+		this->blocking_budget_ = _programs;
+	};
+
+	ShaderLibrary::ShaderLibrary(ShaderProgramCache* _cache) :
+		cache_{ _cache },
+		parallel_{ gl::extensions().max_shader_compiler_threads != nullptr }
+	{
+		if (this->parallel_)
+		{
+			// Let the driver pick how many threads to compile on
+			gl::extensions().max_shader_compiler_threads(0xFFFFFFFF);
+		};
+	};
+	ShaderLibrary::~ShaderLibrary()
+	{
+		for (auto& [_name, _entry] : this->entries_)
+		{
+			this->release(_entry);
+			if (_entry.ready)
+			{
+				_entry.ready->destroy();
+			};
+		};
+	};
+
+
+
+	std::optional<ShaderProgram> HACK_generate_shader(std::istream& _vertex, std::istream& _fragment)
+	{
+		ShaderBuilder _builder{};
+		auto _out = _builder.vertex(_vertex).fragment(_fragment).build();
+		if (!_out)
+		{
+			SAE_LOG(SHADER, ERR) << _builder.log() << '\n';
+		};
+		return _out;
+	};
 
 }
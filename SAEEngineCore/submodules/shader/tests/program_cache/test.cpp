@@ -0,0 +1,215 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Shader.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace sae::engine::core;
+
+/*
+	Builds the same program through a ShaderProgramCache on the recording backend, checking it is compiled once and loaded
+	from disk after that, that edited sources and driver changes miss, and that damaged or refused entries fall back to
+	compiling. Ends by timing the compile path against the cache hit path.
+*/
+
+using CALL = gl::RecordingBackend::CALL;
+
+static size_t gl_calls(CALL _call)
+{
+	return gl::RecordingBackend::counters().count(_call);
+};
+
+constexpr static inline const char* VERTEX_SOURCE = R"(
+#version 330 core
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec4 col;
+out vec4 fcol;
+void main()
+{
+	gl_Position = vec4(pos, 1.0);
+	fcol = col;
+}
+)";
+
+constexpr static inline const char* FRAGMENT_SOURCE = R"(
+#version 330 core
+in vec4 fcol;
+out vec4 color;
+void main()
+{
+	color = fcol;
+}
+)";
+
+static ShaderBuilder make_builder(const char* _fragment = FRAGMENT_SOURCE)
+{
+	ShaderBuilder _builder{};
+	_builder.vertex(VERTEX_SOURCE).fragment(_fragment);
+	return _builder;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	gl::RecordingBackend::install();
+
+	const auto _dir = std::filesystem::temp_directory_path() / "SAEEngineCore_Shader_ProgramCache";
+	std::filesystem::remove_all(_dir);
+
+	// Reading from streams gives the same stages, and so the same key, as passing the strings
+	{
+		std::istringstream _vertex{ VERTEX_SOURCE };
+		std::istringstream _fragment{ FRAGMENT_SOURCE };
+		ShaderBuilder _builder{};
+		_builder.vertex(_vertex).fragment(_fragment);
+		if (_builder.key() != make_builder().key() || make_builder().key() == make_builder("void main(){}").key())
+		{
+			std::cout << "key does not follow the stage sources\n";
+			return 1;
+		};
+	};
+
+	// First build compiles and stores the binary
+	{
+		ShaderProgramCache _cache{ _dir };
+		auto _builder = make_builder();
+		auto _program = _builder.build(_cache);
+		if (!_cache.supported() || !_program || _builder.last_build().path != ShaderBuilder::PATH::COMPILED ||
+			_cache.stats().misses != 1 || _cache.stats().stores != 1 ||
+			!std::filesystem::exists(_cache.path_for(_builder.key())))
+		{
+			std::cout << "first build was not compiled and stored\n";
+			return 2;
+		};
+		if (gl_calls(CALL::COMPILE_SHADER) != 2 || gl_calls(CALL::PROGRAM_PARAMETER_I) != 1 ||
+			gl_calls(CALL::GET_PROGRAM_BINARY) != 1)
+		{
+			std::cout << "compiled program was not made retrievable and read back\n";
+			return 3;
+		};
+		_program->destroy();
+	};
+
+	// A new cache over the same directory, as on the next run, loads the binary without compiling
+	{
+		gl::RecordingBackend::reset_counters();
+		ShaderProgramCache _cache{ _dir };
+		auto _builder = make_builder();
+		auto _program = _builder.build(_cache);
+		if (!_program || _builder.last_build().path != ShaderBuilder::PATH::CACHE_HIT || _cache.stats().hits != 1 ||
+			gl_calls(CALL::COMPILE_SHADER) != 0 || gl_calls(CALL::PROGRAM_BINARY) != 1)
+		{
+			std::cout << "second build did not come from the cache\n";
+			return 4;
+		};
+		_program->destroy();
+	};
+
+	// Editing a stage misses
+	{
+		ShaderProgramCache _cache{ _dir };
+		auto _builder = make_builder("#version 330 core\nout vec4 color;\nvoid main() { color = vec4(1.0); }\n");
+		auto _program = _builder.build(_cache);
+		if (!_program || _builder.last_build().path != ShaderBuilder::PATH::COMPILED || _cache.stats().misses != 1)
+		{
+			std::cout << "edited source was loaded from the cache\n";
+			return 5;
+		};
+		_program->destroy();
+	};
+
+	// A damaged entry is rejected, rebuilt and replaced
+	{
+		ShaderProgramCache _cache{ _dir };
+		const auto _path = _cache.path_for(make_builder().key());
+		std::filesystem::resize_file(_path, std::filesystem::file_size(_path) - 3);
+
+		auto _builder = make_builder();
+		auto _program = _builder.build(_cache);
+		if (!_program || _builder.last_build().path != ShaderBuilder::PATH::COMPILED || _cache.stats().rejects != 1 ||
+			_cache.stats().stores != 1)
+		{
+			std::cout << "truncated entry was not rebuilt\n";
+			return 6;
+		};
+		_program->destroy();
+
+		_program = make_builder().build(_cache);
+		if (!_program || _cache.stats().hits != 1)
+		{
+			std::cout << "rebuilt entry was not loaded\n";
+			return 7;
+		};
+		_program->destroy();
+	};
+
+	// After a driver update the key changes, and a binary from the old driver that ends up under the new key is refused
+	// by glProgramBinary rather than used
+	{
+		ShaderProgramCache _cache{ _dir };
+		const auto _oldKey = make_builder().key();
+		gl::RecordingBackend::set_driver_version("4.3.1 Recording");
+		const auto _newKey = make_builder().key();
+		if (_oldKey == _newKey)
+		{
+			std::cout << "key does not follow the driver version\n";
+			return 8;
+		};
+		std::filesystem::copy_file(_cache.path_for(_oldKey), _cache.path_for(_newKey));
+
+		auto _builder = make_builder();
+		auto _program = _builder.build(_cache);
+		if (!_program || _builder.last_build().path != ShaderBuilder::PATH::COMPILED || _cache.stats().rejects != 1)
+		{
+			std::cout << "binary from another driver version was not rejected\n";
+			return 9;
+		};
+		_program->destroy();
+	};
+
+	// Compile path against cache hit path
+	{
+		constexpr size_t BUILDS = 1000;
+
+		ShaderProgramCache _cache{ _dir };
+		for (size_t n = 0; n != BUILDS; ++n)
+		{
+			make_builder().build(_cache)->destroy();
+		};
+
+		ShaderBuilder _builder = make_builder();
+		std::chrono::nanoseconds _compileTime{ 0 };
+		for (size_t n = 0; n != BUILDS; ++n)
+		{
+			_builder.build()->destroy();
+			_compileTime += _builder.last_build().time;
+		};
+		if (_cache.stats().hits != BUILDS)
+		{
+			std::cout << "expected every cached build to hit\n";
+			return 10;
+		};
+
+		std::cout << "compile : " << (_compileTime.count() / BUILDS) << " ns/build, cache hit : "
+			<< (_cache.stats().hit_time.count() / BUILDS) << " ns/build (recording backend, compile cost is not real)\n";
+	};
+
+	std::filesystem::remove_all(_dir);
+	return GOOD_TEST;
+};
@@ -0,0 +1,203 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Shader.h>
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace sae::engine::core;
+
+/*
+	Submits a batch of programs to a ShaderLibrary on the recording backend, once with parallel shader compile reporting
+	completion after a few polls and once without it, and checks every compile is issued up front, that programs become
+	available over several polls instead of all at once, and that the time to all ready is reported.
+*/
+
+using CALL = gl::RecordingBackend::CALL;
+
+constexpr static inline size_t PROGRAMS = 8;
+constexpr static inline size_t LATENCY = 3;
+
+static size_t gl_calls(CALL _call)
+{
+	return gl::RecordingBackend::counters().count(_call);
+};
+
+static ShaderBuilder make_builder(size_t _n)
+{
+	ShaderBuilder _builder{};
+	_builder.vertex("#version 330 core\nvoid main() { gl_Position = vec4(0.0); }\n");
+	_builder.fragment("#version 330 core\nout vec4 c;\nvoid main() { c = vec4(" + std::to_string(_n) + ".0); }\n");
+	return _builder;
+};
+
+static void submit_all(ShaderLibrary& _library)
+{
+	for (size_t n = 0; n != PROGRAMS; ++n)
+	{
+		_library.submit("program_" + std::to_string(n), make_builder(n));
+	};
+};
+
+static size_t count_ready(ShaderLibrary& _library)
+{
+	size_t _out = 0;
+	for (size_t n = 0; n != PROGRAMS; ++n)
+	{
+		_out += (_library.find("program_" + std::to_string(n)) != nullptr);
+	};
+	return _out;
+};
+
+int main(int argc, char* argv[], char* envp[])
+{
+	// With parallel compile nothing waits, programs are linked once their stages report complete
+	{
+		gl::RecordingBackend::install();
+		gl::RecordingBackend::set_completion_latency(LATENCY);
+
+		ShaderLibrary _library{};
+		if (!_library.parallel() || gl_calls(CALL::MAX_SHADER_COMPILER_THREADS) != 1)
+		{
+			std::cout << "parallel shader compile was not picked up\n";
+			return 1;
+		};
+
+		submit_all(_library);
+		if (gl_calls(CALL::COMPILE_SHADER) != PROGRAMS * 2 || gl_calls(CALL::LINK_PROGRAM) != 0 ||
+			_library.pending() != PROGRAMS || count_ready(_library) != 0 || _library.time_to_all_ready())
+		{
+			std::cout << "submit() did not issue every compile up front\n";
+			return 2;
+		};
+
+		// The first frame draws with nothing ready rather than waiting
+		if (_library.poll() || count_ready(_library) != 0)
+		{
+			std::cout << "poll() waited on the driver\n";
+			return 3;
+		};
+
+		size_t _polls = 1;
+		while (!_library.poll())
+		{
+			if (++_polls > 100)
+			{
+				std::cout << "programs never became ready\n";
+				return 4;
+			};
+		};
+		if (!_library.all_ready() || count_ready(_library) != PROGRAMS || !_library.time_to_all_ready() ||
+			gl_calls(CALL::LINK_PROGRAM) != PROGRAMS)
+		{
+			std::cout << "expected every program to be ready\n";
+			return 5;
+		};
+		std::cout << "parallel : ready after " << (_polls + 1) << " polls, "
+			<< _library.time_to_all_ready()->count() << " ns to all ready\n";
+	};
+
+	// Without it each poll finishes only as many programs as the blocking budget allows
+	{
+		gl::RecordingBackend::install();
+		gl::RecordingBackend::clear_extensions();
+
+		ShaderLibrary _library{};
+		_library.set_blocking_budget(2);
+		if (_library.parallel())
+		{
+			std::cout << "library reports parallel compile without the extension\n";
+			return 6;
+		};
+
+		submit_all(_library);
+		for (size_t n = 1; n <= PROGRAMS / 2; ++n)
+		{
+			_library.poll();
+			if (count_ready(_library) != n * 2)
+			{
+				std::cout << "poll " << n << " did not stay within the blocking budget\n";
+				return 7;
+			};
+		};
+		if (!_library.all_ready() || !_library.time_to_all_ready())
+		{
+			std::cout << "expected every program to be ready\n";
+			return 8;
+		};
+		std::cout << "blocking : ready after " << _library.stats().polls << " polls, "
+			<< _library.time_to_all_ready()->count() << " ns to all ready\n";
+
+		// Resubmitting keeps the ready program available until the new one is built
+		auto _old = _library.find("program_0")->id();
+		_library.submit("program_0", make_builder(100));
+		if (_library.pending() != 1 || _library.find("program_0") == nullptr || _library.find("program_0")->id() != _old ||
+			_library.time_to_all_ready())
+		{
+			std::cout << "resubmitted program was not kept available\n";
+			return 9;
+		};
+		_library.finish();
+		if (_library.pending() != 0 || _library.find("program_0")->id() == _old)
+		{
+			std::cout << "finish() did not replace the resubmitted program\n";
+			return 10;
+		};
+
+		// A program with no stages fails without holding up the rest
+		_library.submit("empty", ShaderBuilder{});
+		if (_library.status("empty") != ShaderLibrary::STATUS::FAILED || _library.log("empty").empty() ||
+			_library.all_ready() || _library.pending() != 0)
+		{
+			std::cout << "empty program did not fail\n";
+			return 11;
+		};
+	};
+
+	// Programs already in a ShaderProgramCache are ready on submit
+	{
+		gl::RecordingBackend::install();
+		const auto _dir = std::filesystem::temp_directory_path() / "SAEEngineCore_Shader_Library";
+		std::filesystem::remove_all(_dir);
+
+		ShaderProgramCache _cache{ _dir };
+		{
+			ShaderLibrary _library{ &_cache };
+			submit_all(_library);
+			_library.finish();
+		};
+		ShaderLibrary _library{ &_cache };
+		submit_all(_library);
+		if (_library.stats().cache_hits != PROGRAMS || count_ready(_library) != PROGRAMS)
+		{
+			std::cout << "cached programs were not ready on submit\n";
+			return 12;
+		};
+
+		// The batch is only closed by poll() or finish()
+		if (_library.time_to_all_ready() || !_library.poll() || !_library.time_to_all_ready())
+		{
+			std::cout << "cached batch was not closed by poll()\n";
+			return 13;
+		};
+		std::cout << "cached : " << _library.time_to_all_ready()->count() << " ns to all ready\n";
+		std::filesystem::remove_all(_dir);
+	};
+
+	return GOOD_TEST;
+};
@@ -0,0 +1,170 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_Shader.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace sae::engine::core;
+
+/*
+	Checks ShaderProgram reads its uniforms and uniform blocks once on creation, that the typed setters skip values the
+	uniform already holds, and that FrameUniforms only uploads when the frame data changes. Ends by counting GL calls for
+	a frame loop that looks locations up and sets every uniform each frame against one using the cached setters.
+*/
+
+using CALL = gl::RecordingBackend::CALL;
+
+static size_t gl_calls(CALL _call)
+{
+	return gl::RecordingBackend::counters().count(_call);
+};
+
+static std::string vertex_source()
+{
+	return std::string{ "#version 330 core\n" } + std::string{ FrameUniforms::GLSL_BLOCK } +
+		"uniform vec2 offset;\n"
+		"uniform float weights[4];\n"
+		"uniform mat4 model; // per object\n"
+		"void main() { gl_Position = projection * model * vec4(offset * weights[0], 0.0, 1.0); }\n";
+};
+
+constexpr static inline const char* FRAGMENT_SOURCE =
+	"#version 330 core\n"
+	"uniform vec2 offset;\n"
+	"uniform vec4 tint;\n"
+	"uniform float scale;\n"
+	"uniform sampler2D tex;\n"
+	"out vec4 color;\n"
+	"void main() { color = texture(tex, offset) * tint * scale; }\n";
+
+int main(int argc, char* argv[], char* envp[])
+{
+	gl::RecordingBackend::install();
+
+	auto _program = ShaderBuilder{}.vertex(vertex_source()).fragment(FRAGMENT_SOURCE).build();
+	if (!_program)
+	{
+		std::cout << "program failed to build\n";
+		return 1;
+	};
+
+	// Stages share "offset", block members are left to the block
+	if (_program->uniforms().size() != 6 || !_program->find_uniform("scale") || !_program->find_uniform("tex") ||
+		_program->find_uniform("viewport") || _program->find_uniform("missing"))
+	{
+		std::cout << "active uniforms were not read correctly, found " << _program->uniforms().size() << '\n';
+		return 2;
+	};
+	auto _weights = _program->find_uniform("weights");
+	if (!_weights || _weights->count != 4 || _weights->type != GL_FLOAT)
+	{
+		std::cout << "array uniform was not read correctly\n";
+		return 3;
+	};
+	auto _block = _program->find_uniform_block(FrameUniforms::BLOCK_NAME);
+	if (!_block || _block->data_size != (GLint)sizeof(FrameUniforms::Data) || _block->binding != FrameUniforms::BINDING)
+	{
+		std::cout << "frame uniform block was not read correctly\n";
+		return 4;
+	};
+
+	// Setting the same value again is skipped, and lookups never go back to GL
+	gl::RecordingBackend::reset_counters();
+	for (int n = 0; n != 100; ++n)
+	{
+		_program->set_uniform("scale", 2.0f);
+		_program->set_uniform("offset", 1.0f, (GLfloat)(n / 50));
+	};
+	if (gl_calls(CALL::UNIFORM_1F) != 1 || gl_calls(CALL::UNIFORM_2F) != 2 || gl_calls(CALL::GET_UNIFORM_LOCATION) != 0 ||
+		_program->uniform_counters().issued != 3 || _program->uniform_counters().elided != 197)
+	{
+		std::cout << "redundant uniform uploads were not skipped\n";
+		return 5;
+	};
+
+	// Setters check the type and integer setters also set samplers
+	const GLfloat _identity[16]{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	if (_program->set_uniform("scale", 1.0f, 2.0f) || _program->set_uniform("missing", 1.0f) ||
+		!_program->set_uniform("tex", 0) || !_program->set_uniform("tint", 1.0f, 1.0f, 1.0f, 1.0f) ||
+		!_program->set_uniform_matrix4("model", _identity) || gl_calls(CALL::UNIFORM_2F) != 2 ||
+		gl_calls(CALL::UNIFORM_1I) != 1 || gl_calls(CALL::UNIFORM_4F) != 1 || gl_calls(CALL::UNIFORM_MATRIX_4FV) != 1)
+	{
+		std::cout << "setter type checks failed\n";
+		return 6;
+	};
+
+	// The frame block is uploaded once per change, however many programs use it
+	{
+		FrameUniforms _frame{};
+		gl::RecordingBackend::reset_counters();
+		for (int f = 0; f != 10; ++f)
+		{
+			_frame.update(800.0f, 600.0f);
+		};
+		_frame.update(1024.0f, 768.0f);
+		const auto _stored = gl::RecordingBackend::buffer_data(_frame.id());
+		if (_frame.stats().uploads != 2 || _frame.stats().skipped != 9 || gl_calls(CALL::BUFFER_SUB_DATA) != 2 ||
+			_stored.size() != sizeof(FrameUniforms::Data) ||
+			std::memcmp(_stored.data(), &_frame.data(), _stored.size()) != 0 || _frame.data().viewport[0] != 1024.0f)
+		{
+			std::cout << "frame uniforms were not uploaded once per change\n";
+			return 7;
+		};
+	};
+
+	// Looking up and setting every uniform each frame against the cached setters, with one value changing per frame
+	{
+		constexpr size_t FRAMES = 1000;
+
+		gl::RecordingBackend::reset_counters();
+		for (size_t f = 0; f != FRAMES; ++f)
+		{
+			const auto _id = _program->id();
+			glUseProgram(_id);
+			glUniform1f(glGetUniformLocation(_id, "scale"), 2.0f);
+			glUniform2f(glGetUniformLocation(_id, "offset"), 1.0f, (GLfloat)f);
+			glUniform4f(glGetUniformLocation(_id, "tint"), 1.0f, 1.0f, 1.0f, 1.0f);
+			glUniform1i(glGetUniformLocation(_id, "tex"), 0);
+			glUniformMatrix4fv(glGetUniformLocation(_id, "model"), 1, GL_FALSE, _identity);
+		};
+		const auto _naiveCalls = gl::RecordingBackend::counters().total_calls();
+
+		gl::RecordingBackend::reset_counters();
+		for (size_t f = 0; f != FRAMES; ++f)
+		{
+			_program->set_uniform("scale", 2.0f);
+			_program->set_uniform("offset", 1.0f, (GLfloat)f);
+			_program->set_uniform("tint", 1.0f, 1.0f, 1.0f, 1.0f);
+			_program->set_uniform("tex", 0);
+			_program->set_uniform_matrix4("model", _identity);
+		};
+		const auto _cachedCalls = gl::RecordingBackend::counters().total_calls();
+
+		if (_cachedCalls * 4 > _naiveCalls)
+		{
+			std::cout << "cached setters did not cut gl calls, " << _cachedCalls << " against " << _naiveCalls << '\n';
+			return 8;
+		};
+		std::cout << "per frame gl calls : " << ((double)_naiveCalls / FRAMES) << " looking up and setting every uniform, "
+			<< ((double)_cachedCalls / FRAMES) << " with cached setters\n";
+	};
+
+	_program->destroy();
+	return GOOD_TEST;
+};
@@ -32,8 +32,11 @@ namespace sae::engine::core
 
 		void refresh() override;
 
-		pixels_t& margin() noexcept;
-		const pixels_t& margin() const noexcept;
+		/**
+		 * @brief Sets the margin between children, marking the list as needing a new layout if it changed
+		*/
+		void set_margin(pixels_t _margin) noexcept;
+		pixels_t margin() const noexcept;
 
 		void set_axis(AXIS _axis) noexcept;
 		AXIS axis() const noexcept;
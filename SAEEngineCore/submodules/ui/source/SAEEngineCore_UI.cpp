@@ -20,7 +20,7 @@ namespace sae::engine::core
 		};
 
 		auto _w = this->bounds().width();
-		auto _inc = _eachWidth + this->margin();
+		auto _inc = _eachWidth + this->margin_;
 		if (this->direction() == DIRECTION::NEGATIVE)
 		{
 			_inc = -_inc;
@@ -28,11 +28,12 @@ namespace sae::engine::core
 
 		for (auto& o : this->children())
 		{
-			auto& _b = o->bounds();
+			Rect _b{};
 			_b.left() = _x;
 			_b.right() = _b.left() + _eachWidth;
 			_b.top() = this->bounds().top();
 			_b.bottom() = this->bounds().bottom();
+			o->set_bounds(_b);
 			_x += _inc;
 		};
 	};
@@ -60,7 +61,7 @@ namespace sae::engine::core
 		};
 
 		auto _h = this->bounds().height();
-		auto _inc = _eachHeight + this->margin();
+		auto _inc = _eachHeight + this->margin_;
 		if (this->direction() == DIRECTION::NEGATIVE)
 		{
 			_inc = -_inc;
@@ -68,11 +69,12 @@ namespace sae::engine::core
 
 		for (auto& o : this->children())
 		{
-			auto& _b = o->bounds();
+			Rect _b{};
 			_b.left() = this->bounds().left();
 			_b.right() = this->bounds().right();
 			_b.top() = _y;
 			_b.bottom() = _y + _eachHeight;
+			o->set_bounds(_b);
 			_y += _inc;
 		};
 	};
@@ -85,18 +87,26 @@ namespace sae::engine::core
 		};
 	};
 
-	pixels_t& UIList::margin() noexcept
+	void UIList::set_margin(pixels_t _margin) noexcept
 	{
-		return this->margin_;
+		if (this->margin_ != _margin)
+		{
+			this->margin_ = _margin;
+			this->mark_dirty(DIRTY_BITS::dtLayout);
+		};
 	};
-	const pixels_t& UIList::margin() const noexcept
+	pixels_t UIList::margin() const noexcept
 	{
 		return this->margin_;
 	};
 
 	void  UIList::set_axis(AXIS _axis) noexcept
 	{
-		this->axis_ = _axis;
+		if (this->axis_ != _axis)
+		{
+			this->axis_ = _axis;
+			this->mark_dirty(DIRTY_BITS::dtLayout);
+		};
 	};
 	UIList::AXIS UIList::axis() const noexcept
 	{
@@ -105,7 +115,11 @@ namespace sae::engine::core
 
 	void UIList::set_direction(DIRECTION _dir) noexcept
 	{
-		this->dir_ = _dir;
+		if (this->dir_ != _dir)
+		{
+			this->dir_ = _dir;
+			this->mark_dirty(DIRTY_BITS::dtLayout);
+		};
 	};
 	UIList::DIRECTION UIList::direction() const noexcept
 	{
@@ -114,16 +128,20 @@ namespace sae::engine::core
 
 	void UIList::refresh()
 	{
-		switch (this->axis())
+		// Skip the layout when only a descendant changed
+		if (this->is_dirty(DIRTY_BITS::dtBounds) || this->is_dirty(DIRTY_BITS::dtChildren) || this->is_dirty(DIRTY_BITS::dtLayout))
 		{
-		case AXIS::HORIZONTAL:
-			this->reposition_horizontal();
-			break;
-		case AXIS::VERTICAL:
-			this->reposition_vertical();
-			break;
-		default:
-			abort();
+			switch (this->axis())
+			{
+			case AXIS::HORIZONTAL:
+				this->reposition_horizontal();
+				break;
+			case AXIS::VERTICAL:
+				this->reposition_vertical();
+				break;
+			default:
+				abort();
+			};
 		};
 		GFXView::refresh();
 	}; 
@@ -135,6 +153,7 @@ namespace sae::engine::core
 	void UIList::use_fixed_size(Rect _r) noexcept
 	{
 		this->fixed_size_ = _r;
+		this->mark_dirty(DIRTY_BITS::dtLayout);
 	};
 	std::optional<Rect> UIList::fixed_size() const noexcept
 	{
@@ -0,0 +1,81 @@
+/*
+	Return GOOD_TEST (0) if the test was passed.
+	Return anything other than GOOD_TEST (0) if the test was failed.
+*/
+
+// Common standard library headers
+
+#include <cassert>
+
+/**
+ * @brief Return this from main if the test was passsed.
+*/
+constexpr static inline int GOOD_TEST = 0;
+
+// Include the headers you need for testing here
+
+#include <SAEEngineCore_UI.h>
+
+
+using namespace sae::engine::core;
+
+int main(int argc, char* argv[], char* envp[])
+{
+	GFXContext _context{ nullptr, Rect{{ 0_px, 0_px }, { 1000_px, 500_px }} };
+
+	// Two columns of rows, each row holding a few objects
+	UIList* _columns[2]{};
+	UIList* _rows[2][4]{};
+	for (auto c = 0; c != 2; ++c)
+	{
+		_columns[c] = new UIList{ &_context, Rect{}, UIList::VERTICAL, UIList::POSITIVE, 0_px };
+		for (auto r = 0; r != 4; ++r)
+		{
+			_rows[c][r] = new UIList{ &_context, Rect{}, UIList::HORIZONTAL, UIList::POSITIVE, 0_px };
+			for (auto n = 0; n != 5; ++n)
+			{
+				_rows[c][r]->emplace(new GFXObject{});
+			};
+			_columns[c]->emplace(_rows[c][r]);
+		};
+	};
+	auto _root = new UIList{ &_context, _context.bounds(), UIList::HORIZONTAL, UIList::POSITIVE, 0_px };
+	_root->emplace(_columns[0]);
+	_root->emplace(_columns[1]);
+	_context.emplace(_root);
+
+	// First refresh lays out everything
+	_context.refresh();
+	const auto _total = 1 + 1 + 2 + 8 + 40;
+	assert(_context.last_refresh_stats().visited == _total);
+	assert(_rows[1][3]->bounds().left() == 500_px);
+	assert(_rows[1][3]->bounds().top() == 375_px);
+	assert(_rows[1][3]->first_child()->bounds().right() == 600_px);
+
+	// Nothing changed, nothing below the root is visited
+	_context.refresh();
+	assert(_context.last_refresh_stats().visited == 0);
+
+	// Changing one row only visits the path down to it and the row's children
+	_rows[0][2]->set_margin(10_px);
+	_context.refresh();
+	assert(_context.last_refresh_stats().visited == 4 + 5);
+	assert(_rows[0][2]->first_child()->bounds().right() == 92_px);
+
+	_context.refresh();
+	assert(_context.last_refresh_stats().visited == 0);
+
+	// Setting the same margin or bounds again does not mark anything
+	_rows[0][2]->set_margin(_rows[0][2]->margin());
+	_rows[0][2]->first_child()->set_bounds(_rows[0][2]->first_child()->bounds());
+	_context.refresh();
+	assert(_context.last_refresh_stats().visited == 0);
+
+	// Adding a child re-lays out only the affected row
+	_rows[1][0]->emplace(new GFXObject{});
+	_context.refresh();
+	assert(_context.last_refresh_stats().visited == 4 + 6);
+	assert(_rows[1][0]->last_child()->bounds().right() == 500_px + 6 * 83_px);
+
+	return GOOD_TEST;
+};
@@ -176,6 +176,8 @@ namespace sae::engine::core
 	{
 		pixels_t x = 0_px;
 		pixels_t y = 0_px;
+
+		constexpr bool operator==(const ScreenPoint&) const noexcept = default;
 	};
 
 	/**
@@ -275,6 +277,8 @@ namespace sae::engine::core
 			return ScreenPoint{ std::midpoint(this->left(), this->right()), std::midpoint(this->top(), this->bottom()) };
 		};
 
+		constexpr bool operator==(const Rect&) const noexcept = default;
+
 
 	};
 
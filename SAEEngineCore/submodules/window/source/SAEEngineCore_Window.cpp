@@ -23,9 +23,7 @@ namespace sae::engine::core
 			_evm.cursor_x = _cursorPos.x;
 			_evm.cursor_y = _cursorPos.y;
 
-			Event _ev{ _evm, true };
-			_ptr->context_->handle_event(_ev);
-
+			_ptr->context_->post_event(Event{ _evm, true });
 		};
 	};
 
@@ -35,8 +33,7 @@ namespace sae::engine::core
 		if (_ptr)
 		{
 			Event::evScroll _event{ _x, _y };
-			Event _ev{ _event };
-			_ptr->context_->handle_event(_ev);
+			_ptr->context_->post_event(Event{ _event });
 		};
 	};
 
@@ -50,13 +47,7 @@ namespace sae::engine::core
 			_event.scancode = _scancode;
 			_event.action = _action;
 			_event.mods = _mods;
-			Event _ev{ _event };
-			_ptr->context_->handle_event(_ev);
-
-			if (!_ev)
-			{
-				_ptr->context_->refresh();
-			};
+			_ptr->context_->post_event(Event{ _event });
 
 		};
 	};
@@ -67,13 +58,7 @@ namespace sae::engine::core
 		{
 			Event::evText _event{};
 			_event.codepoint = _codepoint;
-			Event _ev{ _event };
-			_ptr->context_->handle_event(_ev);
-
-			if (!_ev)
-			{
-				_ptr->context_->refresh();
-			};
+			_ptr->context_->post_event(Event{ _event });
 		};
 	};
 
@@ -85,12 +70,7 @@ namespace sae::engine::core
 			Event::evCursorMove _event{};
 			_event.cursor_x = (int16_t)_x;
 			_event.cursor_y = (int16_t)_y;
-			Event _ev{ _event, true };
-			_ptr->context_->handle_event(_ev);
-			if (!_ev)
-			{
-				_ptr->context_->refresh();
-			};
+			_ptr->context_->post_event(Event{ _event, true });
 		};
 	};
 	void WindowEventAdapter::glfw_cursor_enter_callback(GLFWwindow* _window, int _entered)
@@ -107,13 +87,7 @@ namespace sae::engine::core
 			{
 				_event.action == Event::evCursorWindowBounds::EXIT;
 			};
-			Event _ev{ _event };
-			_ptr->context_->handle_event(_ev);
-
-			if (!_ev)
-			{
-				_ptr->context_->refresh();
-			};
+			_ptr->context_->post_event(Event{ _event });
 		};
 	};
 
@@ -131,11 +105,9 @@ namespace sae::engine::core
 
 			_wb.right() = _width;
 			_wb.bottom() = _height;
+			_ptr->context_->mark_dirty(GFXObject::dtBounds);
 
-			Event _ev{ _event, true };
-			_ptr->context_->handle_event(_ev);
-			_ptr->context_->refresh();
-			
+			_ptr->context_->post_event(Event{ _event, true });
 		};
 	};
 
@@ -144,8 +116,7 @@ namespace sae::engine::core
 		auto _ptr = (WindowEventAdapter*)glfwGetWindowUserPointer(_window);
 		if (_ptr)
 		{
-			Event _ev{ Event::evWindowClose{}, true };
-			_ptr->context_->handle_event(_ev);
+			_ptr->context_->post_event(Event{ Event::evWindowClose{}, true });
 		};
 	};
 
@@ -159,9 +130,11 @@ namespace sae::engine::core
 			glfwGetFramebufferSize(_window, &_w, &_h);
 			WindowEventAdapter::glfw_framebuffer_resize_callback(_window, _w, _h);
 
-			Event _ev{ Event::evRefresh{} };
-			_ptr->context_->handle_event(_ev);
+			_ptr->context_->post_event(Event{ Event::evRefresh{} });
 
+			// The main loop can be stuck inside glfwPollEvents while the window is being resized, handle the queue here so
+			// the layout keeps up
+			_ptr->context_->process_events();
 		};
 
 	};
@@ -169,6 +142,12 @@ namespace sae::engine::core
 	WindowEventAdapter::WindowEventAdapter(GFXContext* _context) : 
 		context_{ _context }
 	{
+		// Headless contexts have no window to take callbacks from, events are posted to them directly
+		if (!this->context_->window())
+		{
+			return;
+		};
+
 		glfwSetWindowUserPointer(this->context_->window(), this);
 		glfwSetMouseButtonCallback(this->context_->window(), &WindowEventAdapter::glfw_mouse_button_callback);
 
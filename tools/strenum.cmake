@@ -0,0 +1,232 @@
+###
+###	Generates a header containing an enum wrapper class with compile time string conversion.
+###
+###	Usage :
+###		cmake -DSTRENUM_INPUT=<enum file> -DSTRENUM_OUTPUT=<header> -DSTRENUM_NAME=<class name> [-DSTRENUM_NAMESPACE=<namespace>] -P strenum.cmake
+###
+###	The input file lists one enumerator per line, each followed by a semicolon. Values are assigned in order starting at 0.
+###
+###	The generated class keeps the enumerator names in a constexpr array so to_string() is an array index, and from_string()
+###	looks names up through a perfect hash whose seed is found here, so neither allocates and both work in constant expressions.
+###
+
+cmake_minimum_required(VERSION 3.8)
+
+foreach(_var STRENUM_INPUT STRENUM_OUTPUT STRENUM_NAME)
+	if(NOT DEFINED ${_var})
+		message(FATAL_ERROR "strenum : ${_var} must be set")
+	endif()
+endforeach()
+
+file(READ "${STRENUM_INPUT}" _content)
+string(REGEX MATCHALL "[A-Za-z_][A-Za-z0-9_]*" _names "${_content}")
+list(LENGTH _names _count)
+if(_count EQUAL 0)
+	message(FATAL_ERROR "strenum : no enumerators found in ${STRENUM_INPUT}")
+endif()
+
+## Character code lookup, identifiers only contain printable ascii
+foreach(_code RANGE 48 122)
+	string(ASCII ${_code} _char)
+	set(_CHAR_CODE_${_char} ${_code})
+endforeach()
+
+## Key for each name. The length and three sampled characters are used when they tell every name apart, which is much cheaper
+## than hashing the whole string, otherwise fall back to 32 bit FNV-1a of the whole name. The per seed mixing below only needs
+## the keys computed once.
+set(_keys "")
+foreach(_name IN LISTS _names)
+	string(LENGTH "${_name}" _len)
+	math(EXPR _mid "${_len} / 2")
+	math(EXPR _last "${_len} - 1")
+	string(SUBSTRING "${_name}" 0 1 _c0)
+	string(SUBSTRING "${_name}" ${_mid} 1 _c1)
+	string(SUBSTRING "${_name}" ${_last} 1 _c2)
+	math(EXPR _k "((${_len} * 31 + ${_CHAR_CODE_${_c0}}) * 31 + ${_CHAR_CODE_${_c1}}) * 31 + ${_CHAR_CODE_${_c2}}")
+	list(APPEND _keys ${_k})
+endforeach()
+
+set(_uniqueKeys ${_keys})
+list(REMOVE_DUPLICATES _uniqueKeys)
+list(LENGTH _uniqueKeys _uniqueCount)
+set(_fullHash false)
+if(NOT _uniqueCount EQUAL _count)
+	set(_fullHash true)
+	set(_keys "")
+	foreach(_name IN LISTS _names)
+		set(_k 2166136261)
+		string(LENGTH "${_name}" _len)
+		math(EXPR _last "${_len} - 1")
+		foreach(_i RANGE ${_last})
+			string(SUBSTRING "${_name}" ${_i} 1 _char)
+			math(EXPR _k "((${_k} ^ ${_CHAR_CODE_${_char}}) * 16777619) & 4294967295")
+		endforeach()
+		list(APPEND _keys ${_k})
+	endforeach()
+endif()
+
+## Search for a seed that gives each name its own slot, starting from the smallest power of two table that fits
+set(_bits 1)
+set(_tableSize 2)
+while(_tableSize LESS _count)
+	math(EXPR _bits "${_bits} + 1")
+	math(EXPR _tableSize "${_tableSize} * 2")
+endwhile()
+
+set(_found FALSE)
+while(NOT _found)
+	math(EXPR _shift "32 - ${_bits}")
+	foreach(_seed RANGE 1 4096)
+		set(_used "")
+		set(_found TRUE)
+		foreach(_k IN LISTS _keys)
+			# Multiply by 0x9E3779B1 modulo 2^32 in two halves so the product stays inside cmake's signed 64 bit math
+			math(EXPR _x "${_k} ^ ${_seed}")
+			math(EXPR _slot "(((${_x} * 31153) + (((${_x} * 40503) & 65535) << 16)) & 4294967295) >> ${_shift}")
+			list(FIND _used ${_slot} _at)
+			if(NOT _at EQUAL -1)
+				set(_found FALSE)
+				break()
+			endif()
+			list(APPEND _used ${_slot})
+		endforeach()
+		if(_found)
+			set(_hashSeed ${_seed})
+			break()
+		endif()
+	endforeach()
+	if(NOT _found)
+		math(EXPR _bits "${_bits} + 1")
+		math(EXPR _tableSize "${_tableSize} * 2")
+	endif()
+endwhile()
+
+## Slot table, npos for slots no name hashes to
+set(_npos 255)
+if(_count GREATER 255)
+	set(_npos 65535)
+endif()
+math(EXPR _lastSlot "${_tableSize} - 1")
+set(_slotValues "")
+foreach(_slot RANGE ${_lastSlot})
+	list(FIND _used ${_slot} _index)
+	if(_index EQUAL -1)
+		list(APPEND _slotValues "npos")
+	else()
+		list(APPEND _slotValues "${_index}")
+	endif()
+endforeach()
+string(REPLACE ";" ", " _slotValues "${_slotValues}")
+
+set(_slotType "uint8_t")
+if(_count GREATER 255)
+	set(_slotType "uint16_t")
+endif()
+
+## Write the header
+set(_name "${STRENUM_NAME}")
+set(_enumerators "")
+set(_strings "")
+foreach(_enumerator IN LISTS _names)
+	string(APPEND _enumerators "\t\t${_enumerator},\n")
+	string(APPEND _strings "\t\t\"${_enumerator}\",\n")
+endforeach()
+
+set(_out "#pragma once\n")
+string(APPEND _out "
+/*
+	Generated by tools/strenum.cmake from ${_count} enumerators, do not edit.
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+")
+if(DEFINED STRENUM_NAMESPACE)
+	string(APPEND _out "\nnamespace ${STRENUM_NAMESPACE}\n{\n")
+endif()
+string(APPEND _out "
+class ${_name}
+{
+public:
+	enum ${_name}_E
+	{
+${_enumerators}	};
+
+	constexpr static inline size_t COUNT = ${_count};
+
+private:
+	constexpr static inline std::array<std::string_view, COUNT> NAMES
+	{
+${_strings}	};
+
+	using slot_type = ${_slotType};
+	constexpr static inline slot_type npos = ${_npos};
+	constexpr static inline uint32_t HASH_SEED = ${_hashSeed};
+	constexpr static inline uint32_t HASH_SHIFT = ${_shift};
+	constexpr static inline std::array<slot_type, ${_tableSize}> HASH_SLOTS
+	{
+		${_slotValues}
+	};
+
+	constexpr static inline bool HASH_FULL = ${_fullHash};
+
+	constexpr static uint32_t hash(std::string_view _str) noexcept
+	{
+		uint32_t _k = 0;
+		if constexpr (HASH_FULL)
+		{
+			_k = 2166136261u;
+			for (auto c : _str)
+			{
+				_k = (_k ^ (uint32_t)(unsigned char)c) * 16777619u;
+			};
+		}
+		else if (!_str.empty())
+		{
+			_k = (uint32_t)_str.size();
+			_k = _k * 31u + (uint32_t)(unsigned char)_str.front();
+			_k = _k * 31u + (uint32_t)(unsigned char)_str[_str.size() / 2];
+			_k = _k * 31u + (uint32_t)(unsigned char)_str.back();
+		};
+		return ((_k ^ HASH_SEED) * 2654435761u) >> HASH_SHIFT;
+	};
+
+	${_name}_E val_;
+
+public:
+	friend constexpr inline bool operator==(const ${_name}& _lhs, const ${_name}& _rhs) noexcept = default;
+	friend constexpr inline bool operator!=(const ${_name}& _lhs, const ${_name}& _rhs) noexcept = default;
+	explicit operator bool() noexcept = delete;
+
+	constexpr static inline std::optional<${_name}_E> from_string(std::string_view _str) noexcept
+	{
+		const auto _slot = HASH_SLOTS[hash(_str)];
+		if (_slot != npos && NAMES[_slot] == _str)
+		{
+			return (${_name}_E)_slot;
+		};
+		return std::nullopt;
+	};
+	constexpr std::string_view to_string() const noexcept
+	{
+		return NAMES[this->val_];
+	};
+
+	constexpr inline operator ${_name}_E() const noexcept { return this->val_; };
+	constexpr ${_name}(${_name}_E _val) noexcept :
+		val_{ _val }
+	{};
+	constexpr ${_name}& operator=(${_name}_E _val) noexcept {
+		this->val_ = _val;
+		return *this;
+	};
+};
+")
+if(DEFINED STRENUM_NAMESPACE)
+	string(APPEND _out "\n};\n")
+endif()
+
+file(WRITE "${STRENUM_OUTPUT}" "${_out}")